@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Vector.hpp"
+#include "Matrix.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace Math
+{
+    /* Affine transform with an implicit fourth row of (0, 0, 0, 1) */
+    struct alignas(16u) Affine3x4
+    {
+        using Index = Matrix4x4::Index;
+
+        /* Affine data will be stored in row major order, this matches a row_major mat4x3 in std140 */
+        std::array<float, 12u> Data;
+
+        inline constexpr float & operator [](Index AffineIndex)
+        {
+            return Data [(AffineIndex.RowIndex << 2u) + AffineIndex.ColumnIndex];
+        }
+
+        inline constexpr float const & operator [](Index AffineIndex) const
+        {
+            return Data [(AffineIndex.RowIndex << 2u) + AffineIndex.ColumnIndex];
+        }
+
+        static constexpr Affine3x4 const Identity()
+        {
+            return Affine3x4
+            {
+                1.0f, 0.0f, 0.0f, 0.0f,
+                0.0f, 1.0f, 0.0f, 0.0f,
+                0.0f, 0.0f, 1.0f, 0.0f,
+            };
+        }
+
+        static constexpr Affine3x4 const TranslationScale(Vector3 const & Translation, float const Scale)
+        {
+            return Affine3x4
+            {
+                Scale, 0.0f, 0.0f, Translation.X,
+                0.0f, Scale, 0.0f, Translation.Y,
+                0.0f, 0.0f, Scale, Translation.Z,
+            };
+        }
+
+        /*
+            Inverts the 3x3 part using cross products, then transforms the translation back.
+            Fails when the 3x3 part is singular, or close enough that 1 / determinant isn't finite. OutputAffine is left unchanged when it fails.
+        */
+        static bool const Inverse(Affine3x4 const & Affine, Affine3x4 & OutputAffine);
+
+        /* Only valid when the 3x3 part is orthonormal, e.g. camera transforms */
+        static Affine3x4 const InverseRigid(Affine3x4 const & Affine);
+
+        /* The bottom row of the matrix is dropped, so this should only be used with affine matrices */
+        static Affine3x4 const FromMatrix4x4(Matrix4x4 const & Matrix);
+
+        static Matrix4x4 const ToMatrix4x4(Affine3x4 const & Affine);
+    };
+
+    extern Affine3x4 const operator * (Affine3x4 const & Left, Affine3x4 const & Right);
+
+    extern Vector3 const TransformPoint(Affine3x4 const & Affine, Vector3 const & Point);
+
+    extern Vector3 const TransformVector(Affine3x4 const & Affine, Vector3 const & Vector);
+
+    /* Batched version of TransformPoint, input and output can alias */
+    extern void TransformPoints(Affine3x4 const & Affine, std::uint32_t const PointCount, Vector3 const * const Points, Vector3 * const OutputPoints);
+}
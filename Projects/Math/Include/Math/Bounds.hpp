@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Vector.hpp"
+#include "Matrix.hpp"
+#include "Affine.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace Math
+{
+    struct AABB
+    {
+        Vector3 Minimum;
+        Vector3 Maximum;
+
+        inline static AABB const Union(AABB const & Left, AABB const & Right)
+        {
+            return AABB
+            {
+                Vector3 { std::min(Left.Minimum.X, Right.Minimum.X), std::min(Left.Minimum.Y, Right.Minimum.Y), std::min(Left.Minimum.Z, Right.Minimum.Z) },
+                Vector3 { std::max(Left.Maximum.X, Right.Maximum.X), std::max(Left.Maximum.Y, Right.Maximum.Y), std::max(Left.Maximum.Z, Right.Maximum.Z) },
+            };
+        }
+
+        /* Half the surface area, the factor of two cancels out in SAH cost ratios */
+        inline static float const HalfSurfaceArea(AABB const & Bounds)
+        {
+            float const ExtentX = Bounds.Maximum.X - Bounds.Minimum.X;
+            float const ExtentY = Bounds.Maximum.Y - Bounds.Minimum.Y;
+            float const ExtentZ = Bounds.Maximum.Z - Bounds.Minimum.Z;
+
+            return ExtentX * ExtentY + ExtentY * ExtentZ + ExtentZ * ExtentX;
+        }
+
+        inline static Vector3 const Centre(AABB const & Bounds)
+        {
+            return Vector3 { (Bounds.Minimum.X + Bounds.Maximum.X) * 0.5f, (Bounds.Minimum.Y + Bounds.Maximum.Y) * 0.5f, (Bounds.Minimum.Z + Bounds.Maximum.Z) * 0.5f };
+        }
+
+        inline static bool const Contains(AABB const & Outer, AABB const & Inner)
+        {
+            return Outer.Minimum.X <= Inner.Minimum.X && Outer.Minimum.Y <= Inner.Minimum.Y && Outer.Minimum.Z <= Inner.Minimum.Z
+                && Outer.Maximum.X >= Inner.Maximum.X && Outer.Maximum.Y >= Inner.Maximum.Y && Outer.Maximum.Z >= Inner.Maximum.Z;
+        }
+
+        inline static bool const Overlaps(AABB const & Left, AABB const & Right)
+        {
+            return Left.Minimum.X <= Right.Maximum.X && Left.Maximum.X >= Right.Minimum.X
+                && Left.Minimum.Y <= Right.Maximum.Y && Left.Maximum.Y >= Right.Minimum.Y
+                && Left.Minimum.Z <= Right.Maximum.Z && Left.Maximum.Z >= Right.Minimum.Z;
+        }
+
+        static constexpr AABB const Empty()
+        {
+            return AABB
+            {
+                Vector3 { 3.402823466e+38f, 3.402823466e+38f, 3.402823466e+38f },
+                Vector3 { -3.402823466e+38f, -3.402823466e+38f, -3.402823466e+38f },
+            };
+        }
+    };
+
+    /* Planes are (Normal, Distance) with the normal pointing into the frustum */
+    using FrustumPlanes = std::array<Vector4, 6u>;
+
+    enum class FrustumTestResults : std::uint8_t
+    {
+        Outside,
+        Intersecting,
+        Inside,
+    };
+
+    /* Works for any clip space with -w <= x <= w, -w <= y <= w and 0 <= z <= w, the planes are normalised */
+    extern void ExtractFrustumPlanes(Matrix4x4 const & WorldToClipMatrix, FrustumPlanes & OutputPlanes);
+
+    /* Conservative, boxes near the frustum corners can be reported as intersecting when they are outside */
+    extern FrustumTestResults const TestFrustumAABB(FrustumPlanes const & Planes, AABB const & Bounds);
+
+    /* The bounds of the transformed box, not the tightest bounds of the transformed contents */
+    extern AABB const TransformAABB(Affine3x4 const & Affine, AABB const & Bounds);
+
+    /* Slab test, InverseDirection is 1 / Direction per component. Outputs the entry distance, which is zero if the origin is inside */
+    extern bool const IntersectRayAABB(Vector3 const & Origin, Vector3 const & InverseDirection, float const MaximumDistance, AABB const & Bounds, float & OutputDistance);
+}
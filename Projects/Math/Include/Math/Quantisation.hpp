@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Vector.hpp"
+#include "Affine.hpp"
+
+#include <cstdint>
+
+namespace Math
+{
+    /* A single extent is used for all axes so that dequantising is a uniform scale, this keeps normals valid under the same transform */
+    struct QuantisationBounds
+    {
+        Vector3 Minimum;
+        float Extent;
+    };
+
+    extern QuantisationBounds const ComputeQuantisationBounds(std::uint32_t const PositionCount, Vector3 const * const Positions);
+
+    /* Maps quantised [0, 1] UNORM positions back into the original space */
+    constexpr Affine3x4 const DequantisationTransform(QuantisationBounds const & Bounds)
+    {
+        return Affine3x4::TranslationScale(Bounds.Minimum, Bounds.Extent);
+    }
+
+    /* Positions are quantised to 4 x 16-bit UNORM, the fourth component is padding so vertices stay 4 byte aligned */
+    extern void QuantisePositions(QuantisationBounds const & Bounds, std::uint32_t const PositionCount, Vector3 const * const Positions, std::uint16_t * const OutputPositions);
+
+    extern Vector3 const DequantisePosition(QuantisationBounds const & Bounds, std::uint16_t const * const QuantisedPosition);
+
+    /* Octahedral encoding, 2 x 16-bit SNORM */
+    extern std::uint32_t const EncodeOctahedralNormal(Vector3 const & Normal);
+
+    extern Vector3 const DecodeOctahedralNormal(std::uint32_t const EncodedNormal);
+
+    /* Octahedral encoding, X is 16-bit SNORM, Y is 15-bit SNORM with the bitangent sign (W) stored in the lowest bit */
+    extern std::uint32_t const EncodeOctahedralTangent(Vector4 const & Tangent);
+
+    extern Vector4 const DecodeOctahedralTangent(std::uint32_t const EncodedTangent);
+
+    extern std::uint16_t const FloatToHalf(float const Value);
+
+    extern float const HalfToFloat(std::uint16_t const Value);
+
+    /* Batch encoders for import time */
+    extern void EncodeOctahedralNormals(std::uint32_t const NormalCount, Vector3 const * const Normals, std::uint32_t * const OutputNormals);
+
+    extern void EncodeOctahedralTangents(std::uint32_t const TangentCount, Vector4 const * const Tangents, std::uint32_t * const OutputTangents);
+
+    /* Only the first two components of each UV are kept */
+    extern void EncodeHalfUVs(std::uint32_t const UVCount, Vector3 const * const UVs, std::uint32_t * const OutputUVs);
+}
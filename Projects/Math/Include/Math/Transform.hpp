@@ -24,7 +24,7 @@ namespace Math
         Matrix [Matrix4x4::Index { 0u, 0u }] = 1.0f; // +X
         Matrix [Matrix4x4::Index { 2u, 1u }] = 1.0f; // +Z
         Matrix [Matrix4x4::Index { 1u, 2u }] = -1.0f; // -Y
-        Matrix [Matrix4x4::Index { 4u, 4u }] = 1.0f;
+        Matrix [Matrix4x4::Index { 3u, 3u }] = 1.0f;
 
         return Matrix;
     }
@@ -0,0 +1,204 @@
+#include "Math/Affine.hpp"
+
+#include <cmath>
+
+#if USE_SSE2
+#include <xmmintrin.h>
+#endif
+
+Math::Affine3x4 const Math::operator * (Affine3x4 const & Left, Affine3x4 const & Right)
+{
+#if USE_SSE2
+    Affine3x4 Result = {};
+
+    __m128 const RightRow0 = _mm_load_ps(&Right.Data [0u << 2u]);
+    __m128 const RightRow1 = _mm_load_ps(&Right.Data [1u << 2u]);
+    __m128 const RightRow2 = _mm_load_ps(&Right.Data [2u << 2u]);
+
+    for (std::uint8_t CurrentRowIndex = { 0u }; CurrentRowIndex < 3u; CurrentRowIndex++)
+    {
+        /* The implicit fourth row of the right transform only contributes the left translation */
+        __m128 CurrentOutputRow = _mm_set_ps(Left [Affine3x4::Index { CurrentRowIndex, 3u }], 0.0f, 0.0f, 0.0f);
+
+        __m128 Scalar0 = _mm_set1_ps(Left [Affine3x4::Index { CurrentRowIndex, 0u }]);
+        CurrentOutputRow = _mm_add_ps(CurrentOutputRow, _mm_mul_ps(RightRow0, Scalar0));
+
+        __m128 Scalar1 = _mm_set1_ps(Left [Affine3x4::Index { CurrentRowIndex, 1u }]);
+        CurrentOutputRow = _mm_add_ps(CurrentOutputRow, _mm_mul_ps(RightRow1, Scalar1));
+
+        __m128 Scalar2 = _mm_set1_ps(Left [Affine3x4::Index { CurrentRowIndex, 2u }]);
+        CurrentOutputRow = _mm_add_ps(CurrentOutputRow, _mm_mul_ps(RightRow2, Scalar2));
+
+        _mm_store_ps(&Result.Data [CurrentRowIndex << 2u], CurrentOutputRow);
+    }
+
+    return Result;
+#else
+    Affine3x4 Result = {};
+
+    for (std::uint8_t CurrentRowIndex = { 0u }; CurrentRowIndex < 3u; CurrentRowIndex++)
+    {
+        for (std::uint8_t CurrentColumnIndex = { 0u }; CurrentColumnIndex < 4u; CurrentColumnIndex++)
+        {
+            Result [Affine3x4::Index { CurrentRowIndex, CurrentColumnIndex }] =
+                Left [Affine3x4::Index { CurrentRowIndex, 0u }] * Right [Affine3x4::Index { 0u, CurrentColumnIndex }] +
+                Left [Affine3x4::Index { CurrentRowIndex, 1u }] * Right [Affine3x4::Index { 1u, CurrentColumnIndex }] +
+                Left [Affine3x4::Index { CurrentRowIndex, 2u }] * Right [Affine3x4::Index { 2u, CurrentColumnIndex }];
+        }
+
+        Result [Affine3x4::Index { CurrentRowIndex, 3u }] += Left [Affine3x4::Index { CurrentRowIndex, 3u }];
+    }
+
+    return Result;
+#endif
+}
+
+Math::Vector3 const Math::TransformPoint(Affine3x4 const & Affine, Vector3 const & Point)
+{
+    return Vector3
+    {
+        Affine.Data [0u] * Point.X + Affine.Data [1u] * Point.Y + Affine.Data [2u] * Point.Z + Affine.Data [3u],
+        Affine.Data [4u] * Point.X + Affine.Data [5u] * Point.Y + Affine.Data [6u] * Point.Z + Affine.Data [7u],
+        Affine.Data [8u] * Point.X + Affine.Data [9u] * Point.Y + Affine.Data [10u] * Point.Z + Affine.Data [11u],
+    };
+}
+
+Math::Vector3 const Math::TransformVector(Affine3x4 const & Affine, Vector3 const & Vector)
+{
+    return Vector3
+    {
+        Affine.Data [0u] * Vector.X + Affine.Data [1u] * Vector.Y + Affine.Data [2u] * Vector.Z,
+        Affine.Data [4u] * Vector.X + Affine.Data [5u] * Vector.Y + Affine.Data [6u] * Vector.Z,
+        Affine.Data [8u] * Vector.X + Affine.Data [9u] * Vector.Y + Affine.Data [10u] * Vector.Z,
+    };
+}
+
+void Math::TransformPoints(Affine3x4 const & Affine, std::uint32_t const PointCount, Vector3 const * const Points, Vector3 * const OutputPoints)
+{
+    std::uint32_t CurrentPointIndex = { 0u };
+
+#if USE_SSE2
+    /* Work on 4 points at a time, splatting each affine element keeps the points in SoA form */
+    std::array<__m128, 12u> AffineElements = {};
+    for (std::uint8_t CurrentElementIndex = { 0u }; CurrentElementIndex < 12u; CurrentElementIndex++)
+    {
+        AffineElements [CurrentElementIndex] = _mm_set1_ps(Affine.Data [CurrentElementIndex]);
+    }
+
+    for (; CurrentPointIndex + 4u <= PointCount; CurrentPointIndex += 4u)
+    {
+        Vector3 const * const kPoints = Points + CurrentPointIndex;
+
+        __m128 const kX = _mm_set_ps(kPoints [3u].X, kPoints [2u].X, kPoints [1u].X, kPoints [0u].X);
+        __m128 const kY = _mm_set_ps(kPoints [3u].Y, kPoints [2u].Y, kPoints [1u].Y, kPoints [0u].Y);
+        __m128 const kZ = _mm_set_ps(kPoints [3u].Z, kPoints [2u].Z, kPoints [1u].Z, kPoints [0u].Z);
+
+        std::array<__m128, 3u> OutputComponents = {};
+        for (std::uint8_t CurrentRowIndex = { 0u }; CurrentRowIndex < 3u; CurrentRowIndex++)
+        {
+            std::uint8_t const kRowOffset = CurrentRowIndex << 2u;
+
+            __m128 Component = _mm_add_ps(_mm_mul_ps(AffineElements [kRowOffset + 0u], kX), AffineElements [kRowOffset + 3u]);
+            Component = _mm_add_ps(Component, _mm_mul_ps(AffineElements [kRowOffset + 1u], kY));
+            Component = _mm_add_ps(Component, _mm_mul_ps(AffineElements [kRowOffset + 2u], kZ));
+
+            OutputComponents [CurrentRowIndex] = Component;
+        }
+
+        alignas(16u) std::array<float, 12u> OutputData = {};
+        _mm_store_ps(&OutputData [0u], OutputComponents [0u]);
+        _mm_store_ps(&OutputData [4u], OutputComponents [1u]);
+        _mm_store_ps(&OutputData [8u], OutputComponents [2u]);
+
+        for (std::uint8_t CurrentOutputIndex = { 0u }; CurrentOutputIndex < 4u; CurrentOutputIndex++)
+        {
+            OutputPoints [CurrentPointIndex + CurrentOutputIndex] = Vector3 { OutputData [CurrentOutputIndex], OutputData [4u + CurrentOutputIndex], OutputData [8u + CurrentOutputIndex] };
+        }
+    }
+#endif
+
+    for (; CurrentPointIndex < PointCount; CurrentPointIndex++)
+    {
+        OutputPoints [CurrentPointIndex] = TransformPoint(Affine, Points [CurrentPointIndex]);
+    }
+}
+
+/* Eric Lengyel, FGED Vol 1 */
+bool const Math::Affine3x4::Inverse(Affine3x4 const & Affine, Affine3x4 & OutputAffine)
+{
+    /* Since the fourth row is (0, 0, 0, 1) only the 3x3 part needs inverting, the rows of its inverse are the cross products of the columns */
+
+    std::array<Math::Vector3, 4u> const kColumns =
+    {
+        Vector3 { Affine.Data [0u], Affine.Data [4u], Affine.Data [8u] },
+        Vector3 { Affine.Data [1u], Affine.Data [5u], Affine.Data [9u] },
+        Vector3 { Affine.Data [2u], Affine.Data [6u], Affine.Data [10u] },
+        Vector3 { Affine.Data [3u], Affine.Data [7u], Affine.Data [11u] },
+    };
+
+    Math::Vector3 Row0 = kColumns [1u] ^ kColumns [2u];
+    Math::Vector3 Row1 = kColumns [2u] ^ kColumns [0u];
+    Math::Vector3 Row2 = kColumns [0u] ^ kColumns [1u];
+
+    float const kDeterminant = Row2 * kColumns [2u];
+    float const kInverseDeterminant = 1.0f / kDeterminant;
+
+    /* Also catches a zero determinant, which divides to infinity */
+    if (!std::isfinite(kInverseDeterminant))
+    {
+        return false;
+    }
+
+    Row0 = Row0 * kInverseDeterminant;
+    Row1 = Row1 * kInverseDeterminant;
+    Row2 = Row2 * kInverseDeterminant;
+
+    OutputAffine = Math::Affine3x4
+    {
+        Row0.X, Row0.Y, Row0.Z, -(Row0 * kColumns [3u]),
+        Row1.X, Row1.Y, Row1.Z, -(Row1 * kColumns [3u]),
+        Row2.X, Row2.Y, Row2.Z, -(Row2 * kColumns [3u]),
+    };
+
+    return true;
+}
+
+Math::Affine3x4 const Math::Affine3x4::InverseRigid(Affine3x4 const & Affine)
+{
+    /* The inverse of an orthonormal basis is its transpose */
+
+    Math::Vector3 const kTranslation = Vector3 { Affine.Data [3u], Affine.Data [7u], Affine.Data [11u] };
+
+    Math::Vector3 const kRow0 = Vector3 { Affine.Data [0u], Affine.Data [4u], Affine.Data [8u] };
+    Math::Vector3 const kRow1 = Vector3 { Affine.Data [1u], Affine.Data [5u], Affine.Data [9u] };
+    Math::Vector3 const kRow2 = Vector3 { Affine.Data [2u], Affine.Data [6u], Affine.Data [10u] };
+
+    return Math::Affine3x4
+    {
+        kRow0.X, kRow0.Y, kRow0.Z, -(kRow0 * kTranslation),
+        kRow1.X, kRow1.Y, kRow1.Z, -(kRow1 * kTranslation),
+        kRow2.X, kRow2.Y, kRow2.Z, -(kRow2 * kTranslation),
+    };
+}
+
+Math::Affine3x4 const Math::Affine3x4::FromMatrix4x4(Matrix4x4 const & Matrix)
+{
+    return Math::Affine3x4
+    {
+        Matrix [Matrix4x4::Index { 0u, 0u }], Matrix [Matrix4x4::Index { 0u, 1u }], Matrix [Matrix4x4::Index { 0u, 2u }], Matrix [Matrix4x4::Index { 0u, 3u }],
+        Matrix [Matrix4x4::Index { 1u, 0u }], Matrix [Matrix4x4::Index { 1u, 1u }], Matrix [Matrix4x4::Index { 1u, 2u }], Matrix [Matrix4x4::Index { 1u, 3u }],
+        Matrix [Matrix4x4::Index { 2u, 0u }], Matrix [Matrix4x4::Index { 2u, 1u }], Matrix [Matrix4x4::Index { 2u, 2u }], Matrix [Matrix4x4::Index { 2u, 3u }],
+    };
+}
+
+Math::Matrix4x4 const Math::Affine3x4::ToMatrix4x4(Affine3x4 const & Affine)
+{
+    /* Matrix4x4 is column major */
+    return Math::Matrix4x4
+    {
+        Affine.Data [0u], Affine.Data [4u], Affine.Data [8u], 0.0f,
+        Affine.Data [1u], Affine.Data [5u], Affine.Data [9u], 0.0f,
+        Affine.Data [2u], Affine.Data [6u], Affine.Data [10u], 0.0f,
+        Affine.Data [3u], Affine.Data [7u], Affine.Data [11u], 1.0f,
+    };
+}
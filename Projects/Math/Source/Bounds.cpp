@@ -0,0 +1,129 @@
+#include "Math/Bounds.hpp"
+
+#include <cmath>
+
+static Math::Vector4 const AddScaledRow(Math::Vector4 const & Left, Math::Vector4 const & Right, float const Scale)
+{
+    return Math::Vector4 { Left.X + Right.X * Scale, Left.Y + Right.Y * Scale, Left.Z + Right.Z * Scale, Left.W + Right.W * Scale };
+}
+
+void Math::ExtractFrustumPlanes(Matrix4x4 const & WorldToClipMatrix, FrustumPlanes & OutputPlanes)
+{
+    std::array<Vector4, 4u> Rows = {};
+
+    for (std::uint8_t CurrentRowIndex = { 0u }; CurrentRowIndex < 4u; CurrentRowIndex++)
+    {
+        Rows [CurrentRowIndex] = Vector4
+        {
+            WorldToClipMatrix [Matrix4x4::Index { CurrentRowIndex, 0u }],
+            WorldToClipMatrix [Matrix4x4::Index { CurrentRowIndex, 1u }],
+            WorldToClipMatrix [Matrix4x4::Index { CurrentRowIndex, 2u }],
+            WorldToClipMatrix [Matrix4x4::Index { CurrentRowIndex, 3u }],
+        };
+    }
+
+    /* Each clip space inequality gives one plane */
+    FrustumPlanes const Planes =
+    {
+        ::AddScaledRow(Rows [3u], Rows [0u], 1.0f),
+        ::AddScaledRow(Rows [3u], Rows [0u], -1.0f),
+        ::AddScaledRow(Rows [3u], Rows [1u], 1.0f),
+        ::AddScaledRow(Rows [3u], Rows [1u], -1.0f),
+        Rows [2u],
+        ::AddScaledRow(Rows [3u], Rows [2u], -1.0f),
+    };
+
+    for (std::uint8_t CurrentPlaneIndex = { 0u }; CurrentPlaneIndex < Planes.size(); CurrentPlaneIndex++)
+    {
+        Vector4 const & Plane = Planes [CurrentPlaneIndex];
+
+        float const InverseLength = 1.0f / std::sqrt(Plane.X * Plane.X + Plane.Y * Plane.Y + Plane.Z * Plane.Z);
+
+        OutputPlanes [CurrentPlaneIndex] = Vector4 { Plane.X * InverseLength, Plane.Y * InverseLength, Plane.Z * InverseLength, Plane.W * InverseLength };
+    }
+}
+
+Math::FrustumTestResults const Math::TestFrustumAABB(FrustumPlanes const & Planes, AABB const & Bounds)
+{
+    FrustumTestResults Result = FrustumTestResults::Inside;
+
+    for (Vector4 const & Plane : Planes)
+    {
+        /* The corner furthest along the plane normal, and the one furthest against it */
+        Vector3 const PositiveCorner =
+        {
+            Plane.X >= 0.0f ? Bounds.Maximum.X : Bounds.Minimum.X,
+            Plane.Y >= 0.0f ? Bounds.Maximum.Y : Bounds.Minimum.Y,
+            Plane.Z >= 0.0f ? Bounds.Maximum.Z : Bounds.Minimum.Z,
+        };
+
+        if (Plane.X * PositiveCorner.X + Plane.Y * PositiveCorner.Y + Plane.Z * PositiveCorner.Z + Plane.W < 0.0f)
+        {
+            return FrustumTestResults::Outside;
+        }
+
+        Vector3 const NegativeCorner =
+        {
+            Plane.X >= 0.0f ? Bounds.Minimum.X : Bounds.Maximum.X,
+            Plane.Y >= 0.0f ? Bounds.Minimum.Y : Bounds.Maximum.Y,
+            Plane.Z >= 0.0f ? Bounds.Minimum.Z : Bounds.Maximum.Z,
+        };
+
+        if (Plane.X * NegativeCorner.X + Plane.Y * NegativeCorner.Y + Plane.Z * NegativeCorner.Z + Plane.W < 0.0f)
+        {
+            Result = FrustumTestResults::Intersecting;
+        }
+    }
+
+    return Result;
+}
+
+Math::AABB const Math::TransformAABB(Affine3x4 const & Affine, AABB const & Bounds)
+{
+    /* Arvo's method, each matrix element scales either the minimum or the maximum depending on its sign */
+    std::array<float, 3u> const Minimum = { Bounds.Minimum.X, Bounds.Minimum.Y, Bounds.Minimum.Z };
+    std::array<float, 3u> const Maximum = { Bounds.Maximum.X, Bounds.Maximum.Y, Bounds.Maximum.Z };
+
+    std::array<float, 3u> OutputMinimum = {};
+    std::array<float, 3u> OutputMaximum = {};
+
+    for (std::uint8_t CurrentRowIndex = { 0u }; CurrentRowIndex < 3u; CurrentRowIndex++)
+    {
+        OutputMinimum [CurrentRowIndex] = Affine [Affine3x4::Index { CurrentRowIndex, 3u }];
+        OutputMaximum [CurrentRowIndex] = Affine [Affine3x4::Index { CurrentRowIndex, 3u }];
+
+        for (std::uint8_t CurrentColumnIndex = { 0u }; CurrentColumnIndex < 3u; CurrentColumnIndex++)
+        {
+            float const Element = Affine [Affine3x4::Index { CurrentRowIndex, CurrentColumnIndex }];
+
+            float const ScaledMinimum = Element * Minimum [CurrentColumnIndex];
+            float const ScaledMaximum = Element * Maximum [CurrentColumnIndex];
+
+            OutputMinimum [CurrentRowIndex] += std::min(ScaledMinimum, ScaledMaximum);
+            OutputMaximum [CurrentRowIndex] += std::max(ScaledMinimum, ScaledMaximum);
+        }
+    }
+
+    return AABB
+    {
+        Vector3 { OutputMinimum [0u], OutputMinimum [1u], OutputMinimum [2u] },
+        Vector3 { OutputMaximum [0u], OutputMaximum [1u], OutputMaximum [2u] },
+    };
+}
+
+bool const Math::IntersectRayAABB(Vector3 const & Origin, Vector3 const & InverseDirection, float const MaximumDistance, AABB const & Bounds, float & OutputDistance)
+{
+    float const NearX = (Bounds.Minimum.X - Origin.X) * InverseDirection.X;
+    float const FarX = (Bounds.Maximum.X - Origin.X) * InverseDirection.X;
+    float const NearY = (Bounds.Minimum.Y - Origin.Y) * InverseDirection.Y;
+    float const FarY = (Bounds.Maximum.Y - Origin.Y) * InverseDirection.Y;
+    float const NearZ = (Bounds.Minimum.Z - Origin.Z) * InverseDirection.Z;
+    float const FarZ = (Bounds.Maximum.Z - Origin.Z) * InverseDirection.Z;
+
+    float const EntryDistance = std::max({ std::min(NearX, FarX), std::min(NearY, FarY), std::min(NearZ, FarZ), 0.0f });
+    float const ExitDistance = std::min({ std::max(NearX, FarX), std::max(NearY, FarY), std::max(NearZ, FarZ), MaximumDistance });
+
+    OutputDistance = EntryDistance;
+
+    return EntryDistance <= ExitDistance;
+}
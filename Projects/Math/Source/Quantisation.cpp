@@ -0,0 +1,399 @@
+#include "Math/Quantisation.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if USE_SSE2
+#include <emmintrin.h>
+#endif
+
+static constexpr float kSNORM16Scale = 32767.0f;
+static constexpr float kSNORM15Scale = 16383.0f;
+static constexpr float kUNORM16Scale = 65535.0f;
+
+static float const SignNotZero(float const Value)
+{
+    return Value >= 0.0f ? 1.0f : -1.0f;
+}
+
+/* Rounds half to even like _mm_cvtps_epi32 does in the default rounding mode, so the scalar and SSE2 paths give the same results */
+static std::int32_t const RoundToInteger(float const Value)
+{
+    return static_cast<std::int32_t>(std::nearbyint(Value));
+}
+
+static void QuantisePosition(Math::QuantisationBounds const & Bounds, float const Scale, Math::Vector3 const & Position, std::uint16_t * const OutputPosition)
+{
+    Math::Vector3 const kOffset = (Position - Bounds.Minimum) * Scale;
+
+    OutputPosition [0u] = static_cast<std::uint16_t>(::RoundToInteger(std::clamp(kOffset.X, 0.0f, kUNORM16Scale)));
+    OutputPosition [1u] = static_cast<std::uint16_t>(::RoundToInteger(std::clamp(kOffset.Y, 0.0f, kUNORM16Scale)));
+    OutputPosition [2u] = static_cast<std::uint16_t>(::RoundToInteger(std::clamp(kOffset.Z, 0.0f, kUNORM16Scale)));
+    OutputPosition [3u] = 0u;
+}
+
+/* Projects onto the octahedron then folds the lower hemisphere over the diagonals */
+static void ProjectOctahedral(Math::Vector3 const & Vector, float & OutputX, float & OutputY)
+{
+    float const kInverseL1Norm = 1.0f / (std::abs(Vector.X) + std::abs(Vector.Y) + std::abs(Vector.Z));
+
+    float const kX = Vector.X * kInverseL1Norm;
+    float const kY = Vector.Y * kInverseL1Norm;
+
+    if (Vector.Z < 0.0f)
+    {
+        OutputX = (1.0f - std::abs(kY)) * SignNotZero(kX);
+        OutputY = (1.0f - std::abs(kX)) * SignNotZero(kY);
+    }
+    else
+    {
+        OutputX = kX;
+        OutputY = kY;
+    }
+}
+
+static Math::Vector3 const UnprojectOctahedral(float const X, float const Y)
+{
+    Math::Vector3 Vector = Math::Vector3 { X, Y, 1.0f - std::abs(X) - std::abs(Y) };
+
+    if (Vector.Z < 0.0f)
+    {
+        Vector.X = (1.0f - std::abs(Y)) * SignNotZero(X);
+        Vector.Y = (1.0f - std::abs(X)) * SignNotZero(Y);
+    }
+
+    return Math::Vector3::Normalize(Vector);
+}
+
+static std::uint32_t const PackTangent(std::int32_t const QuantisedX, std::int32_t const QuantisedY, float const BitangentSign)
+{
+    /* Multiply rather than shift so negative values are well defined */
+    std::int32_t const kFoldedY = QuantisedY * 2 + (BitangentSign < 0.0f ? 1 : 0);
+
+    return (static_cast<std::uint32_t>(kFoldedY) << 16u) | (static_cast<std::uint32_t>(QuantisedX) & 0xFFFFu);
+}
+
+#if USE_SSE2
+/* Projects 4 vectors at a time, the vectors are in SoA form */
+static void ProjectOctahedral(__m128 const X, __m128 const Y, __m128 const Z, __m128 & OutputX, __m128 & OutputY)
+{
+    __m128 const kSignMask = _mm_set1_ps(-0.0f);
+    __m128 const kOne = _mm_set1_ps(1.0f);
+
+    __m128 const kAbsoluteX = _mm_andnot_ps(kSignMask, X);
+    __m128 const kAbsoluteY = _mm_andnot_ps(kSignMask, Y);
+    __m128 const kAbsoluteZ = _mm_andnot_ps(kSignMask, Z);
+
+    __m128 const kInverseL1Norm = _mm_div_ps(kOne, _mm_add_ps(_mm_add_ps(kAbsoluteX, kAbsoluteY), kAbsoluteZ));
+
+    __m128 const kProjectedX = _mm_mul_ps(X, kInverseL1Norm);
+    __m128 const kProjectedY = _mm_mul_ps(Y, kInverseL1Norm);
+
+    __m128 const kSignX = _mm_or_ps(_mm_and_ps(kProjectedX, kSignMask), kOne);
+    __m128 const kSignY = _mm_or_ps(_mm_and_ps(kProjectedY, kSignMask), kOne);
+
+    __m128 const kFoldedX = _mm_mul_ps(_mm_sub_ps(kOne, _mm_andnot_ps(kSignMask, kProjectedY)), kSignX);
+    __m128 const kFoldedY = _mm_mul_ps(_mm_sub_ps(kOne, _mm_andnot_ps(kSignMask, kProjectedX)), kSignY);
+
+    __m128 const kLowerHemisphereMask = _mm_cmplt_ps(Z, _mm_setzero_ps());
+
+    OutputX = _mm_or_ps(_mm_and_ps(kLowerHemisphereMask, kFoldedX), _mm_andnot_ps(kLowerHemisphereMask, kProjectedX));
+    OutputY = _mm_or_ps(_mm_and_ps(kLowerHemisphereMask, kFoldedY), _mm_andnot_ps(kLowerHemisphereMask, kProjectedY));
+}
+#endif
+
+Math::QuantisationBounds const Math::ComputeQuantisationBounds(std::uint32_t const PositionCount, Vector3 const * const Positions)
+{
+    if (PositionCount == 0u)
+    {
+        return QuantisationBounds { Vector3::Zero(), 1.0f };
+    }
+
+    Vector3 Minimum = Positions [0u];
+    Vector3 Maximum = Positions [0u];
+
+    for (std::uint32_t CurrentPositionIndex = { 1u }; CurrentPositionIndex < PositionCount; CurrentPositionIndex++)
+    {
+        Vector3 const & kPosition = Positions [CurrentPositionIndex];
+
+        Minimum = Vector3 { std::min(Minimum.X, kPosition.X), std::min(Minimum.Y, kPosition.Y), std::min(Minimum.Z, kPosition.Z) };
+        Maximum = Vector3 { std::max(Maximum.X, kPosition.X), std::max(Maximum.Y, kPosition.Y), std::max(Maximum.Z, kPosition.Z) };
+    }
+
+    Vector3 const kExtents = Maximum - Minimum;
+    float const kExtent = std::max(std::max(kExtents.X, kExtents.Y), kExtents.Z);
+
+    /* Avoid dividing by zero for a single point or degenerate mesh */
+    return QuantisationBounds { Minimum, kExtent > 0.0f ? kExtent : 1.0f };
+}
+
+void Math::QuantisePositions(QuantisationBounds const & Bounds, std::uint32_t const PositionCount, Vector3 const * const Positions, std::uint16_t * const OutputPositions)
+{
+    float const kScale = kUNORM16Scale / Bounds.Extent;
+
+    std::uint32_t CurrentPositionIndex = { 0u };
+
+#if USE_SSE2
+    __m128 const kMinimum = _mm_set_ps(0.0f, Bounds.Minimum.Z, Bounds.Minimum.Y, Bounds.Minimum.X);
+    __m128 const kScales = _mm_set1_ps(kScale);
+    __m128 const kUpperLimit = _mm_set1_ps(kUNORM16Scale);
+    __m128 const kXYZMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+
+    /* packs_epi32 saturates to signed 16-bit, so values are biased into that range and the bias is flipped back afterwards */
+    __m128i const kBias = _mm_set1_epi32(32768);
+    __m128i const kSignBit = _mm_set1_epi16(-32768);
+
+    for (; CurrentPositionIndex + 4u <= PositionCount; CurrentPositionIndex += 4u)
+    {
+        /* 4 positions are 12 floats, so 3 loads cover them and shuffles split them back into one position per register */
+        float const * const kFloats = &Positions [CurrentPositionIndex].X;
+
+        __m128 const kFirst = _mm_loadu_ps(kFloats + 0u);
+        __m128 const kSecond = _mm_loadu_ps(kFloats + 4u);
+        __m128 const kThird = _mm_loadu_ps(kFloats + 8u);
+
+        __m128 const kSecondPositionUnordered = _mm_shuffle_ps(kFirst, kSecond, _MM_SHUFFLE(1, 0, 3, 3));
+
+        std::array<__m128, 4u> const kSplitPositions =
+        {
+            kFirst,
+            _mm_shuffle_ps(kSecondPositionUnordered, kSecondPositionUnordered, _MM_SHUFFLE(3, 3, 2, 0)),
+            _mm_shuffle_ps(kSecond, kThird, _MM_SHUFFLE(0, 0, 3, 2)),
+            _mm_shuffle_ps(kThird, kThird, _MM_SHUFFLE(3, 3, 2, 1)),
+        };
+
+        std::array<__m128i, 4u> Quantised = {};
+
+        for (std::uint32_t CurrentSplitIndex = { 0u }; CurrentSplitIndex < 4u; CurrentSplitIndex++)
+        {
+            __m128 Position = _mm_mul_ps(_mm_sub_ps(kSplitPositions [CurrentSplitIndex], kMinimum), kScales);
+            Position = _mm_and_ps(_mm_min_ps(_mm_max_ps(Position, _mm_setzero_ps()), kUpperLimit), kXYZMask);
+
+            Quantised [CurrentSplitIndex] = _mm_sub_epi32(_mm_cvtps_epi32(Position), kBias);
+        }
+
+        __m128i const kFirstPair = _mm_xor_si128(_mm_packs_epi32(Quantised [0u], Quantised [1u]), kSignBit);
+        __m128i const kSecondPair = _mm_xor_si128(_mm_packs_epi32(Quantised [2u], Quantised [3u]), kSignBit);
+
+        std::uint16_t * const kOutputPositions = OutputPositions + (CurrentPositionIndex << 2u);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(kOutputPositions + 0u), kFirstPair);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(kOutputPositions + 8u), kSecondPair);
+    }
+#endif
+
+    for (; CurrentPositionIndex < PositionCount; CurrentPositionIndex++)
+    {
+        ::QuantisePosition(Bounds, kScale, Positions [CurrentPositionIndex], OutputPositions + (CurrentPositionIndex << 2u));
+    }
+}
+
+Math::Vector3 const Math::DequantisePosition(QuantisationBounds const & Bounds, std::uint16_t const * const QuantisedPosition)
+{
+    float const kScale = Bounds.Extent / kUNORM16Scale;
+
+    return Bounds.Minimum + Vector3 { QuantisedPosition [0u] * kScale, QuantisedPosition [1u] * kScale, QuantisedPosition [2u] * kScale };
+}
+
+std::uint32_t const Math::EncodeOctahedralNormal(Vector3 const & Normal)
+{
+    float X = {};
+    float Y = {};
+    ::ProjectOctahedral(Normal, X, Y);
+
+    std::int32_t const kQuantisedX = ::RoundToInteger(std::clamp(X, -1.0f, 1.0f) * kSNORM16Scale);
+    std::int32_t const kQuantisedY = ::RoundToInteger(std::clamp(Y, -1.0f, 1.0f) * kSNORM16Scale);
+
+    return (static_cast<std::uint32_t>(kQuantisedY) << 16u) | (static_cast<std::uint32_t>(kQuantisedX) & 0xFFFFu);
+}
+
+Math::Vector3 const Math::DecodeOctahedralNormal(std::uint32_t const EncodedNormal)
+{
+    float const kX = std::max(static_cast<std::int16_t>(EncodedNormal & 0xFFFFu) / kSNORM16Scale, -1.0f);
+    float const kY = std::max(static_cast<std::int16_t>(EncodedNormal >> 16u) / kSNORM16Scale, -1.0f);
+
+    return ::UnprojectOctahedral(kX, kY);
+}
+
+std::uint32_t const Math::EncodeOctahedralTangent(Vector4 const & Tangent)
+{
+    float X = {};
+    float Y = {};
+    ::ProjectOctahedral(Vector3 { Tangent.X, Tangent.Y, Tangent.Z }, X, Y);
+
+    std::int32_t const kQuantisedX = ::RoundToInteger(std::clamp(X, -1.0f, 1.0f) * kSNORM16Scale);
+    std::int32_t const kQuantisedY = ::RoundToInteger(std::clamp(Y, -1.0f, 1.0f) * kSNORM15Scale);
+
+    return ::PackTangent(kQuantisedX, kQuantisedY, Tangent.W);
+}
+
+Math::Vector4 const Math::DecodeOctahedralTangent(std::uint32_t const EncodedTangent)
+{
+    std::int16_t const kFoldedY = static_cast<std::int16_t>(EncodedTangent >> 16u);
+
+    float const kX = std::max(static_cast<std::int16_t>(EncodedTangent & 0xFFFFu) / kSNORM16Scale, -1.0f);
+    float const kY = std::max(((kFoldedY - (kFoldedY & 1)) / 2) / kSNORM15Scale, -1.0f);
+
+    Vector3 const kTangent = ::UnprojectOctahedral(kX, kY);
+
+    return Vector4 { kTangent.X, kTangent.Y, kTangent.Z, (kFoldedY & 1) ? -1.0f : 1.0f };
+}
+
+std::uint16_t const Math::FloatToHalf(float const Value)
+{
+    std::uint32_t Bits = {};
+    std::memcpy(&Bits, &Value, sizeof(Bits));
+
+    std::uint32_t const kSign = (Bits >> 16u) & 0x8000u;
+    std::uint32_t Mantissa = Bits & 0x7FFFFFu;
+    std::int32_t const kExponent = static_cast<std::int32_t>((Bits >> 23u) & 0xFFu) - 127 + 15;
+
+    /* Infinity and NaN */
+    if ((Bits & 0x7FFFFFFFu) >= 0x7F800000u)
+    {
+        return static_cast<std::uint16_t>(kSign | 0x7C00u | (Mantissa ? 0x200u : 0u));
+    }
+
+    /* Too large, clamp to infinity */
+    if (kExponent >= 31)
+    {
+        return static_cast<std::uint16_t>(kSign | 0x7C00u);
+    }
+
+    /* Denormals, or too small and flushed to zero */
+    if (kExponent <= 0)
+    {
+        if (kExponent < -10)
+        {
+            return static_cast<std::uint16_t>(kSign);
+        }
+
+        Mantissa |= 0x800000u;
+
+        std::uint32_t const kShift = static_cast<std::uint32_t>(14 - kExponent);
+        std::uint32_t const kHalfMantissa = (Mantissa >> kShift) + ((Mantissa >> (kShift - 1u)) & 1u);
+
+        return static_cast<std::uint16_t>(kSign | kHalfMantissa);
+    }
+
+    /* Rounding can carry into the exponent, which is still the correct result */
+    std::uint32_t const kHalf = (static_cast<std::uint32_t>(kExponent) << 10u) | (Mantissa >> 13u);
+    return static_cast<std::uint16_t>(kSign | (kHalf + ((Mantissa >> 12u) & 1u)));
+}
+
+float const Math::HalfToFloat(std::uint16_t const Value)
+{
+    std::uint32_t const kSign = static_cast<std::uint32_t>(Value & 0x8000u) << 16u;
+    std::uint32_t const kExponent = (Value >> 10u) & 0x1Fu;
+    std::uint32_t const kMantissa = Value & 0x3FFu;
+
+    if (kExponent == 0u)
+    {
+        /* Zero and denormals, which are all exactly representable as floats */
+        float const kMagnitude = static_cast<float>(kMantissa) * (1.0f / 16777216.0f);
+        return kSign ? -kMagnitude : kMagnitude;
+    }
+
+    std::uint32_t const kBits = kExponent == 0x1Fu
+        ? kSign | 0x7F800000u | (kMantissa << 13u)
+        : kSign | ((kExponent - 15u + 127u) << 23u) | (kMantissa << 13u);
+
+    float Result = {};
+    std::memcpy(&Result, &kBits, sizeof(Result));
+
+    return Result;
+}
+
+void Math::EncodeOctahedralNormals(std::uint32_t const NormalCount, Vector3 const * const Normals, std::uint32_t * const OutputNormals)
+{
+    std::uint32_t CurrentNormalIndex = { 0u };
+
+#if USE_SSE2
+    __m128 const kScale = _mm_set1_ps(kSNORM16Scale);
+    __m128 const kLowerLimit = _mm_set1_ps(-1.0f);
+    __m128 const kUpperLimit = _mm_set1_ps(1.0f);
+
+    for (; CurrentNormalIndex + 4u <= NormalCount; CurrentNormalIndex += 4u)
+    {
+        Vector3 const * const kNormals = Normals + CurrentNormalIndex;
+
+        __m128 const kX = _mm_set_ps(kNormals [3u].X, kNormals [2u].X, kNormals [1u].X, kNormals [0u].X);
+        __m128 const kY = _mm_set_ps(kNormals [3u].Y, kNormals [2u].Y, kNormals [1u].Y, kNormals [0u].Y);
+        __m128 const kZ = _mm_set_ps(kNormals [3u].Z, kNormals [2u].Z, kNormals [1u].Z, kNormals [0u].Z);
+
+        __m128 ProjectedX = {};
+        __m128 ProjectedY = {};
+        ::ProjectOctahedral(kX, kY, kZ, ProjectedX, ProjectedY);
+
+        ProjectedX = _mm_mul_ps(_mm_min_ps(_mm_max_ps(ProjectedX, kLowerLimit), kUpperLimit), kScale);
+        ProjectedY = _mm_mul_ps(_mm_min_ps(_mm_max_ps(ProjectedY, kLowerLimit), kUpperLimit), kScale);
+
+        /* Convert, then interleave X (low) and Y (high) 16-bit halves */
+        __m128i const kQuantised = _mm_packs_epi32(_mm_cvtps_epi32(ProjectedX), _mm_cvtps_epi32(ProjectedY));
+        __m128i const kInterleaved = _mm_unpacklo_epi16(kQuantised, _mm_srli_si128(kQuantised, 8));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(OutputNormals + CurrentNormalIndex), kInterleaved);
+    }
+#endif
+
+    for (; CurrentNormalIndex < NormalCount; CurrentNormalIndex++)
+    {
+        OutputNormals [CurrentNormalIndex] = EncodeOctahedralNormal(Normals [CurrentNormalIndex]);
+    }
+}
+
+void Math::EncodeOctahedralTangents(std::uint32_t const TangentCount, Vector4 const * const Tangents, std::uint32_t * const OutputTangents)
+{
+    std::uint32_t CurrentTangentIndex = { 0u };
+
+#if USE_SSE2
+    __m128 const kLowerLimit = _mm_set1_ps(-1.0f);
+    __m128 const kUpperLimit = _mm_set1_ps(1.0f);
+
+    for (; CurrentTangentIndex + 4u <= TangentCount; CurrentTangentIndex += 4u)
+    {
+        /* Tangents are 16 byte aligned, so transposing gives SoA form */
+        __m128 X = _mm_load_ps(&Tangents [CurrentTangentIndex + 0u].X);
+        __m128 Y = _mm_load_ps(&Tangents [CurrentTangentIndex + 1u].X);
+        __m128 Z = _mm_load_ps(&Tangents [CurrentTangentIndex + 2u].X);
+        __m128 W = _mm_load_ps(&Tangents [CurrentTangentIndex + 3u].X);
+        _MM_TRANSPOSE4_PS(X, Y, Z, W);
+
+        __m128 ProjectedX = {};
+        __m128 ProjectedY = {};
+        ::ProjectOctahedral(X, Y, Z, ProjectedX, ProjectedY);
+
+        ProjectedX = _mm_mul_ps(_mm_min_ps(_mm_max_ps(ProjectedX, kLowerLimit), kUpperLimit), _mm_set1_ps(kSNORM16Scale));
+        ProjectedY = _mm_mul_ps(_mm_min_ps(_mm_max_ps(ProjectedY, kLowerLimit), kUpperLimit), _mm_set1_ps(kSNORM15Scale));
+
+        alignas(16u) std::array<std::int32_t, 4u> QuantisedX = {};
+        alignas(16u) std::array<std::int32_t, 4u> QuantisedY = {};
+        alignas(16u) std::array<float, 4u> Signs = {};
+
+        _mm_store_si128(reinterpret_cast<__m128i *>(QuantisedX.data()), _mm_cvtps_epi32(ProjectedX));
+        _mm_store_si128(reinterpret_cast<__m128i *>(QuantisedY.data()), _mm_cvtps_epi32(ProjectedY));
+        _mm_store_ps(Signs.data(), W);
+
+        for (std::uint8_t CurrentOutputIndex = { 0u }; CurrentOutputIndex < 4u; CurrentOutputIndex++)
+        {
+            OutputTangents [CurrentTangentIndex + CurrentOutputIndex] = ::PackTangent(QuantisedX [CurrentOutputIndex], QuantisedY [CurrentOutputIndex], Signs [CurrentOutputIndex]);
+        }
+    }
+#endif
+
+    for (; CurrentTangentIndex < TangentCount; CurrentTangentIndex++)
+    {
+        OutputTangents [CurrentTangentIndex] = EncodeOctahedralTangent(Tangents [CurrentTangentIndex]);
+    }
+}
+
+void Math::EncodeHalfUVs(std::uint32_t const UVCount, Vector3 const * const UVs, std::uint32_t * const OutputUVs)
+{
+    /* SSE2 has no half conversion instructions (F16C), so this stays scalar */
+    for (std::uint32_t CurrentUVIndex = { 0u }; CurrentUVIndex < UVCount; CurrentUVIndex++)
+    {
+        OutputUVs [CurrentUVIndex] = (static_cast<std::uint32_t>(FloatToHalf(UVs [CurrentUVIndex].Y)) << 16u) | FloatToHalf(UVs [CurrentUVIndex].X);
+    }
+}
@@ -34,8 +34,13 @@ Math::Vector4 const Math::operator * (Math::Matrix4x4 const & Matrix, Math::Vect
 
     return Result;
 #else
-    /* TODO: Implement fallback Matrix-Vector multiply when SSE is not available */
-    return Vector4 {};
+    return Vector4
+    {
+        Matrix [Matrix4x4::Index { 0u, 0u }] * Vector.X + Matrix [Matrix4x4::Index { 0u, 1u }] * Vector.Y + Matrix [Matrix4x4::Index { 0u, 2u }] * Vector.Z + Matrix [Matrix4x4::Index { 0u, 3u }] * Vector.W,
+        Matrix [Matrix4x4::Index { 1u, 0u }] * Vector.X + Matrix [Matrix4x4::Index { 1u, 1u }] * Vector.Y + Matrix [Matrix4x4::Index { 1u, 2u }] * Vector.Z + Matrix [Matrix4x4::Index { 1u, 3u }] * Vector.W,
+        Matrix [Matrix4x4::Index { 2u, 0u }] * Vector.X + Matrix [Matrix4x4::Index { 2u, 1u }] * Vector.Y + Matrix [Matrix4x4::Index { 2u, 2u }] * Vector.Z + Matrix [Matrix4x4::Index { 2u, 3u }] * Vector.W,
+        Matrix [Matrix4x4::Index { 3u, 0u }] * Vector.X + Matrix [Matrix4x4::Index { 3u, 1u }] * Vector.Y + Matrix [Matrix4x4::Index { 3u, 2u }] * Vector.Z + Matrix [Matrix4x4::Index { 3u, 3u }] * Vector.W,
+    };
 #endif
 }
 
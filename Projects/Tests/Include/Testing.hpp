@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+/*
+    Shared by the test and benchmark executables, each one is registered with CTest.
+
+    Checks
+        - A failed check prints the condition and location and the run carries on, so one run reports every failure
+        - Finish returns the exit code, non-zero when any check failed
+
+    Timings
+        - Best of several repeats, so a context switch during one repeat doesn't count
+        - Only checked against a budget in optimised builds, debug builds just print them
+*/
+
+namespace Testing
+{
+    inline std::uint32_t FailureCount = {};
+    inline std::uint32_t CheckCount = {};
+
+    inline void Check(bool const bCondition, char const * const Condition, char const * const File, int const Line)
+    {
+        CheckCount++;
+
+        if (!bCondition)
+        {
+            FailureCount++;
+            std::printf("FAILED: %s (%s:%d)\n", Condition, File, Line);
+        }
+    }
+
+    inline int const Finish(char const * const Name)
+    {
+        std::printf("%s: %u of %u checks passed\n", Name, CheckCount - FailureCount, CheckCount);
+        return FailureCount == 0u ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    /* Stops the compiler from removing work whose result is otherwise unused */
+    template<typename ValueType>
+    inline void DoNotOptimise(ValueType const & Value)
+    {
+        static unsigned char volatile Sink = {};
+
+        unsigned char FirstByte = {};
+        std::memcpy(&FirstByte, &Value, sizeof(FirstByte));
+
+        Sink = FirstByte;
+    }
+
+    /* Best time of RepeatCount runs of Function, in nanoseconds */
+    template<typename FunctionType>
+    inline double const MeasureNanoseconds(std::uint32_t const RepeatCount, FunctionType && Function)
+    {
+        double BestTimeInNanoseconds = std::numeric_limits<double>::max();
+
+        for (std::uint32_t RepeatIndex = {};
+             RepeatIndex < RepeatCount;
+             RepeatIndex++)
+        {
+            std::chrono::steady_clock::time_point const kBeginTime = std::chrono::steady_clock::now();
+
+            Function();
+
+            std::chrono::steady_clock::time_point const kEndTime = std::chrono::steady_clock::now();
+
+            BestTimeInNanoseconds = std::min(BestTimeInNanoseconds, std::chrono::duration<double, std::nano>(kEndTime - kBeginTime).count());
+        }
+
+        return BestTimeInNanoseconds;
+    }
+
+    inline constexpr bool const IsOptimisedBuild()
+    {
+#ifdef NDEBUG
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /* Small and fast, the same seed gives the same sequence on every platform unlike the standard distributions */
+    struct Random
+    {
+        std::uint64_t State = { 0x9E3779B97F4A7C15u };
+
+        inline std::uint64_t const Next()
+        {
+            /* SplitMix64 */
+            State += 0x9E3779B97F4A7C15u;
+
+            std::uint64_t Value = State;
+            Value = (Value ^ (Value >> 30u)) * 0xBF58476D1CE4E5B9u;
+            Value = (Value ^ (Value >> 27u)) * 0x94D049BB133111EBu;
+
+            return Value ^ (Value >> 31u);
+        }
+
+        inline std::uint32_t const NextUint32(std::uint32_t const Count)
+        {
+            return static_cast<std::uint32_t>((Next() >> 32u) * Count >> 32u);
+        }
+
+        /* Uniform in [Minimum, Maximum) */
+        inline float const NextFloat(float const Minimum, float const Maximum)
+        {
+            float const kUnit = static_cast<float>(Next() >> 40u) * (1.0f / 16777216.0f);
+            return Minimum + (Maximum - Minimum) * kUnit;
+        }
+    };
+
+    /* Distance between two floats in units in the last place, the sign is folded so that -0 and +0 are the same value */
+    inline std::uint32_t const ULPDistance(float const Left, float const Right)
+    {
+        auto const ToOrdered = [](float const Value)
+        {
+            std::int32_t Bits = {};
+            std::memcpy(&Bits, &Value, sizeof(Bits));
+
+            return Bits < 0 ? static_cast<std::int64_t>(std::numeric_limits<std::int32_t>::min()) - Bits : static_cast<std::int64_t>(Bits);
+        };
+
+        std::int64_t const kDistance = ToOrdered(Left) - ToOrdered(Right);
+
+        return static_cast<std::uint32_t>(std::min<std::int64_t>(kDistance < 0 ? -kDistance : kDistance, std::numeric_limits<std::uint32_t>::max()));
+    }
+
+    /*
+        Error of Value against a double precision reference, in ULPs of Scale.
+        Scale should be the magnitude of the terms that produced the value, e.g. the sum of |a * b| for a dot product, so cancellation towards zero isn't reported as a huge error.
+    */
+    inline double const ScaledULPError(float const Value, double const Reference, double const Scale)
+    {
+        float const kScale = static_cast<float>(std::max(Scale, static_cast<double>(std::numeric_limits<float>::min())));
+        double const kULP = static_cast<double>(std::nextafter(kScale, std::numeric_limits<float>::max()) - kScale);
+
+        return std::abs(static_cast<double>(Value) - Reference) / kULP;
+    }
+}
+
+#define TEST_CHECK(Condition) Testing::Check((Condition), #Condition, __FILE__, __LINE__)
@@ -0,0 +1,246 @@
+#include "Testing.hpp"
+
+#include "Components/Archetypes.hpp"
+#include "Scene.hpp"
+
+#include <vector>
+
+/*
+    Creates 1M actors with transforms and static meshes, then
+        - Iterates the chunk columns and checks every row against the data it was created with
+        - Moves actors between archetypes, and destroys actors, checking swap and pop keeps the columns dense and every location correct
+*/
+
+using namespace Components;
+
+static uint32 const kActorCount = { 1000000u };
+
+static uint32 const kTransformMask = static_cast<uint32>(Scene::ComponentMasks::Transform);
+static uint32 const kStaticMeshMask = static_cast<uint32>(Scene::ComponentMasks::StaticMesh);
+static uint32 const kRenderableMask = kTransformMask | kStaticMeshMask;
+
+static Testing::Random Random = {};
+
+/* Every column is derived from the actor index, so any row can be checked on its own */
+static Math::Vector3 const PositionOf(uint32 const ActorIndex)
+{
+    return Math::Vector3 { static_cast<float>(ActorIndex), static_cast<float>(ActorIndex & 0xFFu), -1.0f };
+}
+
+static uint32 const MeshHandleOf(uint32 const ActorIndex)
+{
+    return (ActorIndex % 97u) + 1u;
+}
+
+static bool const IsRowValid(Archetypes::Types::ChunkView const & Chunk, uint32 const RowIndex)
+{
+    uint32 const kActorHandle = Chunk.GetColumn<Archetypes::Types::Columns::ActorHandle>() [RowIndex];
+    uint32 const kActorIndex = Scene::GetActorIndex(kActorHandle);
+
+    Math::Vector3 const & kPosition = Chunk.GetColumn<Archetypes::Types::Columns::Position>() [RowIndex];
+    Math::Vector3 const kExpectedPosition = ::PositionOf(kActorIndex);
+
+    bool bValid = kPosition.X == kExpectedPosition.X && kPosition.Y == kExpectedPosition.Y && kPosition.Z == kExpectedPosition.Z;
+
+    if (Chunk.HasColumn(Archetypes::Types::Columns::MeshHandle))
+    {
+        uint32 const kMeshHandle = Chunk.GetColumn<Archetypes::Types::Columns::MeshHandle>() [RowIndex];
+
+        /* Zero when the mesh component was added back after being removed */
+        bValid &= kMeshHandle == ::MeshHandleOf(kActorIndex) || kMeshHandle == 0u;
+    }
+
+    return bValid;
+}
+
+/* Walks every chunk with the components, checks each row and that the actor's location points back at the row */
+static void CheckAllRows(uint32 const ComponentMask, uint32 const ExpectedCount)
+{
+    std::vector<Archetypes::Types::ChunkView> Chunks = {};
+    Archetypes::QueryChunks(ComponentMask, Chunks);
+
+    uint32 RowCount = {};
+    bool bRowsValid = true;
+    bool bLocationsValid = true;
+    bool bColumnsAligned = true;
+
+    for (Archetypes::Types::ChunkView const & kChunk : Chunks)
+    {
+        bColumnsAligned &= (reinterpret_cast<std::uintptr_t>(kChunk.GetColumn<Archetypes::Types::Columns::Position>()) & 15u) == 0u;
+
+        for (uint32 RowIndex = {};
+             RowIndex < kChunk.EntityCount;
+             RowIndex++)
+        {
+            bRowsValid &= ::IsRowValid(kChunk, RowIndex);
+
+            Archetypes::Types::ChunkView FoundChunk = {};
+            uint32 FoundRowIndex = {};
+
+            bLocationsValid &= Archetypes::GetEntity(kChunk.GetColumn<Archetypes::Types::Columns::ActorHandle>() [RowIndex], FoundChunk, FoundRowIndex)
+                               && FoundChunk.Data == kChunk.Data
+                               && FoundRowIndex == RowIndex;
+        }
+
+        RowCount += kChunk.EntityCount;
+    }
+
+    TEST_CHECK(RowCount == ExpectedCount);
+    TEST_CHECK(Archetypes::GetEntityCount(ComponentMask) == ExpectedCount);
+    TEST_CHECK(bRowsValid);
+    TEST_CHECK(bLocationsValid);
+    TEST_CHECK(bColumnsAligned);
+}
+
+int main()
+{
+    std::vector<uint32> ActorHandles = std::vector<uint32>(kActorCount);
+    std::vector<Math::Vector3> Positions = std::vector<Math::Vector3>(kActorCount);
+    std::vector<uint32> MeshHandles = std::vector<uint32>(kActorCount);
+
+    for (uint32 ActorIndex = {};
+         ActorIndex < kActorCount;
+         ActorIndex++)
+    {
+        ActorHandles [ActorIndex] = Scene::MakeActorHandle(ActorIndex, 0u);
+        Positions [ActorIndex] = ::PositionOf(ActorIndex);
+        MeshHandles [ActorIndex] = ::MeshHandleOf(ActorIndex);
+    }
+
+    Archetypes::Types::ColumnData ColumnData = {};
+    ColumnData [static_cast<uint8>(Archetypes::Types::Columns::Position)] = reinterpret_cast<std::byte const *>(Positions.data());
+    ColumnData [static_cast<uint8>(Archetypes::Types::Columns::MeshHandle)] = reinterpret_cast<std::byte const *>(MeshHandles.data());
+
+    double const kCreateInNanoseconds = Testing::MeasureNanoseconds(1u, [&ActorHandles, &ColumnData]()
+                                                                    {
+                                                                        TEST_CHECK(Archetypes::CreateEntities(kRenderableMask, ActorHandles.data(), kActorCount, ColumnData));
+                                                                    });
+
+    ::CheckAllRows(kRenderableMask, kActorCount);
+
+    /* The loop the renderer and the transform update run, one column at a time over every chunk */
+    {
+        std::vector<Archetypes::Types::ChunkView> Chunks = {};
+        Archetypes::QueryChunks(kTransformMask, Chunks);
+
+        double PositionSum = {};
+
+        double const kIterateInNanoseconds = Testing::MeasureNanoseconds(5u, [&Chunks, &PositionSum]()
+                                                                         {
+                                                                             float Sum = {};
+
+                                                                             for (Archetypes::Types::ChunkView const & kChunk : Chunks)
+                                                                             {
+                                                                                 Math::Vector3 const * const kPositions = kChunk.GetColumn<Archetypes::Types::Columns::Position>();
+
+                                                                                 for (uint32 RowIndex = {};
+                                                                                      RowIndex < kChunk.EntityCount;
+                                                                                      RowIndex++)
+                                                                                 {
+                                                                                     Sum += kPositions [RowIndex].Z;
+                                                                                 }
+                                                                             }
+
+                                                                             PositionSum = Sum;
+                                                                             Testing::DoNotOptimise(Sum);
+                                                                         });
+
+        /* Every Z is -1, and the float sum is exact up to 2^24 */
+        TEST_CHECK(PositionSum == -static_cast<double>(kActorCount));
+
+        std::printf("%-40s %12.3f ms\n", "Create 1M actors", kCreateInNanoseconds * 1.0e-6);
+        std::printf("%-40s %12.3f ms (%zu chunks)\n", "Iterate 1M positions", kIterateInNanoseconds * 1.0e-6, Chunks.size());
+    }
+
+    /* Destroying a row moves the last row of the archetype into it */
+    {
+        Archetypes::Types::ChunkView Chunk = {};
+        uint32 RowIndex = {};
+        TEST_CHECK(Archetypes::GetEntity(ActorHandles [1234u], Chunk, RowIndex));
+
+        TEST_CHECK(Archetypes::DestroyEntity(ActorHandles [1234u]));
+
+        Archetypes::Types::ChunkView MovedChunk = {};
+        uint32 MovedRowIndex = {};
+        TEST_CHECK(Archetypes::GetEntity(ActorHandles [kActorCount - 1u], MovedChunk, MovedRowIndex));
+        TEST_CHECK(MovedChunk.Data == Chunk.Data && MovedRowIndex == RowIndex);
+
+        /* The destroyed handle, and a handle to the same index from another generation, are both rejected */
+        TEST_CHECK(!Archetypes::GetEntity(ActorHandles [1234u], Chunk, RowIndex));
+        TEST_CHECK(!Archetypes::DestroyEntity(ActorHandles [1234u]));
+        TEST_CHECK(!Archetypes::GetEntity(Scene::MakeActorHandle(kActorCount - 1u, 1u), Chunk, RowIndex));
+
+        ::CheckAllRows(kRenderableMask, kActorCount - 1u);
+    }
+
+    /* Churn, random actors lose their mesh or are destroyed, then some get the mesh back */
+    {
+        std::vector<uint32> LiveActorIndices = {};
+        LiveActorIndices.reserve(kActorCount);
+
+        for (uint32 ActorIndex = {};
+             ActorIndex < kActorCount;
+             ActorIndex++)
+        {
+            if (ActorIndex != 1234u)
+            {
+                LiveActorIndices.push_back(ActorIndex);
+            }
+        }
+
+        std::vector<uint32> MeshlessActorIndices = {};
+        uint32 DestroyedCount = { 1u };
+
+        double const kChurnInNanoseconds = Testing::MeasureNanoseconds(1u, [&]()
+                                                                       {
+                                                                           for (uint32 OperationIndex = {};
+                                                                                OperationIndex < 100000u;
+                                                                                OperationIndex++)
+                                                                           {
+                                                                               uint32 const kLiveIndex = Random.NextUint32(static_cast<uint32>(LiveActorIndices.size()));
+                                                                               uint32 const kActorIndex = LiveActorIndices [kLiveIndex];
+
+                                                                               LiveActorIndices [kLiveIndex] = LiveActorIndices.back();
+                                                                               LiveActorIndices.pop_back();
+
+                                                                               if (OperationIndex & 1u)
+                                                                               {
+                                                                                   TEST_CHECK(Archetypes::DestroyEntity(ActorHandles [kActorIndex]));
+                                                                                   DestroyedCount++;
+                                                                               }
+                                                                               else
+                                                                               {
+                                                                                   TEST_CHECK(Archetypes::RemoveComponents(ActorHandles [kActorIndex], kStaticMeshMask));
+                                                                                   MeshlessActorIndices.push_back(kActorIndex);
+                                                                               }
+                                                                           }
+                                                                       });
+
+        std::printf("%-40s %12.3f ms\n", "100K removes and destroys", kChurnInNanoseconds * 1.0e-6);
+
+        uint32 const kMeshlessCount = static_cast<uint32>(MeshlessActorIndices.size());
+
+        ::CheckAllRows(kTransformMask, kActorCount - DestroyedCount);
+        ::CheckAllRows(kRenderableMask, kActorCount - DestroyedCount - kMeshlessCount);
+
+        /* Added back, the mesh column starts zeroed and the position comes with the actor */
+        for (uint32 MeshlessIndex = {};
+             MeshlessIndex < kMeshlessCount / 2u;
+             MeshlessIndex++)
+        {
+            TEST_CHECK(Archetypes::AddComponents(ActorHandles [MeshlessActorIndices [MeshlessIndex]], kStaticMeshMask));
+        }
+
+        {
+            Archetypes::Types::ChunkView Chunk = {};
+            uint32 RowIndex = {};
+            TEST_CHECK(Archetypes::GetEntity(ActorHandles [MeshlessActorIndices [0u]], Chunk, RowIndex));
+            TEST_CHECK(Chunk.GetColumn<Archetypes::Types::Columns::MeshHandle>() [RowIndex] == 0u);
+        }
+
+        ::CheckAllRows(kTransformMask, kActorCount - DestroyedCount);
+        ::CheckAllRows(kRenderableMask, kActorCount - DestroyedCount - (kMeshlessCount - kMeshlessCount / 2u));
+    }
+
+    return Testing::Finish("ArchetypeTests");
+}
@@ -0,0 +1,175 @@
+#include "Testing.hpp"
+
+#include "Utilities/Containers.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+/*
+    Churns a SparseVector against an unordered_map holding the same values, then checks
+        - Every live handle finds its value, and dense iteration visits each live value once
+        - Handles from removed values stay rejected, including after a slot has been reused for every generation
+*/
+
+static uint32 const kValueCount = { 1000000u };
+static uint32 const kChurnCount = { 1000000u };
+
+static Testing::Random Random = {};
+
+static void CheckMatchesReference(SparseVector<uint32> const & Values, std::unordered_map<uint32, uint32> const & Reference)
+{
+    TEST_CHECK(Values.Size() == Reference.size());
+
+    bool bLookupsMatch = true;
+
+    for (auto const & [kHandle, kValue] : Reference)
+    {
+        bLookupsMatch &= Values.Contains(kHandle) && Values [kHandle] == kValue;
+    }
+
+    TEST_CHECK(bLookupsMatch);
+
+    /* Dense iteration visits each live value once, next to the handle that finds it */
+    bool bDenseMatches = true;
+
+    for (uint32 DenseIndex = {};
+         DenseIndex < Values.Size();
+         DenseIndex++)
+    {
+        std::unordered_map<uint32, uint32>::const_iterator const kEntry = Reference.find(Values.Handles() [DenseIndex]);
+
+        bDenseMatches &= kEntry != Reference.cend() && kEntry->second == Values.Data() [DenseIndex];
+    }
+
+    TEST_CHECK(bDenseMatches);
+}
+
+int main()
+{
+    SparseVector<uint32> Values = {};
+    std::unordered_map<uint32, uint32> Reference = {};
+
+    std::vector<uint32> LiveHandles = {};
+    std::vector<uint32> RemovedHandles = {};
+
+    double const kAddInNanoseconds = Testing::MeasureNanoseconds(1u, [&]()
+                                                                 {
+                                                                     for (uint32 ValueIndex = {};
+                                                                          ValueIndex < kValueCount;
+                                                                          ValueIndex++)
+                                                                     {
+                                                                         uint32 const kHandle = Values.Add(ValueIndex);
+
+                                                                         LiveHandles.push_back(kHandle);
+                                                                         Reference [kHandle] = ValueIndex;
+                                                                     }
+                                                                 });
+
+    ::CheckMatchesReference(Values, Reference);
+
+    /* Half removes and half adds, so freed slots are reused while other handles to them are still around */
+    double const kChurnInNanoseconds = Testing::MeasureNanoseconds(1u, [&]()
+                                                                   {
+                                                                       for (uint32 ChurnIndex = {};
+                                                                            ChurnIndex < kChurnCount;
+                                                                            ChurnIndex++)
+                                                                       {
+                                                                           if ((Random.Next() & 1u) && LiveHandles.size() > 0u)
+                                                                           {
+                                                                               uint32 const kLiveIndex = Random.NextUint32(static_cast<uint32>(LiveHandles.size()));
+                                                                               uint32 const kHandle = LiveHandles [kLiveIndex];
+
+                                                                               LiveHandles [kLiveIndex] = LiveHandles.back();
+                                                                               LiveHandles.pop_back();
+
+                                                                               TEST_CHECK(Values.Remove(kHandle));
+                                                                               Reference.erase(kHandle);
+                                                                               RemovedHandles.push_back(kHandle);
+                                                                           }
+                                                                           else
+                                                                           {
+                                                                               uint32 const kValue = static_cast<uint32>(Random.Next());
+                                                                               uint32 const kHandle = Values.Add(kValue);
+
+                                                                               LiveHandles.push_back(kHandle);
+                                                                               Reference [kHandle] = kValue;
+                                                                           }
+                                                                       }
+                                                                   });
+
+    ::CheckMatchesReference(Values, Reference);
+
+    {
+        bool bRemovedRejected = true;
+
+        for (uint32 const kHandle : RemovedHandles)
+        {
+            bRemovedRejected &= !Values.Contains(kHandle);
+        }
+
+        TEST_CHECK(bRemovedRejected);
+        TEST_CHECK(!Values.Contains(0u));
+        TEST_CHECK(!Values.Remove(RemovedHandles [0u]));
+    }
+
+    /* The loop the per-frame sweeps run, a linear scan with no holes to skip */
+    {
+        uint64 Sum = {};
+
+        double const kIterateInNanoseconds = Testing::MeasureNanoseconds(5u, [&Values, &Sum]()
+                                                                         {
+                                                                             uint64 LocalSum = {};
+
+                                                                             for (uint32 const kValue : Values)
+                                                                             {
+                                                                                 LocalSum += kValue;
+                                                                             }
+
+                                                                             Sum = LocalSum;
+                                                                             Testing::DoNotOptimise(LocalSum);
+                                                                         });
+
+        uint64 ExpectedSum = {};
+
+        for (auto const & [kHandle, kValue] : Reference)
+        {
+            ExpectedSum += kValue;
+        }
+
+        TEST_CHECK(Sum == ExpectedSum);
+
+        std::printf("%-40s %12.3f ms\n", "Add 1M values", kAddInNanoseconds * 1.0e-6);
+        std::printf("%-40s %12.3f ms\n", "1M random adds and removes", kChurnInNanoseconds * 1.0e-6);
+        std::printf("%-40s %12.3f ms (%u values)\n", "Iterate values", kIterateInNanoseconds * 1.0e-6, Values.Size());
+    }
+
+    /* One value removed and added back more times than there are generations, only the newest handle is valid */
+    {
+        SparseVector<uint32> Reused = {};
+        std::vector<uint32> Handles = { Reused.Add(0u) };
+
+        for (uint32 ReuseIndex = { 1u };
+             ReuseIndex <= SparseVector<uint32>::kGenerationMask * 2u;
+             ReuseIndex++)
+        {
+            TEST_CHECK(Reused.Remove(Handles.back()));
+            Handles.push_back(Reused.Add(ReuseIndex));
+        }
+
+        uint32 AcceptedCount = {};
+
+        for (uint32 const kHandle : Handles)
+        {
+            AcceptedCount += Reused.Contains(kHandle) ? 1u : 0u;
+        }
+
+        TEST_CHECK(AcceptedCount == 1u);
+        TEST_CHECK(Reused.Contains(Handles.back()) && Reused [Handles.back()] == SparseVector<uint32>::kGenerationMask * 2u);
+
+        /* The first slot ran out of generations and was retired, then a second slot took over */
+        TEST_CHECK(Reused.Size() == 1u);
+        TEST_CHECK(Reused.ActualSize() == 2u);
+    }
+
+    return Testing::Finish("ContainerTests");
+}
@@ -0,0 +1,16 @@
+#include "Graphics/ShaderLibrary.hpp"
+
+/*
+    Stands in for Graphics/ShaderLibrary.cpp, which needs glslang and a device.
+    No shader is ever ready, so requested pipelines wait for their shaders and are never compiled.
+*/
+
+bool const ShaderLibrary::IsShaderReady(uint16 const)
+{
+    return false;
+}
+
+bool const ShaderLibrary::CreateShaderModule(Vulkan::Device::DeviceState const &, uint16 const, VkShaderModule &)
+{
+    return false;
+}
@@ -0,0 +1,24 @@
+#include "Assets/StaticMesh.hpp"
+
+/*
+    Stands in for Assets/StaticMesh.cpp, which needs a device and the OBJ loader.
+    Only what the scene and the spatial index read is here, every non-NULL handle is a mesh that fills the unit cube.
+*/
+
+bool const Assets::StaticMesh::GetAssetData(uint32 const kAssetHandle, Assets::StaticMesh::Types::StaticMesh & OutputAssetData)
+{
+    if (kAssetHandle == 0u)
+    {
+        return false;
+    }
+
+    OutputAssetData = Types::StaticMesh {};
+    OutputAssetData.PositionBounds = Math::QuantisationBounds { Math::Vector3::Zero(), 1.0f };
+
+    return true;
+}
+
+Math::Affine3x4 const Assets::StaticMesh::GetMeshToModelTransform(Assets::StaticMesh::Types::StaticMesh const & kStaticMesh)
+{
+    return Math::DequantisationTransform(kStaticMesh.PositionBounds);
+}
@@ -0,0 +1,669 @@
+#include "Testing.hpp"
+
+#include <Math/Affine.hpp>
+#include <Math/Matrix.hpp>
+#include <Math/Transform.hpp>
+#include <Math/Utilities.hpp>
+#include <Math/Vector.hpp>
+
+#include <array>
+#include <vector>
+
+/*
+    Compares MathLib against double precision references and reports the largest error of each operation in ULPs.
+    Built twice, against MathLib and MathLibScalar, so the SSE2 and scalar paths are both measured with the same bounds.
+
+    Errors are in ULPs of the magnitude of the terms that produced each value, see Testing::ScaledULPError.
+*/
+
+#ifdef MATH_SCALAR_BUILD
+static char const * const kBuildName = "MathAccuracy (scalar)";
+#else
+static char const * const kBuildName = "MathAccuracy (SSE2)";
+#endif
+
+static std::uint32_t const kSampleCount = { 100000u };
+
+/* Column major like Math::Matrix4x4 */
+using Matrix4x4d = std::array<double, 16u>;
+
+struct Vector3d
+{
+    double X;
+    double Y;
+    double Z;
+};
+
+static Testing::Random Random = {};
+
+static double const ElementOf(Matrix4x4d const & Matrix, std::uint32_t const RowIndex, std::uint32_t const ColumnIndex)
+{
+    return Matrix [(ColumnIndex << 2u) + RowIndex];
+}
+
+static Matrix4x4d const ToDouble(Math::Matrix4x4 const & Matrix)
+{
+    Matrix4x4d Result = {};
+
+    for (std::uint32_t ElementIndex = {};
+         ElementIndex < 16u;
+         ElementIndex++)
+    {
+        Result [ElementIndex] = static_cast<double>(Matrix.Data [ElementIndex]);
+    }
+
+    return Result;
+}
+
+static Vector3d const ToDouble(Math::Vector3 const & Vector)
+{
+    return Vector3d { Vector.X, Vector.Y, Vector.Z };
+}
+
+/* Gauss-Jordan with partial pivoting */
+static bool const InvertReference(Matrix4x4d const & Matrix, Matrix4x4d & OutputInverse)
+{
+    std::array<std::array<double, 8u>, 4u> Rows = {};
+
+    for (std::uint32_t RowIndex = {};
+         RowIndex < 4u;
+         RowIndex++)
+    {
+        for (std::uint32_t ColumnIndex = {};
+             ColumnIndex < 4u;
+             ColumnIndex++)
+        {
+            Rows [RowIndex] [ColumnIndex] = ElementOf(Matrix, RowIndex, ColumnIndex);
+        }
+
+        Rows [RowIndex] [4u + RowIndex] = 1.0;
+    }
+
+    for (std::uint32_t PivotIndex = {};
+         PivotIndex < 4u;
+         PivotIndex++)
+    {
+        std::uint32_t BestRowIndex = { PivotIndex };
+
+        for (std::uint32_t RowIndex = { PivotIndex + 1u };
+             RowIndex < 4u;
+             RowIndex++)
+        {
+            if (std::abs(Rows [RowIndex] [PivotIndex]) > std::abs(Rows [BestRowIndex] [PivotIndex]))
+            {
+                BestRowIndex = RowIndex;
+            }
+        }
+
+        if (Rows [BestRowIndex] [PivotIndex] == 0.0)
+        {
+            return false;
+        }
+
+        std::swap(Rows [PivotIndex], Rows [BestRowIndex]);
+
+        double const kInversePivot = 1.0 / Rows [PivotIndex] [PivotIndex];
+
+        for (double & Element : Rows [PivotIndex])
+        {
+            Element *= kInversePivot;
+        }
+
+        for (std::uint32_t RowIndex = {};
+             RowIndex < 4u;
+             RowIndex++)
+        {
+            if (RowIndex != PivotIndex)
+            {
+                double const kFactor = Rows [RowIndex] [PivotIndex];
+
+                for (std::uint32_t ColumnIndex = {};
+                     ColumnIndex < 8u;
+                     ColumnIndex++)
+                {
+                    Rows [RowIndex] [ColumnIndex] -= kFactor * Rows [PivotIndex] [ColumnIndex];
+                }
+            }
+        }
+    }
+
+    for (std::uint32_t RowIndex = {};
+         RowIndex < 4u;
+         RowIndex++)
+    {
+        for (std::uint32_t ColumnIndex = {};
+             ColumnIndex < 4u;
+             ColumnIndex++)
+        {
+            OutputInverse [(ColumnIndex << 2u) + RowIndex] = Rows [RowIndex] [4u + ColumnIndex];
+        }
+    }
+
+    return true;
+}
+
+static Math::Vector3 const RandomVector(float const Minimum, float const Maximum)
+{
+    return Math::Vector3 { Random.NextFloat(Minimum, Maximum), Random.NextFloat(Minimum, Maximum), Random.NextFloat(Minimum, Maximum) };
+}
+
+static Math::Vector3 const RandomAxis()
+{
+    return Math::Vector3::Normalize(RandomVector(-1.0f, 1.0f) + Math::Vector3 { 0.0f, 0.0f, 1.0e-3f });
+}
+
+static Math::Matrix4x4 const RandomMatrix()
+{
+    Math::Matrix4x4 Matrix = {};
+
+    for (float & Element : Matrix.Data)
+    {
+        Element = Random.NextFloat(-10.0f, 10.0f);
+    }
+
+    return Matrix;
+}
+
+/* Rotation, uniform scale and translation, the kind of matrix the renderer inverts */
+static Math::Matrix4x4 const RandomTransform()
+{
+    Math::Matrix4x4 Matrix = Math::RotateAxisAngle(RandomAxis(), Random.NextFloat(-180.0f, 180.0f));
+
+    float const kScale = Random.NextFloat(0.25f, 4.0f);
+
+    for (std::uint32_t ElementIndex = {};
+         ElementIndex < 12u;
+         ElementIndex++)
+    {
+        Matrix.Data [ElementIndex] *= kScale;
+    }
+
+    Matrix.Data [12u] = Random.NextFloat(-1000.0f, 1000.0f);
+    Matrix.Data [13u] = Random.NextFloat(-1000.0f, 1000.0f);
+    Matrix.Data [14u] = Random.NextFloat(-1000.0f, 1000.0f);
+
+    return Matrix;
+}
+
+struct ErrorReport
+{
+    char const * Name = {};
+    double MaximumULPs = {};
+    double BoundULPs = {};
+};
+
+static std::vector<ErrorReport> Reports = {};
+
+static void Report(char const * const Name, double const MaximumULPs, double const BoundULPs)
+{
+    Reports.push_back(ErrorReport { Name, MaximumULPs, BoundULPs });
+    Testing::Check(MaximumULPs <= BoundULPs, Name, __FILE__, __LINE__);
+}
+
+static void MeasureMatrixMultiply()
+{
+    double MaximumULPs = {};
+
+    for (std::uint32_t SampleIndex = {};
+         SampleIndex < kSampleCount;
+         SampleIndex++)
+    {
+        Math::Matrix4x4 const kLeft = RandomMatrix();
+        Math::Matrix4x4 const kRight = RandomMatrix();
+
+        Math::Matrix4x4 const kResult = kLeft * kRight;
+
+        Matrix4x4d const kLeftd = ToDouble(kLeft);
+        Matrix4x4d const kRightd = ToDouble(kRight);
+
+        for (std::uint32_t RowIndex = {};
+             RowIndex < 4u;
+             RowIndex++)
+        {
+            for (std::uint32_t ColumnIndex = {};
+                 ColumnIndex < 4u;
+                 ColumnIndex++)
+            {
+                double Reference = {};
+                double Scale = {};
+
+                for (std::uint32_t TermIndex = {};
+                     TermIndex < 4u;
+                     TermIndex++)
+                {
+                    double const kTerm = ElementOf(kLeftd, RowIndex, TermIndex) * ElementOf(kRightd, TermIndex, ColumnIndex);
+
+                    Reference += kTerm;
+                    Scale += std::abs(kTerm);
+                }
+
+                float const kValue = kResult.Data [(ColumnIndex << 2u) + RowIndex];
+                MaximumULPs = std::max(MaximumULPs, Testing::ScaledULPError(kValue, Reference, Scale));
+            }
+        }
+    }
+
+    Report("Matrix4x4 * Matrix4x4", MaximumULPs, 4.0);
+}
+
+static void MeasureMatrixVectorMultiply()
+{
+    double MaximumULPs = {};
+
+    for (std::uint32_t SampleIndex = {};
+         SampleIndex < kSampleCount;
+         SampleIndex++)
+    {
+        Math::Matrix4x4 const kMatrix = RandomMatrix();
+        Math::Vector4 const kVector = Math::Vector4 { Random.NextFloat(-10.0f, 10.0f), Random.NextFloat(-10.0f, 10.0f), Random.NextFloat(-10.0f, 10.0f), Random.NextFloat(-10.0f, 10.0f) };
+
+        Math::Vector4 const kResult = kMatrix * kVector;
+
+        std::array<float, 4u> const kInput = { kVector.X, kVector.Y, kVector.Z, kVector.W };
+        std::array<float, 4u> const kOutput = { kResult.X, kResult.Y, kResult.Z, kResult.W };
+
+        for (std::uint32_t RowIndex = {};
+             RowIndex < 4u;
+             RowIndex++)
+        {
+            double Reference = {};
+            double Scale = {};
+
+            for (std::uint32_t TermIndex = {};
+                 TermIndex < 4u;
+                 TermIndex++)
+            {
+                double const kTerm = static_cast<double>(kMatrix.Data [(TermIndex << 2u) + RowIndex]) * static_cast<double>(kInput [TermIndex]);
+
+                Reference += kTerm;
+                Scale += std::abs(kTerm);
+            }
+
+            MaximumULPs = std::max(MaximumULPs, Testing::ScaledULPError(kOutput [RowIndex], Reference, Scale));
+        }
+    }
+
+    Report("Matrix4x4 * Vector4", MaximumULPs, 4.0);
+}
+
+static void MeasureMatrixInverse()
+{
+    double MaximumULPs = {};
+
+    for (std::uint32_t SampleIndex = {};
+         SampleIndex < kSampleCount;
+         SampleIndex++)
+    {
+        Math::Matrix4x4 const kMatrix = RandomTransform();
+        Math::Matrix4x4 const kInverse = Math::Matrix4x4::Inverse(kMatrix);
+
+        Matrix4x4d ReferenceInverse = {};
+
+        if (!InvertReference(ToDouble(kMatrix), ReferenceInverse))
+        {
+            continue;
+        }
+
+        /* Each column is compared against the largest element of the reference column, translations dominate the last one */
+        for (std::uint32_t ColumnIndex = {};
+             ColumnIndex < 4u;
+             ColumnIndex++)
+        {
+            double Scale = {};
+
+            for (std::uint32_t RowIndex = {};
+                 RowIndex < 4u;
+                 RowIndex++)
+            {
+                Scale = std::max(Scale, std::abs(ElementOf(ReferenceInverse, RowIndex, ColumnIndex)));
+            }
+
+            for (std::uint32_t RowIndex = {};
+                 RowIndex < 4u;
+                 RowIndex++)
+            {
+                float const kValue = kInverse.Data [(ColumnIndex << 2u) + RowIndex];
+                MaximumULPs = std::max(MaximumULPs, Testing::ScaledULPError(kValue, ElementOf(ReferenceInverse, RowIndex, ColumnIndex), Scale));
+            }
+        }
+    }
+
+    Report("Matrix4x4::Inverse", MaximumULPs, 16.0);
+}
+
+static void MeasureVectorOperations()
+{
+    double MaximumDotULPs = {};
+    double MaximumCrossULPs = {};
+    double MaximumNormalizeULPs = {};
+
+    for (std::uint32_t SampleIndex = {};
+         SampleIndex < kSampleCount;
+         SampleIndex++)
+    {
+        Math::Vector3 const kLeft = RandomVector(-100.0f, 100.0f);
+        Math::Vector3 const kRight = RandomVector(-100.0f, 100.0f);
+
+        Vector3d const kLeftd = ToDouble(kLeft);
+        Vector3d const kRightd = ToDouble(kRight);
+
+        {
+            double const kReference = kLeftd.X * kRightd.X + kLeftd.Y * kRightd.Y + kLeftd.Z * kRightd.Z;
+            double const kScale = std::abs(kLeftd.X * kRightd.X) + std::abs(kLeftd.Y * kRightd.Y) + std::abs(kLeftd.Z * kRightd.Z);
+
+            MaximumDotULPs = std::max(MaximumDotULPs, Testing::ScaledULPError(kLeft * kRight, kReference, kScale));
+        }
+
+        {
+            Math::Vector3 const kCross = kLeft ^ kRight;
+
+            std::array<double, 3u> const kReference =
+            {
+                kLeftd.Y * kRightd.Z - kLeftd.Z * kRightd.Y,
+                kLeftd.Z * kRightd.X - kLeftd.X * kRightd.Z,
+                kLeftd.X * kRightd.Y - kLeftd.Y * kRightd.X,
+            };
+
+            std::array<double, 3u> const kScale =
+            {
+                std::abs(kLeftd.Y * kRightd.Z) + std::abs(kLeftd.Z * kRightd.Y),
+                std::abs(kLeftd.Z * kRightd.X) + std::abs(kLeftd.X * kRightd.Z),
+                std::abs(kLeftd.X * kRightd.Y) + std::abs(kLeftd.Y * kRightd.X),
+            };
+
+            MaximumCrossULPs = std::max(MaximumCrossULPs, Testing::ScaledULPError(kCross.X, kReference [0u], kScale [0u]));
+            MaximumCrossULPs = std::max(MaximumCrossULPs, Testing::ScaledULPError(kCross.Y, kReference [1u], kScale [1u]));
+            MaximumCrossULPs = std::max(MaximumCrossULPs, Testing::ScaledULPError(kCross.Z, kReference [2u], kScale [2u]));
+        }
+
+        {
+            Math::Vector3 const kNormal = Math::Vector3::Normalize(kLeft);
+
+            double const kLength = std::sqrt(kLeftd.X * kLeftd.X + kLeftd.Y * kLeftd.Y + kLeftd.Z * kLeftd.Z);
+
+            MaximumNormalizeULPs = std::max(MaximumNormalizeULPs, Testing::ScaledULPError(kNormal.X, kLeftd.X / kLength, 1.0));
+            MaximumNormalizeULPs = std::max(MaximumNormalizeULPs, Testing::ScaledULPError(kNormal.Y, kLeftd.Y / kLength, 1.0));
+            MaximumNormalizeULPs = std::max(MaximumNormalizeULPs, Testing::ScaledULPError(kNormal.Z, kLeftd.Z / kLength, 1.0));
+        }
+    }
+
+    Report("Vector3 dot", MaximumDotULPs, 3.0);
+    Report("Vector3 cross", MaximumCrossULPs, 2.0);
+    Report("Vector3::Normalize", MaximumNormalizeULPs, 4.0);
+}
+
+static void MeasureRotateAxisAngle()
+{
+    double MaximumULPs = {};
+
+    for (std::uint32_t SampleIndex = {};
+         SampleIndex < kSampleCount;
+         SampleIndex++)
+    {
+        Math::Vector3 const kAxis = RandomAxis();
+        float const kAngleInDegrees = Random.NextFloat(-180.0f, 180.0f);
+
+        Math::Matrix4x4 const kMatrix = Math::RotateAxisAngle(kAxis, kAngleInDegrees);
+
+        /* The reference uses the same float axis and angle, so only the evaluation is measured */
+        Vector3d const kAxisd = ToDouble(kAxis);
+        double const kAngleInRadians = static_cast<double>(kAngleInDegrees) * (3.14159265358979323846 / 180.0);
+        double const kCosine = std::cos(kAngleInRadians);
+        double const kSine = std::sin(kAngleInRadians);
+        double const kOneMinusCosine = 1.0 - kCosine;
+
+        Matrix4x4d const kReference =
+        {
+            kAxisd.X * kAxisd.X * kOneMinusCosine + kCosine, kOneMinusCosine * kAxisd.X * kAxisd.Y + kSine * kAxisd.Z, kOneMinusCosine * kAxisd.X * kAxisd.Z - kSine * kAxisd.Y, 0.0,
+            kOneMinusCosine * kAxisd.X * kAxisd.Y - kSine * kAxisd.Z, kOneMinusCosine * kAxisd.Y * kAxisd.Y + kCosine, kOneMinusCosine * kAxisd.Y * kAxisd.Z + kSine * kAxisd.X, 0.0,
+            kOneMinusCosine * kAxisd.X * kAxisd.Z + kSine * kAxisd.Y, kOneMinusCosine * kAxisd.Y * kAxisd.Z - kSine * kAxisd.X, kOneMinusCosine * kAxisd.Z * kAxisd.Z + kCosine, 0.0,
+            0.0, 0.0, 0.0, 1.0,
+        };
+
+        /* Elements of a rotation are at most one */
+        for (std::uint32_t ElementIndex = {};
+             ElementIndex < 16u;
+             ElementIndex++)
+        {
+            MaximumULPs = std::max(MaximumULPs, Testing::ScaledULPError(kMatrix.Data [ElementIndex], kReference [ElementIndex], 1.0));
+        }
+    }
+
+    Report("RotateAxisAngle", MaximumULPs, 8.0);
+}
+
+static void MeasurePerspectiveMatrix()
+{
+    double MaximumULPs = {};
+
+    for (std::uint32_t SampleIndex = {};
+         SampleIndex < kSampleCount;
+         SampleIndex++)
+    {
+        float const kFieldOfView = Random.NextFloat(0.5f, 2.5f);
+        float const kAspectRatio = Random.NextFloat(0.5f, 3.0f);
+        float const kNear = Random.NextFloat(0.01f, 1.0f);
+        float const kFar = kNear + Random.NextFloat(10.0f, 10000.0f);
+
+        Math::Matrix4x4 const kMatrix = Math::PerspectiveMatrix(kFieldOfView, kAspectRatio, kNear, kFar);
+
+        double const kProjectionPlaneDistance = static_cast<double>(kAspectRatio) / std::tan(static_cast<double>(kFieldOfView) * 0.5);
+        double const kRemapMultiplier = 1.0 / (static_cast<double>(kNear) - static_cast<double>(kFar));
+
+        std::array<std::array<double, 3u>, 4u> const kElements =
+        {
+            std::array<double, 3u> { 0.0, 0.0, kProjectionPlaneDistance / static_cast<double>(kAspectRatio) },
+            std::array<double, 3u> { 1.0, 1.0, kProjectionPlaneDistance },
+            std::array<double, 3u> { 2.0, 2.0, kRemapMultiplier },
+            std::array<double, 3u> { 2.0, 3.0, -static_cast<double>(kFar) * kRemapMultiplier },
+        };
+
+        for (std::array<double, 3u> const & kElement : kElements)
+        {
+            std::uint32_t const kRowIndex = static_cast<std::uint32_t>(kElement [0u]);
+            std::uint32_t const kColumnIndex = static_cast<std::uint32_t>(kElement [1u]);
+
+            float const kValue = kMatrix.Data [(kColumnIndex << 2u) + kRowIndex];
+            MaximumULPs = std::max(MaximumULPs, Testing::ScaledULPError(kValue, kElement [2u], std::abs(kElement [2u])));
+        }
+    }
+
+    Report("PerspectiveMatrix", MaximumULPs, 8.0);
+}
+
+static void MeasureAffine()
+{
+    double MaximumComposeULPs = {};
+    double MaximumInverseULPs = {};
+    double MaximumInverseRigidULPs = {};
+    double MaximumPointULPs = {};
+    double MaximumBatchULPs = {};
+
+    std::vector<Math::Vector3> Points = std::vector<Math::Vector3>(7u);
+    std::vector<Math::Vector3> TransformedPoints = std::vector<Math::Vector3>(Points.size());
+
+    for (std::uint32_t SampleIndex = {};
+         SampleIndex < kSampleCount;
+         SampleIndex++)
+    {
+        Math::Affine3x4 const kLeft = Math::Affine3x4::FromMatrix4x4(RandomTransform());
+        Math::Affine3x4 const kRight = Math::Affine3x4::FromMatrix4x4(RandomTransform());
+
+        /* Compose against the same product done in double as a 4x4 */
+        {
+            Math::Affine3x4 const kProduct = kLeft * kRight;
+
+            for (std::uint32_t RowIndex = {};
+                 RowIndex < 3u;
+                 RowIndex++)
+            {
+                for (std::uint32_t ColumnIndex = {};
+                     ColumnIndex < 4u;
+                     ColumnIndex++)
+                {
+                    double Reference = { ColumnIndex == 3u ? static_cast<double>(kLeft.Data [(RowIndex << 2u) + 3u]) : 0.0 };
+                    double Scale = { std::abs(Reference) };
+
+                    for (std::uint32_t TermIndex = {};
+                         TermIndex < 3u;
+                         TermIndex++)
+                    {
+                        double const kTerm = static_cast<double>(kLeft.Data [(RowIndex << 2u) + TermIndex]) * static_cast<double>(kRight.Data [(TermIndex << 2u) + ColumnIndex]);
+
+                        Reference += kTerm;
+                        Scale += std::abs(kTerm);
+                    }
+
+                    MaximumComposeULPs = std::max(MaximumComposeULPs, Testing::ScaledULPError(kProduct.Data [(RowIndex << 2u) + ColumnIndex], Reference, Scale));
+                }
+            }
+        }
+
+        /* Both inverses against the general double inverse, scaled like Matrix4x4::Inverse */
+        {
+            Matrix4x4d ReferenceInverse = {};
+            InvertReference(ToDouble(Math::Affine3x4::ToMatrix4x4(kLeft)), ReferenceInverse);
+
+            Math::Affine3x4 Inverse = {};
+            TEST_CHECK(Math::Affine3x4::Inverse(kLeft, Inverse));
+
+            for (std::uint32_t ColumnIndex = {};
+                 ColumnIndex < 4u;
+                 ColumnIndex++)
+            {
+                double Scale = {};
+
+                for (std::uint32_t RowIndex = {};
+                     RowIndex < 3u;
+                     RowIndex++)
+                {
+                    Scale = std::max(Scale, std::abs(ElementOf(ReferenceInverse, RowIndex, ColumnIndex)));
+                }
+
+                for (std::uint32_t RowIndex = {};
+                     RowIndex < 3u;
+                     RowIndex++)
+                {
+                    double const kReference = ElementOf(ReferenceInverse, RowIndex, ColumnIndex);
+                    MaximumInverseULPs = std::max(MaximumInverseULPs, Testing::ScaledULPError(Inverse.Data [(RowIndex << 2u) + ColumnIndex], kReference, Scale));
+                }
+            }
+        }
+
+        /*
+            InverseRigid needs an orthonormal basis, so the scale is left out.
+            A float rotation is only orthonormal to within rounding and the transpose takes that error with it, hence the looser bound.
+        */
+        {
+            Math::Matrix4x4 Rigid = Math::RotateAxisAngle(RandomAxis(), Random.NextFloat(-180.0f, 180.0f));
+            Rigid.Data [12u] = Random.NextFloat(-1000.0f, 1000.0f);
+            Rigid.Data [13u] = Random.NextFloat(-1000.0f, 1000.0f);
+            Rigid.Data [14u] = Random.NextFloat(-1000.0f, 1000.0f);
+
+            Matrix4x4d ReferenceInverse = {};
+            InvertReference(ToDouble(Rigid), ReferenceInverse);
+
+            Math::Affine3x4 const kInverse = Math::Affine3x4::InverseRigid(Math::Affine3x4::FromMatrix4x4(Rigid));
+
+            /* A float rotation is only orthonormal to within a few ULPs, which shows up in the translation column at the scale of the translation */
+            for (std::uint32_t ColumnIndex = {};
+                 ColumnIndex < 4u;
+                 ColumnIndex++)
+            {
+                double Scale = {};
+
+                for (std::uint32_t RowIndex = {};
+                     RowIndex < 3u;
+                     RowIndex++)
+                {
+                    Scale = std::max(Scale, std::abs(ElementOf(ReferenceInverse, RowIndex, ColumnIndex)));
+                }
+
+                for (std::uint32_t RowIndex = {};
+                     RowIndex < 3u;
+                     RowIndex++)
+                {
+                    double const kReference = ElementOf(ReferenceInverse, RowIndex, ColumnIndex);
+                    MaximumInverseRigidULPs = std::max(MaximumInverseRigidULPs, Testing::ScaledULPError(kInverse.Data [(RowIndex << 2u) + ColumnIndex], kReference, Scale));
+                }
+            }
+        }
+
+        /* Single and batched point transforms, the batch has a SIMD body and a scalar tail */
+        {
+            for (Math::Vector3 & Point : Points)
+            {
+                Point = RandomVector(-100.0f, 100.0f);
+            }
+
+            Math::TransformPoints(kLeft, static_cast<std::uint32_t>(Points.size()), Points.data(), TransformedPoints.data());
+
+            for (std::size_t PointIndex = {};
+                 PointIndex < Points.size();
+                 PointIndex++)
+            {
+                Math::Vector3 const kPoint = Math::TransformPoint(kLeft, Points [PointIndex]);
+
+                std::array<float, 3u> const kSingle = { kPoint.X, kPoint.Y, kPoint.Z };
+                std::array<float, 3u> const kBatch = { TransformedPoints [PointIndex].X, TransformedPoints [PointIndex].Y, TransformedPoints [PointIndex].Z };
+                std::array<float, 3u> const kInput = { Points [PointIndex].X, Points [PointIndex].Y, Points [PointIndex].Z };
+
+                for (std::uint32_t RowIndex = {};
+                     RowIndex < 3u;
+                     RowIndex++)
+                {
+                    double Reference = { static_cast<double>(kLeft.Data [(RowIndex << 2u) + 3u]) };
+                    double Scale = { std::abs(Reference) };
+
+                    for (std::uint32_t TermIndex = {};
+                         TermIndex < 3u;
+                         TermIndex++)
+                    {
+                        double const kTerm = static_cast<double>(kLeft.Data [(RowIndex << 2u) + TermIndex]) * static_cast<double>(kInput [TermIndex]);
+
+                        Reference += kTerm;
+                        Scale += std::abs(kTerm);
+                    }
+
+                    MaximumPointULPs = std::max(MaximumPointULPs, Testing::ScaledULPError(kSingle [RowIndex], Reference, Scale));
+                    MaximumBatchULPs = std::max(MaximumBatchULPs, Testing::ScaledULPError(kBatch [RowIndex], Reference, Scale));
+                }
+            }
+        }
+    }
+
+    Report("Affine3x4 * Affine3x4", MaximumComposeULPs, 4.0);
+    Report("Affine3x4::Inverse", MaximumInverseULPs, 16.0);
+    Report("Affine3x4::InverseRigid", MaximumInverseRigidULPs, 32.0);
+    Report("TransformPoint", MaximumPointULPs, 4.0);
+    Report("TransformPoints", MaximumBatchULPs, 4.0);
+
+    /* Singular matrices are reported rather than returning garbage */
+    {
+        Math::Affine3x4 const kSingular = Math::Affine3x4::TranslationScale(Math::Vector3 { 1.0f, 2.0f, 3.0f }, 0.0f);
+
+        Math::Affine3x4 Inverse = Math::Affine3x4::Identity();
+        TEST_CHECK(!Math::Affine3x4::Inverse(kSingular, Inverse));
+        TEST_CHECK(Inverse.Data == Math::Affine3x4::Identity().Data);
+    }
+}
+
+int main()
+{
+    MeasureMatrixMultiply();
+    MeasureMatrixVectorMultiply();
+    MeasureMatrixInverse();
+    MeasureVectorOperations();
+    MeasureRotateAxisAngle();
+    MeasurePerspectiveMatrix();
+    MeasureAffine();
+
+    std::printf("%-28s %12s %12s\n", "Operation", "Max ULPs", "Bound");
+
+    for (ErrorReport const & kReport : Reports)
+    {
+        std::printf("%-28s %12.2f %12.2f\n", kReport.Name, kReport.MaximumULPs, kReport.BoundULPs);
+    }
+
+    return Testing::Finish(kBuildName);
+}
@@ -0,0 +1,218 @@
+#include "Testing.hpp"
+
+#include <Math/Affine.hpp>
+#include <Math/Matrix.hpp>
+#include <Math/Transform.hpp>
+#include <Math/Vector.hpp>
+
+#include <vector>
+
+/*
+    Latency runs each operation on the result of the previous one, so the calls can't overlap and the time is the length of one call.
+    Throughput runs it over independent inputs, which is what the batched and per-frame paths see.
+*/
+
+static std::uint32_t const kLatencyIterationCount = { 1000000u };
+static std::uint32_t const kThroughputElementCount = { 4096u };
+static std::uint32_t const kThroughputPassCount = { 256u };
+static std::uint32_t const kRepeatCount = { 5u };
+
+static Testing::Random Random = {};
+
+static void PrintResult(char const * const Name, double const LatencyInNanoseconds, double const ThroughputInNanoseconds)
+{
+    std::printf("%-28s %14.2f %18.2f %16.1f\n", Name, LatencyInNanoseconds, ThroughputInNanoseconds, 1000.0 / ThroughputInNanoseconds);
+}
+
+template<typename ElementType, typename OperationType>
+static void Benchmark(char const * const Name, std::vector<ElementType> const & Inputs, OperationType && Operation)
+{
+    double const kLatencyInNanoseconds = Testing::MeasureNanoseconds(kRepeatCount, [&Inputs, &Operation]()
+                                                                     {
+                                                                         ElementType Value = Inputs [0u];
+
+                                                                         for (std::uint32_t IterationIndex = {};
+                                                                              IterationIndex < kLatencyIterationCount;
+                                                                              IterationIndex++)
+                                                                         {
+                                                                             Value = Operation(Value, Inputs [IterationIndex % Inputs.size()]);
+                                                                         }
+
+                                                                         Testing::DoNotOptimise(Value);
+                                                                     }) / kLatencyIterationCount;
+
+    std::vector<ElementType> Outputs = std::vector<ElementType>(Inputs.size());
+
+    double const kThroughputInNanoseconds = Testing::MeasureNanoseconds(kRepeatCount, [&Inputs, &Outputs, &Operation]()
+                                                                        {
+                                                                            for (std::uint32_t PassIndex = {};
+                                                                                 PassIndex < kThroughputPassCount;
+                                                                                 PassIndex++)
+                                                                            {
+                                                                                for (std::size_t ElementIndex = {};
+                                                                                     ElementIndex < Inputs.size();
+                                                                                     ElementIndex++)
+                                                                                {
+                                                                                    Outputs [ElementIndex] = Operation(Inputs [ElementIndex], Inputs [Inputs.size() - 1u - ElementIndex]);
+                                                                                }
+
+                                                                                Testing::DoNotOptimise(Outputs [PassIndex % Outputs.size()]);
+                                                                            }
+                                                                        }) / (static_cast<double>(kThroughputPassCount) * Inputs.size());
+
+    ::PrintResult(Name, kLatencyInNanoseconds, kThroughputInNanoseconds);
+}
+
+static Math::Matrix4x4 const RandomMatrix()
+{
+    Math::Matrix4x4 Matrix = {};
+
+    for (float & Element : Matrix.Data)
+    {
+        Element = Random.NextFloat(-1.0f, 1.0f);
+    }
+
+    /* Diagonally dominant, so every inverse exists and chained results stay bounded */
+    for (std::uint32_t DiagonalIndex = {};
+         DiagonalIndex < 4u;
+         DiagonalIndex++)
+    {
+        Matrix.Data [(DiagonalIndex << 2u) + DiagonalIndex] += 4.0f;
+    }
+
+    return Matrix;
+}
+
+static Math::Vector3 const RandomVector()
+{
+    return Math::Vector3 { Random.NextFloat(-1.0f, 1.0f), Random.NextFloat(-1.0f, 1.0f), Random.NextFloat(-1.0f, 1.0f) + 2.0f };
+}
+
+int main()
+{
+    std::vector<Math::Matrix4x4> Matrices = std::vector<Math::Matrix4x4>(kThroughputElementCount);
+    std::vector<Math::Matrix4x4> Rotations = std::vector<Math::Matrix4x4>(kThroughputElementCount);
+    std::vector<Math::Affine3x4> Affines = std::vector<Math::Affine3x4>(kThroughputElementCount);
+    std::vector<Math::Vector3> Vectors = std::vector<Math::Vector3>(kThroughputElementCount);
+    std::vector<Math::Vector4> Vector4s = std::vector<Math::Vector4>(kThroughputElementCount);
+
+    for (std::uint32_t ElementIndex = {};
+         ElementIndex < kThroughputElementCount;
+         ElementIndex++)
+    {
+        Matrices [ElementIndex] = RandomMatrix();
+        Rotations [ElementIndex] = Math::RotateAxisAngle(Math::Vector3::Normalize(RandomVector()), Random.NextFloat(-180.0f, 180.0f));
+        Affines [ElementIndex] = Math::Affine3x4::FromMatrix4x4(Rotations [ElementIndex]);
+        Vectors [ElementIndex] = RandomVector();
+        Vector4s [ElementIndex] = Math::Vector4 { Vectors [ElementIndex].X, Vectors [ElementIndex].Y, Vectors [ElementIndex].Z, 1.0f };
+    }
+
+    std::printf("%-28s %14s %18s %16s\n", "Operation", "Latency (ns)", "Throughput (ns/op)", "Mops/s");
+
+    /* Rotations, so chained products neither overflow nor decay into denormals */
+    ::Benchmark("Matrix4x4 * Matrix4x4", Rotations, [](Math::Matrix4x4 const & Left, Math::Matrix4x4 const & Right)
+                {
+                    return Left * Right;
+                });
+
+    ::Benchmark("Matrix4x4::Inverse", Matrices, [](Math::Matrix4x4 const & Matrix, Math::Matrix4x4 const &)
+                {
+                    return Math::Matrix4x4::Inverse(Matrix);
+                });
+
+    ::Benchmark("Matrix4x4 * Vector4", Vector4s, [&Rotations](Math::Vector4 const & Vector, Math::Vector4 const &)
+                {
+                    return Rotations [0u] * Vector;
+                });
+
+    ::Benchmark("Affine3x4 * Affine3x4", Affines, [](Math::Affine3x4 const & Left, Math::Affine3x4 const & Right)
+                {
+                    return Left * Right;
+                });
+
+    ::Benchmark("Affine3x4::InverseRigid", Affines, [](Math::Affine3x4 const & Affine, Math::Affine3x4 const &)
+                {
+                    return Math::Affine3x4::InverseRigid(Affine);
+                });
+
+    ::Benchmark("Vector3 + Vector3", Vectors, [](Math::Vector3 const & Left, Math::Vector3 const & Right)
+                {
+                    return (Left + Right) * 0.5f;
+                });
+
+    ::Benchmark("Vector3 cross", Vectors, [](Math::Vector3 const & Left, Math::Vector3 const & Right)
+                {
+                    return Math::Vector3::Normalize(Left ^ Right);
+                });
+
+    ::Benchmark("Vector3 dot", Vectors, [](Math::Vector3 const & Left, Math::Vector3 const & Right)
+                {
+                    return Right * (Left * Right) * 0.1f;
+                });
+
+    ::Benchmark("Vector3::Normalize", Vectors, [](Math::Vector3 const & Vector, Math::Vector3 const &)
+                {
+                    return Math::Vector3::Normalize(Vector);
+                });
+
+    /* The angle comes from the input so the latency chain goes through the trigonometry */
+    ::Benchmark("RotateAxisAngle", Matrices, [](Math::Matrix4x4 const & Matrix, Math::Matrix4x4 const &)
+                {
+                    return Math::RotateAxisAngle(Math::Vector3 { 0.0f, 0.0f, 1.0f }, Matrix.Data [0u] * 10.0f);
+                });
+
+    ::Benchmark("PerspectiveMatrix", Matrices, [](Math::Matrix4x4 const & Matrix, Math::Matrix4x4 const &)
+                {
+                    return Math::PerspectiveMatrix(1.0f + Matrix.Data [0u] * 0.01f, 16.0f / 9.0f, 0.1f, 1000.0f);
+                });
+
+    /* The batched path against the single point path it replaces, both are throughput only */
+    {
+        std::vector<Math::Vector3> TransformedVectors = std::vector<Math::Vector3>(Vectors.size());
+
+        double const kSingleInNanoseconds = Testing::MeasureNanoseconds(kRepeatCount, [&Vectors, &TransformedVectors, &Affines]()
+                                                                        {
+                                                                            for (std::uint32_t PassIndex = {};
+                                                                                 PassIndex < kThroughputPassCount;
+                                                                                 PassIndex++)
+                                                                            {
+                                                                                for (std::size_t VectorIndex = {};
+                                                                                     VectorIndex < Vectors.size();
+                                                                                     VectorIndex++)
+                                                                                {
+                                                                                    TransformedVectors [VectorIndex] = Math::TransformPoint(Affines [PassIndex], Vectors [VectorIndex]);
+                                                                                }
+
+                                                                                Testing::DoNotOptimise(TransformedVectors [PassIndex]);
+                                                                            }
+                                                                        }) / (static_cast<double>(kThroughputPassCount) * Vectors.size());
+
+        double const kBatchInNanoseconds = Testing::MeasureNanoseconds(kRepeatCount, [&Vectors, &TransformedVectors, &Affines]()
+                                                                       {
+                                                                           for (std::uint32_t PassIndex = {};
+                                                                                PassIndex < kThroughputPassCount;
+                                                                                PassIndex++)
+                                                                           {
+                                                                               Math::TransformPoints(Affines [PassIndex], static_cast<std::uint32_t>(Vectors.size()), Vectors.data(), TransformedVectors.data());
+                                                                               Testing::DoNotOptimise(TransformedVectors [PassIndex]);
+                                                                           }
+                                                                       }) / (static_cast<double>(kThroughputPassCount) * Vectors.size());
+
+        std::printf("%-28s %14s %18.2f %16.1f\n", "TransformPoint", "-", kSingleInNanoseconds, 1000.0 / kSingleInNanoseconds);
+        std::printf("%-28s %14s %18.2f %16.1f\n", "TransformPoints", "-", kBatchInNanoseconds, 1000.0 / kBatchInNanoseconds);
+
+        /* The batch must give the same points as the single path, within rounding */
+        for (std::size_t VectorIndex = {};
+             VectorIndex < Vectors.size();
+             VectorIndex++)
+        {
+            Math::Vector3 const kPoint = Math::TransformPoint(Affines [kThroughputPassCount - 1u], Vectors [VectorIndex]);
+
+            TEST_CHECK(Testing::ULPDistance(kPoint.X, TransformedVectors [VectorIndex].X) <= 4u || std::abs(kPoint.X - TransformedVectors [VectorIndex].X) < 1.0e-5f);
+            TEST_CHECK(Testing::ULPDistance(kPoint.Y, TransformedVectors [VectorIndex].Y) <= 4u || std::abs(kPoint.Y - TransformedVectors [VectorIndex].Y) < 1.0e-5f);
+            TEST_CHECK(Testing::ULPDistance(kPoint.Z, TransformedVectors [VectorIndex].Z) <= 4u || std::abs(kPoint.Z - TransformedVectors [VectorIndex].Z) < 1.0e-5f);
+        }
+    }
+
+    return Testing::Finish("MathBenchmarks");
+}
@@ -0,0 +1,140 @@
+#include "Testing.hpp"
+
+#include "Graphics/PipelineCache.hpp"
+
+#include <cstddef>
+#include <vector>
+
+/*
+    Checks which saved pipeline cache data is handed to the driver
+        - A header matching the device is accepted, with or without cache data after it
+        - Data too short to hold the header, or whose header says it is longer than the data, is rejected
+        - A different vendor, device, pipeline cache UUID or header version is rejected
+*/
+
+static VkPhysicalDeviceProperties const MakeDeviceProperties()
+{
+    VkPhysicalDeviceProperties DeviceProperties = {};
+    DeviceProperties.vendorID = 0x10DEu;
+    DeviceProperties.deviceID = 0x2484u;
+
+    for (uint32 ByteIndex = {};
+         ByteIndex < VK_UUID_SIZE;
+         ByteIndex++)
+    {
+        DeviceProperties.pipelineCacheUUID [ByteIndex] = static_cast<uint8>(ByteIndex * 17u + 3u);
+    }
+
+    return DeviceProperties;
+}
+
+/* The header the driver would write for the device */
+static VkPipelineCacheHeaderVersionOne const MakeHeader(VkPhysicalDeviceProperties const & kDeviceProperties)
+{
+    VkPipelineCacheHeaderVersionOne Header = {};
+    Header.headerSize = static_cast<uint32>(sizeof(Header));
+    Header.headerVersion = VK_PIPELINE_CACHE_HEADER_VERSION_ONE;
+    Header.vendorID = kDeviceProperties.vendorID;
+    Header.deviceID = kDeviceProperties.deviceID;
+
+    std::memcpy(Header.pipelineCacheUUID, kDeviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
+
+    return Header;
+}
+
+/* The header followed by PayloadSizeInBytes bytes of cache data */
+static std::vector<std::byte> const MakeCacheData(VkPipelineCacheHeaderVersionOne const & kHeader, uint32 const kPayloadSizeInBytes)
+{
+    std::vector<std::byte> CacheData = std::vector<std::byte>(sizeof(kHeader) + kPayloadSizeInBytes, std::byte { 0xCDu });
+    std::memcpy(CacheData.data(), &kHeader, sizeof(kHeader));
+
+    return CacheData;
+}
+
+int main()
+{
+    using namespace Vulkan::PipelineCache;
+
+    VkPhysicalDeviceProperties const kDeviceProperties = ::MakeDeviceProperties();
+    VkPipelineCacheHeaderVersionOne const kValidHeader = ::MakeHeader(kDeviceProperties);
+
+    /* Valid */
+    {
+        TEST_CHECK(IsCacheDataValid(kDeviceProperties, ::MakeCacheData(kValidHeader, 0u)));
+        TEST_CHECK(IsCacheDataValid(kDeviceProperties, ::MakeCacheData(kValidHeader, 4096u)));
+
+        /* A header longer than the version one fields is accepted, as long as the data holds all of it */
+        VkPipelineCacheHeaderVersionOne LongerHeader = kValidHeader;
+        LongerHeader.headerSize = static_cast<uint32>(sizeof(LongerHeader) + 16u);
+
+        TEST_CHECK(IsCacheDataValid(kDeviceProperties, ::MakeCacheData(LongerHeader, 16u)));
+    }
+
+    /* Truncated, a file cut off at any point inside the header */
+    {
+        std::vector<std::byte> const kCacheData = ::MakeCacheData(kValidHeader, 0u);
+
+        bool bTruncatedRejected = true;
+
+        for (uint32 SizeInBytes = {};
+             SizeInBytes < sizeof(VkPipelineCacheHeaderVersionOne);
+             SizeInBytes++)
+        {
+            bTruncatedRejected &= !IsCacheDataValid(kDeviceProperties, std::vector<std::byte>(kCacheData.cbegin(), kCacheData.cbegin() + SizeInBytes));
+        }
+
+        TEST_CHECK(bTruncatedRejected);
+    }
+
+    /* Header size larger than the data, or too small to hold the header */
+    {
+        VkPipelineCacheHeaderVersionOne Header = kValidHeader;
+
+        Header.headerSize = static_cast<uint32>(sizeof(Header) + 1u);
+        TEST_CHECK(!IsCacheDataValid(kDeviceProperties, ::MakeCacheData(Header, 0u)));
+
+        Header.headerSize = ~0u;
+        TEST_CHECK(!IsCacheDataValid(kDeviceProperties, ::MakeCacheData(Header, 4096u)));
+
+        Header.headerSize = static_cast<uint32>(sizeof(Header) - 1u);
+        TEST_CHECK(!IsCacheDataValid(kDeviceProperties, ::MakeCacheData(Header, 0u)));
+
+        Header.headerSize = 0u;
+        TEST_CHECK(!IsCacheDataValid(kDeviceProperties, ::MakeCacheData(Header, 0u)));
+    }
+
+    /* Written by another device or driver */
+    {
+        VkPipelineCacheHeaderVersionOne Header = kValidHeader;
+        Header.vendorID = kDeviceProperties.vendorID + 1u;
+
+        TEST_CHECK(!IsCacheDataValid(kDeviceProperties, ::MakeCacheData(Header, 0u)));
+
+        Header = kValidHeader;
+        Header.deviceID = kDeviceProperties.deviceID + 1u;
+
+        TEST_CHECK(!IsCacheDataValid(kDeviceProperties, ::MakeCacheData(Header, 0u)));
+
+        Header = kValidHeader;
+        Header.headerVersion = static_cast<VkPipelineCacheHeaderVersion>(VK_PIPELINE_CACHE_HEADER_VERSION_ONE + 1);
+
+        TEST_CHECK(!IsCacheDataValid(kDeviceProperties, ::MakeCacheData(Header, 0u)));
+
+        /* A driver update changes the UUID, any byte of it differing has to be caught */
+        bool bUUIDRejected = true;
+
+        for (uint32 ByteIndex = {};
+             ByteIndex < VK_UUID_SIZE;
+             ByteIndex++)
+        {
+            Header = kValidHeader;
+            Header.pipelineCacheUUID [ByteIndex] = static_cast<uint8>(Header.pipelineCacheUUID [ByteIndex] ^ 0x80u);
+
+            bUUIDRejected &= !IsCacheDataValid(kDeviceProperties, ::MakeCacheData(Header, 0u));
+        }
+
+        TEST_CHECK(bUUIDRejected);
+    }
+
+    return Testing::Finish("PipelineCacheTests");
+}
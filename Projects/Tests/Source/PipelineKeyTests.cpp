@@ -0,0 +1,243 @@
+#include "Testing.hpp"
+
+#include "Graphics/Pipelines.hpp"
+
+#include <vector>
+
+/*
+    Checks how graphics pipeline requests are deduplicated, no device is created so nothing is compiled.
+        - The same description returns the same handle, whatever is left in the unused vertex binding and attribute entries
+        - Descriptions differing in a single field, e.g. blending, depth compare, render pass or vertex layout, each get their own pipeline
+        - Once the table is full a new description is rejected, and the pipelines already in it keep their handles
+*/
+
+using namespace Vulkan::Pipelines;
+
+/* Non-dispatchable handles are only compared, so any non-NULL value will do */
+template<typename HandleType>
+static HandleType const MakeHandle(uint64 const kValue)
+{
+    HandleType Handle = {};
+    std::memcpy(&Handle, &kValue, sizeof(Handle));
+
+    return Handle;
+}
+
+/* Close to the forward renderer's base pass */
+static Types::GraphicsPipelineDescription const MakeDescription()
+{
+    Types::GraphicsPipelineDescription Description = {};
+    Description.PipelineLayout = ::MakeHandle<VkPipelineLayout>(0x1000u);
+    Description.RenderPass = ::MakeHandle<VkRenderPass>(0x2000u);
+    Description.SubpassIndex = 0u;
+    Description.VertexShaderHandle = 1u;
+    Description.FragmentShaderHandle = 2u;
+
+    Description.VertexBindingCount = 2u;
+    Description.VertexBindings [0u] = VkVertexInputBindingDescription { 0u, 12u, VK_VERTEX_INPUT_RATE_VERTEX };
+    Description.VertexBindings [1u] = VkVertexInputBindingDescription { 1u, 8u, VK_VERTEX_INPUT_RATE_VERTEX };
+
+    Description.VertexAttributeCount = 2u;
+    Description.VertexAttributes [0u] = VkVertexInputAttributeDescription { 0u, 0u, VK_FORMAT_R32G32B32_SFLOAT, 0u };
+    Description.VertexAttributes [1u] = VkVertexInputAttributeDescription { 1u, 1u, VK_FORMAT_R32G32_SFLOAT, 0u };
+
+    Description.CullMode = VK_CULL_MODE_BACK_BIT;
+
+    Description.ColourAttachmentCount = 1u;
+    Description.ColourBlendState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+    Description.bDepthTestEnable = VK_TRUE;
+    Description.bDepthWriteEnable = VK_TRUE;
+    Description.DepthCompareOp = VK_COMPARE_OP_LESS;
+
+    return Description;
+}
+
+int main()
+{
+    Types::GraphicsPipelineDescription const kBaseDescription = ::MakeDescription();
+
+    uint16 BaseHandle = {};
+    TEST_CHECK(RequestGraphicsPipeline(kBaseDescription, BaseHandle));
+    TEST_CHECK(BaseHandle != 0u);
+
+    /* Same description */
+    {
+        uint16 Handle = {};
+        TEST_CHECK(RequestGraphicsPipeline(kBaseDescription, Handle));
+        TEST_CHECK(Handle == BaseHandle);
+
+        /* Entries past the counts aren't part of the pipeline */
+        Types::GraphicsPipelineDescription Description = kBaseDescription;
+        Description.VertexBindings [3u] = VkVertexInputBindingDescription { 3u, 64u, VK_VERTEX_INPUT_RATE_INSTANCE };
+        Description.VertexAttributes [2u] = VkVertexInputAttributeDescription { 2u, 3u, VK_FORMAT_R32G32B32A32_SFLOAT, 16u };
+
+        TEST_CHECK(RequestGraphicsPipeline(Description, Handle));
+        TEST_CHECK(Handle == BaseHandle);
+
+        /* Nothing is ready without the shaders */
+        VkPipeline Pipeline = {};
+        TEST_CHECK(!GetPipeline(BaseHandle, Pipeline));
+    }
+
+    /* One field different */
+    {
+        std::vector<Types::GraphicsPipelineDescription> Variants = {};
+
+        Types::GraphicsPipelineDescription Description = kBaseDescription;
+        Description.ColourBlendState.blendEnable = VK_TRUE;
+        Variants.push_back(Description);
+
+        Description = kBaseDescription;
+        Description.ColourBlendState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT;
+        Variants.push_back(Description);
+
+        Description = kBaseDescription;
+        Description.DepthCompareOp = VK_COMPARE_OP_EQUAL;
+        Variants.push_back(Description);
+
+        Description = kBaseDescription;
+        Description.bDepthWriteEnable = VK_FALSE;
+        Variants.push_back(Description);
+
+        Description = kBaseDescription;
+        Description.RenderPass = ::MakeHandle<VkRenderPass>(0x3000u);
+        Variants.push_back(Description);
+
+        Description = kBaseDescription;
+        Description.SubpassIndex = 1u;
+        Variants.push_back(Description);
+
+        Description = kBaseDescription;
+        Description.FragmentShaderHandle = 0u;
+        Variants.push_back(Description);
+
+        Description = kBaseDescription;
+        Description.VertexBindings [1u].stride = 16u;
+        Variants.push_back(Description);
+
+        Description = kBaseDescription;
+        Description.VertexAttributes [1u].format = VK_FORMAT_R16G16_SFLOAT;
+        Variants.push_back(Description);
+
+        /* The same entries, only the counts differ */
+        Description = kBaseDescription;
+        Description.VertexAttributeCount = 1u;
+        Variants.push_back(Description);
+
+        Description = kBaseDescription;
+        Description.VertexBindingCount = 1u;
+        Description.VertexAttributeCount = 1u;
+        Variants.push_back(Description);
+
+        Description = kBaseDescription;
+        Description.CullMode = VK_CULL_MODE_NONE;
+        Variants.push_back(Description);
+
+        std::vector<uint16> Handles = { BaseHandle };
+        bool bAllRequested = true;
+
+        for (Types::GraphicsPipelineDescription const & kVariant : Variants)
+        {
+            uint16 Handle = {};
+            bAllRequested &= RequestGraphicsPipeline(kVariant, Handle);
+            Handles.push_back(Handle);
+        }
+
+        TEST_CHECK(bAllRequested);
+
+        bool bAllDistinct = true;
+
+        for (uint32 HandleIndex = {};
+             HandleIndex < Handles.size();
+             HandleIndex++)
+        {
+            for (uint32 OtherHandleIndex = HandleIndex + 1u;
+                 OtherHandleIndex < Handles.size();
+                 OtherHandleIndex++)
+            {
+                bAllDistinct &= Handles [HandleIndex] != Handles [OtherHandleIndex];
+            }
+        }
+
+        TEST_CHECK(bAllDistinct);
+
+        /* Asking again finds each one */
+        bool bAllFound = true;
+
+        for (uint32 VariantIndex = {};
+             VariantIndex < Variants.size();
+             VariantIndex++)
+        {
+            uint16 Handle = {};
+            bAllFound &= RequestGraphicsPipeline(Variants [VariantIndex], Handle) && Handle == Handles [VariantIndex + 1u];
+        }
+
+        TEST_CHECK(bAllFound);
+    }
+
+    /* Invalid descriptions are rejected without taking an entry */
+    {
+        uint16 Handle = {};
+
+        Types::GraphicsPipelineDescription Description = kBaseDescription;
+        Description.VertexShaderHandle = 0u;
+        TEST_CHECK(!RequestGraphicsPipeline(Description, Handle));
+
+        Description = kBaseDescription;
+        Description.VertexBindingCount = Types::kMaximumVertexBindingCount + 1u;
+        TEST_CHECK(!RequestGraphicsPipeline(Description, Handle));
+
+        TEST_CHECK(Handle == 0u);
+    }
+
+    /* Full table */
+    {
+        constexpr uint32 kMaximumPipelineCount = 64u;
+
+        /* Every subpass index past the ones used above is a new pipeline */
+        std::vector<uint16> Handles = {};
+        Types::GraphicsPipelineDescription Description = kBaseDescription;
+
+        for (uint32 SubpassIndex = 2u;
+             SubpassIndex < kMaximumPipelineCount * 2u;
+             SubpassIndex++)
+        {
+            Description.SubpassIndex = SubpassIndex;
+
+            uint16 Handle = {};
+
+            if (!RequestGraphicsPipeline(Description, Handle))
+            {
+                break;
+            }
+
+            Handles.push_back(Handle);
+        }
+
+        /* The base and its variants were already in the table */
+        TEST_CHECK(Handles.size() == kMaximumPipelineCount - 13u);
+        TEST_CHECK(!Handles.empty() && Handles.back() == kMaximumPipelineCount);
+
+        /* Rejected again, not written over an existing entry */
+        uint16 Handle = {};
+        Description.SubpassIndex = kMaximumPipelineCount * 4u;
+        TEST_CHECK(!RequestGraphicsPipeline(Description, Handle));
+        TEST_CHECK(Handle == 0u);
+
+        bool bAllKept = true;
+
+        for (uint32 HandleIndex = {};
+             HandleIndex < Handles.size();
+             HandleIndex++)
+        {
+            Description.SubpassIndex = HandleIndex + 2u;
+            bAllKept &= RequestGraphicsPipeline(Description, Handle) && Handle == Handles [HandleIndex];
+        }
+
+        TEST_CHECK(bAllKept);
+        TEST_CHECK(RequestGraphicsPipeline(kBaseDescription, Handle) && Handle == BaseHandle);
+    }
+
+    return Testing::Finish("PipelineKeyTests");
+}
@@ -0,0 +1,357 @@
+#include "Testing.hpp"
+
+#include <Math/Quantisation.hpp>
+#include <Math/Vector.hpp>
+
+#include <array>
+#include <vector>
+
+/*
+    Error bounds of the vertex encodings, and that the batched encoders give exactly what the single encoders give.
+    Built twice, against MathLib and MathLibScalar, so the SSE2 and scalar paths are held to the same results.
+*/
+
+#ifdef MATH_SCALAR_BUILD
+static char const * const kBuildName = "QuantisationTests (scalar)";
+#else
+static char const * const kBuildName = "QuantisationTests (SSE2)";
+#endif
+
+static std::uint32_t const kSampleCount = { 100000u };
+
+/* One step of 16-bit SNORM is 1 / 32767 along the octahedron, which is at most about 0.0035 degrees of arc */
+static double const kNormalBoundInDegrees = { 0.005 };
+
+/* Y of a tangent has one bit less */
+static double const kTangentBoundInDegrees = { 0.01 };
+
+static double const kPi = { 3.14159265358979323846 };
+
+static Testing::Random Random = {};
+
+static Math::Vector3 const RandomUnitVector()
+{
+    Math::Vector3 Vector = {};
+
+    do
+    {
+        Vector = Math::Vector3 { Random.NextFloat(-1.0f, 1.0f), Random.NextFloat(-1.0f, 1.0f), Random.NextFloat(-1.0f, 1.0f) };
+    }
+    while (Math::Vector3::Length(Vector) < 1.0e-3f);
+
+    return Math::Vector3::Normalize(Vector);
+}
+
+static double const AngleInDegrees(Math::Vector3 const & Left, Math::Vector3 const & Right)
+{
+    double const kDot = static_cast<double>(Left.X) * Right.X + static_cast<double>(Left.Y) * Right.Y + static_cast<double>(Left.Z) * Right.Z;
+    double const kLengths = std::sqrt((static_cast<double>(Left.X) * Left.X + static_cast<double>(Left.Y) * Left.Y + static_cast<double>(Left.Z) * Left.Z)
+                                      * (static_cast<double>(Right.X) * Right.X + static_cast<double>(Right.Y) * Right.Y + static_cast<double>(Right.Z) * Right.Z));
+
+    return std::acos(std::clamp(kDot / kLengths, -1.0, 1.0)) * 180.0 / kPi;
+}
+
+/* What every path must produce, rounding half to even */
+static std::uint16_t const ReferenceQuantise(float const Value, float const Minimum, float const Scale)
+{
+    return static_cast<std::uint16_t>(std::nearbyint(std::clamp((Value - Minimum) * Scale, 0.0f, 65535.0f)));
+}
+
+static std::vector<Math::Vector3> const RandomPositions(std::uint32_t const PositionCount, float const Centre, float const Radius)
+{
+    std::vector<Math::Vector3> Positions = std::vector<Math::Vector3>(PositionCount);
+
+    for (Math::Vector3 & Position : Positions)
+    {
+        Position = Math::Vector3 { Centre + Random.NextFloat(-Radius, Radius), Centre + Random.NextFloat(-Radius, Radius), Centre + Random.NextFloat(-Radius, Radius) };
+    }
+
+    return Positions;
+}
+
+/* Quantises the positions and checks every output against the reference, returns the largest error in quantisation steps */
+static double const CheckQuantisePositions(Math::QuantisationBounds const & Bounds, std::vector<Math::Vector3> const & Positions)
+{
+    static std::uint16_t const kSentinel = { 0xBEEFu };
+
+    std::uint32_t const kPositionCount = static_cast<std::uint32_t>(Positions.size());
+
+    /* One extra position at the end to catch writes past the output */
+    std::vector<std::uint16_t> Quantised = std::vector<std::uint16_t>((kPositionCount + 1u) * 4u, kSentinel);
+    Math::QuantisePositions(Bounds, kPositionCount, Positions.data(), Quantised.data());
+
+    float const kScale = 65535.0f / Bounds.Extent;
+    double const kStep = static_cast<double>(Bounds.Extent) / 65535.0;
+
+    bool bMatchesReference = true;
+    double MaximumSteps = {};
+
+    for (std::uint32_t PositionIndex = {};
+         PositionIndex < kPositionCount;
+         PositionIndex++)
+    {
+        Math::Vector3 const & kPosition = Positions [PositionIndex];
+        std::uint16_t const * const kQuantised = Quantised.data() + (PositionIndex << 2u);
+
+        bMatchesReference &= kQuantised [0u] == ::ReferenceQuantise(kPosition.X, Bounds.Minimum.X, kScale);
+        bMatchesReference &= kQuantised [1u] == ::ReferenceQuantise(kPosition.Y, Bounds.Minimum.Y, kScale);
+        bMatchesReference &= kQuantised [2u] == ::ReferenceQuantise(kPosition.Z, Bounds.Minimum.Z, kScale);
+        bMatchesReference &= kQuantised [3u] == 0u;
+
+        Math::Vector3 const kDequantised = Math::DequantisePosition(Bounds, kQuantised);
+
+        MaximumSteps = std::max(MaximumSteps, std::abs(static_cast<double>(kDequantised.X) - kPosition.X) / kStep);
+        MaximumSteps = std::max(MaximumSteps, std::abs(static_cast<double>(kDequantised.Y) - kPosition.Y) / kStep);
+        MaximumSteps = std::max(MaximumSteps, std::abs(static_cast<double>(kDequantised.Z) - kPosition.Z) / kStep);
+    }
+
+    TEST_CHECK(bMatchesReference);
+    TEST_CHECK(std::all_of(Quantised.end() - 4, Quantised.end(), [](std::uint16_t const Value) { return Value == kSentinel; }));
+
+    return MaximumSteps;
+}
+
+static void TestPositions()
+{
+    /* Ties round to even on every path, and values outside the bounds clamp */
+    {
+        Math::QuantisationBounds const kBounds = Math::QuantisationBounds { Math::Vector3::Zero(), 65535.0f };
+
+        std::vector<Math::Vector3> const kPositions =
+        {
+            Math::Vector3 { 0.5f, 1.5f, 2.5f },
+            Math::Vector3 { 3.5f, 65534.5f, 100.5f },
+            Math::Vector3 { -3.0f, 70000.0f, 65535.0f },
+            Math::Vector3 { 0.0f, 0.49f, 0.51f },
+            Math::Vector3 { 7.5f, 8.5f, 9.5f },
+            Math::Vector3 { 1.0f, 2.0f, 3.0f },
+        };
+
+        std::vector<std::uint16_t> Quantised = std::vector<std::uint16_t>(kPositions.size() * 4u);
+        Math::QuantisePositions(kBounds, static_cast<std::uint32_t>(kPositions.size()), kPositions.data(), Quantised.data());
+
+        std::array<std::uint16_t, 24u> const kExpected =
+        {
+            0u, 2u, 2u, 0u,
+            4u, 65534u, 100u, 0u,
+            0u, 65535u, 65535u, 0u,
+            0u, 0u, 1u, 0u,
+            8u, 8u, 10u, 0u,
+            1u, 2u, 3u, 0u,
+        };
+
+        TEST_CHECK(std::equal(kExpected.begin(), kExpected.end(), Quantised.begin()));
+    }
+
+    double MaximumSteps = {};
+
+    /* Every count up to a few groups of 4, so the batched loop and the remainder are both covered */
+    for (std::uint32_t PositionCount = {};
+         PositionCount < 37u;
+         PositionCount++)
+    {
+        std::vector<Math::Vector3> const kPositions = ::RandomPositions(PositionCount, Random.NextFloat(-100.0f, 100.0f), Random.NextFloat(0.01f, 50.0f));
+        MaximumSteps = std::max(MaximumSteps, ::CheckQuantisePositions(Math::ComputeQuantisationBounds(PositionCount, kPositions.data()), kPositions));
+    }
+
+    /* Large meshes away from the origin lose the most to float rounding */
+    {
+        std::vector<Math::Vector3> const kPositions = ::RandomPositions(kSampleCount, 1000.0f, 500.0f);
+        MaximumSteps = std::max(MaximumSteps, ::CheckQuantisePositions(Math::ComputeQuantisationBounds(kSampleCount, kPositions.data()), kPositions));
+    }
+
+    /* Half a step from rounding, plus the float error of mapping in and out of the bounds */
+    std::printf("%-32s %12.4f %12.4f\n", "Position error (steps)", MaximumSteps, 0.55);
+    TEST_CHECK(MaximumSteps <= 0.55);
+
+    /* A single point or a flat mesh must not divide by zero */
+    {
+        Math::Vector3 const kPoint = Math::Vector3 { 1.0f, 2.0f, 3.0f };
+        Math::QuantisationBounds const kBounds = Math::ComputeQuantisationBounds(1u, &kPoint);
+
+        TEST_CHECK(kBounds.Extent == 1.0f);
+        TEST_CHECK(::CheckQuantisePositions(kBounds, std::vector<Math::Vector3> { kPoint }) == 0.0);
+    }
+}
+
+static std::vector<Math::Vector3> const TestNormalDirections()
+{
+    std::vector<Math::Vector3> Normals = {};
+
+    /* The axes and the octahedron edges and corners, where the fold is */
+    for (float const kX : { -1.0f, 0.0f, 1.0f })
+    {
+        for (float const kY : { -1.0f, 0.0f, 1.0f })
+        {
+            for (float const kZ : { -1.0f, 0.0f, 1.0f })
+            {
+                if (kX != 0.0f || kY != 0.0f || kZ != 0.0f)
+                {
+                    Normals.push_back(Math::Vector3::Normalize(Math::Vector3 { kX, kY, kZ }));
+                }
+            }
+        }
+    }
+
+    /* Not a multiple of 4, so the batched encoders finish with the single encoder */
+    while (Normals.size() < kSampleCount + 3u)
+    {
+        Normals.push_back(::RandomUnitVector());
+    }
+
+    return Normals;
+}
+
+static void TestNormals()
+{
+    std::vector<Math::Vector3> const kNormals = ::TestNormalDirections();
+
+    double MaximumDegrees = {};
+
+    for (Math::Vector3 const & kNormal : kNormals)
+    {
+        MaximumDegrees = std::max(MaximumDegrees, ::AngleInDegrees(kNormal, Math::DecodeOctahedralNormal(Math::EncodeOctahedralNormal(kNormal))));
+    }
+
+    std::printf("%-32s %12.4f %12.4f\n", "Normal error (degrees)", MaximumDegrees, kNormalBoundInDegrees);
+    TEST_CHECK(MaximumDegrees <= kNormalBoundInDegrees);
+
+    std::vector<std::uint32_t> Encoded = std::vector<std::uint32_t>(kNormals.size());
+    Math::EncodeOctahedralNormals(static_cast<std::uint32_t>(kNormals.size()), kNormals.data(), Encoded.data());
+
+    bool bMatchesSingle = true;
+
+    for (std::size_t NormalIndex = {};
+         NormalIndex < kNormals.size();
+         NormalIndex++)
+    {
+        bMatchesSingle &= Encoded [NormalIndex] == Math::EncodeOctahedralNormal(kNormals [NormalIndex]);
+    }
+
+    TEST_CHECK(bMatchesSingle);
+}
+
+static void TestTangents()
+{
+    std::vector<Math::Vector3> const kDirections = ::TestNormalDirections();
+
+    std::vector<Math::Vector4> Tangents = std::vector<Math::Vector4>(kDirections.size());
+
+    for (std::size_t TangentIndex = {};
+         TangentIndex < kDirections.size();
+         TangentIndex++)
+    {
+        Math::Vector3 const & kDirection = kDirections [TangentIndex];
+        Tangents [TangentIndex] = Math::Vector4 { kDirection.X, kDirection.Y, kDirection.Z, (TangentIndex & 1u) ? -1.0f : 1.0f };
+    }
+
+    double MaximumDegrees = {};
+    bool bKeepsSign = true;
+
+    for (Math::Vector4 const & kTangent : Tangents)
+    {
+        Math::Vector4 const kDecoded = Math::DecodeOctahedralTangent(Math::EncodeOctahedralTangent(kTangent));
+
+        MaximumDegrees = std::max(MaximumDegrees, ::AngleInDegrees(Math::Vector3 { kTangent.X, kTangent.Y, kTangent.Z }, Math::Vector3 { kDecoded.X, kDecoded.Y, kDecoded.Z }));
+        bKeepsSign &= kDecoded.W == kTangent.W;
+    }
+
+    std::printf("%-32s %12.4f %12.4f\n", "Tangent error (degrees)", MaximumDegrees, kTangentBoundInDegrees);
+    TEST_CHECK(MaximumDegrees <= kTangentBoundInDegrees);
+    TEST_CHECK(bKeepsSign);
+
+    std::vector<std::uint32_t> Encoded = std::vector<std::uint32_t>(Tangents.size());
+    Math::EncodeOctahedralTangents(static_cast<std::uint32_t>(Tangents.size()), Tangents.data(), Encoded.data());
+
+    bool bMatchesSingle = true;
+
+    for (std::size_t TangentIndex = {};
+         TangentIndex < Tangents.size();
+         TangentIndex++)
+    {
+        bMatchesSingle &= Encoded [TangentIndex] == Math::EncodeOctahedralTangent(Tangents [TangentIndex]);
+    }
+
+    TEST_CHECK(bMatchesSingle);
+}
+
+static void TestHalfs()
+{
+    /* Every half that isn't a NaN survives the round trip exactly */
+    {
+        bool bRoundTrips = true;
+
+        for (std::uint32_t Half = {};
+             Half <= 0xFFFFu;
+             Half++)
+        {
+            bool const kbIsNaN = (Half & 0x7C00u) == 0x7C00u && (Half & 0x3FFu) != 0u;
+
+            if (!kbIsNaN)
+            {
+                bRoundTrips &= Math::FloatToHalf(Math::HalfToFloat(static_cast<std::uint16_t>(Half))) == Half;
+            }
+        }
+
+        TEST_CHECK(bRoundTrips);
+    }
+
+    /* Normal halves keep 11 significant bits, so rounding is within 2^-11 of the value */
+    double MaximumRelativeError = {};
+
+    for (std::uint32_t SampleIndex = {};
+         SampleIndex < kSampleCount;
+         SampleIndex++)
+    {
+        float const kValue = std::ldexp(Random.NextFloat(1.0f, 2.0f), static_cast<int>(Random.NextUint32(30u)) - 14) * ((SampleIndex & 1u) ? -1.0f : 1.0f);
+
+        if (std::abs(kValue) <= 65504.0f)
+        {
+            double const kHalf = static_cast<double>(Math::HalfToFloat(Math::FloatToHalf(kValue)));
+            MaximumRelativeError = std::max(MaximumRelativeError, std::abs(kHalf - kValue) / std::abs(static_cast<double>(kValue)));
+        }
+    }
+
+    std::printf("%-32s %12.6f %12.6f\n", "Half relative error", MaximumRelativeError, std::ldexp(1.0, -11));
+    TEST_CHECK(MaximumRelativeError <= std::ldexp(1.0, -11));
+
+    TEST_CHECK(Math::FloatToHalf(1.0e6f) == 0x7C00u);
+    TEST_CHECK(Math::FloatToHalf(-1.0e6f) == 0xFC00u);
+    TEST_CHECK(Math::FloatToHalf(1.0e-9f) == 0u);
+
+    /* UVs are X in the low half and Y in the high half */
+    {
+        std::vector<Math::Vector3> UVs = std::vector<Math::Vector3>(9u);
+
+        for (Math::Vector3 & UV : UVs)
+        {
+            UV = Math::Vector3 { Random.NextFloat(-2.0f, 2.0f), Random.NextFloat(-2.0f, 2.0f), 0.0f };
+        }
+
+        std::vector<std::uint32_t> Encoded = std::vector<std::uint32_t>(UVs.size());
+        Math::EncodeHalfUVs(static_cast<std::uint32_t>(UVs.size()), UVs.data(), Encoded.data());
+
+        bool bMatchesSingle = true;
+
+        for (std::size_t UVIndex = {};
+             UVIndex < UVs.size();
+             UVIndex++)
+        {
+            bMatchesSingle &= Encoded [UVIndex] == ((static_cast<std::uint32_t>(Math::FloatToHalf(UVs [UVIndex].Y)) << 16u) | Math::FloatToHalf(UVs [UVIndex].X));
+        }
+
+        TEST_CHECK(bMatchesSingle);
+    }
+}
+
+int main()
+{
+    std::printf("%-32s %12s %12s\n", "Encoding", "Max error", "Bound");
+
+    TestPositions();
+    TestNormals();
+    TestTangents();
+    TestHalfs();
+
+    return Testing::Finish(kBuildName);
+}
@@ -0,0 +1,183 @@
+#include "Testing.hpp"
+
+#include "RenderQueue.hpp"
+
+#include <algorithm>
+#include <vector>
+
+/*
+    Times building and sorting 100K sort keys shaped like a frame's draws, and checks Sort against std::stable_sort for
+        - Frame keys, where the pass, pipeline and high handle bits are the same in every key
+        - Random 64 bit keys, too many live bits to pack with the entry index
+        - Small queues and queues where every key is the same
+*/
+
+static uint32 const kDrawCount = { 100000u };
+static uint32 const kRepeatCount = { 20u };
+
+/* A frame's keys should sort in a fraction of a millisecond on a desktop. Absolute times depend on the machine, so the check is against std::stable_sort of the same keys on the same machine */
+static double const kMinimumSpeedUpOverStableSort = { 3.0 };
+
+static Testing::Random Random = {};
+
+/* Sorts a copy of the keys and checks the keys are in order, with equal keys keeping the order they were pushed in */
+static bool const IsSortedLikeStableSort(std::vector<uint64> const & SortKeys)
+{
+    RenderQueue::Types::QueueData Queue = {};
+
+    for (uint32 EntryIndex = {};
+         EntryIndex < SortKeys.size();
+         EntryIndex++)
+    {
+        RenderQueue::Push(Queue, SortKeys [EntryIndex], EntryIndex);
+    }
+
+    RenderQueue::Sort(Queue);
+
+    std::vector<uint32> ExpectedValues = std::vector<uint32>(SortKeys.size());
+
+    for (uint32 EntryIndex = {};
+         EntryIndex < SortKeys.size();
+         EntryIndex++)
+    {
+        ExpectedValues [EntryIndex] = EntryIndex;
+    }
+
+    std::stable_sort(ExpectedValues.begin(), ExpectedValues.end(), [&SortKeys](uint32 const Left, uint32 const Right)
+                     {
+                         return SortKeys [Left] < SortKeys [Right];
+                     });
+
+    bool bKeysMatch = Queue.SortKeys.size() == SortKeys.size();
+
+    for (uint32 EntryIndex = {};
+         bKeysMatch && EntryIndex < SortKeys.size();
+         EntryIndex++)
+    {
+        bKeysMatch &= Queue.SortKeys [EntryIndex] == SortKeys [ExpectedValues [EntryIndex]];
+    }
+
+    return bKeysMatch && Queue.Values == ExpectedValues;
+}
+
+int main()
+{
+    /* Material, mesh and depth per draw, with a few hundred materials and a couple of thousand meshes like a large scene */
+    std::vector<uint32> MaterialHandles = std::vector<uint32>(kDrawCount);
+    std::vector<uint32> MeshHandles = std::vector<uint32>(kDrawCount);
+    std::vector<float> Depths = std::vector<float>(kDrawCount);
+
+    for (uint32 DrawIndex = {};
+         DrawIndex < kDrawCount;
+         DrawIndex++)
+    {
+        MaterialHandles [DrawIndex] = 1u + Random.NextUint32(300u);
+        MeshHandles [DrawIndex] = 1u + Random.NextUint32(2000u);
+        Depths [DrawIndex] = Random.NextFloat(0.1f, 1000.0f);
+    }
+
+    RenderQueue::Types::QueueData Queue = {};
+
+    double const kBuildInNanoseconds = Testing::MeasureNanoseconds(kRepeatCount, [&]()
+                                                                   {
+                                                                       RenderQueue::Clear(Queue);
+
+                                                                       for (uint32 DrawIndex = {};
+                                                                            DrawIndex < kDrawCount;
+                                                                            DrawIndex++)
+                                                                       {
+                                                                           uint64 const kSortKey = RenderQueue::MakeSortKey(RenderQueue::Types::Passes::Opaque, 0u,
+                                                                                                                            MaterialHandles [DrawIndex], MeshHandles [DrawIndex],
+                                                                                                                            RenderQueue::GetDepthBucket(Depths [DrawIndex], 0.1f, 1000.0f));
+
+                                                                           RenderQueue::Push(Queue, kSortKey, DrawIndex);
+                                                                       }
+                                                                   });
+
+    std::vector<uint64> const kFrameSortKeys = Queue.SortKeys;
+
+    /* Sort works in place, so every repeat starts from a copy of the unsorted keys. The queue is reused like the renderer's, so its scratch memory is already there */
+    RenderQueue::Types::QueueData SortedQueue = {};
+    double BestSortInNanoseconds = std::numeric_limits<double>::max();
+
+    for (uint32 RepeatIndex = {};
+         RepeatIndex < kRepeatCount;
+         RepeatIndex++)
+    {
+        SortedQueue.SortKeys = Queue.SortKeys;
+        SortedQueue.Values = Queue.Values;
+
+        BestSortInNanoseconds = std::min(BestSortInNanoseconds, Testing::MeasureNanoseconds(1u, [&SortedQueue]()
+                                                                                            {
+                                                                                                RenderQueue::Sort(SortedQueue);
+                                                                                            }));
+    }
+
+    /* The entry indices sorted by key, which is what Sort has to produce */
+    std::vector<uint32> EntryIndices = std::vector<uint32>(kDrawCount);
+    double BestStableSortInNanoseconds = std::numeric_limits<double>::max();
+
+    for (uint32 RepeatIndex = {};
+         RepeatIndex < kRepeatCount;
+         RepeatIndex++)
+    {
+        EntryIndices = Queue.Values;
+
+        BestStableSortInNanoseconds = std::min(BestStableSortInNanoseconds, Testing::MeasureNanoseconds(1u, [&EntryIndices, &kFrameSortKeys]()
+                                                                                                        {
+                                                                                                            std::stable_sort(EntryIndices.begin(), EntryIndices.end(), [&kFrameSortKeys](uint32 const Left, uint32 const Right)
+                                                                                                                             {
+                                                                                                                                 return kFrameSortKeys [Left] < kFrameSortKeys [Right];
+                                                                                                                             });
+                                                                                                        }));
+    }
+
+    std::printf("%-40s %12.3f ms\n", "Build 100K keys", kBuildInNanoseconds * 1.0e-6);
+    std::printf("%-40s %12.3f ms\n", "Sort 100K keys", BestSortInNanoseconds * 1.0e-6);
+    std::printf("%-40s %12.3f ms\n", "std::stable_sort 100K keys", BestStableSortInNanoseconds * 1.0e-6);
+
+    if (Testing::IsOptimisedBuild())
+    {
+        TEST_CHECK(BestSortInNanoseconds * kMinimumSpeedUpOverStableSort < BestStableSortInNanoseconds);
+    }
+
+    TEST_CHECK(::IsSortedLikeStableSort(kFrameSortKeys));
+
+    /* Every bit can differ, so the values are sorted alongside the keys */
+    {
+        std::vector<uint64> RandomSortKeys = std::vector<uint64>(kDrawCount);
+
+        for (uint64 & SortKey : RandomSortKeys)
+        {
+            SortKey = Random.Next();
+        }
+
+        /* Some duplicates, to check equal keys stay in order */
+        for (uint32 DuplicateIndex = {};
+             DuplicateIndex < kDrawCount / 10u;
+             DuplicateIndex++)
+        {
+            RandomSortKeys [Random.NextUint32(kDrawCount)] = RandomSortKeys [Random.NextUint32(kDrawCount)];
+        }
+
+        TEST_CHECK(::IsSortedLikeStableSort(RandomSortKeys));
+    }
+
+    /* Few entries, few live bits, and nothing to sort at all */
+    for (uint32 EntryCount = {};
+         EntryCount < 40u;
+         EntryCount++)
+    {
+        std::vector<uint64> SmallSortKeys = std::vector<uint64>(EntryCount);
+
+        for (uint64 & SortKey : SmallSortKeys)
+        {
+            SortKey = (uint64 { 0xABCu } << 40u) | (Random.Next() & 7u);
+        }
+
+        TEST_CHECK(::IsSortedLikeStableSort(SmallSortKeys));
+        TEST_CHECK(::IsSortedLikeStableSort(std::vector<uint64>(EntryCount, 0x1234u)));
+    }
+
+    return Testing::Finish("RenderQueueTests");
+}
@@ -0,0 +1,233 @@
+#include "Testing.hpp"
+
+#include "RenderSnapshot.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+/*
+    Runs the snapshot queue between a producer and a consumer thread, as the simulation and render threads do.
+        - Every snapshot is read once, in the order it was published
+        - A snapshot is never handed back to the producer while the consumer is still reading it, and its contents don't change under the reader
+        - Both ends sleep rather than fail while the other catches up, and wake when the queue is closed
+        - Reads wait while minimised, and a reader waiting for the window to be minimised is woken
+*/
+
+using namespace RenderSnapshot;
+
+/* The sequence number is kept in TransformSlotCount, the slots hold a payload whose size varies so the vectors are reallocated */
+static void WriteSnapshot(uint32 const kSequenceNumber, Types::FrameSnapshot & Snapshot)
+{
+    Snapshot.TransformSlotCount = kSequenceNumber;
+    Snapshot.InstanceTransformSlots.assign(kSequenceNumber % 61u + 1u, kSequenceNumber);
+}
+
+static bool const IsSnapshotIntact(uint32 const kSequenceNumber, Types::FrameSnapshot const & kSnapshot)
+{
+    bool bIntact = kSnapshot.TransformSlotCount == kSequenceNumber && kSnapshot.InstanceTransformSlots.size() == kSequenceNumber % 61u + 1u;
+
+    for (uint32 const kSlot : kSnapshot.InstanceTransformSlots)
+    {
+        bIntact &= kSlot == kSequenceNumber;
+    }
+
+    return bIntact;
+}
+
+int main()
+{
+    constexpr uint32 kTimeoutInMilliseconds = 10000u;
+
+    /* Producer and consumer */
+    {
+        constexpr uint32 kSnapshotCount = 20000u;
+
+        static Types::SnapshotQueue Queue = {};
+
+        /* The sequence number the consumer is reading, zero when it isn't */
+        std::atomic<uint32> ReadingSequenceNumber = {};
+
+        bool bProducerNeverTimedOut = true;
+        bool bNoSnapshotReused = true;
+
+        std::thread Producer = std::thread([&]()
+        {
+            for (uint32 SequenceNumber = 1u;
+                 SequenceNumber <= kSnapshotCount;
+                 SequenceNumber++)
+            {
+                Types::FrameSnapshot * Snapshot = {};
+
+                if (!WaitToWrite(Queue, kTimeoutInMilliseconds, Snapshot))
+                {
+                    bProducerNeverTimedOut = false;
+                    break;
+                }
+
+                /* The snapshot still holds whatever was written to it two publishes ago, which the consumer must be done with */
+                bNoSnapshotReused &= Snapshot->TransformSlotCount == 0u || Snapshot->TransformSlotCount != ReadingSequenceNumber.load();
+
+                ::WriteSnapshot(SequenceNumber, *Snapshot);
+                EndWrite(Queue);
+            }
+        });
+
+        uint32 ReadCount = {};
+        bool bInOrder = true;
+        bool bIntact = true;
+
+        for (uint32 ExpectedSequenceNumber = 1u;
+             ExpectedSequenceNumber <= kSnapshotCount;
+             ExpectedSequenceNumber++)
+        {
+            Types::FrameSnapshot const * Snapshot = {};
+
+            if (!WaitToRead(Queue, Snapshot))
+            {
+                break;
+            }
+
+            ReadingSequenceNumber.store(Snapshot->TransformSlotCount);
+
+            bInOrder &= Snapshot->TransformSlotCount == ExpectedSequenceNumber;
+            bIntact &= ::IsSnapshotIntact(ExpectedSequenceNumber, *Snapshot);
+
+            /* Reading slowly now and then, so the producer fills the queue and has to wait */
+            if (ExpectedSequenceNumber % 512u == 0u)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1u));
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+
+            bIntact &= ::IsSnapshotIntact(ExpectedSequenceNumber, *Snapshot);
+
+            ReadingSequenceNumber.store(0u);
+            EndRead(Queue);
+
+            ReadCount++;
+        }
+
+        Producer.join();
+
+        TEST_CHECK(bProducerNeverTimedOut);
+        TEST_CHECK(ReadCount == kSnapshotCount);
+        TEST_CHECK(bInOrder);
+        TEST_CHECK(bIntact);
+        TEST_CHECK(bNoSnapshotReused);
+
+        /* Nothing left over */
+        Types::FrameSnapshot const * Snapshot = {};
+        TEST_CHECK(!BeginRead(Queue, Snapshot));
+    }
+
+    /* A full queue times out the writer, and closing wakes a reader waiting on an empty one */
+    {
+        static Types::SnapshotQueue Queue = {};
+
+        Types::FrameSnapshot * WritableSnapshot = {};
+
+        TEST_CHECK(WaitToWrite(Queue, 0u, WritableSnapshot));
+        EndWrite(Queue);
+        TEST_CHECK(WaitToWrite(Queue, 0u, WritableSnapshot));
+        EndWrite(Queue);
+
+        std::chrono::steady_clock::time_point const kBeginTime = std::chrono::steady_clock::now();
+        TEST_CHECK(!WaitToWrite(Queue, 20u, WritableSnapshot));
+        TEST_CHECK(std::chrono::steady_clock::now() - kBeginTime >= std::chrono::milliseconds(20u));
+
+        Types::FrameSnapshot const * ReadableSnapshot = {};
+
+        TEST_CHECK(WaitToRead(Queue, ReadableSnapshot));
+        EndRead(Queue);
+        TEST_CHECK(WaitToRead(Queue, ReadableSnapshot));
+        EndRead(Queue);
+
+        std::atomic<bool> bReaderReturned = {};
+        bool bReadAfterClose = true;
+
+        std::thread Reader = std::thread([&]()
+        {
+            Types::FrameSnapshot const * Snapshot = {};
+            bReadAfterClose = WaitToRead(Queue, Snapshot);
+            bReaderReturned = true;
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20u));
+        TEST_CHECK(!bReaderReturned);
+
+        Close(Queue);
+        Reader.join();
+
+        TEST_CHECK(!bReadAfterClose);
+        TEST_CHECK(!WaitToWrite(Queue, kTimeoutInMilliseconds, WritableSnapshot));
+    }
+
+    /* Minimised */
+    {
+        static Types::SnapshotQueue Queue = {};
+
+        Types::FrameSnapshot * WritableSnapshot = {};
+
+        TEST_CHECK(WaitToWrite(Queue, 0u, WritableSnapshot));
+        ::WriteSnapshot(1u, *WritableSnapshot);
+        EndWrite(Queue);
+
+        SetMinimised(Queue, true);
+
+        /* Already minimised, so this returns straight away */
+        std::chrono::steady_clock::time_point const kBeginTime = std::chrono::steady_clock::now();
+        WaitForMinimised(Queue, kTimeoutInMilliseconds);
+        TEST_CHECK(std::chrono::steady_clock::now() - kBeginTime < std::chrono::milliseconds(kTimeoutInMilliseconds));
+
+        std::atomic<bool> bReaderReturned = {};
+        bool bReadIntact = false;
+
+        std::thread Reader = std::thread([&]()
+        {
+            Types::FrameSnapshot const * Snapshot = {};
+
+            if (WaitToRead(Queue, Snapshot))
+            {
+                bReadIntact = ::IsSnapshotIntact(1u, *Snapshot);
+                EndRead(Queue);
+            }
+
+            bReaderReturned = true;
+        });
+
+        /* A snapshot is waiting, but nothing is read until the window is restored */
+        std::this_thread::sleep_for(std::chrono::milliseconds(20u));
+        TEST_CHECK(!bReaderReturned);
+
+        SetMinimised(Queue, false);
+        Reader.join();
+
+        TEST_CHECK(bReadIntact);
+
+        /* A render thread that failed a frame is woken once the simulation thread sees the window was minimised */
+        std::atomic<bool> bWaiterReturned = {};
+
+        std::thread Waiter = std::thread([&]()
+        {
+            WaitForMinimised(Queue, kTimeoutInMilliseconds);
+            bWaiterReturned = true;
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20u));
+        TEST_CHECK(!bWaiterReturned);
+
+        std::chrono::steady_clock::time_point const kMinimiseTime = std::chrono::steady_clock::now();
+        SetMinimised(Queue, true);
+        Waiter.join();
+
+        TEST_CHECK(std::chrono::steady_clock::now() - kMinimiseTime < std::chrono::milliseconds(kTimeoutInMilliseconds));
+
+        Close(Queue);
+    }
+
+    return Testing::Finish("RenderSnapshotQueueTests");
+}
@@ -0,0 +1,291 @@
+#include "Testing.hpp"
+
+#include "Jobs.hpp"
+#include "Scene.hpp"
+#include "SpatialIndex.hpp"
+
+#include <Math/Affine.hpp>
+#include <Math/Transform.hpp>
+
+#include <vector>
+
+/*
+    Times building, refitting and querying the spatial index over 100K random boxes, and checks every query against a brute force
+    loop over all of the boxes. The index is driven through UpdateActor directly, so no scene or meshes are needed.
+*/
+
+static uint32 const kActorCount = { 100000u };
+static uint32 const kQueryCount = { 256u };
+static uint32 const kRepeatCount = { 5u };
+
+static float const kWorldExtent = { 500.0f };
+
+static Testing::Random Random = {};
+
+static Math::AABB const RandomBounds(Math::Vector3 const & Centre)
+{
+    Math::Vector3 const kHalfExtent = Math::Vector3 { Random.NextFloat(0.1f, 4.0f), Random.NextFloat(0.1f, 4.0f), Random.NextFloat(0.1f, 4.0f) };
+
+    return Math::AABB { Centre - kHalfExtent, Centre + kHalfExtent };
+}
+
+static Math::Vector3 const RandomPoint(float const Extent)
+{
+    return Math::Vector3 { Random.NextFloat(-Extent, Extent), Random.NextFloat(-Extent, Extent), Random.NextFloat(-Extent, Extent) };
+}
+
+/* Runs overlap, frustum and ray queries against the index and checks each one against testing every box */
+static void CheckQueries(std::vector<uint32> const & ActorHandles, std::vector<Math::AABB> const & ActorBounds)
+{
+    std::vector<Math::AABB> QueryBounds = std::vector<Math::AABB>(kQueryCount);
+    std::vector<Math::FrustumPlanes> QueryPlanes = std::vector<Math::FrustumPlanes>(kQueryCount);
+    std::vector<Math::Vector3> RayOrigins = std::vector<Math::Vector3>(kQueryCount);
+    std::vector<Math::Vector3> RayDirections = std::vector<Math::Vector3>(kQueryCount);
+
+    for (uint32 QueryIndex = {};
+         QueryIndex < kQueryCount;
+         QueryIndex++)
+    {
+        Math::Vector3 const kCentre = ::RandomPoint(kWorldExtent);
+        Math::Vector3 const kHalfExtent = Math::Vector3 { 20.0f, 20.0f, 20.0f };
+        QueryBounds [QueryIndex] = Math::AABB { kCentre - kHalfExtent, kCentre + kHalfExtent };
+
+        /* A camera at a random point turned about Z, so the frustum crosses part of the world */
+        Math::Matrix4x4 const kViewMatrix = Math::RotateZAxis(Random.NextFloat(-180.0f, 180.0f)) * Math::Affine3x4::ToMatrix4x4(Math::Affine3x4::TranslationScale(::RandomPoint(kWorldExtent * 0.5f) * -1.0f, 1.0f));
+        Math::ExtractFrustumPlanes(Math::PerspectiveMatrix(1.2f, 16.0f / 9.0f, 0.1f, 200.0f) * kViewMatrix, QueryPlanes [QueryIndex]);
+
+        RayOrigins [QueryIndex] = ::RandomPoint(kWorldExtent);
+        RayDirections [QueryIndex] = Math::Vector3::Normalize(::RandomPoint(1.0f));
+    }
+
+    std::vector<std::vector<uint32>> OverlapResults = std::vector<std::vector<uint32>>(kQueryCount);
+    std::vector<std::vector<uint32>> FrustumResults = std::vector<std::vector<uint32>>(kQueryCount);
+    std::vector<SpatialIndex::Types::RayHit> RayHits = std::vector<SpatialIndex::Types::RayHit>(kQueryCount);
+    std::vector<uint8> HasRayHits = std::vector<uint8>(kQueryCount);
+
+    double const kOverlapInNanoseconds = Testing::MeasureNanoseconds(kRepeatCount, [&QueryBounds, &OverlapResults]()
+                                                                     {
+                                                                         for (uint32 QueryIndex = {};
+                                                                              QueryIndex < kQueryCount;
+                                                                              QueryIndex++)
+                                                                         {
+                                                                             OverlapResults [QueryIndex].clear();
+                                                                             SpatialIndex::QueryOverlap(QueryBounds [QueryIndex], OverlapResults [QueryIndex]);
+                                                                         }
+                                                                     }) / kQueryCount;
+
+    double const kFrustumInNanoseconds = Testing::MeasureNanoseconds(kRepeatCount, [&QueryPlanes, &FrustumResults]()
+                                                                     {
+                                                                         for (uint32 QueryIndex = {};
+                                                                              QueryIndex < kQueryCount;
+                                                                              QueryIndex++)
+                                                                         {
+                                                                             FrustumResults [QueryIndex].clear();
+                                                                             SpatialIndex::QueryFrustum(QueryPlanes [QueryIndex], FrustumResults [QueryIndex]);
+                                                                         }
+                                                                     }) / kQueryCount;
+
+    double const kRayCastInNanoseconds = Testing::MeasureNanoseconds(kRepeatCount, [&RayOrigins, &RayDirections, &RayHits, &HasRayHits]()
+                                                                     {
+                                                                         for (uint32 QueryIndex = {};
+                                                                              QueryIndex < kQueryCount;
+                                                                              QueryIndex++)
+                                                                         {
+                                                                             HasRayHits [QueryIndex] = static_cast<uint8>(SpatialIndex::RayCast(RayOrigins [QueryIndex], RayDirections [QueryIndex], kWorldExtent, RayHits [QueryIndex]));
+                                                                         }
+                                                                     }) / kQueryCount;
+
+    bool bOverlapsMatch = true;
+    bool bFrustumsMatch = true;
+    bool bRayHitsMatch = true;
+
+    uint64 OverlapCount = {};
+    uint64 FrustumCount = {};
+    uint32 RayHitCount = {};
+
+    std::vector<uint32> Expected = {};
+
+    double const kBruteForceInNanoseconds = Testing::MeasureNanoseconds(1u, [&]()
+                                                                        {
+                                                                            for (uint32 QueryIndex = {};
+                                                                                 QueryIndex < kQueryCount;
+                                                                                 QueryIndex++)
+                                                                            {
+                                                                                Expected.clear();
+
+                                                                                for (uint32 ActorIndex = {};
+                                                                                     ActorIndex < ActorBounds.size();
+                                                                                     ActorIndex++)
+                                                                                {
+                                                                                    if (Math::AABB::Overlaps(ActorBounds [ActorIndex], QueryBounds [QueryIndex]))
+                                                                                    {
+                                                                                        Expected.push_back(ActorHandles [ActorIndex]);
+                                                                                    }
+                                                                                }
+
+                                                                                std::sort(OverlapResults [QueryIndex].begin(), OverlapResults [QueryIndex].end());
+                                                                                bOverlapsMatch &= OverlapResults [QueryIndex] == Expected;
+                                                                                OverlapCount += Expected.size();
+
+                                                                                Expected.clear();
+
+                                                                                for (uint32 ActorIndex = {};
+                                                                                     ActorIndex < ActorBounds.size();
+                                                                                     ActorIndex++)
+                                                                                {
+                                                                                    if (Math::TestFrustumAABB(QueryPlanes [QueryIndex], ActorBounds [ActorIndex]) != Math::FrustumTestResults::Outside)
+                                                                                    {
+                                                                                        Expected.push_back(ActorHandles [ActorIndex]);
+                                                                                    }
+                                                                                }
+
+                                                                                std::sort(FrustumResults [QueryIndex].begin(), FrustumResults [QueryIndex].end());
+                                                                                bFrustumsMatch &= FrustumResults [QueryIndex] == Expected;
+                                                                                FrustumCount += Expected.size();
+
+                                                                                /* Several boxes can share the closest distance, so only the distance is compared */
+                                                                                Math::Vector3 const & kDirection = RayDirections [QueryIndex];
+                                                                                Math::Vector3 const kInverseDirection = { 1.0f / kDirection.X, 1.0f / kDirection.Y, 1.0f / kDirection.Z };
+
+                                                                                bool bExpectedHit = false;
+                                                                                float ClosestDistance = { kWorldExtent };
+
+                                                                                for (uint32 ActorIndex = {};
+                                                                                     ActorIndex < ActorBounds.size();
+                                                                                     ActorIndex++)
+                                                                                {
+                                                                                    float Distance = {};
+
+                                                                                    if (Math::IntersectRayAABB(RayOrigins [QueryIndex], kInverseDirection, ClosestDistance, ActorBounds [ActorIndex], Distance))
+                                                                                    {
+                                                                                        bExpectedHit = true;
+                                                                                        ClosestDistance = Distance;
+                                                                                    }
+                                                                                }
+
+                                                                                bRayHitsMatch &= static_cast<bool>(HasRayHits [QueryIndex]) == bExpectedHit;
+                                                                                bRayHitsMatch &= !bExpectedHit || RayHits [QueryIndex].Distance == ClosestDistance;
+                                                                                RayHitCount += bExpectedHit ? 1u : 0u;
+                                                                            }
+                                                                        });
+
+    std::printf("%-40s %12.3f us (%.1f actors)\n", "  Overlap query", kOverlapInNanoseconds * 1.0e-3, static_cast<double>(OverlapCount) / kQueryCount);
+    std::printf("%-40s %12.3f us (%.1f actors)\n", "  Frustum query", kFrustumInNanoseconds * 1.0e-3, static_cast<double>(FrustumCount) / kQueryCount);
+    std::printf("%-40s %12.3f us (%u of %u hit)\n", "  Ray cast", kRayCastInNanoseconds * 1.0e-3, RayHitCount, kQueryCount);
+    std::printf("%-40s %12.3f us\n", "  Brute force, all three", kBruteForceInNanoseconds * 1.0e-3 / kQueryCount);
+
+    TEST_CHECK(bOverlapsMatch);
+    TEST_CHECK(bFrustumsMatch);
+    TEST_CHECK(bRayHitsMatch);
+
+    /* Queries that find nothing would match brute force without testing anything */
+    TEST_CHECK(OverlapCount > 0u);
+    TEST_CHECK(FrustumCount > 0u);
+    TEST_CHECK(RayHitCount > 0u);
+}
+
+int main()
+{
+    Jobs::Initialise();
+
+    std::vector<uint32> ActorHandles = std::vector<uint32>(kActorCount);
+    std::vector<Math::AABB> ActorBounds = std::vector<Math::AABB>(kActorCount);
+
+    for (uint32 ActorIndex = {};
+         ActorIndex < kActorCount;
+         ActorIndex++)
+    {
+        ActorHandles [ActorIndex] = Scene::MakeActorHandle(ActorIndex, 0u);
+        ActorBounds [ActorIndex] = ::RandomBounds(::RandomPoint(kWorldExtent));
+    }
+
+    /* Inserting one at a time, then the binned SAH rebuild a level load uses */
+    {
+        double const kInsertInNanoseconds = Testing::MeasureNanoseconds(1u, [&ActorHandles, &ActorBounds]()
+                                                                        {
+                                                                            for (uint32 ActorIndex = {};
+                                                                                 ActorIndex < kActorCount;
+                                                                                 ActorIndex++)
+                                                                            {
+                                                                                SpatialIndex::UpdateActor(ActorHandles [ActorIndex], ActorBounds [ActorIndex]);
+                                                                            }
+                                                                        });
+
+        TEST_CHECK(SpatialIndex::GetActorCount() == kActorCount);
+
+        float const kInsertedTreeCost = SpatialIndex::GetTreeCost();
+
+        double const kRebuildInNanoseconds = Testing::MeasureNanoseconds(kRepeatCount, []()
+                                                                         {
+                                                                             SpatialIndex::Rebuild();
+                                                                         });
+
+        std::printf("%-40s %12.3f ms (cost %.1f)\n", "Insert 100K actors", kInsertInNanoseconds * 1.0e-6, kInsertedTreeCost);
+        std::printf("%-40s %12.3f ms (cost %.1f)\n", "Rebuild 100K actors", kRebuildInNanoseconds * 1.0e-6, SpatialIndex::GetTreeCost());
+
+        TEST_CHECK(SpatialIndex::GetActorCount() == kActorCount);
+        ::CheckQueries(ActorHandles, ActorBounds);
+    }
+
+    /* Small movements stay inside the enlarged leaf bounds, large ones remove and reinsert the leaf */
+    {
+        double const kSmallMoveInNanoseconds = Testing::MeasureNanoseconds(1u, [&ActorHandles, &ActorBounds]()
+                                                                           {
+                                                                               for (uint32 ActorIndex = {};
+                                                                                    ActorIndex < kActorCount;
+                                                                                    ActorIndex++)
+                                                                               {
+                                                                                   Math::Vector3 const kOffset = ::RandomPoint(0.01f);
+
+                                                                                   ActorBounds [ActorIndex] = Math::AABB { ActorBounds [ActorIndex].Minimum + kOffset, ActorBounds [ActorIndex].Maximum + kOffset };
+                                                                                   SpatialIndex::UpdateActor(ActorHandles [ActorIndex], ActorBounds [ActorIndex]);
+                                                                               }
+                                                                           });
+
+        double const kLargeMoveInNanoseconds = Testing::MeasureNanoseconds(1u, [&ActorHandles, &ActorBounds]()
+                                                                           {
+                                                                               for (uint32 MoveIndex = {};
+                                                                                    MoveIndex < kActorCount / 10u;
+                                                                                    MoveIndex++)
+                                                                               {
+                                                                                   uint32 const kActorIndex = Random.NextUint32(kActorCount);
+
+                                                                                   ActorBounds [kActorIndex] = ::RandomBounds(::RandomPoint(kWorldExtent));
+                                                                                   SpatialIndex::UpdateActor(ActorHandles [kActorIndex], ActorBounds [kActorIndex]);
+                                                                               }
+                                                                           });
+
+        std::printf("%-40s %12.3f ms\n", "Refit, every actor moved slightly", kSmallMoveInNanoseconds * 1.0e-6);
+        std::printf("%-40s %12.3f ms (cost %.1f)\n", "Reinsert, 10% moved anywhere", kLargeMoveInNanoseconds * 1.0e-6, SpatialIndex::GetTreeCost());
+
+        ::CheckQueries(ActorHandles, ActorBounds);
+    }
+
+    /* Removing actors leaves the queries finding only the rest */
+    {
+        std::vector<uint32> KeptActorHandles = {};
+        std::vector<Math::AABB> KeptActorBounds = {};
+
+        for (uint32 ActorIndex = {};
+             ActorIndex < kActorCount;
+             ActorIndex++)
+        {
+            if (ActorIndex & 1u)
+            {
+                KeptActorHandles.push_back(ActorHandles [ActorIndex]);
+                KeptActorBounds.push_back(ActorBounds [ActorIndex]);
+            }
+            else
+            {
+                SpatialIndex::RemoveActor(ActorHandles [ActorIndex]);
+            }
+        }
+
+        TEST_CHECK(SpatialIndex::GetActorCount() == kActorCount / 2u);
+        ::CheckQueries(KeptActorHandles, KeptActorBounds);
+    }
+
+    Jobs::Destroy();
+
+    return Testing::Finish("SpatialIndexTests");
+}
@@ -0,0 +1,234 @@
+#include "Testing.hpp"
+
+#include "Components/TransformComponent.hpp"
+#include "Jobs.hpp"
+#include "Scene.hpp"
+
+#include <cstring>
+#include <vector>
+
+/*
+    Times UpdateWorldTransforms over a 100K node hierarchy and checks every world transform against a naive walk up the parents.
+    The hierarchy is a random tree plus a long chain, so there are both wide levels and deep ones, and parents are created after
+    some of their children so the nodes have to be reordered.
+*/
+
+using namespace Components;
+
+static uint32 const kNodeCount = { 100000u };
+static uint32 const kChainLength = { 1000u };
+static uint32 const kRepeatCount = { 5u };
+
+static Testing::Random Random = {};
+
+/* Recomputes the world transform from the actor's own local transform and its parents', with nothing cached */
+static Math::Affine3x4 const NaiveWorldTransform(uint32 const ActorHandle)
+{
+    Transform::TransformData Data = {};
+    Transform::GetTransform(ActorHandle, Data);
+
+    Math::Affine3x4 const kLocalTransform = Math::Affine3x4::TranslationScale(Data.Position, Data.Scale);
+
+    uint32 ParentActorHandle = {};
+    Transform::GetParent(ActorHandle, ParentActorHandle);
+
+    return ParentActorHandle == 0u ? kLocalTransform : ::NaiveWorldTransform(ParentActorHandle) * kLocalTransform;
+}
+
+/* The update does the same multiplications in the same order, so the results must match exactly */
+static void CheckWorldTransforms(Scene::SceneData const & Scene, std::vector<uint32> const & ActorHandles)
+{
+    bool bMatchesNaive = true;
+
+    double const kNaiveInNanoseconds = Testing::MeasureNanoseconds(1u, [&Scene, &ActorHandles, &bMatchesNaive]()
+                                                                   {
+                                                                       for (uint32 const kActorHandle : ActorHandles)
+                                                                       {
+                                                                           if (!Scene::IsActorValid(Scene, kActorHandle))
+                                                                           {
+                                                                               continue;
+                                                                           }
+
+                                                                           Math::Affine3x4 WorldTransform = {};
+                                                                           Transform::GetTransformationMatrix(kActorHandle, WorldTransform);
+
+                                                                           Math::Affine3x4 const kNaiveTransform = ::NaiveWorldTransform(kActorHandle);
+
+                                                                           bMatchesNaive &= std::memcmp(WorldTransform.Data.data(), kNaiveTransform.Data.data(), sizeof(float) * kNaiveTransform.Data.size()) == 0;
+                                                                       }
+                                                                   });
+
+    std::printf("%-40s %12.3f ms\n", "  Naive parent walk", kNaiveInNanoseconds * 1.0e-6);
+
+    TEST_CHECK(bMatchesNaive);
+}
+
+/* Times the update after Dirty has marked some transforms, best of several runs */
+template<typename DirtyFunctionType>
+static void MeasureUpdate(char const * const Name, DirtyFunctionType && Dirty)
+{
+    double BestTimeInNanoseconds = std::numeric_limits<double>::max();
+
+    for (uint32 RepeatIndex = {};
+         RepeatIndex < kRepeatCount;
+         RepeatIndex++)
+    {
+        Dirty();
+
+        BestTimeInNanoseconds = std::min(BestTimeInNanoseconds, Testing::MeasureNanoseconds(1u, []()
+                                                                                            {
+                                                                                                Transform::UpdateWorldTransforms();
+                                                                                            }));
+    }
+
+    std::printf("%-40s %12.3f ms\n", Name, BestTimeInNanoseconds * 1.0e-6);
+}
+
+int main()
+{
+    Jobs::Initialise();
+
+    Scene::SceneData Scene = {};
+
+    std::vector<Math::Vector3> Positions = std::vector<Math::Vector3>(kNodeCount);
+    std::vector<float> Scales = std::vector<float>(kNodeCount);
+
+    for (uint32 NodeIndex = {};
+         NodeIndex < kNodeCount;
+         NodeIndex++)
+    {
+        Positions [NodeIndex] = Math::Vector3 { Random.NextFloat(-10.0f, 10.0f), Random.NextFloat(-10.0f, 10.0f), Random.NextFloat(-10.0f, 10.0f) };
+        Scales [NodeIndex] = Random.NextFloat(0.99f, 1.01f);
+    }
+
+    Archetypes::Types::ColumnData ColumnData = {};
+    ColumnData [static_cast<uint8>(Archetypes::Types::Columns::Position)] = reinterpret_cast<std::byte const *>(Positions.data());
+    ColumnData [static_cast<uint8>(Archetypes::Types::Columns::Scale)] = reinterpret_cast<std::byte const *>(Scales.data());
+
+    std::vector<uint32> ActorHandles = std::vector<uint32>(kNodeCount);
+    TEST_CHECK(Scene::CreateActors(Scene, static_cast<uint32>(Scene::ComponentMasks::Transform), kNodeCount, ColumnData, nullptr, ActorHandles.data()));
+
+    /* Parents are picked in a shuffled order, so a parent is often created after its child */
+    std::vector<uint32> Order = std::vector<uint32>(kNodeCount);
+
+    for (uint32 NodeIndex = {};
+         NodeIndex < kNodeCount;
+         NodeIndex++)
+    {
+        Order [NodeIndex] = NodeIndex;
+    }
+
+    for (uint32 NodeIndex = { kNodeCount - 1u };
+         NodeIndex > 0u;
+         NodeIndex--)
+    {
+        std::swap(Order [NodeIndex], Order [Random.NextUint32(NodeIndex + 1u)]);
+    }
+
+    std::vector<uint32> ChildHandles = {};
+    std::vector<uint32> ParentHandles = {};
+
+    for (uint32 OrderIndex = { 1u };
+         OrderIndex < kNodeCount;
+         OrderIndex++)
+    {
+        /* The last nodes form one long chain */
+        uint32 const kParentOrderIndex = OrderIndex >= kNodeCount - kChainLength ? OrderIndex - 1u : Random.NextUint32(OrderIndex);
+
+        /* Every 16th node stays a root */
+        if ((OrderIndex & 15u) != 0u || OrderIndex >= kNodeCount - kChainLength)
+        {
+            ChildHandles.push_back(ActorHandles [Order [OrderIndex]]);
+            ParentHandles.push_back(ActorHandles [Order [kParentOrderIndex]]);
+        }
+    }
+
+    TEST_CHECK(Transform::SetParents(ChildHandles.data(), ParentHandles.data(), static_cast<uint32>(ChildHandles.size()), Scene));
+
+    double const kFirstUpdateInNanoseconds = Testing::MeasureNanoseconds(1u, []()
+                                                                         {
+                                                                             Transform::UpdateWorldTransforms();
+                                                                         });
+
+    std::printf("%-40s %12.3f ms\n", "First update, 100K nodes", kFirstUpdateInNanoseconds * 1.0e-6);
+    ::CheckWorldTransforms(Scene, ActorHandles);
+
+    /* Moving every root dirties the whole hierarchy */
+    std::vector<uint32> RootHandles = {};
+
+    for (uint32 const kActorHandle : ActorHandles)
+    {
+        uint32 ParentActorHandle = {};
+        Transform::GetParent(kActorHandle, ParentActorHandle);
+
+        if (ParentActorHandle == 0u)
+        {
+            RootHandles.push_back(kActorHandle);
+        }
+    }
+
+    ::MeasureUpdate("Every root moved", [&RootHandles]()
+                    {
+                        for (uint32 const kActorHandle : RootHandles)
+                        {
+                            Math::Vector3 const kPosition = Math::Vector3 { Random.NextFloat(-10.0f, 10.0f), 0.0f, 0.0f };
+                            Transform::SetTransform(kActorHandle, &kPosition, nullptr, nullptr);
+                        }
+                    });
+
+    ::CheckWorldTransforms(Scene, ActorHandles);
+
+    ::MeasureUpdate("1% of nodes moved", [&ActorHandles]()
+                    {
+                        for (uint32 MoveIndex = {};
+                             MoveIndex < kNodeCount / 100u;
+                             MoveIndex++)
+                        {
+                            float const kScale = Random.NextFloat(0.99f, 1.01f);
+                            Transform::SetTransform(ActorHandles [Random.NextUint32(kNodeCount)], nullptr, nullptr, &kScale);
+                        }
+                    });
+
+    ::CheckWorldTransforms(Scene, ActorHandles);
+
+    ::MeasureUpdate("Nothing moved", []()
+                    {
+                    });
+
+    /* Reparenting and destroying reorders the nodes and leaves holes, which the next update removes */
+    {
+        for (uint32 ChangeIndex = {};
+             ChangeIndex < 1000u;
+             ChangeIndex++)
+        {
+            uint32 const kActorHandle = ActorHandles [Random.NextUint32(kNodeCount)];
+
+            if (!Scene::IsActorValid(Scene, kActorHandle))
+            {
+                continue;
+            }
+
+            if (ChangeIndex & 1u)
+            {
+                Scene::DestroyActor(Scene, kActorHandle);
+            }
+            else
+            {
+                /* Roots keep cycles rare, SetParent rejects the ones that would form */
+                Transform::SetParent(kActorHandle, RootHandles [Random.NextUint32(static_cast<uint32>(RootHandles.size()))], Scene);
+            }
+        }
+
+        double const kUpdateInNanoseconds = Testing::MeasureNanoseconds(1u, []()
+                                                                        {
+                                                                            Transform::UpdateWorldTransforms();
+                                                                        });
+
+        std::printf("%-40s %12.3f ms\n", "After reparenting and destroying", kUpdateInNanoseconds * 1.0e-6);
+        ::CheckWorldTransforms(Scene, ActorHandles);
+    }
+
+    Jobs::Destroy();
+
+    return Testing::Finish("TransformHierarchyTests");
+}
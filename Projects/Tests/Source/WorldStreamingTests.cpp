@@ -0,0 +1,423 @@
+#include "Testing.hpp"
+
+#include "World/Streaming.hpp"
+
+#include <string>
+#include <vector>
+
+/*
+    Replays camera paths against a fake cell loader, which records every call and keeps its own count of what is in memory.
+        - A short path down a row of cells, where the order of loads, integrations and evictions is worked out by hand
+        - A long loop over a grid with shared assets, slow loads and a time slice, checked for the budget, the loader's own accounting,
+          load and unload distances, and replaying the same path twice giving the same calls
+*/
+
+using namespace World::Streaming;
+
+static Testing::Random Random = {};
+
+struct FakeLoader
+{
+    Types::WorldLayout const * Layout = {};
+
+    /* Updates a load takes to complete */
+    uint32 LoadLatency = {};
+
+    uint64 IntegrateTimeInNanoSeconds = {};
+    uint32 FailingCellIndex = { ~0u };
+
+    uint32 UpdateIndex = {};
+
+    /* Indexed by cell index */
+    std::vector<uint32> LoadBeginUpdateIndices = {};
+    std::vector<uint8> CellsInMemory = {};
+
+    /* Indexed by asset index */
+    std::vector<uint32> AssetUserCounts = {};
+    std::vector<uint8> AssetsInMemory = {};
+
+    uint64 SizeInBytes = {};
+
+    /* One letter per call followed by the cell index, Begin, Integrate, Unload and Fail */
+    std::string Calls = {};
+
+    /* Only set by the checks, so a failure names the first call that broke the rule */
+    bool bCallsValid = true;
+};
+
+static void RecordCall(FakeLoader & Loader, char const Type, uint32 const CellIndex)
+{
+    Loader.Calls += Type;
+    Loader.Calls += std::to_string(CellIndex);
+    Loader.Calls += ' ';
+}
+
+static void BeginLoad(void * Data, uint32 const CellIndex)
+{
+    FakeLoader & Loader = *static_cast<FakeLoader *>(Data);
+    Types::CellDesc const & kCell = Loader.Layout->Cells [CellIndex];
+
+    Loader.bCallsValid &= Loader.CellsInMemory [CellIndex] == 0u;
+
+    Loader.LoadBeginUpdateIndices [CellIndex] = Loader.UpdateIndex;
+    Loader.CellsInMemory [CellIndex] = 1u;
+    Loader.SizeInBytes += kCell.ActorSizeInBytes;
+
+    for (uint32 CurrentIndex = { kCell.FirstAssetIndex };
+         CurrentIndex < kCell.FirstAssetIndex + kCell.AssetCount;
+         CurrentIndex++)
+    {
+        uint32 const kAssetIndex = Loader.Layout->CellAssetIndices [CurrentIndex];
+
+        if (Loader.AssetUserCounts [kAssetIndex]++ == 0u && Loader.AssetsInMemory [kAssetIndex] == 0u)
+        {
+            Loader.AssetsInMemory [kAssetIndex] = 1u;
+            Loader.SizeInBytes += Loader.Layout->AssetSizesInBytes [kAssetIndex];
+        }
+    }
+
+    ::RecordCall(Loader, 'B', CellIndex);
+}
+
+static bool const IsLoadComplete(void * Data, uint32 const CellIndex)
+{
+    FakeLoader const & kLoader = *static_cast<FakeLoader const *>(Data);
+
+    return kLoader.UpdateIndex >= kLoader.LoadBeginUpdateIndices [CellIndex] + kLoader.LoadLatency;
+}
+
+static bool const Integrate(void * Data, uint32 const CellIndex, uint64 & OutputTimeInNanoSeconds)
+{
+    FakeLoader & Loader = *static_cast<FakeLoader *>(Data);
+
+    Loader.bCallsValid &= Loader.CellsInMemory [CellIndex] == 1u && ::IsLoadComplete(Data, CellIndex);
+
+    OutputTimeInNanoSeconds = Loader.IntegrateTimeInNanoSeconds;
+
+    bool const kbSucceeded = CellIndex != Loader.FailingCellIndex;
+    ::RecordCall(Loader, kbSucceeded ? 'I' : 'F', CellIndex);
+
+    return kbSucceeded;
+}
+
+static void Unload(void * Data, uint32 const CellIndex, uint64 & OutputTimeInNanoSeconds)
+{
+    FakeLoader & Loader = *static_cast<FakeLoader *>(Data);
+    Types::CellDesc const & kCell = Loader.Layout->Cells [CellIndex];
+
+    Loader.bCallsValid &= Loader.CellsInMemory [CellIndex] == 1u;
+
+    Loader.CellsInMemory [CellIndex] = 0u;
+    Loader.SizeInBytes -= kCell.ActorSizeInBytes;
+
+    for (uint32 CurrentIndex = { kCell.FirstAssetIndex };
+         CurrentIndex < kCell.FirstAssetIndex + kCell.AssetCount;
+         CurrentIndex++)
+    {
+        Loader.AssetUserCounts [Loader.Layout->CellAssetIndices [CurrentIndex]]--;
+    }
+
+    OutputTimeInNanoSeconds = {};
+
+    ::RecordCall(Loader, 'U', CellIndex);
+}
+
+/* Every asset is released, except that assets with an odd index stay resident */
+static bool const ReleaseAsset(void * Data, uint32 const AssetIndex)
+{
+    FakeLoader & Loader = *static_cast<FakeLoader *>(Data);
+
+    Loader.bCallsValid &= Loader.AssetUserCounts [AssetIndex] == 0u && Loader.AssetsInMemory [AssetIndex] == 1u;
+
+    if (AssetIndex & 1u)
+    {
+        return false;
+    }
+
+    Loader.AssetsInMemory [AssetIndex] = 0u;
+    Loader.SizeInBytes -= Loader.Layout->AssetSizesInBytes [AssetIndex];
+
+    return true;
+}
+
+static Types::Loader const MakeLoader(FakeLoader & Loader, Types::WorldLayout const & Layout)
+{
+    Loader.Layout = &Layout;
+    Loader.LoadBeginUpdateIndices.assign(Layout.Cells.size(), 0u);
+    Loader.CellsInMemory.assign(Layout.Cells.size(), 0u);
+    Loader.AssetUserCounts.assign(Layout.AssetSizesInBytes.size(), 0u);
+    Loader.AssetsInMemory.assign(Layout.AssetSizesInBytes.size(), 0u);
+
+    return Types::Loader { &Loader, ::BeginLoad, ::IsLoadComplete, ::Integrate, ::Unload, ::ReleaseAsset };
+}
+
+static Types::CellDesc const MakeCell(float const X, float const Z, float const Size, uint64 const ActorSizeInBytes)
+{
+    return Types::CellDesc { Math::AABB { Math::Vector3 { X, 0.0f, Z }, Math::Vector3 { X + Size, 10.0f, Z + Size } }, ActorSizeInBytes, 0u, 0u };
+}
+
+/*
+    Eight 10m cells in a row, loads complete by the next update, with room for three cells. Loads reach 5m and unloads start past 15m,
+    so each step along the row loads the next cell and evicts the one two behind, which is still inside the unload distance.
+*/
+static void ReplayRow()
+{
+    Types::WorldLayout Layout = {};
+
+    for (uint32 CellIndex = {};
+         CellIndex < 8u;
+         CellIndex++)
+    {
+        Layout.Cells.push_back(::MakeCell(10.0f * CellIndex, 0.0f, 10.0f, 1u));
+    }
+
+    FakeLoader Loader = {};
+    Loader.LoadLatency = 1u;
+
+    Types::Settings const kSettings = { 5.0f, 15.0f, 3u, 1000000u, 4u };
+
+    Types::StreamingState State = {};
+    TEST_CHECK(World::Streaming::Initialise(State, Layout, kSettings, ::MakeLoader(Loader, Layout)));
+
+    /* The centre of each cell down the row, then straight back two cells, then staying still for the loads to finish */
+    std::vector<float> const kPath = { 5.0f, 15.0f, 25.0f, 35.0f, 45.0f, 55.0f, 65.0f, 75.0f, 45.0f, 45.0f };
+
+    std::vector<std::string> UpdateCalls = {};
+    bool bWithinBudget = true;
+
+    for (float const kX : kPath)
+    {
+        Loader.Calls.clear();
+
+        World::Streaming::Update(State, Math::Vector3 { kX, 5.0f, 5.0f });
+        Loader.UpdateIndex++;
+
+        UpdateCalls.push_back(Loader.Calls);
+        bWithinBudget &= World::Streaming::GetResidentSizeInBytes(State) <= kSettings.MemoryBudgetInBytes;
+        bWithinBudget &= World::Streaming::GetResidentSizeInBytes(State) == Loader.SizeInBytes;
+    }
+
+    std::vector<std::string> const kExpectedCalls =
+    {
+        "B0 B1 ",
+        "I1 I0 B2 ",
+        "I2 U0 B3 ",
+        "I3 U1 B4 ",
+        "I4 U2 B5 ",
+        "I5 U3 B6 ",
+        "I6 U4 B7 ",
+        "I7 ",
+        /* Cell 7 is out of range, cell 4 fits next to 5 and 6, cell 3 evicts cell 6 which is further away */
+        "U7 B4 U6 B3 ",
+        "I4 I3 ",
+    };
+
+    TEST_CHECK(UpdateCalls == kExpectedCalls);
+    TEST_CHECK(bWithinBudget);
+    TEST_CHECK(Loader.bCallsValid);
+
+    for (uint32 UpdateIndex = {};
+         UpdateIndex < UpdateCalls.size() && UpdateIndex < kExpectedCalls.size();
+         UpdateIndex++)
+    {
+        if (UpdateCalls [UpdateIndex] != kExpectedCalls [UpdateIndex])
+        {
+            std::printf("  Update %u called \"%s\", expected \"%s\"\n", UpdateIndex, UpdateCalls [UpdateIndex].c_str(), kExpectedCalls [UpdateIndex].c_str());
+        }
+    }
+
+    Loader.UpdateIndex += Loader.LoadLatency;
+    World::Streaming::UnloadAll(State);
+
+    TEST_CHECK(World::Streaming::GetResidentSizeInBytes(State) == 0u);
+    TEST_CHECK(Loader.SizeInBytes == 0u);
+}
+
+static uint32 const kGridSize = { 32u };
+static float const kCellSize = { 100.0f };
+static uint32 const kAssetCount = { 64u };
+static uint32 const kPathLength = { 2000u };
+
+/* Records the calls for the whole path and checks the budget and distances after every update */
+static std::string const ReplayGridPath(Types::WorldLayout const & Layout, std::vector<Math::Vector3> const & Path, double & OutputUpdateInNanoseconds)
+{
+    FakeLoader Loader = {};
+    Loader.LoadLatency = 3u;
+    Loader.IntegrateTimeInNanoSeconds = 400000u;
+
+    /* On the loop, where it starts at angle zero */
+    Loader.FailingCellIndex = 16u * kGridSize + 27u;
+
+    /* Around 20 cells with their assets, less than the 30 or so within the load distance */
+    Types::Settings const kSettings = { 250.0f, 400.0f, 20u << 20u, 1000000u, 8u };
+
+    Types::StreamingState State = {};
+    TEST_CHECK(World::Streaming::Initialise(State, Layout, kSettings, ::MakeLoader(Loader, Layout)));
+
+    std::string Calls = {};
+
+    bool bWithinBudget = true;
+    bool bAccountingMatches = true;
+    bool bDistancesValid = true;
+    bool bTimeSliceKept = true;
+
+    uint32 DeferredCount = {};
+    uint32 FailedCount = {};
+
+    OutputUpdateInNanoseconds = {};
+
+    for (Math::Vector3 const & kPosition : Path)
+    {
+        Loader.Calls.clear();
+
+        Types::UpdateStatistics Statistics = {};
+
+        OutputUpdateInNanoseconds += Testing::MeasureNanoseconds(1u, [&State, &kPosition, &Statistics]()
+                                                                 {
+                                                                     World::Streaming::Update(State, kPosition, &Statistics);
+                                                                 });
+
+        Loader.UpdateIndex++;
+
+        uint64 const kResidentSizeInBytes = World::Streaming::GetResidentSizeInBytes(State);
+
+        bWithinBudget &= kResidentSizeInBytes <= kSettings.MemoryBudgetInBytes;
+        bAccountingMatches &= kResidentSizeInBytes == Loader.SizeInBytes;
+
+        /* The first integration always runs, every later one has to start inside the time slice */
+        bTimeSliceKept &= Statistics.IntegratedCellCount <= 1u || Statistics.TimeInNanoSeconds < kSettings.TimeSliceInNanoSeconds + Loader.IntegrateTimeInNanoSeconds;
+
+        /* Loads start within the load distance. Unloads are failed cells, out of range, or evictions further away than the cell they made room for */
+        float ClosestBeginDistance = { 3.402823466e+38f };
+        float FurthestBeginDistance = {};
+
+        for (uint32 CellIndex = {};
+             CellIndex < Layout.Cells.size();
+             CellIndex++)
+        {
+            if (State.CurrentCellStates [CellIndex] == Types::CellStates::Loading && Loader.LoadBeginUpdateIndices [CellIndex] == Loader.UpdateIndex - 1u)
+            {
+                float const kDistance = World::Streaming::GetCellDistance(Layout.Cells [CellIndex], kPosition);
+
+                ClosestBeginDistance = std::min(ClosestBeginDistance, kDistance);
+                FurthestBeginDistance = std::max(FurthestBeginDistance, kDistance);
+            }
+        }
+
+        bDistancesValid &= FurthestBeginDistance <= kSettings.LoadDistance;
+
+        for (std::size_t CallIndex = { Loader.Calls.find('U') };
+             CallIndex != std::string::npos;
+             CallIndex = Loader.Calls.find('U', CallIndex + 1u))
+        {
+            uint32 const kCellIndex = static_cast<uint32>(std::stoul(Loader.Calls.substr(CallIndex + 1u)));
+            float const kDistance = World::Streaming::GetCellDistance(Layout.Cells [kCellIndex], kPosition);
+
+            bool const kbFailed = State.CurrentCellStates [kCellIndex] == Types::CellStates::Failed;
+
+            bDistancesValid &= kbFailed || kDistance > kSettings.UnloadDistance || kDistance > ClosestBeginDistance;
+        }
+
+        DeferredCount += Statistics.DeferredCellCount;
+        FailedCount += Loader.Calls.find('F') != std::string::npos ? 1u : 0u;
+
+        Calls += Loader.Calls;
+        Calls += '|';
+    }
+
+    TEST_CHECK(bWithinBudget);
+    TEST_CHECK(bAccountingMatches);
+    TEST_CHECK(bDistancesValid);
+    TEST_CHECK(bTimeSliceKept);
+    TEST_CHECK(Loader.bCallsValid);
+
+    /* The budget has to actually limit the loads, and the failing cell is tried exactly once */
+    TEST_CHECK(DeferredCount > 0u);
+    TEST_CHECK(FailedCount == 1u);
+
+    /* UnloadAll waits for the loads still in progress, which only finish as the fake's updates go by */
+    Loader.UpdateIndex += Loader.LoadLatency;
+    World::Streaming::UnloadAll(State);
+
+    /* Only the assets the loader kept are left */
+    uint64 KeptAssetSizeInBytes = {};
+
+    for (uint32 AssetIndex = {};
+         AssetIndex < kAssetCount;
+         AssetIndex++)
+    {
+        KeptAssetSizeInBytes += Loader.AssetsInMemory [AssetIndex] ? Layout.AssetSizesInBytes [AssetIndex] : 0u;
+    }
+
+    TEST_CHECK(World::Streaming::GetResidentSizeInBytes(State) == Loader.SizeInBytes);
+    TEST_CHECK(Loader.SizeInBytes == KeptAssetSizeInBytes);
+
+    return Calls;
+}
+
+/* A 32 x 32 grid where neighbouring cells share assets, and a camera flying a loop over it with some jitter */
+static void ReplayGrid()
+{
+    Types::WorldLayout Layout = {};
+
+    for (uint32 CellZ = {};
+         CellZ < kGridSize;
+         CellZ++)
+    {
+        for (uint32 CellX = {};
+             CellX < kGridSize;
+             CellX++)
+        {
+            Types::CellDesc Cell = ::MakeCell(kCellSize * CellX, kCellSize * CellZ, kCellSize, (256u + Random.NextUint32(768u)) << 10u);
+            Cell.FirstAssetIndex = static_cast<uint32>(Layout.CellAssetIndices.size());
+            Cell.AssetCount = 3u;
+
+            /* Assets are shared by 4 x 4 blocks of cells, plus one picked at random */
+            uint32 const kBlockAssetIndex = ((CellZ / 4u) * (kGridSize / 4u) + CellX / 4u) % kAssetCount;
+
+            Layout.CellAssetIndices.push_back(kBlockAssetIndex);
+            Layout.CellAssetIndices.push_back((kBlockAssetIndex + 1u) % kAssetCount);
+            Layout.CellAssetIndices.push_back(Random.NextUint32(kAssetCount));
+
+            Layout.Cells.push_back(Cell);
+        }
+    }
+
+    for (uint32 AssetIndex = {};
+         AssetIndex < kAssetCount;
+         AssetIndex++)
+    {
+        Layout.AssetSizesInBytes.push_back((128u + Random.NextUint32(256u)) << 10u);
+    }
+
+    std::vector<Math::Vector3> Path = {};
+
+    for (uint32 StepIndex = {};
+         StepIndex < kPathLength;
+         StepIndex++)
+    {
+        float const kAngle = 6.2831853f * static_cast<float>(StepIndex) / kPathLength;
+        float const kRadius = kCellSize * kGridSize * 0.35f;
+        float const kCentre = kCellSize * kGridSize * 0.5f;
+
+        Path.push_back(Math::Vector3 { kCentre + kRadius * std::cos(kAngle) + Random.NextFloat(-20.0f, 20.0f), 5.0f, kCentre + kRadius * std::sin(kAngle) + Random.NextFloat(-20.0f, 20.0f) });
+    }
+
+    double FirstUpdateInNanoseconds = {};
+    double SecondUpdateInNanoseconds = {};
+
+    std::string const kFirstCalls = ::ReplayGridPath(Layout, Path, FirstUpdateInNanoseconds);
+    std::string const kSecondCalls = ::ReplayGridPath(Layout, Path, SecondUpdateInNanoseconds);
+
+    TEST_CHECK(kFirstCalls == kSecondCalls);
+
+    std::printf("%-40s %12.3f us\n", "Update, 1024 cells", std::min(FirstUpdateInNanoseconds, SecondUpdateInNanoseconds) * 1.0e-3 / kPathLength);
+}
+
+int main()
+{
+    ::ReplayRow();
+    ::ReplayGrid();
+
+    return Testing::Finish("WorldStreamingTests");
+}
@@ -24,5 +24,9 @@ namespace Assets::Material
 
     extern bool const CreateMaterial(MaterialData const & MaterialDesc, std::string AssetName, uint32 & OutputMaterialHandle);
 
+    extern bool const FindMaterial(std::string const & AssetName, uint32 & OutputMaterialHandle);
+
     extern bool const GetAssetData(uint32 const AssetHandle, MaterialData & OutputAssetData);
+
+    extern bool const GetAssetName(uint32 const AssetHandle, std::string & OutputAssetName);
 }
\ No newline at end of file
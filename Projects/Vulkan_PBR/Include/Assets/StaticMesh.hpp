@@ -3,6 +3,8 @@
 #include "Common.hpp"
 #include "Graphics/VulkanModule.hpp"
 
+#include <Math/Quantisation.hpp>
+
 #include <filesystem>
 
 namespace Vulkan::Device
@@ -20,6 +22,9 @@ namespace Assets::StaticMesh::Types
             bool bHasUVs = {};
         };
 
+        /* Positions are quantised relative to these bounds */
+        Math::QuantisationBounds PositionBounds = {};
+
         uint64 NormalDataOffsetInBytes = {};
         uint64 TangentDataOffsetInBytes = {};
         uint64 UVDataOffsetInBytes = {};
@@ -45,5 +50,13 @@ namespace Assets::StaticMesh
 
     extern bool const InitialiseGPUResources(VkCommandBuffer const kCommandBuffer, Vulkan::Device::DeviceState const & kDeviceState, VkFence const kTransferFence);
 
+    extern bool const FindStaticMesh(std::string const & kAssetName, uint32 & OutputAssetHandle);
+
     extern bool const GetAssetData(uint32 const kAssetHandle, Assets::StaticMesh::Types::StaticMesh & OutputAssetData);
+
+    /* The name and file the mesh was imported with, used to save references to it */
+    extern bool const GetAssetSource(uint32 const kAssetHandle, std::string & OutputAssetName, std::filesystem::path & OutputFilePath);
+
+    /* Maps the quantised unit cube positions into model space, converting from Y up to Z up */
+    extern Math::Affine3x4 const GetMeshToModelTransform(Assets::StaticMesh::Types::StaticMesh const & kStaticMesh);
 }
\ No newline at end of file
@@ -30,6 +30,9 @@ namespace Assets::Texture
 
     extern bool const GetTextureData(uint32 const AssetHandle, TextureData & OutputTextureData);
 
+    /* The name and file the texture was imported with, used to save references to it */
+    extern bool const GetAssetSource(uint32 const AssetHandle, std::string & OutputAssetName, std::filesystem::path & OutputFilePath);
+
     /* Run through all the new textures and create the resources + buffer the transfer */
     extern bool const InitialiseGPUResources(VkCommandBuffer CommandBuffer, Vulkan::Device::DeviceState const & DeviceState, VkFence const TransferFence);
 
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Common.hpp"
+
+#include <Math/Vector.hpp>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+/*
+    Actors with the same component mask (signature) are stored together in an archetype.
+    Each archetype is split into fixed size chunks, and each chunk stores its columns as contiguous arrays (SoA).
+*/
+namespace Components::Archetypes::Types
+{
+    enum class Columns : uint8
+    {
+        ActorHandle = 0u, // Present in every archetype
+        Position,
+        Orientation,
+        Scale,
+        MeshHandle,
+        MaterialHandle,
+        Count,
+    };
+
+    template<Columns kColumn> struct ColumnType;
+    template<> struct ColumnType<Columns::ActorHandle> { using Type = uint32; };
+    template<> struct ColumnType<Columns::Position> { using Type = Math::Vector3; };
+    template<> struct ColumnType<Columns::Orientation> { using Type = Math::Vector3; };
+    template<> struct ColumnType<Columns::Scale> { using Type = float; };
+    template<> struct ColumnType<Columns::MeshHandle> { using Type = uint32; };
+    template<> struct ColumnType<Columns::MaterialHandle> { using Type = uint32; };
+
+    static constexpr uint8 kColumnCount = static_cast<uint8>(Columns::Count);
+    static constexpr uint32 kInvalidColumnOffset = ~0u;
+
+    struct ChunkView
+    {
+        std::byte * Data = {};
+        std::array<uint32, kColumnCount> ColumnOffsets = {};
+        uint32 EntityCount = {};
+
+        bool const HasColumn(Columns const kColumn) const
+        {
+            return ColumnOffsets [static_cast<uint8>(kColumn)] != kInvalidColumnOffset;
+        }
+
+        template<Columns kColumn>
+        typename ColumnType<kColumn>::Type * GetColumn() const
+        {
+            PBR_ASSERT(HasColumn(kColumn));
+            return reinterpret_cast<typename ColumnType<kColumn>::Type *>(Data + ColumnOffsets [static_cast<uint8>(kColumn)]);
+        }
+    };
+
+    /* One pointer per column to tightly packed elements of the column's type, NULL columns are zero initialised */
+    using ColumnData = std::array<std::byte const *, kColumnCount>;
+
+    /* Where an actor lives, indexed directly by the actor index in the handle so no hashing is needed */
+    struct EntityLocation
+    {
+        uint32 ArchetypeIndex = {};
+        uint32 EntityIndex = {};
+    };
+}
+
+namespace Components::Archetypes
+{
+    /* Adds the actor to the archetype with no components */
+    extern bool const CreateEntity(uint32 const ActorHandle);
+
+    /* Appends every actor straight into the archetype for ComponentMask, columns are copied a chunk at a time. The actor handle column is ignored */
+    extern bool const CreateEntities(uint32 const ComponentMask, uint32 const * const ActorHandles, uint32 const ActorCount, Types::ColumnData const & ColumnData);
+
+    /* Swap and pop removal, the last entity in the archetype is moved into the freed row */
+    extern bool const DestroyEntity(uint32 const ActorHandle);
+
+    /* Moves the actor into the archetype that also has the components in ComponentMask, new columns are zero initialised */
+    extern bool const AddComponents(uint32 const ActorHandle, uint32 const ComponentMask);
+
+    /* Moves the actor into the archetype without the components in ComponentMask, the removed columns are discarded */
+    extern bool const RemoveComponents(uint32 const ActorHandle, uint32 const ComponentMask);
+
+    /* Fails for NULL and stale handles */
+    extern bool const GetEntity(uint32 const ActorHandle, Types::ChunkView & OutputChunk, uint32 & OutputRowIndex);
+
+    /* Outputs every non-empty chunk whose archetype has all the components in ComponentMask */
+    extern void QueryChunks(uint32 const ComponentMask, std::vector<Types::ChunkView> & OutputChunks);
+
+    extern uint32 const GetEntityCount(uint32 const ComponentMask);
+
+    /* Whether archetypes with exactly the components in ComponentMask store the column */
+    extern bool const HasColumn(uint32 const ComponentMask, Types::Columns const Column);
+
+    extern uint32 const GetColumnSizeInBytes(Types::Columns const Column);
+}
@@ -3,27 +3,26 @@
 #include "Common.hpp"
 
 #include <Math/Vector.hpp>
-#include <Math/Matrix.hpp>
+#include <Math/Affine.hpp>
 
 #include <vector>
-#include <unordered_map>
 
 namespace Scene
 {
     struct SceneData;
 }
 
-namespace Components::Transform
+namespace Components::Transform::Types
 {
-    struct TransformCollection
+    struct SlotRange
     {
-        std::unordered_map<uint32, uint32> ActorHandleToComponentIndex = {};
-
-        std::vector<Math::Vector3> Positions = {};
-        std::vector<Math::Vector3> Orientations = {};
-        std::vector<float> Scales = {};
+        uint32 FirstSlotIndex = {};
+        uint32 SlotCount = {};
     };
+}
 
+namespace Components::Transform
+{
     struct TransformData
     {
         Math::Vector3 Position = {};
@@ -33,9 +32,43 @@ namespace Components::Transform
 
     extern bool const CreateComponent(uint32 const ActorHandle, Scene::SceneData & Scene);
 
+    /* For actors that were created with the transform columns already filled in, see Scene::CreateActors. The new transforms are dirty */
+    extern bool const CreateComponents(uint32 const * const ActorHandles, uint32 const ActorCount);
+
+    extern bool const DestroyComponent(uint32 const ActorHandle, Scene::SceneData & Scene);
+
     extern bool const SetTransform(uint32 const ActorHandle, Math::Vector3 const * const NewPosition, Math::Vector3 const * const NewOrientation, float const * const NewScale);
 
     extern bool const GetTransform(uint32 const ActorHandle, TransformData & OutputTransformData);
 
-    extern bool const GetTransformationMatrix(uint32 const ActorHandle, Math::Matrix4x4 & OutputTransformation);
+    /* A NULL parent handle detaches the actor, the transform set with SetTransform becomes relative to the parent */
+    extern bool const SetParent(uint32 const ActorHandle, uint32 const ParentActorHandle, Scene::SceneData const & Scene);
+
+    /* Same as calling SetParent for each actor, but the nodes are reordered at most once. Fails without changing anything if the parents would form a cycle */
+    extern bool const SetParents(uint32 const * const ActorHandles, uint32 const * const ParentActorHandles, uint32 const ActorCount, Scene::SceneData const & Scene);
+
+    /* Outputs NULL if the actor doesn't have a parent */
+    extern bool const GetParent(uint32 const ActorHandle, uint32 & OutputParentActorHandle);
+
+    /* Propagates dirty local transforms to world transforms, this does nothing if no transform changed since the last update */
+    extern void UpdateWorldTransforms();
+
+    /* Outputs the world transform computed by the last call to UpdateWorldTransforms */
+    extern bool const GetTransformationMatrix(uint32 const ActorHandle, Math::Affine3x4 & OutputTransformation);
+
+    /*
+        Each transform has a slot that doesn't change for its lifetime, so slots can index a persistent GPU buffer.
+        Freed slots are reused, the slot count only grows.
+    */
+    extern bool const GetTransformSlot(uint32 const ActorHandle, uint32 & OutputSlotIndex);
+
+    extern uint32 const GetTransformSlotCount();
+
+    /* Outputs runs of slots whose world transform changed since the last flush, at most MaximumSlotCount slots are flushed and the rest stay dirty */
+    extern uint32 const FlushDirtySlots(uint32 const MaximumSlotCount, std::vector<Types::SlotRange> & OutputSlotRanges);
+
+    extern void GetWorldTransforms(Types::SlotRange const & SlotRange, Math::Affine3x4 * const OutputTransforms);
+
+    /* Appends the actors whose world transform changed since the last flush, destroyed actors can still be included */
+    extern void FlushMovedActors(std::vector<uint32> & OutputActorHandles);
 }
\ No newline at end of file
@@ -1,10 +1,12 @@
 #pragma once
 
+#include "Common.hpp"
+
 struct VkApplicationInfo;
 
-namespace Scene
+namespace RenderSnapshot::Types
 {
-    struct SceneData;
+    struct FrameSnapshot;
 }
 
 namespace ForwardRenderer
@@ -13,5 +15,12 @@ namespace ForwardRenderer
 
     extern bool const Shutdown();
 
-    extern void Render(Scene::SceneData const & Scene);
+    /* Called from the render thread. Returns false if the frame was skipped, e.g. for a resize, and the snapshot should be rendered again */
+    extern bool const Render(RenderSnapshot::Types::FrameSnapshot const & Snapshot);
+
+    /* Changed transforms that fit in one frame's staging memory, snapshots shouldn't take more than this */
+    extern uint32 const GetMaximumTransformUploadCount();
+
+    /* Fixed once Initialise returns. When set, snapshots should include every actor with a static mesh and the renderer does the frustum culling */
+    extern bool const IsGPUCullingEnabled();
 }
\ No newline at end of file
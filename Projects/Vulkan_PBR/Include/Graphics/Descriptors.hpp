@@ -23,6 +23,7 @@ namespace Vulkan::Device
 *       - VK_ERROR_OUT_OF_POOL_MEMORY => Allocate a new pool
 *       - Keep a series of pools available for each buffered frame, then just reset them at the start of the frame
 *       - When allocating use a first fit method of allocating to begin with
+*       - Sets that live across frames, such as one per material, come from an allocator that is never reset
 *
 *   Below Should be handled by some global render state.
 * 
@@ -34,6 +35,10 @@ namespace Vulkan::Device
 *   Bind to pipeline layout based on descriptor set index and binding slot index
 *
 *   Create pipeline layout using descriptor set layout handles
+*
+*   Threading
+*       - Descriptor writes are cached per thread, FlushDescriptorWrites only flushes the calling thread's writes
+*       - An allocator must only be used by one thread at a time, threads recording in parallel should each have their own
 */
 
 namespace Vulkan::Descriptors
@@ -43,10 +48,15 @@ namespace Vulkan::Descriptors
         Uniform = 0x1,
         SampledImage = 0x2,
         Sampler = 0x4,
+        StorageBuffer = 0x8,
+        UniformDynamic = 0x10,
     };
 
     extern bool const CreateDescriptorAllocator(Vulkan::Device::DeviceState const & kDeviceState, uint32 const kDescriptorTypeFlags, uint16 & OutputAllocatorHandle);
 
+    /* Each pool holds kPoolDescriptorCount of every type. Pass VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT for sets with update after bind layouts */
+    extern bool const CreateDescriptorAllocator(Vulkan::Device::DeviceState const & kDeviceState, uint32 const kDescriptorTypeFlags, uint32 const kPoolDescriptorCount, VkDescriptorPoolCreateFlags const kPoolCreateFlags, uint16 & OutputAllocatorHandle);
+
     extern bool const DestroyDescriptorAllocator(Vulkan::Device::DeviceState const & kDeviceState, uint16 const kAllocatorHandle);
 
     extern bool const ResetDescriptorAllocator(Vulkan::Device::DeviceState const & kDeviceState, uint16 const kAllocatorHandle);
@@ -57,10 +67,16 @@ namespace Vulkan::Descriptors
 
     extern bool const BindImageDescriptors(uint16 const kAllocatorHandle, uint16 const kDescriptorSetHandle, VkDescriptorType const kDescriptorType, uint8 const kFirstBindingIndex, uint8 const kDescriptorCount, VkDescriptorImageInfo const * const kImageDescriptors);
 
+    /* Writes elements [kFirstArrayElement, kFirstArrayElement + kDescriptorCount) of an array binding */
+    extern bool const BindImageDescriptors(uint16 const kAllocatorHandle, uint16 const kDescriptorSetHandle, VkDescriptorType const kDescriptorType, uint8 const kBindingIndex, uint32 const kFirstArrayElement, uint8 const kDescriptorCount, VkDescriptorImageInfo const * const kImageDescriptors);
+
     extern bool const FlushDescriptorWrites(Vulkan::Device::DeviceState const & kDeviceState);
 
     extern bool const CreateDescriptorSetLayout(Vulkan::Device::DeviceState const & kDeviceState, uint32 const kBindingCount, VkDescriptorSetLayoutBinding const * const kResourceBindings, uint16 & OutputLayoutHandle);
 
+    /* kBindingFlags has one entry per binding. The layout can only be allocated from an update after bind pool if any binding is update after bind */
+    extern bool const CreateDescriptorSetLayout(Vulkan::Device::DeviceState const & kDeviceState, uint32 const kBindingCount, VkDescriptorSetLayoutBinding const * const kResourceBindings, VkDescriptorBindingFlags const * const kBindingFlags, uint16 & OutputLayoutHandle);
+
     extern bool const DestroyDescriptorSetLayout(Vulkan::Device::DeviceState const & kDeviceState, uint16 const kLayoutHandle);
 
     extern bool const GetDescriptorSetLayout(uint16 const kLayoutHandle, VkDescriptorSetLayout & OutputLayout);
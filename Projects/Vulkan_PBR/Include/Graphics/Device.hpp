@@ -86,13 +86,17 @@ namespace Vulkan::Device
     struct DeviceState
     {
         VkPhysicalDeviceFeatures PhysicalDeviceFeatures = {};
+        VkPhysicalDeviceProperties PhysicalDeviceProperties = {};
+
+        /* Only enabled when every feature bindless textures need is supported */
+        VkPhysicalDeviceDescriptorIndexingFeatures DescriptorIndexingFeatures = {};
         VkPhysicalDevice PhysicalDevice;
         VkDevice Device;
 
         VkQueue GraphicsQueue;
         uint32 GraphicsQueueFamilyIndex;
 
-        /* Can put this here to begin with, but for multithreading each thread should use its own Pool*/
+        /* Primary command buffers come from here. Pools can only be used by one thread at a time, so threads recording in parallel create their own with CreateCommandPool */
         VkCommandPool CommandPool;
     };
 
@@ -100,8 +104,15 @@ namespace Vulkan::Device
 
     extern void DestroyDevice(DeviceState & kDeviceState);
 
+    extern void CreateCommandPool(DeviceState const & kDeviceState, VkCommandPoolCreateFlags const kFlags, VkCommandPool & OutputCommandPool);
+
+    /* Also frees every command buffer allocated from the pool */
+    extern void DestroyCommandPool(DeviceState const & kDeviceState, VkCommandPool & CommandPool);
+
     extern void CreateCommandBuffers(DeviceState const & kDeviceState, VkCommandBufferLevel const kCommandBufferLevel, uint32 const kCommandBufferCount, std::vector<VkCommandBuffer> & OutputCommandBuffers);
 
+    extern void CreateCommandBuffers(DeviceState const & kDeviceState, VkCommandPool const kCommandPool, VkCommandBufferLevel const kCommandBufferLevel, uint32 const kCommandBufferCount, std::vector<VkCommandBuffer> & OutputCommandBuffers);
+
     extern void DestroyCommandBuffers(DeviceState const & kDeviceState, std::vector<VkCommandBuffer> & CommandBuffers);
 
     extern void CreateSemaphore(DeviceState const & kDeviceState, VkSemaphoreCreateFlags const kFlags, VkSemaphore & OutputSemaphore);
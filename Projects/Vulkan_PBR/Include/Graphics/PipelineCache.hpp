@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Graphics/VulkanModule.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+namespace Vulkan::Device
+{
+    struct DeviceState;
+}
+
+/*
+*   The pipeline cache is saved to disk on shutdown and used to seed the cache on the next run, so warm starts skip most of the driver's pipeline compilation.
+*
+*   Drivers are not required to reject data written by a different device, so the header is checked before the data is handed to the driver.
+*   Missing or invalid data isn't an error, the cache just starts empty.
+*/
+
+namespace Vulkan::PipelineCache
+{
+    /* Checks the header at the start of the data matches the device's vendor, device and pipeline cache UUID */
+    extern bool const IsCacheDataValid(VkPhysicalDeviceProperties const & kDeviceProperties, std::vector<std::byte> const & kCacheData);
+
+    extern bool const CreatePipelineCache(Vulkan::Device::DeviceState const & kDeviceState, std::filesystem::path const & kFilePath, VkPipelineCache & OutputPipelineCache);
+
+    /* Writes the cache data to the file, then destroys the cache */
+    extern bool const DestroyPipelineCache(Vulkan::Device::DeviceState const & kDeviceState, std::filesystem::path const & kFilePath, VkPipelineCache & PipelineCache);
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Graphics/VulkanModule.hpp"
+
+#include <array>
+
+namespace Vulkan::Device
+{
+    struct DeviceState;
+}
+
+/*
+*   Graphics pipelines are requested with a description of their state and built off the render thread.
+*
+*   Requests
+*       - Descriptions are hashed, so requesting the same state twice returns the same handle
+*       - A request never blocks, the handle is returned straight away
+*
+*   Compilation
+*       - Update, called once a frame, queues pipelines whose shaders have finished compiling as background jobs
+*       - GetPipeline fails until the pipeline is ready, callers skip their draws until then
+*
+*   Threading
+*       - Everything other than GetPipeline must be called from the render thread
+*/
+
+namespace Vulkan::Pipelines::Types
+{
+    static constexpr uint32 kMaximumVertexBindingCount = { 4u };
+    static constexpr uint32 kMaximumVertexAttributeCount = { 4u };
+
+    /* Viewport and scissor are always dynamic. Only the first VertexBindingCount bindings and VertexAttributeCount attributes are used, so the rest don't affect the hash */
+    struct GraphicsPipelineDescription
+    {
+        VkPipelineLayout PipelineLayout = {};
+        VkRenderPass RenderPass = {};
+        uint32 SubpassIndex = {};
+
+        /* ShaderLibrary handles, without a fragment shader the pipeline only writes depth */
+        uint16 VertexShaderHandle = {};
+        uint16 FragmentShaderHandle = {};
+
+        uint32 VertexBindingCount = {};
+        std::array<VkVertexInputBindingDescription, kMaximumVertexBindingCount> VertexBindings = {};
+
+        uint32 VertexAttributeCount = {};
+        std::array<VkVertexInputAttributeDescription, kMaximumVertexAttributeCount> VertexAttributes = {};
+
+        VkCullModeFlags CullMode = {};
+
+        /* Every colour attachment of the subpass uses the same blend state */
+        uint32 ColourAttachmentCount = {};
+        VkPipelineColorBlendAttachmentState ColourBlendState = {};
+
+        VkBool32 bDepthTestEnable = {};
+        VkBool32 bDepthWriteEnable = {};
+        VkCompareOp DepthCompareOp = {};
+    };
+}
+
+namespace Vulkan::Pipelines
+{
+    extern void Initialise(Vulkan::Device::DeviceState const & kDeviceState, VkPipelineCache const kPipelineCache);
+
+    /* Waits for pipelines that are still compiling, then destroys every pipeline */
+    extern void Destroy(Vulkan::Device::DeviceState const & kDeviceState);
+
+    extern bool const RequestGraphicsPipeline(Types::GraphicsPipelineDescription const & kDescription, uint16 & OutputPipelineHandle);
+
+    extern void Update(Vulkan::Device::DeviceState const & kDeviceState);
+
+    extern bool const GetPipeline(uint16 const kPipelineHandle, VkPipeline & OutputPipeline);
+}
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include <Vulkan.hpp>
 
 #include <filesystem>
+#include <string>
+#include <vector>
 
 namespace Vulkan::Device
 {
@@ -19,6 +21,12 @@ namespace ShaderLibrary
     /* This could event be uint8, not planning on having 2^16 shaders */
     extern bool const LoadShader(std::filesystem::path const FilePath, uint16 & OutputShaderIndex);
 
+    /* Loads a permutation of the shader, each set of defines gets its own handle */
+    extern bool const LoadShader(std::filesystem::path const FilePath, std::vector<std::string> const & Defines, uint16 & OutputShaderIndex);
+
+    /* Doesn't block, true once compilation has finished even if it failed */
+    extern bool const IsShaderReady(uint16 const ShaderIndex);
+
     extern bool const CreateShaderModule(Vulkan::Device::DeviceState const & DeviceState, uint16 const ShaderIndex, VkShaderModule & OutputShaderModule);
 
     extern void DestroyShaderModules(Vulkan::Device::DeviceState const & DeviceState);
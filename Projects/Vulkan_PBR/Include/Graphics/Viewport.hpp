@@ -34,7 +34,8 @@ namespace Vulkan::Viewport
 
     extern bool const CreateViewport(Vulkan::Instance::InstanceState const & InstanceState, Vulkan::Device::DeviceState const & DeviceState, ViewportState & OutputState);
 
-    extern bool const ResizeViewport(Vulkan::Instance::InstanceState const & InstanceState, Vulkan::Device::DeviceState const & DeviceState, ViewportState & State);
+    /* WindowExtents is only a hint, the surface can fix the size of the swap chain images */
+    extern bool const ResizeViewport(Vulkan::Instance::InstanceState const & InstanceState, Vulkan::Device::DeviceState const & DeviceState, VkExtent2D const & WindowExtents, ViewportState & State);
 
     extern void DestroyViewport(Vulkan::Device::DeviceState const & DeviceState, ViewportState & State);
 }
\ No newline at end of file
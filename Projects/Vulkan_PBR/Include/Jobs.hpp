@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Common.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace Jobs::Types
+{
+    using JobFunction = void (*)(void * Data);
+
+    /* Processes the indices [FirstIndex, EndIndex) */
+    using ParallelForFunction = void (*)(void * Data, uint32 const FirstIndex, uint32 const EndIndex);
+
+    struct Counter;
+
+    struct Job
+    {
+        JobFunction Function = {};
+        void * Data = {};
+
+        /* Incremented when the job is submitted and decremented once it has run, can be NULL */
+        Counter * SignalCounter = {};
+    };
+
+    /* Reaches zero once every job signalling it has run, jobs submitted after it are held here until then */
+    struct Counter
+    {
+        std::atomic<uint32> Value = {};
+
+        std::mutex DependentJobsMutex = {};
+        std::vector<Job> DependentJobs = {};
+    };
+}
+
+namespace Jobs
+{
+    /* Starts one worker per core, minus one for the calling thread, if WorkerCount is zero */
+    extern bool const Initialise(uint32 const WorkerCount = 0u);
+
+    /* Any jobs still queued are run before the workers exit */
+    extern void Destroy();
+
+    extern uint32 const GetWorkerCount();
+
+    /* Jobs are pushed onto the calling thread's queue, idle workers steal from the other end. Runs the job inline if there are no workers */
+    extern void Submit(Types::Job const & Job);
+
+    extern void Submit(Types::Job const * const NewJobs, uint32 const JobCount);
+
+    /* The job is only queued once DependencyCounter reaches zero */
+    extern void SubmitAfter(Types::Counter & DependencyCounter, Types::Job const & Job);
+
+    /*
+        For long running or blocking work that used to own a thread, e.g. shader compilation and log output.
+        These are only picked up by workers that have nothing else to do, and never by WaitForCounter.
+    */
+    extern void SubmitBackground(Types::Job const & Job);
+
+    /* The calling thread runs queued jobs until the counter reaches zero */
+    extern void WaitForCounter(Types::Counter & Counter);
+
+    /* Splits [0, Count) into batches that are pulled by the calling thread and any idle workers, returns once every batch has run */
+    extern void ParallelFor(uint32 const Count, uint32 const BatchSize, Types::ParallelForFunction const Function, void * const Data);
+
+    template<class FunctionType>
+    void ParallelFor(uint32 const Count, uint32 const BatchSize, FunctionType const & Function)
+    {
+        Jobs::ParallelFor(Count, BatchSize,
+                          [](void * Data, uint32 const FirstIndex, uint32 const EndIndex)
+                          {
+                              (*static_cast<FunctionType const *>(Data))(FirstIndex, EndIndex);
+                          },
+                          const_cast<FunctionType *>(&Function));
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "CommonTypes.hpp"
+
+#include <string_view>
+
+/*
+    Program wide interned names for actors, assets and file paths.
+    Each name is hashed and stored once, after that it is a 32 bit ID that compares and hashes as an integer. 0 is the empty name.
+    Safe to use from any thread.
+*/
+namespace Names
+{
+    extern uint32 const Intern(std::string_view const Name);
+
+    /* Outputs 0 if the name has never been interned, without adding it */
+    extern uint32 const Find(std::string_view const Name);
+
+    /* Null terminated and valid for the lifetime of the program */
+    extern std::string_view const GetString(uint32 const NameID);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Common.hpp"
+
+#include <vector>
+
+/*
+    Draws are recorded in the order of 64 bit sort keys, so draws that share state end up next to each other and redundant binds can be skipped.
+    From the most significant bits a key is the pass, pipeline, material, mesh and depth bucket.
+    Nothing here touches the device, so building and sorting keys can be timed without a GPU.
+*/
+namespace RenderQueue::Types
+{
+    enum class Passes : uint8
+    {
+        Opaque,
+    };
+
+    struct QueueData
+    {
+        std::vector<uint64> SortKeys = {};
+
+        /* Moved with the keys, usually the index of the draw the key was built for */
+        std::vector<uint32> Values = {};
+
+        /* Reused by every sort */
+        std::vector<uint64> PackedWords = {};
+        std::vector<uint64> ScratchPackedWords = {};
+        std::vector<uint64> ScratchSortKeys = {};
+        std::vector<uint32> ScratchValues = {};
+    };
+}
+
+namespace RenderQueue
+{
+    /*
+        4 bits of pass, 8 of pipeline, 20 of material, 20 of mesh and 12 of depth bucket.
+        Fields are masked to their bit counts, so handles past the limit only share ordering with other handles and never change what is drawn.
+    */
+    extern uint64 const MakeSortKey(Types::Passes const Pass, uint32 const Pipeline, uint32 const MaterialHandle, uint32 const MeshHandle, uint32 const DepthBucket);
+
+    /* Buckets are spread linearly between the nearest and furthest depth, nearer depths get lower buckets */
+    extern uint32 const GetDepthBucket(float const Depth, float const MinimumDepth, float const MaximumDepth);
+
+    extern void Clear(Types::QueueData & Queue);
+
+    extern void Push(Types::QueueData & Queue, uint64 const SortKey, uint32 const Value);
+
+    /*
+        Stable least significant digit radix sort with 11 bit digits, over only the bits that differ between keys.
+        When those bits fit next to the entry index they are sorted as one packed word, then the keys are rebuilt from it and the values are gathered once at the end.
+    */
+    extern void Sort(Types::QueueData & Queue);
+}
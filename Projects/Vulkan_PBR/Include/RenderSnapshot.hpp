@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Common.hpp"
+
+#include "Components/TransformComponent.hpp"
+
+#include <Math/Affine.hpp>
+#include <Math/Bounds.hpp>
+#include <Math/Matrix.hpp>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace Scene
+{
+    struct SceneData;
+}
+
+/*
+    Everything the renderer needs from the simulation for one frame. Snapshots are built on the simulation thread and only read by the render thread,
+    so the renderer never touches the scene, and the simulation can build frame N + 1 while frame N is being recorded.
+*/
+namespace RenderSnapshot::Types
+{
+    struct DrawPacket
+    {
+        uint32 MeshHandle = {};
+        uint32 MaterialHandle = {};
+        uint32 TransformSlotIndex = {};
+    };
+
+    /* Visible actors sharing a mesh and material, drawn with a single instanced draw */
+    struct DrawBatch
+    {
+        uint32 MeshHandle = {};
+        uint32 MaterialHandle = {};
+
+        /* Range of FrameSnapshot::InstanceTransformSlots, passed to the draw as the first instance so the shader can index with gl_InstanceIndex */
+        uint32 FirstInstanceIndex = {};
+        uint32 InstanceCount = {};
+    };
+
+    struct FrameSnapshot
+    {
+        Math::Matrix4x4 WorldToViewMatrix = {};
+        Math::Matrix4x4 ViewToClipMatrix = {};
+        Math::FrustumPlanes FrustumPlanes = {};
+
+        /* In render queue order, see RenderQueue.hpp */
+        std::vector<DrawBatch> DrawBatches = {};
+
+        /* One per actor in the view frustum, or per actor with a static mesh when culling on the GPU. Indexes the transform buffer */
+        std::vector<uint32> InstanceTransformSlots = {};
+
+        /* The transform buffer needs at least this many slots */
+        uint32 TransformSlotCount = {};
+
+        /* World transforms that changed since the previous snapshot, packed in the same order as the ranges */
+        std::vector<Components::Transform::Types::SlotRange> TransformRanges = {};
+        std::vector<Math::Affine3x4> Transforms = {};
+
+        /* Not set by Build. Static meshes are drawn to the depth buffer first, then shaded with an EQUAL depth test */
+        bool bDepthPrePass = {};
+
+        /* Not set by Build. The window's client area when the snapshot was built, the swap chain is resized to it as the window is only touched by the simulation thread */
+        uint32 WindowWidth = {};
+        uint32 WindowHeight = {};
+    };
+
+    /*
+        Single producer and single consumer. Every snapshot is read in order and none are dropped, as the transforms are only the changes since the previous one.
+        With two snapshots the simulation can be at most one frame ahead of the renderer.
+    */
+    struct SnapshotQueue
+    {
+        std::array<FrameSnapshot, 2u> Snapshots = {};
+
+        std::atomic<uint64> PublishedCount = {};
+        std::atomic<uint64> ReleasedCount = {};
+
+        /* Either end sleeps here rather than spinning while the other catches up, the counts are still read without the lock */
+        std::mutex SleepMutex = {};
+        std::condition_variable SleepCondition = {};
+
+        /* Guarded by SleepMutex. While minimised the render thread sleeps, rather than retrying a frame that can't be presented */
+        bool bMinimised = {};
+        bool bClosed = {};
+    };
+}
+
+namespace RenderSnapshot
+{
+    /*
+        Call after SpatialIndex::Synchronise. At most MaximumTransformCount changed transforms are taken, the rest stay dirty for the next snapshot.
+        With bCullOnGPU the batches hold every actor with a static mesh rather than only those in the view frustum, and the renderer culls the instances.
+    */
+    extern void Build(Scene::SceneData const & Scene, uint32 const MaximumTransformCount, bool const bCullOnGPU, Types::FrameSnapshot & OutputSnapshot);
+
+    /* Simulation thread. Fails while the render thread is still using both snapshots */
+    extern bool const BeginWrite(Types::SnapshotQueue & Queue, Types::FrameSnapshot *& OutputSnapshot);
+
+    /* Hands the snapshot from BeginWrite to the render thread */
+    extern void EndWrite(Types::SnapshotQueue & Queue);
+
+    /* Render thread. Fails if nothing has been published since the last EndRead */
+    extern bool const BeginRead(Types::SnapshotQueue & Queue, Types::FrameSnapshot const *& OutputSnapshot);
+
+    /* The snapshot can be reused by the simulation thread after this */
+    extern void EndRead(Types::SnapshotQueue & Queue);
+
+    /* Simulation thread. BeginWrite, sleeping for up to TimeoutInMilliseconds until it can succeed, so window messages are still handled while the render thread is stalled. Fails once closed */
+    extern bool const WaitToWrite(Types::SnapshotQueue & Queue, uint32 const TimeoutInMilliseconds, Types::FrameSnapshot *& OutputSnapshot);
+
+    /* Render thread. BeginRead, sleeping until a snapshot is published and the window isn't minimised. Fails once closed */
+    extern bool const WaitToRead(Types::SnapshotQueue & Queue, Types::FrameSnapshot const *& OutputSnapshot);
+
+    /* Render thread, after a frame that couldn't be presented. Usually the window was minimised, so this sleeps until the simulation thread reports it, for at most TimeoutInMilliseconds */
+    extern void WaitForMinimised(Types::SnapshotQueue & Queue, uint32 const TimeoutInMilliseconds);
+
+    /* Simulation thread, after handling window messages */
+    extern void SetMinimised(Types::SnapshotQueue & Queue, bool const bMinimised);
+
+    /* Wakes both threads, every wait fails after this */
+    extern void Close(Types::SnapshotQueue & Queue);
+}
@@ -3,9 +3,10 @@
 #include "CommonTypes.hpp"
 
 #include "Camera.hpp"
+#include "Components/Archetypes.hpp"
 
-#include <unordered_map>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <queue>
 
@@ -23,13 +24,47 @@ namespace Scene
         StaticMesh = Transform << 1u,
     };
 
+    /*
+        Actor handles are 32 bits, the low bits store the actor index + 1 (so 0 is the NULL handle) and the high bits store a generation.
+        The generation is bumped every time an actor is destroyed, so stale handles can be detected in O(1).
+    */
+    static constexpr uint32 kActorIndexBitCount = { 22u };
+    static constexpr uint32 kActorGenerationBitCount = { 32u - kActorIndexBitCount };
+
+    static constexpr uint32 kActorIndexMask = { (1u << kActorIndexBitCount) - 1u };
+    static constexpr uint32 kActorGenerationMask = { (1u << kActorGenerationBitCount) - 1u };
+
+    /* Index + 1 must fit in the index bits */
+    static constexpr uint32 kMaximumActorCount = { kActorIndexMask };
+
+    constexpr uint32 const MakeActorHandle(uint32 const ActorIndex, uint32 const Generation)
+    {
+        return ((Generation & kActorGenerationMask) << kActorIndexBitCount) | (ActorIndex + 1u);
+    }
+
+    /* Only valid for non-NULL handles */
+    constexpr uint32 const GetActorIndex(uint32 const ActorHandle)
+    {
+        return (ActorHandle & kActorIndexMask) - 1u;
+    }
+
+    constexpr uint32 const GetActorGeneration(uint32 const ActorHandle)
+    {
+        return ActorHandle >> kActorIndexBitCount;
+    }
+
     struct SceneData
     {
-        std::unordered_map<std::string, uint32> ActorNameToHandleMap = {};
+        /* Indexed by name ID - 1, the most recently created actor with the name or NULL. Actors store the ID of their name */
+        std::vector<uint32> NameActorHandles = {};
 
-        std::queue<uint32> FreeActorHandles = {};
+        /* FIFO so that an index is reused as late as possible, this makes generation wrap around less likely to alias a stale handle */
+        std::queue<uint32> FreeActorIndices = {};
 
+        /* Indexed by actor index */
         std::vector<uint32> ComponentMasks = {};
+        std::vector<uint16> ActorGenerations = {};
+        std::vector<uint32> ActorNameIDs = {};
 
         Camera::CameraState MainCamera = {};
 
@@ -38,7 +73,22 @@ namespace Scene
 
     extern bool const CreateActor(SceneData & Scene, ActorData const & NewActorData, uint32 & OutputActorHandle);
 
-    //extern bool const DestroyActor(SceneData & Scene, uint32 const ActorHandle);
+    /*
+        Creates ActorCount actors that share the components in ComponentMask, component columns are copied straight into the archetype chunks.
+        ActorNames can be NULL, as can any name in it. One line is logged for the whole batch rather than one per actor.
+    */
+    extern bool const CreateActors(SceneData & Scene, uint32 const ComponentMask, uint32 const ActorCount, Components::Archetypes::Types::ColumnData const & ColumnData,
+                                   std::string_view const * const ActorNames, uint32 * const OutputActorHandles);
+
+    extern bool const DestroyActor(SceneData & Scene, uint32 const ActorHandle);
+
+    extern bool const IsActorValid(SceneData const & Scene, uint32 const ActorHandle);
 
     extern bool const DoesActorHaveComponents(SceneData const & Scene, uint32 const ActorHandle, uint32 const ComponentMask);
+
+    /* Outputs the most recently created actor with the name */
+    extern bool const FindActor(SceneData const & Scene, std::string_view const ActorName, uint32 & OutputActorHandle);
+
+    /* Empty for unnamed actors and invalid handles */
+    extern std::string_view const GetActorName(SceneData const & Scene, uint32 const ActorHandle);
 }
\ No newline at end of file
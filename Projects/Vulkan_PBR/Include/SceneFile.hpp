@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Common.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+namespace Scene
+{
+    struct SceneData;
+}
+
+/*
+    Binary scene files. Actors are stored in blocks that share a component mask, and each block stores its component columns
+    back to back (SoA) like the archetype chunks do, so loading is one read followed by a copy per column.
+    Assets are referenced by name and by file path relative to the scene file, they are only imported if no asset with that name is loaded.
+*/
+namespace SceneFile
+{
+    /* Adds the actors in the file to the scene, their handles are appended to OutputActorHandles in file order */
+    extern bool const Load(std::filesystem::path const & FilePath, Scene::SceneData & Scene, std::vector<uint32> & OutputActorHandles);
+
+    /* Only reads the file contents, so it can run on any thread. Load is ReadFile followed by LoadFromMemory */
+    extern bool const ReadFile(std::filesystem::path const & FilePath, std::vector<std::byte> & OutputFileData);
+
+    /* Same as Load for file contents that have already been read, asset paths are relative to SceneDirectoryPath */
+    extern bool const LoadFromMemory(std::vector<std::byte> FileData, std::filesystem::path const & SceneDirectoryPath, Scene::SceneData & Scene, std::vector<uint32> & OutputActorHandles);
+
+    /*
+        Writes actors along with the assets they reference, every actor in the scene is written if ActorHandles is NULL.
+        Parents that aren't written are dropped, so the transforms of their children become world transforms.
+    */
+    extern bool const Save(std::filesystem::path const & FilePath, Scene::SceneData const & Scene, uint32 const * const ActorHandles = nullptr, uint32 const ActorCount = 0u);
+}
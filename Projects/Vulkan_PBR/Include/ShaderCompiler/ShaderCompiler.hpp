@@ -5,6 +5,7 @@
 #include "CommonTypes.hpp"
 
 #include <filesystem>
+#include <string>
 #include <vector>
 #include <future>
 
@@ -13,5 +14,6 @@ namespace ShaderCompiler
     extern bool const Initialise();
     extern void Destroy();
 
-    extern bool const CompileShader(std::filesystem::path const & FilePath, unsigned int *& OutputByteCode, uint64 & OutputByteCodeSizeInBytes, std::basic_string<Platform::Windows::Types::Char> & OutputErrorMessage);
+    /* Each define is added as #define <Define> straight after the #version directive */
+    extern bool const CompileShader(std::filesystem::path const & FilePath, std::vector<std::string> const & Defines, unsigned int *& OutputByteCode, uint64 & OutputByteCodeSizeInBytes, std::basic_string<Platform::Windows::Types::Char> & OutputErrorMessage);
 }
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Common.hpp"
+
+#include <Math/Bounds.hpp>
+#include <Math/Vector.hpp>
+
+#include <vector>
+
+namespace Scene
+{
+    struct SceneData;
+}
+
+/*
+    Dynamic bounding volume hierarchy over actor bounds, with one actor per leaf.
+    Leaves store bounds that are slightly larger than the actor, so small movements don't change the tree.
+    Actors that move outside their leaf bounds are removed and reinserted where they add the least surface area,
+    and the whole tree is rebuilt with a binned SAH once enough of it has changed.
+*/
+namespace SpatialIndex::Types
+{
+    struct RayHit
+    {
+        uint32 ActorHandle = {};
+        float Distance = {};
+    };
+}
+
+namespace SpatialIndex
+{
+    /* Inserts the actor, or moves it if it is already in the index. Bounds are in world space */
+    extern void UpdateActor(uint32 const ActorHandle, Math::AABB const & Bounds);
+
+    /* Does nothing if the actor isn't in the index */
+    extern void RemoveActor(uint32 const ActorHandle);
+
+    /* For changes that don't move the transform, e.g. a new mesh. Picked up by the next Synchronise */
+    extern void MarkActorDirty(uint32 const ActorHandle);
+
+    /* Updates the bounds of moved and dirty actors from their world transform and mesh bounds, call after UpdateWorldTransforms */
+    extern void Synchronise(Scene::SceneData const & Scene);
+
+    /* Rebuilds the tree top down, used for bulk loads and when incremental updates have degraded the tree */
+    extern void Rebuild();
+
+    /* Outputs every actor whose bounds intersect the frustum, large trees are traversed in parallel */
+    extern void QueryFrustum(Math::FrustumPlanes const & Planes, std::vector<uint32> & OutputActorHandles);
+
+    extern void QueryOverlap(Math::AABB const & Bounds, std::vector<uint32> & OutputActorHandles);
+
+    /* Finds the closest actor bounds hit by the ray, Direction does not need to be normalised but distances are in units of it */
+    extern bool const RayCast(Math::Vector3 const & Origin, Math::Vector3 const & Direction, float const MaximumDistance, Types::RayHit & OutputHit);
+
+    extern uint32 const GetActorCount();
+
+    /* Sum of internal node surface areas relative to the root, lower is better. For measuring tree quality */
+    extern float const GetTreeCost();
+}
@@ -4,90 +4,173 @@
 
 #include <vector>
 
+/*
+    Slot map. Values are packed densely so iterating them is a linear scan with no holes, and slots map stable handles to dense indices.
+    Handles store the slot index + 1 in the low bits (so 0 is the NULL handle) and the slot generation in the high bits.
+    The generation is bumped when a value is removed, so stale handles are detected instead of aliasing the next value in the slot.
+    A slot is retired instead of wrapping its generation back to zero, so a stale handle can never match a later value.
+*/
 template<class TDataType>
 class SparseVector
 {
-    union Node
-    {
-        TDataType Value = {};
+public:
+    static constexpr uint32 kSlotIndexBitCount = { 24u };
+    static constexpr uint32 kSlotIndexMask = { (1u << kSlotIndexBitCount) - 1u };
+    static constexpr uint32 kGenerationMask = { (1u << (32u - kSlotIndexBitCount)) - 1u };
 
-        struct
-        {
-            uint32 NextFreeIndex = {};
-        } Internal;
-    };
+    /* Stored as the dense index of retired slots, never a valid dense index so Contains rejects every handle to the slot */
+    static constexpr uint32 kRetiredDenseIndex = { ~0u };
 
-public:
     SparseVector() = default;
 
-    uint32 Add(TDataType const & kData)
+    /* Outputs the handle for the value, or NULL when every slot index is in use or retired */
+    uint32 const Add(TDataType const & kData)
     {
-        uint32 DataIndex = {};
+        uint32 SlotIndex = {};
 
         if (FreeSlotCount_ > 0u)
         {
-            DataIndex = FirstFreeSlotIndex_;
-            FirstFreeSlotIndex_ = Data_ [FirstFreeSlotIndex_].Internal.NextFreeIndex;
-
-            Data_ [DataIndex].Value = kData;
-            FreeSlotFlags_ [DataIndex] = false;
+            SlotIndex = FirstFreeSlotIndex_;
+            FirstFreeSlotIndex_ = SlotDenseIndices_ [SlotIndex];
 
             FreeSlotCount_--;
         }
         else
         {
-            DataIndex = static_cast<uint32>(Data_.size());
+            SlotIndex = static_cast<uint32>(SlotDenseIndices_.size());
 
-            Data_.emplace_back(Node { kData });
-            FreeSlotFlags_.push_back(false);
+            /* The slot index + 1 has to fit in the handle's index bits */
+            if (SlotIndex >= kSlotIndexMask)
+            {
+                return 0u;
+            }
+
+            SlotDenseIndices_.emplace_back();
+            SlotGenerations_.emplace_back();
         }
 
-        return DataIndex;
+        uint32 const kHandle = (SlotGenerations_ [SlotIndex] << kSlotIndexBitCount) | (SlotIndex + 1u);
+
+        SlotDenseIndices_ [SlotIndex] = static_cast<uint32>(Values_.size());
+
+        Values_.push_back(kData);
+        DenseHandles_.push_back(kHandle);
+
+        return kHandle;
     }
 
-    void Remove(uint32 const kIndex)
+    /* The last value is moved into the removed value's place, so pointers and dense indices are not stable across removals */
+    bool const Remove(uint32 const kHandle)
     {
-        if (FreeSlotCount_ == 0u)
+        if (!Contains(kHandle))
         {
-            FirstFreeSlotIndex_ = kIndex;
+            return false;
         }
-        else
+
+        uint32 const kSlotIndex = (kHandle & kSlotIndexMask) - 1u;
+        uint32 const kDenseIndex = SlotDenseIndices_ [kSlotIndex];
+        uint32 const kLastDenseIndex = static_cast<uint32>(Values_.size() - 1u);
+
+        if (kDenseIndex != kLastDenseIndex)
         {
-            Data_ [LastFreeSlotIndex_].Internal.NextFreeIndex = kIndex;
+            Values_ [kDenseIndex] = std::move(Values_ [kLastDenseIndex]);
+            DenseHandles_ [kDenseIndex] = DenseHandles_ [kLastDenseIndex];
+
+            SlotDenseIndices_ [(DenseHandles_ [kDenseIndex] & kSlotIndexMask) - 1u] = kDenseIndex;
         }
 
-        Data_ [kIndex].Internal.NextFreeIndex = FirstFreeSlotIndex_;
+        Values_.pop_back();
+        DenseHandles_.pop_back();
 
-        LastFreeSlotIndex_ = kIndex;
-        FreeSlotFlags_ [kIndex] = true;
+        /* Every generation of this slot has been handed out, reusing it would make the first handle valid again */
+        if (SlotGenerations_ [kSlotIndex] == kGenerationMask)
+        {
+            SlotDenseIndices_ [kSlotIndex] = kRetiredDenseIndex;
+            return true;
+        }
+
+        SlotGenerations_ [kSlotIndex]++;
+
+        /* Freed slots form a list through their dense indices */
+        SlotDenseIndices_ [kSlotIndex] = FirstFreeSlotIndex_;
+        FirstFreeSlotIndex_ = kSlotIndex;
         FreeSlotCount_++;
+
+        return true;
     }
 
-    inline TDataType & operator [] (uint32 const kIndex)
+    /* False for NULL and stale handles */
+    inline bool const Contains(uint32 const kHandle) const
     {
-        return Data_ [kIndex].Value;
+        uint32 const kSlotIndex = (kHandle & kSlotIndexMask) - 1u;
+
+        return kHandle != 0u
+            && kSlotIndex < SlotGenerations_.size()
+            && SlotGenerations_ [kSlotIndex] == (kHandle >> kSlotIndexBitCount)
+            && SlotDenseIndices_ [kSlotIndex] < DenseHandles_.size()
+            && DenseHandles_ [SlotDenseIndices_ [kSlotIndex]] == kHandle;
+    }
+
+    /* Only valid for handles that Contains accepts */
+    inline TDataType & operator [] (uint32 const kHandle)
+    {
+        return Values_ [SlotDenseIndices_ [(kHandle & kSlotIndexMask) - 1u]];
+    }
+
+    inline TDataType const & operator [] (uint32 const kHandle) const
+    {
+        return Values_ [SlotDenseIndices_ [(kHandle & kSlotIndexMask) - 1u]];
+    }
+
+    /* Dense access, Handles() [i] is the handle for Data() [i] */
+    inline TDataType * const Data()
+    {
+        return Values_.data();
     }
 
-    inline TDataType const & operator [] (uint32 const kIndex) const
+    inline TDataType const * const Data() const
     {
-        return Data_ [kIndex].Value;
+        return Values_.data();
     }
 
+    inline uint32 const * const Handles() const
+    {
+        return DenseHandles_.data();
+    }
+
+    inline auto begin() { return Values_.begin(); }
+    inline auto end() { return Values_.end(); }
+    inline auto begin() const { return Values_.cbegin(); }
+    inline auto end() const { return Values_.cend(); }
+
     inline uint32 const Size() const
     {
-        return Data_.size() - FreeSlotCount_;
+        return static_cast<uint32>(Values_.size());
     }
 
+    /* Number of slots, including free and retired ones */
     inline uint32 const ActualSize() const
     {
-        return Data_.size();
+        return static_cast<uint32>(SlotDenseIndices_.size());
+    }
+
+    void Reserve(uint32 const kCapacity)
+    {
+        Values_.reserve(kCapacity);
+        DenseHandles_.reserve(kCapacity);
+        SlotDenseIndices_.reserve(kCapacity);
+        SlotGenerations_.reserve(kCapacity);
     }
 
 private:
-    std::vector<bool> FreeSlotFlags_ = {};
-    std::vector<Node> Data_ = {};
+    /* Indexed by dense index */
+    std::vector<TDataType> Values_ = {};
+    std::vector<uint32> DenseHandles_ = {};
+
+    /* Indexed by slot index, free slots store the next free slot index instead */
+    std::vector<uint32> SlotDenseIndices_ = {};
+    std::vector<uint32> SlotGenerations_ = {};
 
     uint32 FreeSlotCount_ = {};
     uint32 FirstFreeSlotIndex_ = {};
-    uint32 LastFreeSlotIndex_ = {};
 };
\ No newline at end of file
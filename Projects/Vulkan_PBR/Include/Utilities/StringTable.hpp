@@ -0,0 +1,184 @@
+#pragma once
+
+#include "CommonTypes.hpp"
+
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+/*
+    Interns strings and hands out 32 bit IDs, so each string is hashed and stored once and compared by ID after that.
+    IDs are dense and start at 1, 0 is the empty string. Strings are never removed.
+*/
+class StringTable
+{
+public:
+    StringTable() = default;
+
+    uint32 const Intern(std::string_view const kString)
+    {
+        if (kString.empty())
+        {
+            return 0u;
+        }
+
+        uint64 const kHash = std::hash<std::string_view> {}(kString);
+
+        uint32 SlotIndex = FindSlot(kString, kHash);
+
+        if (Slots_.size() > 0u && Slots_ [SlotIndex] != 0u)
+        {
+            return Slots_ [SlotIndex];
+        }
+
+        /* Kept at most half full so probe sequences stay short */
+        if ((Strings_.size() + 1u) * 2u > Slots_.size())
+        {
+            Grow();
+            SlotIndex = FindSlot(kString, kHash);
+        }
+
+        uint32 const kID = static_cast<uint32>(Strings_.size() + 1u);
+
+        Strings_.push_back(StoreCharacters(kString));
+        Lengths_.push_back(static_cast<uint32>(kString.size()));
+        Hashes_.push_back(kHash);
+
+        Slots_ [SlotIndex] = kID;
+
+        return kID;
+    }
+
+    /* Outputs 0 if the string hasn't been interned */
+    uint32 const Find(std::string_view const kString) const
+    {
+        if (kString.empty() || Slots_.size() == 0u)
+        {
+            return 0u;
+        }
+
+        return Slots_ [FindSlot(kString, std::hash<std::string_view> {}(kString))];
+    }
+
+    /* Null terminated, and valid for as long as the table is since characters are never moved */
+    std::string_view const Get(uint32 const kID) const
+    {
+        if (kID == 0u || kID > Strings_.size())
+        {
+            return std::string_view {};
+        }
+
+        return std::string_view { Strings_ [kID - 1u], Lengths_ [kID - 1u] };
+    }
+
+    void Reserve(uint32 const kStringCount)
+    {
+        Strings_.reserve(kStringCount);
+        Lengths_.reserve(kStringCount);
+        Hashes_.reserve(kStringCount);
+    }
+
+    inline uint32 const Size() const
+    {
+        return static_cast<uint32>(Strings_.size());
+    }
+
+private:
+    static constexpr uint64 kBlockSizeInBytes = { 64u * 1024u };
+
+    /* Linear probing, outputs the slot holding the string or the empty slot it would go in */
+    uint32 const FindSlot(std::string_view const kString, uint64 const kHash) const
+    {
+        if (Slots_.size() == 0u)
+        {
+            return 0u;
+        }
+
+        uint64 const kSlotMask = Slots_.size() - 1u;
+        uint64 SlotIndex = kHash & kSlotMask;
+
+        while (Slots_ [SlotIndex] != 0u)
+        {
+            uint32 const kID = Slots_ [SlotIndex];
+
+            if (Hashes_ [kID - 1u] == kHash && Get(kID) == kString)
+            {
+                break;
+            }
+
+            SlotIndex = (SlotIndex + 1u) & kSlotMask;
+        }
+
+        return static_cast<uint32>(SlotIndex);
+    }
+
+    /* Stored hashes are reused, so no string is hashed twice */
+    void Grow()
+    {
+        uint64 const kSlotCount = Slots_.size() > 0u ? Slots_.size() * 2u : 64u;
+        uint64 const kSlotMask = kSlotCount - 1u;
+
+        Slots_.assign(kSlotCount, 0u);
+
+        for (uint32 CurrentID = { 1u };
+             CurrentID <= Strings_.size();
+             CurrentID++)
+        {
+            uint64 SlotIndex = Hashes_ [CurrentID - 1u] & kSlotMask;
+
+            while (Slots_ [SlotIndex] != 0u)
+            {
+                SlotIndex = (SlotIndex + 1u) & kSlotMask;
+            }
+
+            Slots_ [SlotIndex] = CurrentID;
+        }
+    }
+
+    /* Strings are packed into fixed size blocks, anything larger than a block gets one to itself */
+    char const * const StoreCharacters(std::string_view const kString)
+    {
+        uint64 const kSizeInBytes = kString.size() + 1u;
+
+        char * Characters = {};
+
+        if (kSizeInBytes > kBlockSizeInBytes)
+        {
+            Blocks_.emplace_back(new char [kSizeInBytes]);
+            Characters = Blocks_.back().get();
+        }
+        else
+        {
+            if (!CurrentBlock_ || kSizeInBytes > kBlockSizeInBytes - BlockOffsetInBytes_)
+            {
+                Blocks_.emplace_back(new char [kBlockSizeInBytes]);
+
+                CurrentBlock_ = Blocks_.back().get();
+                BlockOffsetInBytes_ = 0u;
+            }
+
+            Characters = CurrentBlock_ + BlockOffsetInBytes_;
+            BlockOffsetInBytes_ += kSizeInBytes;
+        }
+
+        std::memcpy(Characters, kString.data(), kString.size());
+        Characters [kString.size()] = '\0';
+
+        return Characters;
+    }
+
+    std::vector<std::unique_ptr<char []>> Blocks_ = {};
+
+    char * CurrentBlock_ = {};
+    uint64 BlockOffsetInBytes_ = {};
+
+    /* Indexed by ID - 1 */
+    std::vector<char const *> Strings_ = {};
+    std::vector<uint32> Lengths_ = {};
+    std::vector<uint64> Hashes_ = {};
+
+    /* Open addressed, holds IDs with 0 for empty slots */
+    std::vector<uint32> Slots_ = {};
+};
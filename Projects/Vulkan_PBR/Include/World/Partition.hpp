@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Common.hpp"
+
+#include "World/Streaming.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+namespace Scene
+{
+    struct SceneData;
+}
+
+/*
+    A partitioned world is a world file plus one scene file per cell. Each cell file is an ordinary scene file, so it carries its own
+    actor and asset manifest, and the world file stores the cell bounds and memory sizes the streaming scheduler works from.
+*/
+namespace World::Partition::Types
+{
+    enum class ReadStates : uint8
+    {
+        Idle,
+        Reading,
+        Succeeded,
+        Failed,
+    };
+
+    struct CellData
+    {
+        std::filesystem::path FilePath = {};
+
+        /* Filled in by a background job, only touched by the streaming thread once the read state is no longer Reading */
+        std::vector<std::byte> FileData = {};
+        std::atomic<ReadStates> ReadState = {};
+
+        std::vector<uint32> ActorHandles = {};
+    };
+
+    struct WorldData
+    {
+        Streaming::Types::WorldLayout Layout = {};
+
+        /* Indexed by cell index */
+        std::vector<CellData> Cells = {};
+
+        Scene::SceneData * Scene = {};
+    };
+}
+
+namespace World::Partition
+{
+    /*
+        Splits the scene into a grid of cubic cells, writing a scene file per cell next to the world file. Call after UpdateWorldTransforms.
+        Actors are placed by the world position of the root of their hierarchy so hierarchies are never split,
+        and actors without a transform go in a cell that is always loaded.
+    */
+    extern bool const Build(Scene::SceneData const & Scene, float const CellSize, std::filesystem::path const & WorldFilePath);
+
+    /* Reads the world file, no cells are loaded until streaming starts */
+    extern bool const LoadWorld(std::filesystem::path const & WorldFilePath, Types::WorldData & OutputWorld);
+
+    /* Cells are read on a background job and added to the scene when the scheduler integrates them. World must outlive the streaming state */
+    extern Streaming::Types::Loader const CreateLoader(Types::WorldData & World, Scene::SceneData & Scene);
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "Common.hpp"
+
+#include <Math/Bounds.hpp>
+#include <Math/Vector.hpp>
+
+#include <vector>
+
+/*
+    Decides which world cells should be in memory around a view position, under a memory budget and a per update time slice.
+    The scheduler doesn't load anything itself, it calls into a Loader. That keeps it independent of the scene,
+    so a camera path can be replayed against a fake loader to check residency and budgets without a window or device.
+*/
+namespace World::Streaming::Types
+{
+    enum class CellStates : uint8
+    {
+        Unloaded,
+        Loading,
+        Loaded,
+        Resident,
+        Failed,
+    };
+
+    struct CellDesc
+    {
+        Math::AABB Bounds = {};
+
+        /* Actors and components once the cell is in the scene. Assets are counted separately as cells share them */
+        uint64 ActorSizeInBytes = {};
+
+        /* Range of WorldLayout::CellAssetIndices */
+        uint32 FirstAssetIndex = {};
+        uint32 AssetCount = {};
+    };
+
+    struct WorldLayout
+    {
+        std::vector<CellDesc> Cells = {};
+        std::vector<uint32> CellAssetIndices = {};
+
+        /* Indexed by asset index */
+        std::vector<uint64> AssetSizesInBytes = {};
+    };
+
+    struct Settings
+    {
+        /* Cells are loaded within LoadDistance of the view and unloaded beyond UnloadDistance, the gap stops cells on the edge from thrashing */
+        float LoadDistance = {};
+        float UnloadDistance = {};
+
+        /* Memory is reserved when a load starts, so cells that are still loading count against the budget */
+        uint64 MemoryBudgetInBytes = {};
+
+        /* Time spent adding and removing cells per update, at least one cell is added per update so streaming always makes progress */
+        uint64 TimeSliceInNanoSeconds = {};
+
+        uint32 MaximumLoadingCellCount = {};
+    };
+
+    /* Every function is called from the thread that calls Update */
+    struct Loader
+    {
+        void * Data = {};
+
+        /* Starts loading the cell in the background, this must not block */
+        void (*BeginLoad)(void * Data, uint32 const CellIndex) = {};
+
+        bool const (*IsLoadComplete)(void * Data, uint32 const CellIndex) = {};
+
+        /* Adds a loaded cell to the scene. A cell that fails is unloaded and never tried again */
+        bool const (*Integrate)(void * Data, uint32 const CellIndex, uint64 & OutputTimeInNanoSeconds) = {};
+
+        /* Removes a loaded or resident cell */
+        void (*Unload)(void * Data, uint32 const CellIndex, uint64 & OutputTimeInNanoSeconds) = {};
+
+        /* Called once no loading or resident cell uses the asset. Returning false keeps the asset resident, and it stays counted against the budget */
+        bool const (*ReleaseAsset)(void * Data, uint32 const AssetIndex) = {};
+    };
+
+    struct UpdateStatistics
+    {
+        uint32 StartedLoadCount = {};
+        uint32 IntegratedCellCount = {};
+        uint32 UnloadedCellCount = {};
+
+        /* Cells in range that were left unloaded because they didn't fit in the budget */
+        uint32 DeferredCellCount = {};
+
+        uint64 TimeInNanoSeconds = {};
+    };
+
+    struct StreamingState
+    {
+        WorldLayout Layout = {};
+        Settings StreamingSettings = {};
+        Loader CellLoader = {};
+
+        /* Indexed by cell index */
+        std::vector<CellStates> CurrentCellStates = {};
+        std::vector<float> CellDistances = {};
+
+        /* Indexed by asset index */
+        std::vector<uint32> AssetReferenceCounts = {};
+        std::vector<uint8> ResidentAssets = {};
+
+        uint64 ResidentSizeInBytes = {};
+        uint32 LoadingCellCount = {};
+
+        /* Reused between updates */
+        std::vector<uint32> SortedCellIndices = {};
+    };
+}
+
+namespace World::Streaming
+{
+    /* Every cell starts unloaded. Fails if an asset index is out of range or a loader function is NULL */
+    extern bool const Initialise(Types::StreamingState & State, Types::WorldLayout Layout, Types::Settings const & Settings, Types::Loader const & Loader);
+
+    /* Loads are started closest first, and resident cells further away than a cell that doesn't fit are evicted to make room */
+    extern void Update(Types::StreamingState & State, Math::Vector3 const & ViewPosition, Types::UpdateStatistics * const OutputStatistics = nullptr);
+
+    /* Waits for loads in progress, then unloads every cell */
+    extern void UnloadAll(Types::StreamingState & State);
+
+    /* Zero inside the bounds */
+    extern float const GetCellDistance(Types::CellDesc const & Cell, Math::Vector3 const & Position);
+
+    /* Loading, loaded and resident cells, plus assets that are still resident */
+    extern uint64 const GetResidentSizeInBytes(Types::StreamingState const & State);
+}
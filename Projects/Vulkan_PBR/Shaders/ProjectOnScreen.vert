@@ -7,43 +7,89 @@ uniform PerFrameData
     mat4x4 ViewToClipMatrix;
 };
 
-layout (set = 1, binding = 0)
+/* Transform slot of each instance, gl_InstanceIndex includes the first instance of the draw */
+layout (set = 0, binding = 2, std430)
+readonly buffer InstanceData
+{
+    uint InstanceTransformSlots [];
+};
+
+/* Affine transforms, 3 rows of 4 columns */
+layout (set = 0, binding = 3, row_major, std430)
+readonly buffer TransformData
+{
+    mat4x3 ModelToWorldMatrices [];
+};
+
+/* Bound with a dynamic offset per draw */
+layout (set = 2, binding = 0, row_major)
 uniform PerDrawData
 {
-    mat4x4 ModelToWorldMatrix;
+    mat4x3 MeshToModelMatrix;
 };
 
-layout (location = 0) in vec3 Position;
-layout (location = 1) in vec3 Normal;
-layout (location = 2) in vec4 Tangent;
-layout (location = 3) in vec3 UV;
+layout (location = 0) in vec3 Position; // Quantised to the mesh bounds, the dequantisation is part of MeshToModelMatrix
+
+/* The depth pre-pass only reads the position stream */
+#ifndef DEPTH_ONLY
+layout (location = 1) in vec2 Normal; // Octahedral
+layout (location = 2) in ivec2 Tangent; // Octahedral, with the bitangent sign in the lowest bit of Y
+layout (location = 3) in vec2 UV;
 
 layout (location = 0) out vec3 FragmentPositionWS;
 layout (location = 1) out vec3 FragmentPositionVS;
 layout (location = 2) out vec3 FragmentNormalWS;
 layout (location = 3) out vec4 FragmentTangentWS;
-layout (location = 4) out vec3 FragmentUV;
+layout (location = 4) out vec2 FragmentUV;
 layout (location = 5) out vec3 ViewPositionWS;
+#endif
+
+/* The scene pass tests EQUAL against the pre-pass depth, so both permutations have to produce exactly the same position */
+invariant gl_Position;
 
 const vec3 DiffuseAlbedo = vec3(0.1f, 0.1f, 0.8f);
 
-const mat4x4 UpAxisConversion = mat4x4(1.0f, 0.0f, 0.0f, 0.0f,
-                                       0.0f, 0.0f, 1.0f, 0.0f,
-                                       0.0f, -1.0f, 0.0f, 0.0f, 
-                                       0.0f, 0.0f, 0.0f, 1.0f);
+vec3 DecodeOctahedral(vec2 Encoded)
+{
+    vec3 Vector = vec3(Encoded.xy, 1.0f - abs(Encoded.x) - abs(Encoded.y));
+
+    if (Vector.z < 0.0f)
+    {
+        Vector.xy = (1.0f - abs(Vector.yx)) * vec2(Vector.x >= 0.0f ? 1.0f : -1.0f, Vector.y >= 0.0f ? 1.0f : -1.0f);
+    }
+
+    return normalize(Vector);
+}
 
 void main()
 {
-    mat4x4 Transformation = ModelToWorldMatrix * UpAxisConversion;
+    mat4x3 ModelToWorldMatrix = ModelToWorldMatrices [InstanceTransformSlots [gl_InstanceIndex]];
+
+    /* The up axis conversion is folded into MeshToModelMatrix */
+    mat4x4 Transformation = mat4x4(vec4(ModelToWorldMatrix [0u], 0.0f),
+                                   vec4(ModelToWorldMatrix [1u], 0.0f),
+                                   vec4(ModelToWorldMatrix [2u], 0.0f),
+                                   vec4(ModelToWorldMatrix [3u], 1.0f))
+                          * mat4x4(vec4(MeshToModelMatrix [0u], 0.0f),
+                                   vec4(MeshToModelMatrix [1u], 0.0f),
+                                   vec4(MeshToModelMatrix [2u], 0.0f),
+                                   vec4(MeshToModelMatrix [3u], 1.0f));
 
     vec4 PositionWS = Transformation * vec4(Position.xyz, 1.0f);
     vec4 PositionVS = WorldToViewMatrix * PositionWS;
     gl_Position = ViewToClipMatrix * PositionVS;
 
+#ifndef DEPTH_ONLY
+    vec3 NormalMS = DecodeOctahedral(Normal);
+
+    vec2 EncodedTangent = vec2(max(float(Tangent.x) / 32767.0f, -1.0f), max(float(Tangent.y >> 1) / 16383.0f, -1.0f));
+    vec4 TangentMS = vec4(DecodeOctahedral(EncodedTangent), (Tangent.y & 1) != 0 ? -1.0f : 1.0f);
+
     FragmentPositionWS = PositionWS.xyz;
     FragmentPositionVS = PositionVS.xyz;
-    FragmentNormalWS = (Transformation * vec4(Normal.xyz, 0.0f)).xyz; // This is fine as long as we don't use non-uniform scaling
-    FragmentTangentWS = vec4((Transformation * vec4(Tangent.xyz, 0.0f)).xyz, Tangent.w);
+    FragmentNormalWS = (Transformation * vec4(NormalMS, 0.0f)).xyz; // This is fine as long as we don't use non-uniform scaling
+    FragmentTangentWS = vec4((Transformation * vec4(TangentMS.xyz, 0.0f)).xyz, TangentMS.w);
     FragmentUV = UV;
     ViewPositionWS = (inverse(WorldToViewMatrix) [3u]).xyz;
+#endif
 }
\ No newline at end of file
@@ -1,19 +1,61 @@
 #version 450 core
 
+#ifdef BINDLESS_MATERIALS
+#extension GL_EXT_nonuniform_qualifier : require
+#endif
+
 layout (location = 0) in vec3 FragmentPositionWS;
 layout (location = 1) in vec3 FragmentPositionVS;
 layout (location = 2) in vec3 FragmentNormalWS;
 layout (location = 3) in vec4 FragmentTangentWS;
-layout (location = 4) in vec3 FragmentUV;
+layout (location = 4) in vec2 FragmentUV;
 layout (location = 5) in vec3 ViewPositionWS;
 
-layout (set = 1, binding = 1) uniform texture2D DiffuseTexture;
-layout (set = 1, binding = 2) uniform texture2D SpecularTexture;
-layout (set = 1, binding = 3) uniform texture2D NormalTexture;
-layout (set = 1, binding = 4) uniform texture2D GlossTexture;
-layout (set = 1, binding = 5) uniform texture2D AOTexture;
-layout (set = 1, binding = 6) uniform sampler AnisotropicSampler;
-layout (set = 1, binding = 7) uniform sampler LinearSampler;
+#ifdef BINDLESS_MATERIALS
+
+/* Every texture lives in the one array, materials only store indices into it */
+layout (set = 1, binding = 0) uniform texture2D Textures [];
+layout (set = 1, binding = 1) uniform sampler AnisotropicSampler;
+layout (set = 1, binding = 2) uniform sampler LinearSampler;
+
+struct MaterialData
+{
+    uint DiffuseTextureIndex;
+    uint SpecularTextureIndex;
+    uint NormalTextureIndex;
+    uint GlossTextureIndex;
+    uint AOTextureIndex;
+};
+
+layout (set = 1, binding = 3, std430)
+readonly buffer MaterialBuffer
+{
+    MaterialData Materials [];
+};
+
+layout (push_constant)
+uniform MaterialConstants
+{
+    uint MaterialIndex;
+};
+
+#define DiffuseTexture Textures [nonuniformEXT(Materials [MaterialIndex].DiffuseTextureIndex)]
+#define SpecularTexture Textures [nonuniformEXT(Materials [MaterialIndex].SpecularTextureIndex)]
+#define NormalTexture Textures [nonuniformEXT(Materials [MaterialIndex].NormalTextureIndex)]
+#define GlossTexture Textures [nonuniformEXT(Materials [MaterialIndex].GlossTextureIndex)]
+#define AOTexture Textures [nonuniformEXT(Materials [MaterialIndex].AOTextureIndex)]
+
+#else
+
+layout (set = 1, binding = 0) uniform texture2D DiffuseTexture;
+layout (set = 1, binding = 1) uniform texture2D SpecularTexture;
+layout (set = 1, binding = 2) uniform texture2D NormalTexture;
+layout (set = 1, binding = 3) uniform texture2D GlossTexture;
+layout (set = 1, binding = 4) uniform texture2D AOTexture;
+layout (set = 1, binding = 5) uniform sampler AnisotropicSampler;
+layout (set = 1, binding = 6) uniform sampler LinearSampler;
+
+#endif
 
 layout (location = 0) out vec4 FragmentColour;
 
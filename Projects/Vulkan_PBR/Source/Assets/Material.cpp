@@ -1,5 +1,8 @@
 #include "Assets/Material.hpp"
 
+#include "Names.hpp"
+
+#include <mutex>
 #include <vector>
 #include <queue>
 
@@ -16,12 +19,23 @@ struct MaterialCollection
 
 static MaterialCollection Materials = {};
 
-static std::unordered_map<std::string, uint32> AssetNameToHandleMap = {};
+/* Indexed by asset index */
+static std::vector<uint32> AssetNameIDs = {};
+
+/* Keyed by name ID */
+static std::unordered_map<uint32, uint32> AssetNameToHandleMap = {};
+
+/* Materials are created on the simulation thread and read by the render thread */
+static std::mutex MaterialMutex = {};
 
 bool const Assets::Material::CreateMaterial(Assets::Material::MaterialData const & MaterialDesc, std::string AssetName, uint32 & OutputMaterialHandle)
 {
     /* TODO: Check the textures and use a default texture if any in desc are NULL */
 
+    uint32 const kAssetNameID = Names::Intern(AssetName);
+
+    std::scoped_lock Lock = std::scoped_lock(MaterialMutex);
+
     Materials.AlbedoTextures.push_back(MaterialDesc.AlbedoTexture);
     Materials.NormalTextures.push_back(MaterialDesc.NormalTexture);
     Materials.SpecularTextures.push_back(MaterialDesc.SpecularTexture);
@@ -30,7 +44,26 @@ bool const Assets::Material::CreateMaterial(Assets::Material::MaterialData const
 
     OutputMaterialHandle = static_cast<uint32>(Materials.AlbedoTextures.size());
 
-    AssetNameToHandleMap [std::move(AssetName)] = OutputMaterialHandle;
+    AssetNameIDs.push_back(kAssetNameID);
+    AssetNameToHandleMap [AssetNameIDs.back()] = OutputMaterialHandle;
+
+    return true;
+}
+
+bool const Assets::Material::FindMaterial(std::string const & AssetName, uint32 & OutputMaterialHandle)
+{
+    /* Names that were never interned can't belong to a material, and ID 0 is shared by every unnamed one */
+    uint32 const kAssetNameID = Names::Find(AssetName);
+
+    std::scoped_lock Lock = std::scoped_lock(MaterialMutex);
+
+    auto FoundAsset = kAssetNameID != 0u ? AssetNameToHandleMap.find(kAssetNameID) : AssetNameToHandleMap.cend();
+    if (FoundAsset == AssetNameToHandleMap.cend())
+    {
+        return false;
+    }
+
+    OutputMaterialHandle = FoundAsset->second;
 
     return true;
 }
@@ -44,11 +77,29 @@ bool const Assets::Material::GetAssetData(uint32 const AssetHandle, Assets::Mate
     }
 
     uint32 const kAssetIndex = { AssetHandle - 1u };
+
+    std::scoped_lock Lock = std::scoped_lock(MaterialMutex);
+
     OutputAssetData.AlbedoTexture = Materials.AlbedoTextures [kAssetIndex];
     OutputAssetData.NormalTexture = Materials.NormalTextures [kAssetIndex];
     OutputAssetData.SpecularTexture = Materials.SpecularTextures [kAssetIndex];
     OutputAssetData.RoughnessTexture = Materials.RoughnessTextures [kAssetIndex];
     OutputAssetData.AmbientOcclusionTexture = Materials.AmbientOcclusionTextures [kAssetIndex];
 
+    return true;
+}
+
+bool const Assets::Material::GetAssetName(uint32 const AssetHandle, std::string & OutputAssetName)
+{
+    std::scoped_lock Lock = std::scoped_lock(MaterialMutex);
+
+    if (AssetHandle == 0u || AssetHandle > AssetNameIDs.size())
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to get material name for NULL or invalid handle."));
+        return false;
+    }
+
+    OutputAssetName = Names::GetString(AssetNameIDs [AssetHandle - 1u]);
+
     return true;
 }
\ No newline at end of file
@@ -2,11 +2,16 @@
 
 #include "Graphics/Device.hpp"
 #include "Graphics/Memory.hpp"
+#include "Jobs.hpp"
+#include "Names.hpp"
 
+#include <Math/Quantisation.hpp>
+#include <Math/Transform.hpp>
 #include <Math/Vector.hpp>
 #include <OBJLoader/OBJLoader.hpp>
 
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -14,6 +19,19 @@ namespace Assets::StaticMesh::Private
 {
     static std::vector StaticMeshes = std::vector<Assets::StaticMesh::Types::StaticMesh>();
     static std::vector NewAssetHandles = std::vector<uint32>();
+
+    /* Indexed by asset index */
+    static std::vector AssetNameIDs = std::vector<uint32>();
+    static std::vector AssetFilePathIDs = std::vector<uint32>();
+
+    /* Keyed by name ID */
+    static std::unordered_map<uint32, uint32> AssetNameToHandleMap = {};
+
+    /* Meshes are imported on the simulation thread and given GPU resources on the render thread */
+    static std::mutex AssetMutex = {};
+
+    /* Vertices per encode job */
+    static uint32 const kEncodeBatchSize = { 16384u };
 }
 
 static void GenerateTangentVectors(std::vector<Math::Vector3> const & kVertices, 
@@ -70,28 +88,33 @@ static void GenerateTangentVectors(std::vector<Math::Vector3> const & kVertices,
         BitangentVectors [kIndices [2u]] = BitangentVectors [kIndices [2u]] + kBitangentVector;
     }
 
-    for (uint32 VertexIndex = { 0u };
-         VertexIndex < kVertices.size();
-         VertexIndex++)
-    {
-        Math::Vector3 & TangentVector = reinterpret_cast<Math::Vector3 &>(TangentVectors [VertexIndex]);
-        Math::Vector3 & BitangentVector = BitangentVectors [VertexIndex];
-
-        /* Make sure tangent vector is perpendicular to the normal vector */
-        Math::Vector3 const kAdjustedTangent = TangentVector - (TangentVector * kNormals [VertexIndex]) * kNormals [VertexIndex];
-        TangentVector = Math::Vector3::Normalize(kAdjustedTangent);
-
-        /* Make sure the bitangent vector is perpendicular to both the normal and tangent vectors */
-        Math::Vector3 const kAdjustedBitangent = BitangentVector - ((BitangentVector * TangentVector) * TangentVector) - ((BitangentVector * kNormals [VertexIndex]) * kNormals [VertexIndex]);
-        BitangentVector = Math::Vector3::Normalize(kAdjustedBitangent);
-
-        /*
-        *   Cross product between tangent and bitangent to get normal.
-        *   Use dot product of result with normal to determine the sign.
-        *   Use this sign in the shader to flip the bitangent, this ensures consistency.
-        */
-        TangentVectors [VertexIndex].W = ((TangentVector ^ BitangentVector) * kNormals [VertexIndex]) > 0.0f ? 1.0f : -1.0f;
-    }
+    /* Each vertex is independent once the triangle contributions have been accumulated */
+    Jobs::ParallelFor(static_cast<uint32>(kVertices.size()), Assets::StaticMesh::Private::kEncodeBatchSize,
+                      [&](uint32 const FirstIndex, uint32 const EndIndex)
+                      {
+                          for (uint32 VertexIndex = { FirstIndex };
+                               VertexIndex < EndIndex;
+                               VertexIndex++)
+                          {
+                              Math::Vector3 & TangentVector = reinterpret_cast<Math::Vector3 &>(TangentVectors [VertexIndex]);
+                              Math::Vector3 & BitangentVector = BitangentVectors [VertexIndex];
+
+                              /* Make sure tangent vector is perpendicular to the normal vector */
+                              Math::Vector3 const kAdjustedTangent = TangentVector - (TangentVector * kNormals [VertexIndex]) * kNormals [VertexIndex];
+                              TangentVector = Math::Vector3::Normalize(kAdjustedTangent);
+
+                              /* Make sure the bitangent vector is perpendicular to both the normal and tangent vectors */
+                              Math::Vector3 const kAdjustedBitangent = BitangentVector - ((BitangentVector * TangentVector) * TangentVector) - ((BitangentVector * kNormals [VertexIndex]) * kNormals [VertexIndex]);
+                              BitangentVector = Math::Vector3::Normalize(kAdjustedBitangent);
+
+                              /*
+                              *   Cross product between tangent and bitangent to get normal.
+                              *   Use dot product of result with normal to determine the sign.
+                              *   Use this sign in the shader to flip the bitangent, this ensures consistency.
+                              */
+                              TangentVectors [VertexIndex].W = ((TangentVector ^ BitangentVector) * kNormals [VertexIndex]) > 0.0f ? 1.0f : -1.0f;
+                          }
+                      });
 
     OutputTangents = std::move(TangentVectors);
 }
@@ -169,28 +192,53 @@ static void ProcessMeshData(OBJLoader::OBJMeshData const & kOBJMeshData, Assets:
     OutputStaticMesh.VertexCount = static_cast<uint32>(Vertices.size());
     OutputStaticMesh.IndexCount = static_cast<uint32>(Indices.size());
 
-    uint64 const kVertexDataSizeInBytes = { Vertices.size() * sizeof(Math::Vector3) };
-    uint64 const kTangentDataSizeInBytes = { Tangents.size() * sizeof(Math::Vector4) };
+    /* Positions are 4 x 16-bit UNORM, normals/tangents are octahedral 2 x 16-bit and UVs are 2 x half */
+    uint64 const kVertexDataSizeInBytes = { Vertices.size() * sizeof(uint16) * 4u };
+    uint64 const kNormalDataSizeInBytes = { Normals.size() * sizeof(uint32) };
+    uint64 const kTangentDataSizeInBytes = { Tangents.size() * sizeof(uint32) };
+    uint64 const kUVDataSizeInBytes = { UVs.size() * sizeof(uint32) };
 
-    OutputStaticMesh.MeshDataSizeInBytes = kVertexDataSizeInBytes * 3u + Tangents.size() * sizeof(Math::Vector4);
+    OutputStaticMesh.MeshDataSizeInBytes = kVertexDataSizeInBytes + kNormalDataSizeInBytes + kTangentDataSizeInBytes + kUVDataSizeInBytes;
 
     OutputStaticMesh.MeshData = new std::byte [OutputStaticMesh.MeshDataSizeInBytes];
     OutputStaticMesh.IndexData = new uint32 [OutputStaticMesh.IndexCount];
 
     OutputStaticMesh.NormalDataOffsetInBytes = kVertexDataSizeInBytes;
-    OutputStaticMesh.TangentDataOffsetInBytes = OutputStaticMesh.NormalDataOffsetInBytes + kVertexDataSizeInBytes;
+    OutputStaticMesh.TangentDataOffsetInBytes = OutputStaticMesh.NormalDataOffsetInBytes + kNormalDataSizeInBytes;
     OutputStaticMesh.UVDataOffsetInBytes = OutputStaticMesh.TangentDataOffsetInBytes + kTangentDataSizeInBytes;
 
-    Math::Vector3 * const kVertexData = reinterpret_cast<Math::Vector3 *>(OutputStaticMesh.MeshData);
-    Math::Vector3 * const kNormalData = reinterpret_cast<Math::Vector3 *>(OutputStaticMesh.MeshData + OutputStaticMesh.NormalDataOffsetInBytes);
-    Math::Vector4 * const kTangentData = reinterpret_cast<Math::Vector4 *>(OutputStaticMesh.MeshData + OutputStaticMesh.TangentDataOffsetInBytes);
-    Math::Vector3 * const kUVData = reinterpret_cast<Math::Vector3 *>(OutputStaticMesh.MeshData + OutputStaticMesh.UVDataOffsetInBytes);
+    uint16 * const kVertexData = reinterpret_cast<uint16 *>(OutputStaticMesh.MeshData);
+    uint32 * const kNormalData = reinterpret_cast<uint32 *>(OutputStaticMesh.MeshData + OutputStaticMesh.NormalDataOffsetInBytes);
+    uint32 * const kTangentData = reinterpret_cast<uint32 *>(OutputStaticMesh.MeshData + OutputStaticMesh.TangentDataOffsetInBytes);
+    uint32 * const kUVData = reinterpret_cast<uint32 *>(OutputStaticMesh.MeshData + OutputStaticMesh.UVDataOffsetInBytes);
+
+    OutputStaticMesh.PositionBounds = Math::ComputeQuantisationBounds(static_cast<uint32>(Vertices.size()), Vertices.data());
+
+    Math::QuantisationBounds const kPositionBounds = OutputStaticMesh.PositionBounds;
+
+    /* Vertices | Normals | Tangents | UVs, each batch encodes the same vertex range of every stream */
+    Jobs::ParallelFor(OutputStaticMesh.VertexCount, Assets::StaticMesh::Private::kEncodeBatchSize,
+                      [&](uint32 const FirstIndex, uint32 const EndIndex)
+                      {
+                          uint32 const kVertexCount = { EndIndex - FirstIndex };
+
+                          Math::QuantisePositions(kPositionBounds, kVertexCount, Vertices.data() + FirstIndex, kVertexData + FirstIndex * 4u);
+
+                          if (Normals.size() > 0u)
+                          {
+                              Math::EncodeOctahedralNormals(kVertexCount, Normals.data() + FirstIndex, kNormalData + FirstIndex);
+                          }
 
-    /* Vertices | Normals | Tangents | UVs */
-    std::copy(Vertices.cbegin(), Vertices.cend(), kVertexData);
-    std::copy(Normals.cbegin(), Normals.cend(), kNormalData);
-    std::copy(Tangents.cbegin(), Tangents.cend(), kTangentData);
-    std::copy(UVs.cbegin(), UVs.cend(), kUVData);
+                          if (Tangents.size() > 0u)
+                          {
+                              Math::EncodeOctahedralTangents(kVertexCount, Tangents.data() + FirstIndex, kTangentData + FirstIndex);
+                          }
+
+                          if (UVs.size() > 0u)
+                          {
+                              Math::EncodeHalfUVs(kVertexCount, UVs.data() + FirstIndex, kUVData + FirstIndex);
+                          }
+                      });
 
     std::copy(Indices.cbegin(), Indices.cend(), OutputStaticMesh.IndexData);
 }
@@ -289,11 +337,22 @@ bool const Assets::StaticMesh::ImportStaticMesh(std::filesystem::path const & kF
 
         bResult = OBJLoader::LoadFile(kFilePath, MeshData, Materials);
 
-        Types::StaticMesh & StaticMeshData = Private::StaticMeshes.emplace_back();
+        Types::StaticMesh StaticMeshData = {};
         ::ProcessMeshData(MeshData, StaticMeshData);
 
+        uint32 const kAssetNameID = Names::Intern(AssetName);
+        uint32 const kFilePathID = Names::Intern(kFilePath.generic_string());
+
+        std::scoped_lock Lock = std::scoped_lock(Private::AssetMutex);
+
+        Private::StaticMeshes.push_back(StaticMeshData);
+
         OutputAssetHandle = { static_cast<uint32>(Private::StaticMeshes.size()) };
         Private::NewAssetHandles.push_back(OutputAssetHandle);
+
+        Private::AssetNameIDs.push_back(kAssetNameID);
+        Private::AssetFilePathIDs.push_back(kFilePathID);
+        Private::AssetNameToHandleMap [kAssetNameID] = OutputAssetHandle;
     }
 
     return bResult;
@@ -303,6 +362,8 @@ bool const Assets::StaticMesh::InitialiseGPUResources(VkCommandBuffer const kCom
 {
     std::vector MemoryBarriers = std::vector<VkBufferMemoryBarrier>();
 
+    std::scoped_lock Lock = std::scoped_lock(Private::AssetMutex);
+
     for (uint32 CurrentAssetIndex = {};
          CurrentAssetIndex < Private::NewAssetHandles.size();
          CurrentAssetIndex++)
@@ -329,6 +390,24 @@ bool const Assets::StaticMesh::InitialiseGPUResources(VkCommandBuffer const kCom
     return true;
 }
 
+bool const Assets::StaticMesh::FindStaticMesh(std::string const & kAssetName, uint32 & OutputAssetHandle)
+{
+    uint32 const kAssetNameID = Names::Find(kAssetName);
+
+    std::scoped_lock Lock = std::scoped_lock(Private::AssetMutex);
+
+    decltype(Private::AssetNameToHandleMap)::const_iterator const kAssetIterator = kAssetNameID != 0u ? Private::AssetNameToHandleMap.find(kAssetNameID) : Private::AssetNameToHandleMap.cend();
+
+    if (kAssetIterator == Private::AssetNameToHandleMap.cend())
+    {
+        return false;
+    }
+
+    OutputAssetHandle = kAssetIterator->second;
+
+    return true;
+}
+
 bool const Assets::StaticMesh::GetAssetData(uint32 const kAssetHandle, Assets::StaticMesh::Types::StaticMesh & OutputStaticMesh)
 {
     if (kAssetHandle == 0u)
@@ -339,7 +418,31 @@ bool const Assets::StaticMesh::GetAssetData(uint32 const kAssetHandle, Assets::S
 
     uint32 const kAssetIndex = { kAssetHandle - 1u };
 
+    std::scoped_lock Lock = std::scoped_lock(Private::AssetMutex);
+
     OutputStaticMesh = Private::StaticMeshes [kAssetIndex]; sizeof(Assets::StaticMesh::Types::StaticMesh);
 
     return true;
-}
\ No newline at end of file
+}
+
+Math::Affine3x4 const Assets::StaticMesh::GetMeshToModelTransform(Assets::StaticMesh::Types::StaticMesh const & kStaticMesh)
+{
+    /* Dequantisation has to be applied before the up axis conversion */
+    return Math::Affine3x4::FromMatrix4x4(Math::YAxisUpToZAxisUp()) * Math::DequantisationTransform(kStaticMesh.PositionBounds);
+}
+
+bool const Assets::StaticMesh::GetAssetSource(uint32 const kAssetHandle, std::string & OutputAssetName, std::filesystem::path & OutputFilePath)
+{
+    std::scoped_lock Lock = std::scoped_lock(Private::AssetMutex);
+
+    if (kAssetHandle == 0u || kAssetHandle > Private::AssetNameIDs.size())
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to get static mesh source for NULL or invalid handle."));
+        return false;
+    }
+
+    OutputAssetName = Names::GetString(Private::AssetNameIDs [kAssetHandle - 1u]);
+    OutputFilePath = Names::GetString(Private::AssetFilePathIDs [kAssetHandle - 1u]);
+
+    return true;
+}
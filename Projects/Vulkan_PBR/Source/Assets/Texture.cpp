@@ -2,9 +2,11 @@
 
 #include "Graphics/Device.hpp"
 #include "Graphics/Memory.hpp"
+#include "Names.hpp"
 
 #include <BMPLoader/BMPLoader.hpp>
 
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -19,14 +21,21 @@ struct TextureCollection
 
     std::vector<uint32> ImageHandles = {};
     std::vector<uint32> ViewHandles = {};
+
+    std::vector<uint32> AssetNameIDs = {};
+    std::vector<uint32> FilePathIDs = {};
 };
 
 static TextureCollection Textures = {};
 
 static std::vector<uint32> NewTextureHandles = {};
 
-static std::unordered_set<std::string> ImportedTextureSet = {};
-static std::unordered_map<std::string, uint32> TextureNameToHandleMap = {};
+/* Keyed by name ID */
+static std::unordered_set<uint32> ImportedTextureSet = {};
+static std::unordered_map<uint32, uint32> TextureNameToHandleMap = {};
+
+/* Textures are imported on the simulation thread and given GPU resources on the render thread */
+static std::mutex TextureMutex = {};
 
 static void CreateTextureResources(uint32 const TextureIndex, Vulkan::Device::DeviceState const & DeviceState)
 {
@@ -112,27 +121,39 @@ bool const Assets::Texture::ImportTexture(std::filesystem::path const & FilePath
     /* Only support .bmp atm */
     if (FilePath.extension() == ".bmp")
     {
-        std::string PathString = FilePath.string();
+        uint32 const kFilePathID = Names::Intern(FilePath.generic_string());
+
+        bool bIsImported = false;
+        {
+            std::scoped_lock Lock = std::scoped_lock(TextureMutex);
+            bIsImported = ImportedTextureSet.find(kFilePathID) != ImportedTextureSet.cend();
+        }
 
-        auto FoundPath = ImportedTextureSet.find(PathString);
-        if (FoundPath == ImportedTextureSet.cend())
+        if (!bIsImported)
         {
             BMPLoader::BMPImageData ImageData = {};
             bResult = BMPLoader::LoadFile(FilePath, ImageData);
 
             if (bResult)
             {
+                uint32 const kAssetNameID = Names::Intern(AssetName);
+
+                /* The file is read without the lock so the render thread isn't held up */
+                std::scoped_lock Lock = std::scoped_lock(TextureMutex);
+
                 Textures.RawDatas.push_back(ImageData.RawData);
                 Textures.WidthsInPixels.push_back(ImageData.WidthInPixels);
                 Textures.HeightsInPixels.push_back(ImageData.HeightInPixels);
                 Textures.ImageHandles.emplace_back();
                 Textures.ViewHandles.emplace_back();
+                Textures.AssetNameIDs.push_back(kAssetNameID);
+                Textures.FilePathIDs.push_back(kFilePathID);
 
                 OutputAssetHandle = static_cast<uint32>(Textures.RawDatas.size());
 
-                TextureNameToHandleMap [std::move(AssetName)] = OutputAssetHandle;
+                TextureNameToHandleMap [Textures.AssetNameIDs.back()] = OutputAssetHandle;
                 
-                ImportedTextureSet.emplace(std::move(PathString));
+                ImportedTextureSet.emplace(kFilePathID);
 
                 NewTextureHandles.push_back(OutputAssetHandle);
             }
@@ -144,7 +165,11 @@ bool const Assets::Texture::ImportTexture(std::filesystem::path const & FilePath
 
 bool const Assets::Texture::FindTexture(std::string const & AssetName, uint32 & OutputAssetHandle)
 {
-    auto FoundAsset = TextureNameToHandleMap.find(AssetName);
+    uint32 const kAssetNameID = Names::Find(AssetName);
+
+    std::scoped_lock Lock = std::scoped_lock(TextureMutex);
+
+    auto FoundAsset = kAssetNameID != 0u ? TextureNameToHandleMap.find(kAssetNameID) : TextureNameToHandleMap.cend();
     if (FoundAsset == TextureNameToHandleMap.cend())
     {
         /* ERROR */
@@ -166,6 +191,8 @@ bool const Assets::Texture::GetTextureData(uint32 const AssetHandle, Assets::Tex
 
     uint32 const TextureIndex = { AssetHandle - 1u };
 
+    std::scoped_lock Lock = std::scoped_lock(TextureMutex);
+
     OutputTextureData.Data = Textures.RawDatas [TextureIndex];
     OutputTextureData.WidthInPixels = Textures.WidthsInPixels [TextureIndex];
     OutputTextureData.HeightInPixels = Textures.HeightsInPixels [TextureIndex];
@@ -177,6 +204,8 @@ bool const Assets::Texture::GetTextureData(uint32 const AssetHandle, Assets::Tex
 
 bool const Assets::Texture::InitialiseGPUResources(VkCommandBuffer CommandBuffer, Vulkan::Device::DeviceState const & DeviceState, VkFence const TransferFence)
 {
+    std::scoped_lock Lock = std::scoped_lock(TextureMutex);
+
     for (uint32 CurrentAssetIndex = {};
          CurrentAssetIndex < NewTextureHandles.size();
          CurrentAssetIndex++)
@@ -201,5 +230,21 @@ bool const Assets::Texture::InitialiseGPUResources(VkCommandBuffer CommandBuffer
 
     NewTextureHandles.clear();
 
+    return true;
+}
+
+bool const Assets::Texture::GetAssetSource(uint32 const AssetHandle, std::string & OutputAssetName, std::filesystem::path & OutputFilePath)
+{
+    std::scoped_lock Lock = std::scoped_lock(TextureMutex);
+
+    if (AssetHandle == 0u || AssetHandle > Textures.AssetNameIDs.size())
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to get texture source for NULL or invalid handle."));
+        return false;
+    }
+
+    OutputAssetName = Names::GetString(Textures.AssetNameIDs [AssetHandle - 1u]);
+    OutputFilePath = Names::GetString(Textures.FilePathIDs [AssetHandle - 1u]);
+
     return true;
 }
\ No newline at end of file
@@ -0,0 +1,504 @@
+#include "Components/Archetypes.hpp"
+
+#include "Scene.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+
+using namespace Components;
+
+namespace Components::Archetypes::Private
+{
+    static constexpr uint32 kChunkSizeInBytes = { 16u * 1024u };
+    static constexpr uint32 kColumnAlignmentInBytes = { 16u };
+    static constexpr uint32 kInvalidArchetypeIndex = { ~0u };
+
+    struct ColumnInfo
+    {
+        uint32 ComponentMask = {};
+        uint32 SizeInBytes = {};
+    };
+
+    static std::array<ColumnInfo, Types::kColumnCount> const kColumnInfos =
+    {
+        ColumnInfo { 0u, sizeof(Types::ColumnType<Types::Columns::ActorHandle>::Type) },
+        ColumnInfo { static_cast<uint32>(Scene::ComponentMasks::Transform), sizeof(Types::ColumnType<Types::Columns::Position>::Type) },
+        ColumnInfo { static_cast<uint32>(Scene::ComponentMasks::Transform), sizeof(Types::ColumnType<Types::Columns::Orientation>::Type) },
+        ColumnInfo { static_cast<uint32>(Scene::ComponentMasks::Transform), sizeof(Types::ColumnType<Types::Columns::Scale>::Type) },
+        ColumnInfo { static_cast<uint32>(Scene::ComponentMasks::StaticMesh), sizeof(Types::ColumnType<Types::Columns::MeshHandle>::Type) },
+        ColumnInfo { static_cast<uint32>(Scene::ComponentMasks::StaticMesh), sizeof(Types::ColumnType<Types::Columns::MaterialHandle>::Type) },
+    };
+
+    struct Archetype
+    {
+        uint32 ComponentMask = {};
+        uint32 ChunkCapacity = {};
+        uint32 EntityCount = {};
+
+        std::array<uint32, Types::kColumnCount> ColumnOffsets = {};
+
+        std::vector<std::unique_ptr<std::byte []>> Chunks = {};
+    };
+
+    static std::vector<Archetype> Archetypes = {};
+    static std::unordered_map<uint32, uint32> ComponentMaskToArchetypeIndex = {};
+
+    /* Indexed by actor index */
+    static std::vector<Types::EntityLocation> EntityLocations = {};
+}
+
+static uint32 const AlignColumnOffset(uint32 const kOffsetInBytes)
+{
+    return (kOffsetInBytes + Archetypes::Private::kColumnAlignmentInBytes - 1u) & ~(Archetypes::Private::kColumnAlignmentInBytes - 1u);
+}
+
+static bool const ColumnInArchetype(uint32 const kComponentMask, uint8 const kColumnIndex)
+{
+    uint32 const kColumnMask = Archetypes::Private::kColumnInfos [kColumnIndex].ComponentMask;
+    return (kComponentMask & kColumnMask) == kColumnMask;
+}
+
+static uint32 const FindOrCreateArchetype(uint32 const kComponentMask)
+{
+    using namespace Archetypes;
+
+    decltype(Private::ComponentMaskToArchetypeIndex)::const_iterator const kArchetypeIterator = Private::ComponentMaskToArchetypeIndex.find(kComponentMask);
+
+    if (kArchetypeIterator != Private::ComponentMaskToArchetypeIndex.cend())
+    {
+        return kArchetypeIterator->second;
+    }
+
+    Private::Archetype NewArchetype = {};
+    NewArchetype.ComponentMask = kComponentMask;
+
+    uint32 RowSizeInBytes = {};
+    for (uint8 CurrentColumnIndex = {};
+         CurrentColumnIndex < Types::kColumnCount;
+         CurrentColumnIndex++)
+    {
+        if (::ColumnInArchetype(kComponentMask, CurrentColumnIndex))
+        {
+            RowSizeInBytes += Private::kColumnInfos [CurrentColumnIndex].SizeInBytes;
+        }
+    }
+
+    /* Shrink the capacity until the aligned columns fit in the chunk */
+    uint32 ChunkCapacity = { Private::kChunkSizeInBytes / RowSizeInBytes };
+    uint32 ChunkSizeInBytes = {};
+
+    do
+    {
+        ChunkSizeInBytes = 0u;
+
+        for (uint8 CurrentColumnIndex = {};
+             CurrentColumnIndex < Types::kColumnCount;
+             CurrentColumnIndex++)
+        {
+            if (::ColumnInArchetype(kComponentMask, CurrentColumnIndex))
+            {
+                ChunkSizeInBytes = ::AlignColumnOffset(ChunkSizeInBytes);
+                NewArchetype.ColumnOffsets [CurrentColumnIndex] = ChunkSizeInBytes;
+                ChunkSizeInBytes += Private::kColumnInfos [CurrentColumnIndex].SizeInBytes * ChunkCapacity;
+            }
+            else
+            {
+                NewArchetype.ColumnOffsets [CurrentColumnIndex] = Types::kInvalidColumnOffset;
+            }
+        }
+    } while (ChunkSizeInBytes > Private::kChunkSizeInBytes && --ChunkCapacity > 0u);
+
+    NewArchetype.ChunkCapacity = ChunkCapacity;
+
+    uint32 const kNewArchetypeIndex = static_cast<uint32>(Private::Archetypes.size());
+
+    Private::Archetypes.push_back(std::move(NewArchetype));
+    Private::ComponentMaskToArchetypeIndex [kComponentMask] = kNewArchetypeIndex;
+
+    return kNewArchetypeIndex;
+}
+
+static Archetypes::Types::ChunkView const GetChunkView(Archetypes::Private::Archetype const & kArchetype, uint32 const kChunkIndex)
+{
+    uint32 const kFirstEntityIndex = { kChunkIndex * kArchetype.ChunkCapacity };
+
+    return Archetypes::Types::ChunkView
+    {
+        kArchetype.Chunks [kChunkIndex].get(),
+        kArchetype.ColumnOffsets,
+        std::min(kArchetype.ChunkCapacity, kArchetype.EntityCount - kFirstEntityIndex),
+    };
+}
+
+static std::byte * const GetElementAddress(Archetypes::Private::Archetype const & kArchetype, uint32 const kEntityIndex, uint8 const kColumnIndex)
+{
+    uint32 const kChunkIndex = { kEntityIndex / kArchetype.ChunkCapacity };
+    uint32 const kRowIndex = { kEntityIndex % kArchetype.ChunkCapacity };
+
+    return kArchetype.Chunks [kChunkIndex].get() + kArchetype.ColumnOffsets [kColumnIndex] + kRowIndex * Archetypes::Private::kColumnInfos [kColumnIndex].SizeInBytes;
+}
+
+static uint32 const AppendEntity(Archetypes::Private::Archetype & Archetype, uint32 const kActorHandle)
+{
+    uint32 const kEntityIndex = { Archetype.EntityCount++ };
+
+    if (kEntityIndex / Archetype.ChunkCapacity >= Archetype.Chunks.size())
+    {
+        Archetype.Chunks.emplace_back(new std::byte [Archetypes::Private::kChunkSizeInBytes]);
+    }
+
+    for (uint8 CurrentColumnIndex = {};
+         CurrentColumnIndex < Archetypes::Types::kColumnCount;
+         CurrentColumnIndex++)
+    {
+        if (Archetype.ColumnOffsets [CurrentColumnIndex] != Archetypes::Types::kInvalidColumnOffset)
+        {
+            std::memset(::GetElementAddress(Archetype, kEntityIndex, CurrentColumnIndex), 0, Archetypes::Private::kColumnInfos [CurrentColumnIndex].SizeInBytes);
+        }
+    }
+
+    std::memcpy(::GetElementAddress(Archetype, kEntityIndex, static_cast<uint8>(Archetypes::Types::Columns::ActorHandle)), &kActorHandle, sizeof(kActorHandle));
+
+    return kEntityIndex;
+}
+
+/* Swap and pop, the last entity is moved into the removed slot so the columns stay dense */
+static void RemoveEntity(Archetypes::Private::Archetype & Archetype, uint32 const kEntityIndex)
+{
+    uint32 const kLastEntityIndex = { Archetype.EntityCount - 1u };
+
+    if (kEntityIndex != kLastEntityIndex)
+    {
+        for (uint8 CurrentColumnIndex = {};
+             CurrentColumnIndex < Archetypes::Types::kColumnCount;
+             CurrentColumnIndex++)
+        {
+            if (Archetype.ColumnOffsets [CurrentColumnIndex] != Archetypes::Types::kInvalidColumnOffset)
+            {
+                std::memcpy(::GetElementAddress(Archetype, kEntityIndex, CurrentColumnIndex),
+                            ::GetElementAddress(Archetype, kLastEntityIndex, CurrentColumnIndex),
+                            Archetypes::Private::kColumnInfos [CurrentColumnIndex].SizeInBytes);
+            }
+        }
+
+        uint32 MovedActorHandle = {};
+        std::memcpy(&MovedActorHandle, ::GetElementAddress(Archetype, kEntityIndex, static_cast<uint8>(Archetypes::Types::Columns::ActorHandle)), sizeof(MovedActorHandle));
+
+        Archetypes::Private::EntityLocations [Scene::GetActorIndex(MovedActorHandle)].EntityIndex = kEntityIndex;
+    }
+
+    Archetype.EntityCount--;
+
+    /* Keep one spare chunk around to avoid thrashing when an actor moves back and forth */
+    uint32 const kRequiredChunkCount = { (Archetype.EntityCount + Archetype.ChunkCapacity - 1u) / Archetype.ChunkCapacity };
+    if (Archetype.Chunks.size() > kRequiredChunkCount + 1u)
+    {
+        Archetype.Chunks.pop_back();
+    }
+}
+
+/* Outputs the location of a live entity, stale handles are rejected by comparing against the handle stored in the entity's row */
+static bool const FindEntityLocation(uint32 const kActorHandle, Archetypes::Types::EntityLocation & OutputLocation)
+{
+    if (kActorHandle == 0u)
+    {
+        return false;
+    }
+
+    uint32 const kActorIndex = Scene::GetActorIndex(kActorHandle);
+
+    if (kActorIndex >= Archetypes::Private::EntityLocations.size())
+    {
+        return false;
+    }
+
+    Archetypes::Types::EntityLocation const & kLocation = Archetypes::Private::EntityLocations [kActorIndex];
+
+    if (kLocation.ArchetypeIndex == Archetypes::Private::kInvalidArchetypeIndex)
+    {
+        return false;
+    }
+
+    uint32 StoredActorHandle = {};
+    std::memcpy(&StoredActorHandle,
+                ::GetElementAddress(Archetypes::Private::Archetypes [kLocation.ArchetypeIndex], kLocation.EntityIndex, static_cast<uint8>(Archetypes::Types::Columns::ActorHandle)),
+                sizeof(StoredActorHandle));
+
+    if (StoredActorHandle != kActorHandle)
+    {
+        return false;
+    }
+
+    OutputLocation = kLocation;
+
+    return true;
+}
+
+/* Moves the entity into the archetype for kNewComponentMask, columns that exist in both archetypes are copied */
+static void MoveEntity(uint32 const kActorHandle, Archetypes::Types::EntityLocation const & kSourceLocation, uint32 const kNewComponentMask)
+{
+    using namespace Archetypes;
+
+    /* This can grow the archetype array, so only take references after */
+    uint32 const kDestinationArchetypeIndex = ::FindOrCreateArchetype(kNewComponentMask);
+
+    Private::Archetype & SourceArchetype = Private::Archetypes [kSourceLocation.ArchetypeIndex];
+    Private::Archetype & DestinationArchetype = Private::Archetypes [kDestinationArchetypeIndex];
+
+    uint32 const kDestinationEntityIndex = ::AppendEntity(DestinationArchetype, kActorHandle);
+
+    for (uint8 CurrentColumnIndex = {};
+         CurrentColumnIndex < Types::kColumnCount;
+         CurrentColumnIndex++)
+    {
+        if (SourceArchetype.ColumnOffsets [CurrentColumnIndex] != Types::kInvalidColumnOffset
+            && DestinationArchetype.ColumnOffsets [CurrentColumnIndex] != Types::kInvalidColumnOffset)
+        {
+            std::memcpy(::GetElementAddress(DestinationArchetype, kDestinationEntityIndex, CurrentColumnIndex),
+                        ::GetElementAddress(SourceArchetype, kSourceLocation.EntityIndex, CurrentColumnIndex),
+                        Private::kColumnInfos [CurrentColumnIndex].SizeInBytes);
+        }
+    }
+
+    ::RemoveEntity(SourceArchetype, kSourceLocation.EntityIndex);
+
+    Private::EntityLocations [Scene::GetActorIndex(kActorHandle)] = Types::EntityLocation { kDestinationArchetypeIndex, kDestinationEntityIndex };
+}
+
+bool const Archetypes::CreateEntity(uint32 const ActorHandle)
+{
+    if (ActorHandle == 0u)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot create entity for NULL actor handle."));
+        return false;
+    }
+
+    uint32 const kActorIndex = Scene::GetActorIndex(ActorHandle);
+
+    if (kActorIndex >= Private::EntityLocations.size())
+    {
+        Private::EntityLocations.resize(kActorIndex + 1u, Types::EntityLocation { Private::kInvalidArchetypeIndex, 0u });
+    }
+
+    uint32 const kArchetypeIndex = ::FindOrCreateArchetype(0u);
+
+    Private::EntityLocations [kActorIndex] = Types::EntityLocation
+    {
+        kArchetypeIndex,
+        ::AppendEntity(Private::Archetypes [kArchetypeIndex], ActorHandle),
+    };
+
+    return true;
+}
+
+bool const Archetypes::CreateEntities(uint32 const ComponentMask, uint32 const * const ActorHandles, uint32 const ActorCount, Types::ColumnData const & ColumnData)
+{
+    uint32 MaximumActorIndex = {};
+
+    for (uint32 CurrentActorIndex = {};
+         CurrentActorIndex < ActorCount;
+         CurrentActorIndex++)
+    {
+        if (ActorHandles [CurrentActorIndex] == 0u)
+        {
+            Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot create entities. One of the actor handles is NULL."));
+            return false;
+        }
+
+        MaximumActorIndex = std::max(MaximumActorIndex, Scene::GetActorIndex(ActorHandles [CurrentActorIndex]));
+    }
+
+    if (ActorCount == 0u)
+    {
+        return true;
+    }
+
+    if (MaximumActorIndex >= Private::EntityLocations.size())
+    {
+        Private::EntityLocations.resize(MaximumActorIndex + 1u, Types::EntityLocation { Private::kInvalidArchetypeIndex, 0u });
+    }
+
+    uint32 const kArchetypeIndex = ::FindOrCreateArchetype(ComponentMask);
+
+    Private::Archetype & Archetype = Private::Archetypes [kArchetypeIndex];
+
+    uint32 const kRequiredChunkCount = { (Archetype.EntityCount + ActorCount + Archetype.ChunkCapacity - 1u) / Archetype.ChunkCapacity };
+
+    while (Archetype.Chunks.size() < kRequiredChunkCount)
+    {
+        Archetype.Chunks.emplace_back(new std::byte [Private::kChunkSizeInBytes]);
+    }
+
+    uint32 CopiedActorCount = {};
+
+    /* Each pass fills the rest of one chunk */
+    while (CopiedActorCount < ActorCount)
+    {
+        uint32 const kFirstEntityIndex = { Archetype.EntityCount };
+        uint32 const kRowCount = std::min(Archetype.ChunkCapacity - kFirstEntityIndex % Archetype.ChunkCapacity, ActorCount - CopiedActorCount);
+
+        for (uint8 CurrentColumnIndex = {};
+             CurrentColumnIndex < Types::kColumnCount;
+             CurrentColumnIndex++)
+        {
+            if (Archetype.ColumnOffsets [CurrentColumnIndex] == Types::kInvalidColumnOffset)
+            {
+                continue;
+            }
+
+            uint32 const kElementSizeInBytes = Private::kColumnInfos [CurrentColumnIndex].SizeInBytes;
+
+            std::byte const * SourceData = ColumnData [CurrentColumnIndex];
+
+            if (CurrentColumnIndex == static_cast<uint8>(Types::Columns::ActorHandle))
+            {
+                SourceData = reinterpret_cast<std::byte const *>(ActorHandles);
+            }
+
+            std::byte * const kDestinationData = ::GetElementAddress(Archetype, kFirstEntityIndex, CurrentColumnIndex);
+
+            if (SourceData)
+            {
+                std::memcpy(kDestinationData, SourceData + static_cast<uint64>(CopiedActorCount) * kElementSizeInBytes, kRowCount * kElementSizeInBytes);
+            }
+            else
+            {
+                std::memset(kDestinationData, 0, kRowCount * kElementSizeInBytes);
+            }
+        }
+
+        for (uint32 CurrentRowIndex = {};
+             CurrentRowIndex < kRowCount;
+             CurrentRowIndex++)
+        {
+            Private::EntityLocations [Scene::GetActorIndex(ActorHandles [CopiedActorCount + CurrentRowIndex])] = Types::EntityLocation { kArchetypeIndex, kFirstEntityIndex + CurrentRowIndex };
+        }
+
+        Archetype.EntityCount += kRowCount;
+        CopiedActorCount += kRowCount;
+    }
+
+    return true;
+}
+
+bool const Archetypes::DestroyEntity(uint32 const ActorHandle)
+{
+    Types::EntityLocation Location = {};
+
+    if (!::FindEntityLocation(ActorHandle, Location))
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot destroy entity for invalid actor handle."));
+        return false;
+    }
+
+    ::RemoveEntity(Private::Archetypes [Location.ArchetypeIndex], Location.EntityIndex);
+
+    Private::EntityLocations [Scene::GetActorIndex(ActorHandle)] = Types::EntityLocation { Private::kInvalidArchetypeIndex, 0u };
+
+    return true;
+}
+
+bool const Archetypes::AddComponents(uint32 const ActorHandle, uint32 const ComponentMask)
+{
+    Types::EntityLocation SourceLocation = {};
+
+    if (!::FindEntityLocation(ActorHandle, SourceLocation))
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot add components to invalid actor handle."));
+        return false;
+    }
+
+    uint32 const kCurrentComponentMask = { Private::Archetypes [SourceLocation.ArchetypeIndex].ComponentMask };
+
+    if ((kCurrentComponentMask | ComponentMask) != kCurrentComponentMask)
+    {
+        ::MoveEntity(ActorHandle, SourceLocation, kCurrentComponentMask | ComponentMask);
+    }
+
+    return true;
+}
+
+bool const Archetypes::RemoveComponents(uint32 const ActorHandle, uint32 const ComponentMask)
+{
+    Types::EntityLocation SourceLocation = {};
+
+    if (!::FindEntityLocation(ActorHandle, SourceLocation))
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot remove components from invalid actor handle."));
+        return false;
+    }
+
+    uint32 const kCurrentComponentMask = { Private::Archetypes [SourceLocation.ArchetypeIndex].ComponentMask };
+
+    if ((kCurrentComponentMask & ~ComponentMask) != kCurrentComponentMask)
+    {
+        ::MoveEntity(ActorHandle, SourceLocation, kCurrentComponentMask & ~ComponentMask);
+    }
+
+    return true;
+}
+
+bool const Archetypes::GetEntity(uint32 const ActorHandle, Types::ChunkView & OutputChunk, uint32 & OutputRowIndex)
+{
+    Types::EntityLocation Location = {};
+
+    if (!::FindEntityLocation(ActorHandle, Location))
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot get entity for invalid actor handle."));
+        return false;
+    }
+
+    Private::Archetype const & kArchetype = Private::Archetypes [Location.ArchetypeIndex];
+
+    OutputChunk = ::GetChunkView(kArchetype, Location.EntityIndex / kArchetype.ChunkCapacity);
+    OutputRowIndex = Location.EntityIndex % kArchetype.ChunkCapacity;
+
+    return true;
+}
+
+void Archetypes::QueryChunks(uint32 const ComponentMask, std::vector<Types::ChunkView> & OutputChunks)
+{
+    for (Private::Archetype const & kArchetype : Private::Archetypes)
+    {
+        if ((kArchetype.ComponentMask & ComponentMask) != ComponentMask || kArchetype.EntityCount == 0u)
+        {
+            continue;
+        }
+
+        uint32 const kUsedChunkCount = { (kArchetype.EntityCount + kArchetype.ChunkCapacity - 1u) / kArchetype.ChunkCapacity };
+
+        for (uint32 CurrentChunkIndex = {};
+             CurrentChunkIndex < kUsedChunkCount;
+             CurrentChunkIndex++)
+        {
+            OutputChunks.push_back(::GetChunkView(kArchetype, CurrentChunkIndex));
+        }
+    }
+}
+
+uint32 const Archetypes::GetEntityCount(uint32 const ComponentMask)
+{
+    uint32 EntityCount = {};
+
+    for (Private::Archetype const & kArchetype : Private::Archetypes)
+    {
+        if ((kArchetype.ComponentMask & ComponentMask) == ComponentMask)
+        {
+            EntityCount += kArchetype.EntityCount;
+        }
+    }
+
+    return EntityCount;
+}
+
+bool const Archetypes::HasColumn(uint32 const ComponentMask, Types::Columns const Column)
+{
+    return ::ColumnInArchetype(ComponentMask, static_cast<uint8>(Column));
+}
+
+uint32 const Archetypes::GetColumnSizeInBytes(Types::Columns const Column)
+{
+    return Private::kColumnInfos [static_cast<uint8>(Column)].SizeInBytes;
+}
@@ -1,93 +1,80 @@
 #include "Components/StaticMeshComponent.hpp"
 
+#include "Components/Archetypes.hpp"
 #include "Scene.hpp"
-
-#include <array>
-#include <unordered_map>
-#include <vector>
+#include "SpatialIndex.hpp"
 
 using namespace Components;
 
-namespace Components::StaticMesh::Private
+bool const StaticMesh::CreateComponent(Scene::SceneData & Scene, uint32 const ActorHandle, uint32 const StaticMeshHandle, uint32 const MaterialHandle)
 {
-    struct StaticMeshCollection
+    if (!Scene::IsActorValid(Scene, ActorHandle))
     {
-        std::unordered_map<uint32, uint32> ActorIDToMeshIndex = {};
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot create static mesh component for NULL or stale actor handle."));
+        return false;
+    }
 
-        std::vector<uint32> ParentActorHandles = {};
-        std::vector<uint32> MeshHandles = {};
-        std::vector<uint32> MaterialHandles = {};
-    };
-}
+    if (!Archetypes::AddComponents(ActorHandle, static_cast<uint32>(Scene::ComponentMasks::StaticMesh)))
+    {
+        return false;
+    }
 
-static StaticMesh::Private::StaticMeshCollection StaticMeshes = {};
+    Archetypes::Types::ChunkView Chunk = {};
+    uint32 RowIndex = {};
+    Archetypes::GetEntity(ActorHandle, Chunk, RowIndex);
 
-StaticMesh::Types::Iterator::Iterator(uint32 const Index)
-    : Utilities::IteratorBase(Index)
-{
-}
+    Chunk.GetColumn<Archetypes::Types::Columns::MeshHandle>() [RowIndex] = StaticMeshHandle;
+    Chunk.GetColumn<Archetypes::Types::Columns::MaterialHandle>() [RowIndex] = MaterialHandle;
 
-StaticMesh::Types::Iterator StaticMesh::Types::Iterator::Begin()
-{
-    return StaticMesh::Types::Iterator(0u);
-}
+    Scene.ComponentMasks [Scene::GetActorIndex(ActorHandle)] |= static_cast<uint32>(Scene::ComponentMasks::StaticMesh);
 
-StaticMesh::Types::Iterator StaticMesh::Types::Iterator::End()
-{
-    return StaticMesh::Types::Iterator(static_cast<uint32>(StaticMeshes.MeshHandles.size()));
-}
+    /* The bounds depend on the mesh, so they are recomputed even if the actor hasn't moved */
+    SpatialIndex::MarkActorDirty(ActorHandle);
 
-StaticMesh::Types::ComponentData StaticMesh::Types::Iterator::operator * () const
-{
-    return ComponentData
-    {
-        StaticMeshes.ParentActorHandles [CurrentIndex_],
-        StaticMeshes.MeshHandles [CurrentIndex_],
-        StaticMeshes.MaterialHandles [CurrentIndex_],
-    };
+    return true;
 }
 
-bool const StaticMesh::CreateComponent(Scene::SceneData & Scene, uint32 const ActorHandle, uint32 const StaticMeshHandle, uint32 const MaterialHandle)
+bool const StaticMesh::DestroyComponent(Scene::SceneData & Scene, uint32 const ActorHandle)
 {
-    if (ActorHandle == 0u)
+    if (!Scene::DoesActorHaveComponents(Scene, ActorHandle, static_cast<uint32>(Scene::ComponentMasks::StaticMesh)))
     {
-        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot create static mesh component for NULL actor handle."));
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot destroy static mesh component. The actor handle is stale or the actor doesn't have a static mesh component."));
         return false;
     }
 
-    uint32 const NewMeshIndex = static_cast<uint32>(StaticMeshes.MeshHandles.size());
-    StaticMeshes.ActorIDToMeshIndex [ActorHandle] = NewMeshIndex;
+    if (!Archetypes::RemoveComponents(ActorHandle, static_cast<uint32>(Scene::ComponentMasks::StaticMesh)))
+    {
+        return false;
+    }
 
-    StaticMeshes.ParentActorHandles.push_back(ActorHandle);
-    StaticMeshes.MeshHandles.push_back(StaticMeshHandle);
-    StaticMeshes.MaterialHandles.push_back(MaterialHandle);
+    Scene.ComponentMasks [Scene::GetActorIndex(ActorHandle)] &= ~static_cast<uint32>(Scene::ComponentMasks::StaticMesh);
 
-    uint32 const kActorIndex = ActorHandle - 1u;
-    Scene.ComponentMasks [kActorIndex] |= static_cast<uint32>(Scene::ComponentMasks::StaticMesh);
+    SpatialIndex::RemoveActor(ActorHandle);
 
     return true;
 }
 
 bool const StaticMesh::GetComponentData(Scene::SceneData const & Scene, uint32 const ActorHandle, StaticMesh::Types::ComponentData & OutputComponentData)
 {
-    if (ActorHandle == 0u)
+    if (!Scene::IsActorValid(Scene, ActorHandle))
     {
-        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to get static mesh component data for NULL handle."));
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to get static mesh component data for NULL or stale handle."));
         return false;
     }
 
-    uint32 const kActorIndex = ActorHandle - 1u;
-
-    if ((Scene.ComponentMasks [kActorIndex] & static_cast<uint32>(Scene::ComponentMasks::StaticMesh)) == 0u)
+    if (!Scene::DoesActorHaveComponents(Scene, ActorHandle, static_cast<uint32>(Scene::ComponentMasks::StaticMesh)))
     {
         Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to get component data. Provided actor does not have a static mesh component."));
         return false;
     }
 
-    uint32 const kComponentIndex = StaticMeshes.ActorIDToMeshIndex [kActorIndex];
-    OutputComponentData.ParentActorHandle = StaticMeshes.ParentActorHandles [kComponentIndex];
-    OutputComponentData.MeshHandle = StaticMeshes.MeshHandles [kComponentIndex];
-    OutputComponentData.MaterialHandle = StaticMeshes.MaterialHandles [kComponentIndex];
+    Archetypes::Types::ChunkView Chunk = {};
+    uint32 RowIndex = {};
+    Archetypes::GetEntity(ActorHandle, Chunk, RowIndex);
+
+    OutputComponentData.ParentActorHandle = Chunk.GetColumn<Archetypes::Types::Columns::ActorHandle>() [RowIndex];
+    OutputComponentData.MeshHandle = Chunk.GetColumn<Archetypes::Types::Columns::MeshHandle>() [RowIndex];
+    OutputComponentData.MaterialHandle = Chunk.GetColumn<Archetypes::Types::Columns::MaterialHandle>() [RowIndex];
 
     return true;
-}
\ No newline at end of file
+}
@@ -1,34 +1,384 @@
 #include "Components/TransformComponent.hpp"
 
+#include "Components/Archetypes.hpp"
+#include "Jobs.hpp"
 #include "Scene.hpp"
 
-#include <Math/Transform.hpp>
+#include <Math/Affine.hpp>
 
-Components::Transform::TransformCollection Transforms = {};
+#include <algorithm>
+#include <intrin.h>
+#include <vector>
 
-bool const Components::Transform::CreateComponent(uint32 const ActorHandle, Scene::SceneData & Scene)
+using namespace Components;
+
+namespace Components::Transform::Private
 {
-    if (ActorHandle == 0u)
+    static constexpr uint32 kInvalidNodeIndex = { ~0u };
+
+    /*
+        Nodes are stored so that a parent always comes before its children, this lets world transforms be propagated in a single linear pass.
+        Destroying a node leaves a hole (NULL actor handle), holes are removed the next time world transforms are updated.
+    */
+    static std::vector<uint32> NodeActorHandles = {};
+    static std::vector<uint32> NodeParentIndices = {};
+    static std::vector<Math::Affine3x4> LocalTransforms = {};
+    static std::vector<Math::Affine3x4> WorldTransforms = {};
+    static std::vector<uint8> DirtyFlags = {};
+    static std::vector<uint32> NodeSlotIndices = {};
+
+    /* Indexed by slot, a set bit means the world transform needs uploading */
+    static std::vector<uint32> SlotNodeIndices = {};
+    static std::vector<uint64> DirtySlotMasks = {};
+    static std::vector<uint32> FreeSlotIndices = {};
+
+    /* Indexed by actor index, ActorMovedHandles holds the handle if it is in MovedActorHandles */
+    static std::vector<uint32> ActorNodeIndices = {};
+    static std::vector<uint32> ActorMovedHandles = {};
+
+    /* Actors whose world transform changed since the last flush, each handle is only added once */
+    static std::vector<uint32> MovedActorHandles = {};
+
+    /* Children are always after their parent so nothing before this needs to be visited */
+    static uint32 FirstDirtyNodeIndex = { kInvalidNodeIndex };
+    static uint32 HoleCount = {};
+
+    static std::vector<uint32> NodeIndexRemap = {};
+
+    /*
+        Dirty nodes are grouped by their distance from the closest dirty ancestor (level), every node in a level only reads
+        world transforms from earlier levels or clean nodes, so each level can be updated in parallel.
+    */
+    static std::vector<uint32> NodeDirtyLevels = {};
+    static std::vector<std::vector<uint32>> DirtyLevelNodeIndices = {};
+
+    static uint32 const kWorldTransformBatchSize = { 512u };
+}
+
+static void MarkNodeDirty(uint32 const kNodeIndex)
+{
+    Transform::Private::DirtyFlags [kNodeIndex] = 1u;
+    Transform::Private::FirstDirtyNodeIndex = std::min(Transform::Private::FirstDirtyNodeIndex, kNodeIndex);
+}
+
+static void MarkSlotDirty(uint32 const kSlotIndex)
+{
+    Transform::Private::DirtySlotMasks [kSlotIndex >> 6u] |= uint64 { 1u } << (kSlotIndex & 63u);
+}
+
+static uint32 const AllocateSlot(uint32 const kNodeIndex)
+{
+    using namespace Transform;
+
+    uint32 SlotIndex = {};
+
+    /* Reuse the most recently freed slot so the buffer stays compact */
+    if (Private::FreeSlotIndices.size() > 0u)
+    {
+        SlotIndex = Private::FreeSlotIndices.back();
+        Private::FreeSlotIndices.pop_back();
+    }
+    else
+    {
+        SlotIndex = static_cast<uint32>(Private::SlotNodeIndices.size());
+        Private::SlotNodeIndices.emplace_back();
+        Private::DirtySlotMasks.resize((Private::SlotNodeIndices.size() + 63u) >> 6u);
+    }
+
+    Private::SlotNodeIndices [SlotIndex] = kNodeIndex;
+    ::MarkSlotDirty(SlotIndex);
+
+    return SlotIndex;
+}
+
+static void FreeSlot(uint32 const kSlotIndex)
+{
+    using namespace Transform;
+
+    Private::SlotNodeIndices [kSlotIndex] = Private::kInvalidNodeIndex;
+    Private::DirtySlotMasks [kSlotIndex >> 6u] &= ~(uint64 { 1u } << (kSlotIndex & 63u));
+    Private::FreeSlotIndices.push_back(kSlotIndex);
+}
+
+/* Outputs the node of a live transform, stale handles fail because the node stores the full handle */
+static bool const FindNodeIndex(uint32 const kActorHandle, uint32 & OutputNodeIndex)
+{
+    using namespace Transform;
+
+    if (kActorHandle == 0u)
+    {
+        return false;
+    }
+
+    uint32 const kActorIndex = Scene::GetActorIndex(kActorHandle);
+
+    if (kActorIndex >= Private::ActorNodeIndices.size())
+    {
+        return false;
+    }
+
+    uint32 const kNodeIndex = Private::ActorNodeIndices [kActorIndex];
+
+    if (kNodeIndex == Private::kInvalidNodeIndex || Private::NodeActorHandles [kNodeIndex] != kActorHandle)
+    {
+        return false;
+    }
+
+    OutputNodeIndex = kNodeIndex;
+
+    return true;
+}
+
+/*
+    Rebuilds the node arrays in the order given, holes must not be included.
+    The order must keep parents before children, children of holes are attached to the hole's closest live ancestor.
+*/
+static void RebuildNodes(std::vector<uint32> const & kNewOrder)
+{
+    using namespace Transform;
+
+    uint32 const kOldNodeCount = static_cast<uint32>(Private::NodeActorHandles.size());
+
+    Private::NodeIndexRemap.assign(kOldNodeCount, Private::kInvalidNodeIndex);
+
+    for (uint32 CurrentNodeIndex = {};
+         CurrentNodeIndex < kNewOrder.size();
+         CurrentNodeIndex++)
+    {
+        Private::NodeIndexRemap [kNewOrder [CurrentNodeIndex]] = CurrentNodeIndex;
+    }
+
+    /* A hole's parent is always before it, so its remapped index is already known */
+    for (uint32 CurrentNodeIndex = {};
+         CurrentNodeIndex < kOldNodeCount;
+         CurrentNodeIndex++)
+    {
+        if (Private::NodeActorHandles [CurrentNodeIndex] == 0u)
+        {
+            uint32 const kParentIndex = Private::NodeParentIndices [CurrentNodeIndex];
+            Private::NodeIndexRemap [CurrentNodeIndex] = kParentIndex == Private::kInvalidNodeIndex ? Private::kInvalidNodeIndex : Private::NodeIndexRemap [kParentIndex];
+        }
+    }
+
+    uint32 const kNewNodeCount = static_cast<uint32>(kNewOrder.size());
+
+    std::vector<uint32> NewNodeActorHandles (kNewNodeCount);
+    std::vector<uint32> NewNodeParentIndices (kNewNodeCount);
+    std::vector<Math::Affine3x4> NewLocalTransforms (kNewNodeCount);
+    std::vector<Math::Affine3x4> NewWorldTransforms (kNewNodeCount);
+    std::vector<uint8> NewDirtyFlags (kNewNodeCount);
+    std::vector<uint32> NewNodeSlotIndices (kNewNodeCount);
+
+    Private::FirstDirtyNodeIndex = Private::kInvalidNodeIndex;
+
+    for (uint32 CurrentNodeIndex = {};
+         CurrentNodeIndex < kNewNodeCount;
+         CurrentNodeIndex++)
+    {
+        uint32 const kOldNodeIndex = kNewOrder [CurrentNodeIndex];
+        uint32 const kOldParentIndex = Private::NodeParentIndices [kOldNodeIndex];
+        uint32 const kActorHandle = Private::NodeActorHandles [kOldNodeIndex];
+
+        NewNodeActorHandles [CurrentNodeIndex] = kActorHandle;
+        NewNodeParentIndices [CurrentNodeIndex] = kOldParentIndex == Private::kInvalidNodeIndex ? Private::kInvalidNodeIndex : Private::NodeIndexRemap [kOldParentIndex];
+        NewLocalTransforms [CurrentNodeIndex] = Private::LocalTransforms [kOldNodeIndex];
+        NewWorldTransforms [CurrentNodeIndex] = Private::WorldTransforms [kOldNodeIndex];
+        NewNodeSlotIndices [CurrentNodeIndex] = Private::NodeSlotIndices [kOldNodeIndex];
+
+        /* Losing a parent changes the world transform */
+        bool const kParentRemoved = kOldParentIndex != Private::kInvalidNodeIndex && Private::NodeActorHandles [kOldParentIndex] == 0u;
+        NewDirtyFlags [CurrentNodeIndex] = Private::DirtyFlags [kOldNodeIndex] | static_cast<uint8>(kParentRemoved);
+
+        if (NewDirtyFlags [CurrentNodeIndex])
+        {
+            Private::FirstDirtyNodeIndex = std::min(Private::FirstDirtyNodeIndex, CurrentNodeIndex);
+        }
+
+        Private::ActorNodeIndices [Scene::GetActorIndex(kActorHandle)] = CurrentNodeIndex;
+        Private::SlotNodeIndices [NewNodeSlotIndices [CurrentNodeIndex]] = CurrentNodeIndex;
+    }
+
+    Private::NodeActorHandles.swap(NewNodeActorHandles);
+    Private::NodeParentIndices.swap(NewNodeParentIndices);
+    Private::LocalTransforms.swap(NewLocalTransforms);
+    Private::WorldTransforms.swap(NewWorldTransforms);
+    Private::DirtyFlags.swap(NewDirtyFlags);
+    Private::NodeSlotIndices.swap(NewNodeSlotIndices);
+
+    Private::HoleCount = 0u;
+}
+
+/* The parent's world transform must already be up to date */
+static void UpdateWorldTransform(uint32 const kNodeIndex)
+{
+    using namespace Transform;
+
+    uint32 const kParentIndex = Private::NodeParentIndices [kNodeIndex];
+
+    if (kParentIndex == Private::kInvalidNodeIndex)
+    {
+        Private::WorldTransforms [kNodeIndex] = Private::LocalTransforms [kNodeIndex];
+    }
+    else
+    {
+        Private::WorldTransforms [kNodeIndex] = Private::WorldTransforms [kParentIndex] * Private::LocalTransforms [kNodeIndex];
+    }
+}
+
+static bool const GetTransformEntity(uint32 const kActorHandle, Archetypes::Types::ChunkView & OutputChunk, uint32 & OutputRowIndex)
+{
+    if (!Archetypes::GetEntity(kActorHandle, OutputChunk, OutputRowIndex))
+    {
+        return false;
+    }
+
+    if (!OutputChunk.HasColumn(Archetypes::Types::Columns::Position))
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("The actor provided doesn't have an associated transform component."));
+        return false;
+    }
+
+    return true;
+}
+
+bool const Transform::CreateComponent(uint32 const ActorHandle, Scene::SceneData & Scene)
+{
+    if (!Scene::IsActorValid(Scene, ActorHandle))
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot create transform component for NULL or stale actor handle."));
+        return false;
+    }
+
+    if (!Archetypes::AddComponents(ActorHandle, static_cast<uint32>(Scene::ComponentMasks::Transform)))
+    {
+        return false;
+    }
+
+    Scene.ComponentMasks [Scene::GetActorIndex(ActorHandle)] |= static_cast<uint32>(Scene::ComponentMasks::Transform);
+
+    uint32 const kActorIndex = Scene::GetActorIndex(ActorHandle);
+
+    if (kActorIndex >= Private::ActorNodeIndices.size())
+    {
+        Private::ActorNodeIndices.resize(kActorIndex + 1u, Private::kInvalidNodeIndex);
+        Private::ActorMovedHandles.resize(kActorIndex + 1u);
+    }
+
+    uint32 const kNewNodeIndex = static_cast<uint32>(Private::NodeActorHandles.size());
+
+    /* New columns are zero initialised, so this matches the transform stored in the chunk */
+    Private::NodeActorHandles.push_back(ActorHandle);
+    Private::NodeParentIndices.push_back(Private::kInvalidNodeIndex);
+    Private::LocalTransforms.push_back(Math::Affine3x4::TranslationScale(Math::Vector3 {}, 0.0f));
+    Private::WorldTransforms.push_back(Private::LocalTransforms.back());
+    Private::DirtyFlags.push_back(0u);
+    Private::NodeSlotIndices.push_back(::AllocateSlot(kNewNodeIndex));
+
+    Private::ActorNodeIndices [kActorIndex] = kNewNodeIndex;
+
+    return true;
+}
+
+bool const Transform::CreateComponents(uint32 const * const ActorHandles, uint32 const ActorCount)
+{
+    uint32 MaximumActorIndex = {};
+
+    for (uint32 CurrentActorIndex = {};
+         CurrentActorIndex < ActorCount;
+         CurrentActorIndex++)
+    {
+        Archetypes::Types::ChunkView Chunk = {};
+        uint32 RowIndex = {};
+
+        if (!::GetTransformEntity(ActorHandles [CurrentActorIndex], Chunk, RowIndex))
+        {
+            return false;
+        }
+
+        MaximumActorIndex = std::max(MaximumActorIndex, Scene::GetActorIndex(ActorHandles [CurrentActorIndex]));
+    }
+
+    if (ActorCount == 0u)
+    {
+        return true;
+    }
+
+    if (MaximumActorIndex >= Private::ActorNodeIndices.size())
+    {
+        Private::ActorNodeIndices.resize(MaximumActorIndex + 1u, Private::kInvalidNodeIndex);
+        Private::ActorMovedHandles.resize(MaximumActorIndex + 1u);
+    }
+
+    uint32 const kFirstNodeIndex = static_cast<uint32>(Private::NodeActorHandles.size());
+    uint32 const kNodeCount = { kFirstNodeIndex + ActorCount };
+
+    /* Grown geometrically, reserving the exact count would reallocate every batch when actors are spawned each frame */
+    if (kNodeCount > Private::NodeActorHandles.capacity())
+    {
+        uint64 const kNodeCapacity = std::max<uint64>(kNodeCount, Private::NodeActorHandles.capacity() * 2u);
+
+        Private::NodeActorHandles.reserve(kNodeCapacity);
+        Private::NodeParentIndices.reserve(kNodeCapacity);
+        Private::LocalTransforms.reserve(kNodeCapacity);
+        Private::WorldTransforms.reserve(kNodeCapacity);
+        Private::DirtyFlags.reserve(kNodeCapacity);
+        Private::NodeSlotIndices.reserve(kNodeCapacity);
+    }
+
+    for (uint32 CurrentActorIndex = {};
+         CurrentActorIndex < ActorCount;
+         CurrentActorIndex++)
+    {
+        uint32 const kActorHandle = ActorHandles [CurrentActorIndex];
+        uint32 const kNewNodeIndex = { kFirstNodeIndex + CurrentActorIndex };
+
+        Archetypes::Types::ChunkView Chunk = {};
+        uint32 RowIndex = {};
+        Archetypes::GetEntity(kActorHandle, Chunk, RowIndex);
+
+        Private::NodeActorHandles.push_back(kActorHandle);
+        Private::NodeParentIndices.push_back(Private::kInvalidNodeIndex);
+        Private::LocalTransforms.push_back(Math::Affine3x4::TranslationScale(Chunk.GetColumn<Archetypes::Types::Columns::Position>() [RowIndex],
+                                                                             Chunk.GetColumn<Archetypes::Types::Columns::Scale>() [RowIndex]));
+        Private::WorldTransforms.push_back(Private::LocalTransforms.back());
+        Private::DirtyFlags.push_back(1u);
+        Private::NodeSlotIndices.push_back(::AllocateSlot(kNewNodeIndex));
+
+        Private::ActorNodeIndices [Scene::GetActorIndex(kActorHandle)] = kNewNodeIndex;
+    }
+
+    Private::FirstDirtyNodeIndex = std::min(Private::FirstDirtyNodeIndex, kFirstNodeIndex);
+
+    return true;
+}
+
+bool const Transform::DestroyComponent(uint32 const ActorHandle, Scene::SceneData & Scene)
+{
+    if (!Scene::DoesActorHaveComponents(Scene, ActorHandle, static_cast<uint32>(Scene::ComponentMasks::Transform)))
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot destroy transform component. The actor handle is stale or the actor doesn't have a transform component."));
+        return false;
+    }
+
+    if (!Archetypes::RemoveComponents(ActorHandle, static_cast<uint32>(Scene::ComponentMasks::Transform)))
     {
-        /* LOG ERROR */
         return false;
     }
 
-    /* TODO: Reserve memory on the first components creation */
+    Scene.ComponentMasks [Scene::GetActorIndex(ActorHandle)] &= ~static_cast<uint32>(Scene::ComponentMasks::Transform);
 
-    Transforms.Positions.emplace_back();
-    Transforms.Orientations.emplace_back();
-    Transforms.Scales.emplace_back();
+    uint32 const kNodeIndex = Private::ActorNodeIndices [Scene::GetActorIndex(ActorHandle)];
 
-    uint32 const NewComponentHandle = static_cast<uint32>(Transforms.Positions.size());
-    Transforms.ActorHandleToComponentIndex [ActorHandle] = NewComponentHandle;
+    ::FreeSlot(Private::NodeSlotIndices [kNodeIndex]);
 
-    Scene.ComponentMasks [ActorHandle - 1u] |= static_cast<uint32>(Scene::ComponentMasks::Transform);
+    Private::NodeActorHandles [kNodeIndex] = 0u;
+    Private::ActorNodeIndices [Scene::GetActorIndex(ActorHandle)] = Private::kInvalidNodeIndex;
+    Private::HoleCount++;
 
     return true;
 }
 
-bool const Components::Transform::SetTransform(uint32 const ActorHandle, Math::Vector3 const * const NewPosition, Math::Vector3 const * const NewOrientation, float const * const NewScale)
+bool const Transform::SetTransform(uint32 const ActorHandle, Math::Vector3 const * const NewPosition, Math::Vector3 const * const NewOrientation, float const * const NewScale)
 {
     if (ActorHandle == 0u)
     {
@@ -36,27 +386,39 @@ bool const Components::Transform::SetTransform(uint32 const ActorHandle, Math::V
         return false;
     }
 
-    uint32 const ComponentIndex = Transforms.ActorHandleToComponentIndex [ActorHandle] - 1u;
+    Archetypes::Types::ChunkView Chunk = {};
+    uint32 RowIndex = {};
+
+    if (!::GetTransformEntity(ActorHandle, Chunk, RowIndex))
+    {
+        return false;
+    }
 
     if (NewPosition)
     {
-        Transforms.Positions [ComponentIndex] = *NewPosition;
+        Chunk.GetColumn<Archetypes::Types::Columns::Position>() [RowIndex] = *NewPosition;
     }
 
     if (NewOrientation)
     {
-        Transforms.Orientations [ComponentIndex] = *NewOrientation;
+        Chunk.GetColumn<Archetypes::Types::Columns::Orientation>() [RowIndex] = *NewOrientation;
     }
 
     if (NewScale)
     {
-        Transforms.Scales [ComponentIndex] = *NewScale;
+        Chunk.GetColumn<Archetypes::Types::Columns::Scale>() [RowIndex] = *NewScale;
     }
 
+    uint32 const kNodeIndex = Private::ActorNodeIndices [Scene::GetActorIndex(ActorHandle)];
+
+    Private::LocalTransforms [kNodeIndex] = Math::Affine3x4::TranslationScale(Chunk.GetColumn<Archetypes::Types::Columns::Position>() [RowIndex],
+                                                                               Chunk.GetColumn<Archetypes::Types::Columns::Scale>() [RowIndex]);
+    ::MarkNodeDirty(kNodeIndex);
+
     return true;
 }
 
-bool const Components::Transform::GetTransform(uint32 const ActorHandle, Components::Transform::TransformData & /*OutputTransformData*/)
+bool const Transform::GetTransform(uint32 const ActorHandle, Transform::TransformData & OutputTransformData)
 {
     if (ActorHandle == 0u)
     {
@@ -64,10 +426,361 @@ bool const Components::Transform::GetTransform(uint32 const ActorHandle, Compone
         return false;
     }
 
+    Archetypes::Types::ChunkView Chunk = {};
+    uint32 RowIndex = {};
+
+    if (!::GetTransformEntity(ActorHandle, Chunk, RowIndex))
+    {
+        return false;
+    }
+
+    OutputTransformData.Position = Chunk.GetColumn<Archetypes::Types::Columns::Position>() [RowIndex];
+    OutputTransformData.Orientation = Chunk.GetColumn<Archetypes::Types::Columns::Orientation>() [RowIndex];
+    OutputTransformData.Scale = Chunk.GetColumn<Archetypes::Types::Columns::Scale>() [RowIndex];
+
+    return true;
+}
+
+bool const Transform::SetParent(uint32 const ActorHandle, uint32 const ParentActorHandle, Scene::SceneData const & Scene)
+{
+    uint32 const kTransformMask = static_cast<uint32>(Scene::ComponentMasks::Transform);
+
+    if (!Scene::DoesActorHaveComponents(Scene, ActorHandle, kTransformMask))
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot set parent. The actor handle is stale or the actor doesn't have a transform component."));
+        return false;
+    }
+
+    if (ParentActorHandle != 0u && !Scene::DoesActorHaveComponents(Scene, ParentActorHandle, kTransformMask))
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot set parent. The parent actor handle is stale or the parent doesn't have a transform component."));
+        return false;
+    }
+
+    uint32 NodeIndex = Private::ActorNodeIndices [Scene::GetActorIndex(ActorHandle)];
+    uint32 ParentNodeIndex = ParentActorHandle == 0u ? Private::kInvalidNodeIndex : Private::ActorNodeIndices [Scene::GetActorIndex(ParentActorHandle)];
+
+    /* Walking up from the new parent must not reach the actor, otherwise this would create a cycle */
+    for (uint32 AncestorNodeIndex = ParentNodeIndex;
+         AncestorNodeIndex != Private::kInvalidNodeIndex;
+         AncestorNodeIndex = Private::NodeParentIndices [AncestorNodeIndex])
+    {
+        if (AncestorNodeIndex == NodeIndex)
+        {
+            Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot set parent. An actor cannot be parented to itself or one of its children."));
+            return false;
+        }
+    }
+
+    /* The parent must come first, so move the actor's subtree to the end. Any holes are removed at the same time */
+    if (ParentNodeIndex != Private::kInvalidNodeIndex && ParentNodeIndex > NodeIndex)
+    {
+        uint32 const kNodeCount = static_cast<uint32>(Private::NodeActorHandles.size());
+
+        std::vector<uint8> InSubtree (kNodeCount);
+        InSubtree [NodeIndex] = 1u;
+
+        std::vector<uint32> NewOrder = {};
+        NewOrder.reserve(kNodeCount - Private::HoleCount);
+
+        for (uint32 CurrentNodeIndex = {};
+             CurrentNodeIndex < kNodeCount;
+             CurrentNodeIndex++)
+        {
+            uint32 const kCurrentParentIndex = Private::NodeParentIndices [CurrentNodeIndex];
+
+            if (CurrentNodeIndex > NodeIndex && kCurrentParentIndex != Private::kInvalidNodeIndex)
+            {
+                InSubtree [CurrentNodeIndex] = InSubtree [kCurrentParentIndex];
+            }
+
+            if (!InSubtree [CurrentNodeIndex] && Private::NodeActorHandles [CurrentNodeIndex] != 0u)
+            {
+                NewOrder.push_back(CurrentNodeIndex);
+            }
+        }
+
+        for (uint32 CurrentNodeIndex = { NodeIndex };
+             CurrentNodeIndex < kNodeCount;
+             CurrentNodeIndex++)
+        {
+            if (InSubtree [CurrentNodeIndex] && Private::NodeActorHandles [CurrentNodeIndex] != 0u)
+            {
+                NewOrder.push_back(CurrentNodeIndex);
+            }
+        }
+
+        ::RebuildNodes(NewOrder);
+
+        NodeIndex = Private::ActorNodeIndices [Scene::GetActorIndex(ActorHandle)];
+        ParentNodeIndex = Private::ActorNodeIndices [Scene::GetActorIndex(ParentActorHandle)];
+    }
+
+    Private::NodeParentIndices [NodeIndex] = ParentNodeIndex;
+    ::MarkNodeDirty(NodeIndex);
+
+    return true;
+}
+
+bool const Transform::SetParents(uint32 const * const ActorHandles, uint32 const * const ParentActorHandles, uint32 const ActorCount, Scene::SceneData const & Scene)
+{
+    uint32 const kTransformMask = static_cast<uint32>(Scene::ComponentMasks::Transform);
+
+    for (uint32 CurrentActorIndex = {};
+         CurrentActorIndex < ActorCount;
+         CurrentActorIndex++)
+    {
+        uint32 const kParentActorHandle = ParentActorHandles [CurrentActorIndex];
+
+        if (!Scene::DoesActorHaveComponents(Scene, ActorHandles [CurrentActorIndex], kTransformMask)
+            || (kParentActorHandle != 0u && !Scene::DoesActorHaveComponents(Scene, kParentActorHandle, kTransformMask)))
+        {
+            Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot set parents. An actor handle is stale or one of the actors doesn't have a transform component."));
+            return false;
+        }
+    }
+
+    uint32 const kNodeCount = static_cast<uint32>(Private::NodeActorHandles.size());
+
+    /* Applied to a copy so nothing changes if there is a cycle */
+    std::vector<uint32> NewParentIndices = Private::NodeParentIndices;
+
+    bool bParentsFirst = true;
+
+    for (uint32 CurrentActorIndex = {};
+         CurrentActorIndex < ActorCount;
+         CurrentActorIndex++)
+    {
+        uint32 const kNodeIndex = Private::ActorNodeIndices [Scene::GetActorIndex(ActorHandles [CurrentActorIndex])];
+        uint32 const kParentActorHandle = ParentActorHandles [CurrentActorIndex];
+        uint32 const kParentNodeIndex = kParentActorHandle == 0u ? Private::kInvalidNodeIndex : Private::ActorNodeIndices [Scene::GetActorIndex(kParentActorHandle)];
+
+        NewParentIndices [kNodeIndex] = kParentNodeIndex;
+        bParentsFirst &= kParentNodeIndex == Private::kInvalidNodeIndex || kParentNodeIndex < kNodeIndex;
+    }
+
+    std::vector<uint32> NewOrder = {};
+
+    /* Sorting live nodes by depth puts every parent before its children */
+    if (!bParentsFirst)
+    {
+        static constexpr uint32 kUnknownDepth = { ~0u };
+        static constexpr uint32 kVisitingDepth = { ~0u - 1u };
+
+        std::vector<uint32> Depths (kNodeCount, kUnknownDepth);
+        std::vector<uint32> Ancestors = {};
+
+        uint32 MaximumDepth = {};
+
+        for (uint32 CurrentNodeIndex = {};
+             CurrentNodeIndex < kNodeCount;
+             CurrentNodeIndex++)
+        {
+            uint32 AncestorIndex = { CurrentNodeIndex };
+
+            while (AncestorIndex != Private::kInvalidNodeIndex && Depths [AncestorIndex] == kUnknownDepth)
+            {
+                Depths [AncestorIndex] = kVisitingDepth;
+                Ancestors.push_back(AncestorIndex);
+                AncestorIndex = NewParentIndices [AncestorIndex];
+            }
+
+            if (AncestorIndex != Private::kInvalidNodeIndex && Depths [AncestorIndex] == kVisitingDepth)
+            {
+                Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot set parents. An actor cannot be parented to itself or one of its children."));
+                return false;
+            }
+
+            uint32 Depth = AncestorIndex == Private::kInvalidNodeIndex ? 0u : Depths [AncestorIndex] + 1u;
+
+            for (std::vector<uint32>::reverse_iterator AncestorIterator = Ancestors.rbegin();
+                 AncestorIterator != Ancestors.rend();
+                 AncestorIterator++)
+            {
+                Depths [*AncestorIterator] = Depth++;
+            }
+
+            MaximumDepth = std::max(MaximumDepth, Depth);
+            Ancestors.clear();
+        }
+
+        std::vector<uint32> DepthOffsets (MaximumDepth + 1u);
+
+        for (uint32 CurrentNodeIndex = {};
+             CurrentNodeIndex < kNodeCount;
+             CurrentNodeIndex++)
+        {
+            if (Private::NodeActorHandles [CurrentNodeIndex] != 0u)
+            {
+                DepthOffsets [Depths [CurrentNodeIndex] + 1u]++;
+            }
+        }
+
+        for (uint32 CurrentDepth = { 1u };
+             CurrentDepth < DepthOffsets.size();
+             CurrentDepth++)
+        {
+            DepthOffsets [CurrentDepth] += DepthOffsets [CurrentDepth - 1u];
+        }
+
+        NewOrder.resize(kNodeCount - Private::HoleCount);
+
+        for (uint32 CurrentNodeIndex = {};
+             CurrentNodeIndex < kNodeCount;
+             CurrentNodeIndex++)
+        {
+            if (Private::NodeActorHandles [CurrentNodeIndex] != 0u)
+            {
+                NewOrder [DepthOffsets [Depths [CurrentNodeIndex]]++] = CurrentNodeIndex;
+            }
+        }
+    }
+
+    Private::NodeParentIndices.swap(NewParentIndices);
+
+    for (uint32 CurrentActorIndex = {};
+         CurrentActorIndex < ActorCount;
+         CurrentActorIndex++)
+    {
+        ::MarkNodeDirty(Private::ActorNodeIndices [Scene::GetActorIndex(ActorHandles [CurrentActorIndex])]);
+    }
+
+    if (!bParentsFirst)
+    {
+        ::RebuildNodes(NewOrder);
+    }
+
+    return true;
+}
+
+bool const Transform::GetParent(uint32 const ActorHandle, uint32 & OutputParentActorHandle)
+{
+    uint32 NodeIndex = {};
+
+    if (!::FindNodeIndex(ActorHandle, NodeIndex))
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot get parent. The actor handle is stale or the actor doesn't have a transform component."));
+        return false;
+    }
+
+    uint32 ParentIndex = Private::NodeParentIndices [NodeIndex];
+
+    /* Destroyed parents leave holes until the next update, children of a hole end up attached to the hole's closest live ancestor */
+    while (ParentIndex != Private::kInvalidNodeIndex && Private::NodeActorHandles [ParentIndex] == 0u)
+    {
+        ParentIndex = Private::NodeParentIndices [ParentIndex];
+    }
+
+    OutputParentActorHandle = ParentIndex == Private::kInvalidNodeIndex ? 0u : Private::NodeActorHandles [ParentIndex];
+
     return true;
 }
 
-bool const Components::Transform::GetTransformationMatrix(uint32 const ActorHandle, Math::Matrix4x4 & OutputTransformation)
+void Transform::UpdateWorldTransforms()
+{
+    /* Static scenery costs nothing */
+    if (Private::HoleCount == 0u && Private::FirstDirtyNodeIndex == Private::kInvalidNodeIndex)
+    {
+        return;
+    }
+
+    if (Private::HoleCount > 0u)
+    {
+        std::vector<uint32> NewOrder = {};
+        NewOrder.reserve(Private::NodeActorHandles.size() - Private::HoleCount);
+
+        for (uint32 CurrentNodeIndex = {};
+             CurrentNodeIndex < Private::NodeActorHandles.size();
+             CurrentNodeIndex++)
+        {
+            if (Private::NodeActorHandles [CurrentNodeIndex] != 0u)
+            {
+                NewOrder.push_back(CurrentNodeIndex);
+            }
+        }
+
+        ::RebuildNodes(NewOrder);
+
+        if (Private::FirstDirtyNodeIndex == Private::kInvalidNodeIndex)
+        {
+            return;
+        }
+    }
+
+    uint32 const kNodeCount = static_cast<uint32>(Private::NodeActorHandles.size());
+
+    Private::NodeDirtyLevels.resize(kNodeCount);
+
+    uint32 LevelCount = {};
+
+    /* A node is recomputed if it or its parent changed, the parent's flag is set by the time the child is visited */
+    for (uint32 CurrentNodeIndex = { Private::FirstDirtyNodeIndex };
+         CurrentNodeIndex < kNodeCount;
+         CurrentNodeIndex++)
+    {
+        uint32 const kParentIndex = Private::NodeParentIndices [CurrentNodeIndex];
+
+        uint32 Level = {};
+
+        if (kParentIndex != Private::kInvalidNodeIndex && Private::DirtyFlags [kParentIndex])
+        {
+            Level = Private::NodeDirtyLevels [kParentIndex] + 1u;
+            Private::DirtyFlags [CurrentNodeIndex] = 1u;
+        }
+        else if (!Private::DirtyFlags [CurrentNodeIndex])
+        {
+            continue;
+        }
+
+        Private::NodeDirtyLevels [CurrentNodeIndex] = Level;
+
+        if (Level == Private::DirtyLevelNodeIndices.size())
+        {
+            Private::DirtyLevelNodeIndices.emplace_back();
+        }
+
+        Private::DirtyLevelNodeIndices [Level].push_back(CurrentNodeIndex);
+        LevelCount = std::max(LevelCount, Level + 1u);
+
+        /* Done here as the dirty slot masks and moved actors are shared between nodes */
+        ::MarkSlotDirty(Private::NodeSlotIndices [CurrentNodeIndex]);
+
+        /* Compares the full handle, a destroyed actor's entry must not hide the actor that reused its index */
+        uint32 const kActorHandle = Private::NodeActorHandles [CurrentNodeIndex];
+        uint32 const kActorIndex = Scene::GetActorIndex(kActorHandle);
+
+        if (Private::ActorMovedHandles [kActorIndex] != kActorHandle)
+        {
+            Private::ActorMovedHandles [kActorIndex] = kActorHandle;
+            Private::MovedActorHandles.push_back(kActorHandle);
+        }
+    }
+
+    for (uint32 CurrentLevel = {};
+         CurrentLevel < LevelCount;
+         CurrentLevel++)
+    {
+        std::vector<uint32> & LevelNodeIndices = Private::DirtyLevelNodeIndices [CurrentLevel];
+
+        Jobs::ParallelFor(static_cast<uint32>(LevelNodeIndices.size()), Private::kWorldTransformBatchSize,
+                          [&LevelNodeIndices](uint32 const FirstIndex, uint32 const EndIndex)
+                          {
+                              for (uint32 CurrentIndex = { FirstIndex };
+                                   CurrentIndex < EndIndex;
+                                   CurrentIndex++)
+                              {
+                                  ::UpdateWorldTransform(LevelNodeIndices [CurrentIndex]);
+                              }
+                          });
+
+        LevelNodeIndices.clear();
+    }
+
+    std::fill(Private::DirtyFlags.begin() + Private::FirstDirtyNodeIndex, Private::DirtyFlags.end(), uint8 {});
+    Private::FirstDirtyNodeIndex = Private::kInvalidNodeIndex;
+}
+
+bool const Transform::GetTransformationMatrix(uint32 const ActorHandle, Math::Affine3x4 & OutputTransformation)
 {
     if (ActorHandle == 0u)
     {
@@ -75,15 +788,113 @@ bool const Components::Transform::GetTransformationMatrix(uint32 const ActorHand
         return false;
     }
 
-    if (Transforms.ActorHandleToComponentIndex [ActorHandle] == 0u)
+    uint32 NodeIndex = {};
+
+    if (!::FindNodeIndex(ActorHandle, NodeIndex))
     {
         Logging::Log(Logging::LogTypes::Error, PBR_TEXT("The actor provided doesn't have an associated transform component."));
         return false;
     }
 
-    uint32 const ComponentIndex = { Transforms.ActorHandleToComponentIndex [ActorHandle] - 1u };
+    OutputTransformation = Private::WorldTransforms [NodeIndex];
+
+    return true;
+}
+
+bool const Transform::GetTransformSlot(uint32 const ActorHandle, uint32 & OutputSlotIndex)
+{
+    uint32 NodeIndex = {};
+
+    if (!::FindNodeIndex(ActorHandle, NodeIndex))
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot get transform slot. The actor handle is stale or the actor doesn't have a transform component."));
+        return false;
+    }
 
-    OutputTransformation = Math::TranslationMatrix(Transforms.Positions [ComponentIndex]) * Math::ScaleMatrix(Transforms.Scales [ComponentIndex]);
+    OutputSlotIndex = Private::NodeSlotIndices [NodeIndex];
 
     return true;
-}
\ No newline at end of file
+}
+
+uint32 const Transform::GetTransformSlotCount()
+{
+    return static_cast<uint32>(Private::SlotNodeIndices.size());
+}
+
+uint32 const Transform::FlushDirtySlots(uint32 const MaximumSlotCount, std::vector<Types::SlotRange> & OutputSlotRanges)
+{
+    uint32 FlushedSlotCount = {};
+
+    for (uint32 CurrentMaskIndex = {};
+         CurrentMaskIndex < Private::DirtySlotMasks.size() && FlushedSlotCount < MaximumSlotCount;
+         CurrentMaskIndex++)
+    {
+        uint64 & DirtyMask = Private::DirtySlotMasks [CurrentMaskIndex];
+
+        while (DirtyMask != 0u && FlushedSlotCount < MaximumSlotCount)
+        {
+            unsigned long FirstBitIndex = {};
+            ::_BitScanForward64(&FirstBitIndex, DirtyMask);
+
+            /* Length of the run of set bits starting at FirstBitIndex */
+            unsigned long FirstClearBitIndex = { 64u - FirstBitIndex };
+            uint64 const kClearBits = ~(DirtyMask >> FirstBitIndex);
+            if (kClearBits != 0u)
+            {
+                ::_BitScanForward64(&FirstClearBitIndex, kClearBits);
+            }
+
+            uint32 const kRunLength = std::min(static_cast<uint32>(FirstClearBitIndex), MaximumSlotCount - FlushedSlotCount);
+
+            uint64 const kRunMask = (kRunLength == 64u ? ~uint64 {} : ((uint64 { 1u } << kRunLength) - 1u)) << FirstBitIndex;
+            DirtyMask &= ~kRunMask;
+
+            uint32 const kFirstSlotIndex = { (CurrentMaskIndex << 6u) + static_cast<uint32>(FirstBitIndex) };
+
+            /* Runs can continue across masks */
+            if (OutputSlotRanges.size() > 0u && OutputSlotRanges.back().FirstSlotIndex + OutputSlotRanges.back().SlotCount == kFirstSlotIndex)
+            {
+                OutputSlotRanges.back().SlotCount += kRunLength;
+            }
+            else
+            {
+                OutputSlotRanges.push_back(Types::SlotRange { kFirstSlotIndex, kRunLength });
+            }
+
+            FlushedSlotCount += kRunLength;
+        }
+    }
+
+    return FlushedSlotCount;
+}
+
+void Transform::GetWorldTransforms(Types::SlotRange const & SlotRange, Math::Affine3x4 * const OutputTransforms)
+{
+    for (uint32 CurrentSlotOffset = {};
+         CurrentSlotOffset < SlotRange.SlotCount;
+         CurrentSlotOffset++)
+    {
+        uint32 const kNodeIndex = Private::SlotNodeIndices [SlotRange.FirstSlotIndex + CurrentSlotOffset];
+
+        /* Only dirty slots are flushed and freed slots are never dirty */
+        PBR_ASSERT(kNodeIndex != Private::kInvalidNodeIndex);
+
+        OutputTransforms [CurrentSlotOffset] = Private::WorldTransforms [kNodeIndex];
+    }
+}
+
+void Transform::FlushMovedActors(std::vector<uint32> & OutputActorHandles)
+{
+    for (uint32 const kActorHandle : Private::MovedActorHandles)
+    {
+        uint32 & MovedHandle = Private::ActorMovedHandles [Scene::GetActorIndex(kActorHandle)];
+
+        if (MovedHandle == kActorHandle)
+        {
+            MovedHandle = 0u;
+        }
+    }
+
+    OutputActorHandles.insert(OutputActorHandles.end(), Private::MovedActorHandles.cbegin(), Private::MovedActorHandles.cend());
+    Private::MovedActorHandles.clear();
+}
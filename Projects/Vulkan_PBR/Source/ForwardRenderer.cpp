@@ -3,9 +3,6 @@
 #include "Assets/Material.hpp"
 #include "Assets/StaticMesh.hpp"
 #include "Assets/Texture.hpp"
-#include "Camera.hpp"
-#include "Components/StaticMeshComponent.hpp"
-#include "Components/TransformComponent.hpp"
 #include "Graphics/VulkanModule.hpp"
 #include "Graphics/Instance.hpp"
 #include "Graphics/Device.hpp"
@@ -14,14 +11,22 @@
 #include "Graphics/Descriptors.hpp"
 #include "Graphics/Memory.hpp"
 #include "Graphics/Allocators.hpp"
-#include "Scene.hpp"
+#include "Graphics/PipelineCache.hpp"
+#include "Graphics/Pipelines.hpp"
+#include "Jobs.hpp"
+#include "RenderSnapshot.hpp"
 #include "VulkanPBR.hpp"
 
+#include <Math/Affine.hpp>
+#include <Math/Bounds.hpp>
 #include <Math/Matrix.hpp>
+#include <Math/Quantisation.hpp>
 #include <Math/Transform.hpp>
 #include <Math/Utilities.hpp>
 
+#include <algorithm>
 #include <array>
+#include <filesystem>
 
 struct PerFrameUniformBufferData
 {
@@ -31,15 +36,72 @@ struct PerFrameUniformBufferData
 
 struct PerDrawUniformBufferData
 {
-    Math::Matrix4x4 ModelToWorldMatrix;
+    /* Dequantisation and up axis conversion for the mesh, only 48 bytes as the fourth row is implicit in the shader */
+    Math::Affine3x4 MeshToModelMatrix;
+};
+
+/* Matches MaterialData in TorranceSparrow.frag, each is an index into the bindless texture array */
+struct BindlessMaterialData
+{
+    uint32 DiffuseTextureIndex;
+    uint32 SpecularTextureIndex;
+    uint32 NormalTextureIndex;
+    uint32 GlossTextureIndex;
+    uint32 AOTextureIndex;
+};
+
+/* Matches the push constants in CullInstances.comp */
+struct CullConstants
+{
+    Math::FrustumPlanes FrustumPlanes;
+    uint32 InstanceCount;
+    uint32 BatchCount;
+    uint32 Padding [2u];
+};
+
+/* Matches CullBatch in CullInstances.comp, std430 pads it to 64 bytes */
+struct CullBatchData
+{
+    Math::Affine3x4 MeshToModelMatrix;
+    uint32 FirstInstanceIndex;
+    uint32 InstanceCount;
+    uint32 Padding [2u];
+};
+
+/* What the recording jobs bind for a mesh, resolved on the render thread so the jobs don't take the static mesh lock */
+struct MeshDrawBuffers
+{
+    /* VK_NULL_HANDLE when the mesh is missing, its batches aren't drawn */
+    VkBuffer VertexBuffer = {};
+    VkBuffer IndexBuffer = {};
+
+    /* Position, normal, tangent and UV streams in the vertex buffer */
+    std::array<VkDeviceSize, 4u> StreamOffsetsInBytes = {};
+
+    uint32 IndexCount = {};
+};
+
+/* Buffers the cull pass reads and writes, besides the transform and instance buffers */
+struct CullBufferAllocations
+{
+    uint32 CandidateAllocation = {};
+    uint32 BatchAllocation = {};
+    uint32 DrawCommandAllocation = {};
 };
 
 struct FrameStateCollection
 {
     std::vector<uint16> LinearAllocatorHandles = {};
+    std::vector<uint16> StagingAllocatorHandles = {};
+    std::vector<uint16> InstanceAllocatorHandles = {};
 
     std::vector<VkCommandBuffer> CommandBuffers = {};
 
+    /* RecordingJobCount per frame, each job recording static meshes has its own pool and secondary command buffers */
+    std::vector<VkCommandPool> RecordingCommandPools = {};
+    std::vector<VkCommandBuffer> RecordingCommandBuffers = {};
+    std::vector<VkCommandBuffer> DepthPrePassCommandBuffers = {};
+
     std::vector<VkSemaphore> Semaphores = {};
     std::vector<VkFence> Fences = {};
 
@@ -61,46 +123,141 @@ struct FrameStateCollection
 static std::string const kDefaultShaderEntryPointName = "main";
 static uint8 const kFrameStateCount = { 3u };
 
+/* Per frame data plus a slot per mesh drawn, enough for 2k meshes at the largest alignment the spec allows */
+static uint64 const kUniformBufferSizeInBytes = { 512u * 1024u + 1024u };
+
+static uint64 const kTransformStagingSizeInBytes = { 1024u * 1024u };
+static uint32 const kMinimumTransformSlotCount = { 1024u };
+
+/* Transform slot per visible instance, enough for a million instances a frame. Culling on the GPU also takes the candidates, batches and draw commands from it */
+static uint64 const kInstanceBufferSizeInBytes = { sizeof(uint32) * 1024u * 1024u };
+
+/* The largest minStorageBufferOffsetAlignment the spec allows, instance buffer allocations are rounded up to it so they can all be bound as storage buffers */
+static uint64 const kStorageBufferAlignmentInBytes = { 256u };
+
+/* Must match local_size_x in CullInstances.comp */
+static uint32 const kCullGroupSize = { 64u };
+
+/* Each recording job takes a command pool per frame, past this many the jobs are too small to be worth it */
+static uint32 const kMaximumRecordingJobCount = { 16u };
+
+/* Fewer batches than this aren't worth a secondary command buffer of their own */
+static uint32 const kMinimumBatchesPerRecordingJob = { 64u };
+
+/* Descriptor writes are cached with 8 bit offsets until they are flushed, so first time materials are spread over a few frames */
+static uint32 const kMaximumMaterialWritesPerFrame = { 32u };
+
+/* Texture handles index the bindless texture array directly, material handles index the material buffer */
+static uint32 const kMaximumBindlessTextureCount = { 4096u };
+static uint32 const kMaximumBindlessMaterialCount = { 1024u };
+
 static Vulkan::Instance::InstanceState InstanceState = {};
 static Vulkan::Device::DeviceState DeviceState = {};
 static Vulkan::Viewport::ViewportState ViewportState = {};
 static FrameStateCollection FrameState = {};
 
+/* One per job thread plus the render thread */
+static uint32 RecordingJobCount = {};
+
 static VkRenderPass MainRenderPass = {};
 
+/* Loaded before any pipelines are created and saved on shutdown */
+static std::filesystem::path const kPipelineCacheFilePath = std::filesystem::current_path() / "PipelineCache.bin";
+static VkPipelineCache PipelineCache = {};
+
+/* World transforms stay on the GPU between frames and are indexed by transform slot, only changed slots are uploaded */
+static uint32 TransformBufferHandle = {};
+static uint32 TransformBufferCapacity = {};
+
+/* Material sets are written once and kept until shutdown, so this allocator is never reset */
+static uint16 MaterialDescriptorAllocatorHandle = {};
+
+/* Indexed by material handle - 1, 0 until the material's textures are on the GPU. With bindless materials every ready material holds the bindless set */
+static std::vector<uint16> MaterialDescriptorSetHandles = {};
+
+/* Set when the device supports descriptor indexing, materials are then a push constant index into the material buffer rather than a set each */
+static bool bBindlessMaterials = {};
+
+/* The bindless set is written as textures are first used and kept until shutdown */
+static uint16 BindlessDescriptorAllocatorHandle = {};
+static uint16 BindlessDescriptorSetHandle = {};
+static VkDescriptorSet BindlessDescriptorSet = {};
+
+/* Holds a BindlessMaterialData per material, entries are only written before the material is first drawn so in flight frames never see them change */
+static uint16 MaterialBufferAllocatorHandle = {};
+static uint32 MaterialBufferAllocation = {};
+
+/* Indexed by texture handle - 1 */
+static std::vector<bool> WrittenTextureSlots = {};
+
+/* Indexed by material handle - 1, materials past the bindless limits are reported once and never tried again */
+static std::vector<bool> RejectedBindlessMaterials = {};
+
+/* Set when the device supports drawIndirectFirstInstance, otherwise snapshots are culled on the CPU and drawn directly */
+static bool bCullOnGPU = {};
+
+/* sizeof(PerDrawUniformBufferData) rounded up to minUniformBufferOffsetAlignment */
+static uint32 PerDrawUniformStrideInBytes = {};
+
+/*
+    The per-draw uniform slots only hold mesh data, so there is a slot per mesh drawn this frame rather than per batch.
+    UniformSlotMeshHandles holds the mesh of each slot, and an entry of MeshUniformSlotIndices is only valid when that slot points back at its mesh, so neither needs clearing between frames.
+*/
+static std::vector<uint32> UniformSlotMeshHandles = {};
+
+/* Indexed by mesh handle */
+static std::vector<uint32> MeshUniformSlotIndices = {};
+
+/* Indexed by uniform slot like UniformSlotMeshHandles, written alongside the per-draw uniform buffer */
+static std::vector<MeshDrawBuffers> UniformSlotMeshBuffers = {};
+
+/*
+*   0 = Render Pipeline
+*   1 = Output Pipeline
+*   2 = Cull Pipeline
+*/
+std::array<VkPipelineLayout, 3u> PipelineLayouts = {};
+
 /*
 *   0 = Render Pipeline
 *   1 = Output Pipeline
+*   2 = Depth Pre-Pass Pipeline
+*   3 = Render Pipeline after the Depth Pre-Pass
 */
-std::array<VkPipelineLayout, 2u> PipelineLayouts = {};
-std::array<VkPipeline, 2u> Pipelines = {};
+std::array<uint16, 4u> GraphicsPipelineHandles = {};
+
+/* Compute pipelines aren't requested through Vulkan::Pipelines, so the cull pipeline is created directly */
+static VkPipeline CullPipeline = {};
 
 /*
 *   0 = Projection VS
 *   1 = Full Screen Triangle VS
+*   2 = Projection Depth Only VS
 */
-std::array<uint16, 2u> VertexShaderHandles = {};
+std::array<uint16, 3u> VertexShaderHandles = {};
 
 /*
 *   0 = Torrance Sparrow FS
 *   1 = Post Process FS
+*   2 = Torrance Sparrow Bindless FS
 */
-std::array<uint16, 2u> FragmentShaderHandles = {};
+std::array<uint16, 3u> FragmentShaderHandles = {};
+
+static uint16 CullInstancesShaderHandle = {};
 
 std::array<VkShaderModule, 2u> VertexShaderModules = {};
 std::array<VkShaderModule, 2u> FragmentShaderModules = {};
 
-static VkShaderModule ProjectVerticesVSShaderModule = {};
-static VkShaderModule TorranceSparrowFSShaderModule = {};
-
-static VkShaderModule FullScreenTriangleVSShaderModule = {};
-static VkShaderModule PostProcessFSShaderModule = {};
+static VkShaderModule CullInstancesCSShaderModule = {};
 
 /*
 *   0 = Per Frame Layout
-*   1 = Per Draw Layout
+*   1 = Material Layout
+*   2 = Cull Layout
+*   3 = Per Draw Layout
+*   4 = Bindless Material Layout
 */
-static std::array<uint16, 2u> DescriptorSetLayoutHandles = {};
+static std::array<uint16, 5u> DescriptorSetLayoutHandles = {};
 
 /*
 *   0 = Linear Sampler
@@ -135,10 +292,18 @@ static void CreateFrameState()
     FrameState.Semaphores.resize(kFrameStateCount * 2u);    // Each frame uses 2 semaphores
     FrameState.Fences.resize(kFrameStateCount);
     FrameState.LinearAllocatorHandles.resize(kFrameStateCount);
+    FrameState.StagingAllocatorHandles.resize(kFrameStateCount);
+    FrameState.InstanceAllocatorHandles.resize(kFrameStateCount);
     FrameState.DescriptorAllocators.resize(kFrameStateCount);
 
     Vulkan::Device::CreateCommandBuffers(DeviceState, VK_COMMAND_BUFFER_LEVEL_PRIMARY, kFrameStateCount, FrameState.CommandBuffers);
 
+    RecordingJobCount = std::min(Jobs::GetWorkerCount() + 1u, kMaximumRecordingJobCount);
+
+    FrameState.RecordingCommandPools.resize(kFrameStateCount * RecordingJobCount);
+    FrameState.RecordingCommandBuffers.resize(kFrameStateCount * RecordingJobCount);
+    FrameState.DepthPrePassCommandBuffers.resize(kFrameStateCount * RecordingJobCount);
+
     for (uint8 CurrentFrameStateIndex = {};
          CurrentFrameStateIndex < kFrameStateCount;
          CurrentFrameStateIndex++)
@@ -189,13 +354,39 @@ static void CreateFrameState()
         Vulkan::Device::CreateFence(DeviceState, VK_FENCE_CREATE_SIGNALED_BIT, FrameState.Fences [CurrentFrameStateIndex]);
 
         Vulkan::Allocators::LinearBufferAllocator::CreateAllocator(DeviceState,
-                                                                   1024u,
+                                                                   kUniformBufferSizeInBytes,
                                                                    VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
                                                                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
                                                                    FrameState.LinearAllocatorHandles [CurrentFrameStateIndex]);
+        Vulkan::Allocators::LinearBufferAllocator::CreateAllocator(DeviceState,
+                                                                   kTransformStagingSizeInBytes,
+                                                                   VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                                                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                                                   FrameState.StagingAllocatorHandles [CurrentFrameStateIndex]);
+        Vulkan::Allocators::LinearBufferAllocator::CreateAllocator(DeviceState,
+                                                                   kInstanceBufferSizeInBytes,
+                                                                   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                                                                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                                                   FrameState.InstanceAllocatorHandles [CurrentFrameStateIndex]);
         Vulkan::Descriptors::CreateDescriptorAllocator(DeviceState,
-                                                       Vulkan::Descriptors::DescriptorTypes::Uniform | Vulkan::Descriptors::DescriptorTypes::SampledImage | Vulkan::Descriptors::DescriptorTypes::Sampler,
+                                                       Vulkan::Descriptors::DescriptorTypes::Uniform | Vulkan::Descriptors::DescriptorTypes::UniformDynamic | Vulkan::Descriptors::DescriptorTypes::SampledImage | Vulkan::Descriptors::DescriptorTypes::Sampler | Vulkan::Descriptors::DescriptorTypes::StorageBuffer,
                                                        FrameState.DescriptorAllocators [CurrentFrameStateIndex]);
+
+        for (uint32 JobIndex = {};
+             JobIndex < RecordingJobCount;
+             JobIndex++)
+        {
+            uint32 const kRecordingIndex = { CurrentFrameStateIndex * RecordingJobCount + JobIndex };
+
+            /* The whole pool is reset at the start of the frame rather than each command buffer */
+            Vulkan::Device::CreateCommandPool(DeviceState, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT, FrameState.RecordingCommandPools [kRecordingIndex]);
+
+            std::vector<VkCommandBuffer> SecondaryCommandBuffers = {};
+            Vulkan::Device::CreateCommandBuffers(DeviceState, FrameState.RecordingCommandPools [kRecordingIndex], VK_COMMAND_BUFFER_LEVEL_SECONDARY, 2u, SecondaryCommandBuffers);
+
+            FrameState.RecordingCommandBuffers [kRecordingIndex] = SecondaryCommandBuffers [0u];
+            FrameState.DepthPrePassCommandBuffers [kRecordingIndex] = SecondaryCommandBuffers [1u];
+        }
     }
 }
 
@@ -206,6 +397,16 @@ static void DestroyFrameState()
         Vulkan::Allocators::LinearBufferAllocator::DestroyAllocator(kAllocatorHandle, DeviceState);
     }
 
+    for (uint16 const kAllocatorHandle : FrameState.StagingAllocatorHandles)
+    {
+        Vulkan::Allocators::LinearBufferAllocator::DestroyAllocator(kAllocatorHandle, DeviceState);
+    }
+
+    for (uint16 const kAllocatorHandle : FrameState.InstanceAllocatorHandles)
+    {
+        Vulkan::Allocators::LinearBufferAllocator::DestroyAllocator(kAllocatorHandle, DeviceState);
+    }
+
     for (VkFence & Fence : FrameState.Fences)
     {
         Vulkan::Device::DestroyFence(DeviceState, Fence);
@@ -222,6 +423,11 @@ static void DestroyFrameState()
     }
 
     Vulkan::Device::DestroyCommandBuffers(DeviceState, FrameState.CommandBuffers);
+
+    for (VkCommandPool & CommandPool : FrameState.RecordingCommandPools)
+    {
+        Vulkan::Device::DestroyCommandPool(DeviceState, CommandPool);
+    }
 }
 
 static bool const CreateMainRenderPass()
@@ -270,25 +476,58 @@ static bool const CreateMainRenderPass()
 
 static bool const CreateDescriptorSetLayout()
 {
-    std::array<VkDescriptorSetLayoutBinding, 10u> const kDescriptorBindings =
+    std::array<VkDescriptorSetLayoutBinding, 21u> const kDescriptorBindings =
     {
         // Per Frame
         Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1u, 0u, VK_SHADER_STAGE_VERTEX_BIT),
         Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1u, 1u, VK_SHADER_STAGE_FRAGMENT_BIT),
+        Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1u, 2u, VK_SHADER_STAGE_VERTEX_BIT),
+        Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1u, 3u, VK_SHADER_STAGE_VERTEX_BIT),
 
-        // Per Draw
-        Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1u, 0u, VK_SHADER_STAGE_VERTEX_BIT),
+        // Per Material
+        Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1u, 0u, VK_SHADER_STAGE_FRAGMENT_BIT),
         Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1u, 1u, VK_SHADER_STAGE_FRAGMENT_BIT),
         Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1u, 2u, VK_SHADER_STAGE_FRAGMENT_BIT),
         Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1u, 3u, VK_SHADER_STAGE_FRAGMENT_BIT),
         Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1u, 4u, VK_SHADER_STAGE_FRAGMENT_BIT),
-        Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1u, 5u, VK_SHADER_STAGE_FRAGMENT_BIT),
+        Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_SAMPLER, 1u, 5u, VK_SHADER_STAGE_FRAGMENT_BIT),
         Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_SAMPLER, 1u, 6u, VK_SHADER_STAGE_FRAGMENT_BIT),
-        Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_SAMPLER, 1u, 7u, VK_SHADER_STAGE_FRAGMENT_BIT),
+
+        // Cull
+        Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1u, 0u, VK_SHADER_STAGE_COMPUTE_BIT),
+        Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1u, 1u, VK_SHADER_STAGE_COMPUTE_BIT),
+        Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1u, 2u, VK_SHADER_STAGE_COMPUTE_BIT),
+        Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1u, 3u, VK_SHADER_STAGE_COMPUTE_BIT),
+        Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1u, 4u, VK_SHADER_STAGE_COMPUTE_BIT),
+
+        // Per Draw
+        Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1u, 0u, VK_SHADER_STAGE_VERTEX_BIT),
+
+        // Bindless Material
+        Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, kMaximumBindlessTextureCount, 0u, VK_SHADER_STAGE_FRAGMENT_BIT),
+        Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_SAMPLER, 1u, 1u, VK_SHADER_STAGE_FRAGMENT_BIT),
+        Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_SAMPLER, 1u, 2u, VK_SHADER_STAGE_FRAGMENT_BIT),
+        Vulkan::DescriptorSetBinding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1u, 3u, VK_SHADER_STAGE_FRAGMENT_BIT),
     };
 
-    Vulkan::Descriptors::CreateDescriptorSetLayout(DeviceState, 2u, kDescriptorBindings.data(), DescriptorSetLayoutHandles [0u]);
-    Vulkan::Descriptors::CreateDescriptorSetLayout(DeviceState, 8u, kDescriptorBindings.data() + 2u, DescriptorSetLayoutHandles [1u]);
+    Vulkan::Descriptors::CreateDescriptorSetLayout(DeviceState, 4u, kDescriptorBindings.data(), DescriptorSetLayoutHandles [0u]);
+    Vulkan::Descriptors::CreateDescriptorSetLayout(DeviceState, 7u, kDescriptorBindings.data() + 4u, DescriptorSetLayoutHandles [1u]);
+    Vulkan::Descriptors::CreateDescriptorSetLayout(DeviceState, 5u, kDescriptorBindings.data() + 11u, DescriptorSetLayoutHandles [2u]);
+    Vulkan::Descriptors::CreateDescriptorSetLayout(DeviceState, 1u, kDescriptorBindings.data() + 16u, DescriptorSetLayoutHandles [3u]);
+
+    if (bBindlessMaterials)
+    {
+        /* Slots are written while earlier frames are still in flight, and slots for textures that aren't loaded are never written */
+        std::array<VkDescriptorBindingFlags, 4u> const kBindlessBindingFlags =
+        {
+            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT,
+            0u,
+            0u,
+            0u,
+        };
+
+        Vulkan::Descriptors::CreateDescriptorSetLayout(DeviceState, 4u, kDescriptorBindings.data() + 17u, kBindlessBindingFlags.data(), DescriptorSetLayoutHandles [4u]);
+    }
 
     return true;
 }
@@ -296,203 +535,461 @@ static bool const CreateDescriptorSetLayout()
 static bool const CreateTorranceSparrowPipeline()
 {
     {
-        std::array<VkDescriptorSetLayout, 2u> DescriptorSetLayouts = {};
+        std::array<VkDescriptorSetLayout, 3u> DescriptorSetLayouts = {};
         Vulkan::Descriptors::GetDescriptorSetLayout(DescriptorSetLayoutHandles [0u], DescriptorSetLayouts [0u]);
-        Vulkan::Descriptors::GetDescriptorSetLayout(DescriptorSetLayoutHandles [1u], DescriptorSetLayouts [1u]);
+        Vulkan::Descriptors::GetDescriptorSetLayout(DescriptorSetLayoutHandles [bBindlessMaterials ? 4u : 1u], DescriptorSetLayouts [1u]);
+        Vulkan::Descriptors::GetDescriptorSetLayout(DescriptorSetLayoutHandles [3u], DescriptorSetLayouts [2u]);
 
-        VkPipelineLayoutCreateInfo const CreateInfo = Vulkan::PipelineLayout(static_cast<uint32>(DescriptorSetLayouts.size()), DescriptorSetLayouts.data());
+        /* The material index, only used by the bindless shader */
+        VkPushConstantRange const kPushConstantRange = { VK_SHADER_STAGE_FRAGMENT_BIT, 0u, sizeof(uint32) };
+
+        VkPipelineLayoutCreateInfo const CreateInfo = Vulkan::PipelineLayout(static_cast<uint32>(DescriptorSetLayouts.size()), DescriptorSetLayouts.data(),
+                                                                             bBindlessMaterials ? 1u : 0u, &kPushConstantRange);
         VERIFY_VKRESULT(vkCreatePipelineLayout(DeviceState.Device, &CreateInfo, nullptr, &PipelineLayouts [0u]));
     }
 
-    ShaderLibrary::CreateShaderModule(DeviceState, VertexShaderHandles [0u], ProjectVerticesVSShaderModule);
-    ShaderLibrary::CreateShaderModule(DeviceState, FragmentShaderHandles [0u], TorranceSparrowFSShaderModule);
+    /* See Math/Quantisation.hpp for the encodings */
+    Vulkan::Pipelines::Types::GraphicsPipelineDescription Description = {};
+    Description.PipelineLayout = PipelineLayouts [0u];
+    Description.RenderPass = MainRenderPass;
+    Description.SubpassIndex = 0u;
+    Description.VertexShaderHandle = VertexShaderHandles [0u];
+    Description.FragmentShaderHandle = FragmentShaderHandles [bBindlessMaterials ? 2u : 0u];
+    Description.VertexBindingCount = 4u;
+    Description.VertexBindings =
+    {
+        Vulkan::VertexInputBinding(0u, sizeof(uint16) * 4u),
+        Vulkan::VertexInputBinding(1u, sizeof(uint32)),
+        Vulkan::VertexInputBinding(2u, sizeof(uint32)),
+        Vulkan::VertexInputBinding(3u, sizeof(uint32)),
+    };
+    Description.VertexAttributeCount = 4u;
+    Description.VertexAttributes =
+    {
+        Vulkan::VertexInputAttribute(0u, 0u, 0u, VK_FORMAT_R16G16B16A16_UNORM),
+        Vulkan::VertexInputAttribute(1u, 1u, 0u, VK_FORMAT_R16G16_SNORM),
+        Vulkan::VertexInputAttribute(2u, 2u, 0u, VK_FORMAT_R16G16_SINT),
+        Vulkan::VertexInputAttribute(3u, 3u, 0u, VK_FORMAT_R16G16_SFLOAT),
+    };
+    Description.CullMode = VK_CULL_MODE_BACK_BIT;
+    Description.ColourAttachmentCount = 1u;
+    Description.ColourBlendState = Vulkan::ColourAttachmentBlendState();
+    Description.bDepthTestEnable = VK_TRUE;
+    Description.bDepthWriteEnable = VK_TRUE;
+    Description.DepthCompareOp = VK_COMPARE_OP_GREATER;
+
+    bool bResult = Vulkan::Pipelines::RequestGraphicsPipeline(Description, GraphicsPipelineHandles [0u]);
+
+    /* After the pre-pass only the closest surface passes the depth test, so each pixel is shaded once */
+    Description.bDepthWriteEnable = VK_FALSE;
+    Description.DepthCompareOp = VK_COMPARE_OP_EQUAL;
+
+    bResult &= Vulkan::Pipelines::RequestGraphicsPipeline(Description, GraphicsPipelineHandles [3u]);
+
+    /* The pre-pass only reads positions and has no fragment shader. The subpass still has a colour attachment, so the pipeline needs a blend state that doesn't write to it */
+    Description.VertexShaderHandle = VertexShaderHandles [2u];
+    Description.FragmentShaderHandle = 0u;
+    Description.VertexBindingCount = 1u;
+    Description.VertexAttributeCount = 1u;
+    Description.ColourBlendState.colorWriteMask = 0u;
+    Description.bDepthWriteEnable = VK_TRUE;
+    Description.DepthCompareOp = VK_COMPARE_OP_GREATER;
+
+    bResult &= Vulkan::Pipelines::RequestGraphicsPipeline(Description, GraphicsPipelineHandles [2u]);
+
+    return bResult;
+}
+
+static bool const CreateOutputPipeline()
+{
+    {
+        VkDescriptorSetLayout DescriptorSetLayout = {};
+        Vulkan::Descriptors::GetDescriptorSetLayout(DescriptorSetLayoutHandles [0u], DescriptorSetLayout);
+
+        VkPipelineLayoutCreateInfo const PipelineLayout = Vulkan::PipelineLayout(1u, &DescriptorSetLayout);
+        VERIFY_VKRESULT(vkCreatePipelineLayout(DeviceState.Device, &PipelineLayout, nullptr, &PipelineLayouts [1u]));
+    }
+
+    Vulkan::Pipelines::Types::GraphicsPipelineDescription Description = {};
+    Description.PipelineLayout = PipelineLayouts [1u];
+    Description.RenderPass = MainRenderPass;
+    Description.SubpassIndex = 1u;
+    Description.VertexShaderHandle = VertexShaderHandles [1u];
+    Description.FragmentShaderHandle = FragmentShaderHandles [1u];
+    Description.CullMode = VK_CULL_MODE_NONE;
+    Description.ColourAttachmentCount = 1u;
+    Description.ColourBlendState = Vulkan::ColourAttachmentBlendState();
+    Description.bDepthTestEnable = VK_FALSE;
+    Description.bDepthWriteEnable = VK_FALSE;
+    Description.DepthCompareOp = VK_COMPARE_OP_NEVER;
+
+    return Vulkan::Pipelines::RequestGraphicsPipeline(Description, GraphicsPipelineHandles [1u]);
+}
+
+static bool const CreateCullPipeline()
+{
+    {
+        VkDescriptorSetLayout DescriptorSetLayout = {};
+        Vulkan::Descriptors::GetDescriptorSetLayout(DescriptorSetLayoutHandles [2u], DescriptorSetLayout);
+
+        VkPushConstantRange const kPushConstantRange = { VK_SHADER_STAGE_COMPUTE_BIT, 0u, sizeof(CullConstants) };
 
-    if (ProjectVerticesVSShaderModule == VK_NULL_HANDLE || TorranceSparrowFSShaderModule == VK_NULL_HANDLE)
+        VkPipelineLayoutCreateInfo const CreateInfo = Vulkan::PipelineLayout(1u, &DescriptorSetLayout, 1u, &kPushConstantRange);
+        VERIFY_VKRESULT(vkCreatePipelineLayout(DeviceState.Device, &CreateInfo, nullptr, &PipelineLayouts [2u]));
+    }
+
+    if (!ShaderLibrary::CreateShaderModule(DeviceState, CullInstancesShaderHandle, CullInstancesCSShaderModule) || CullInstancesCSShaderModule == VK_NULL_HANDLE)
     {
-        /* ERROR */
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to create shader module for Cull pipeline"));
         return false;
     }
 
-    std::array<VkPipelineShaderStageCreateInfo, 2u> const ShaderStages =
+    VkPipelineShaderStageCreateInfo const kShaderStage = Vulkan::PipelineShaderStage(VK_SHADER_STAGE_COMPUTE_BIT, CullInstancesCSShaderModule, kDefaultShaderEntryPointName.c_str());
+
+    VkComputePipelineCreateInfo const kCreateInfo = Vulkan::ComputePipelineState(PipelineLayouts [2u], kShaderStage);
+    VERIFY_VKRESULT(vkCreateComputePipelines(DeviceState.Device, PipelineCache, 1u, &kCreateInfo, nullptr, &CullPipeline));
+
+    return true;
+}
+
+static uint64 const AlignToUniformBuffer(uint64 const kSizeInBytes)
+{
+    uint64 const kAlignmentInBytes = { DeviceState.PhysicalDeviceProperties.limits.minUniformBufferOffsetAlignment };
+
+    return (kSizeInBytes + kAlignmentInBytes - 1u) & ~(kAlignmentInBytes - 1u);
+}
+
+static bool const CreateAndFillUniformBuffers(RenderSnapshot::Types::FrameSnapshot const & kSnapshot, std::vector<uint32> & OutputUniformBufferAllocations)
+{
+    bool bResult = false;
+
     {
-        Vulkan::PipelineShaderStage(VK_SHADER_STAGE_VERTEX_BIT, ProjectVerticesVSShaderModule, kDefaultShaderEntryPointName.c_str()),
-        Vulkan::PipelineShaderStage(VK_SHADER_STAGE_FRAGMENT_BIT, TorranceSparrowFSShaderModule, kDefaultShaderEntryPointName.c_str()),
-    };
+        /* Rounded up so the per draw allocation after it starts on an aligned offset */
+        uint32 AllocationHandle = {};
+        bResult = Vulkan::Allocators::LinearBufferAllocator::Allocate(FrameState.LinearAllocatorHandles [FrameState.CurrentFrameStateIndex], ::AlignToUniformBuffer(sizeof(PerFrameUniformBufferData)), AllocationHandle);
+
+        if (bResult)
+        {
+            PerFrameUniformBufferData const kPerFrameData =
+            {
+                kSnapshot.WorldToViewMatrix,
+                kSnapshot.ViewToClipMatrix,
+            };
+
+            void * MappedAddress = {};
+            Vulkan::Allocators::LinearBufferAllocator::GetMappedAddress(AllocationHandle, MappedAddress);
 
+            ::memcpy_s(MappedAddress, sizeof(PerFrameUniformBufferData), &kPerFrameData, sizeof(kPerFrameData));
+
+            OutputUniformBufferAllocations.push_back(AllocationHandle);
+        }
+    }
+
+    return bResult;
+}
+
+/*
+    A slot per mesh drawn, each aligned so the slots can be bound with a dynamic offset of SlotIndex * PerDrawUniformStrideInBytes.
+    Fails if the uniform buffer is full, there must be at least one batch.
+*/
+static bool const CreateAndFillPerDrawUniformBuffer(RenderSnapshot::Types::FrameSnapshot const & kSnapshot, uint32 & OutputUniformBufferAllocation)
+{
+    UniformSlotMeshHandles.clear();
+
+    for (RenderSnapshot::Types::DrawBatch const & kDrawBatch : kSnapshot.DrawBatches)
     {
-        std::array<VkVertexInputBindingDescription, 4u> const kVertexInputBindings =
+        if (kDrawBatch.MeshHandle >= MeshUniformSlotIndices.size())
         {
-            Vulkan::VertexInputBinding(0u, sizeof(Math::Vector3)),
-            Vulkan::VertexInputBinding(1u, sizeof(Math::Vector3)),
-            Vulkan::VertexInputBinding(2u, sizeof(Math::Vector4)),
-            Vulkan::VertexInputBinding(3u, sizeof(Math::Vector3)),
-        };
+            MeshUniformSlotIndices.resize(kDrawBatch.MeshHandle + 1u);
+        }
 
-        std::array<VkVertexInputAttributeDescription, 4u> const kVertexAttributes =
+        uint32 const kSlotIndex = { MeshUniformSlotIndices [kDrawBatch.MeshHandle] };
+
+        if (kSlotIndex >= UniformSlotMeshHandles.size() || UniformSlotMeshHandles [kSlotIndex] != kDrawBatch.MeshHandle)
         {
-            Vulkan::VertexInputAttribute(0u, 0u, 0u),
-            Vulkan::VertexInputAttribute(1u, 1u, 0u),
-            Vulkan::VertexInputAttribute(2u, 2u, 0u),
-            Vulkan::VertexInputAttribute(3u, 3u, 0u),
-        };
+            MeshUniformSlotIndices [kDrawBatch.MeshHandle] = static_cast<uint32>(UniformSlotMeshHandles.size());
+            UniformSlotMeshHandles.push_back(kDrawBatch.MeshHandle);
+        }
+    }
 
-        VkPipelineVertexInputStateCreateInfo const VertexInputState = Vulkan::VertexInputState(static_cast<uint32>(kVertexInputBindings.size()), kVertexInputBindings.data(),
-                                                                                               static_cast<uint32>(kVertexAttributes.size()), kVertexAttributes.data());
+    uint64 const kAllocationSizeInBytes = { uint64 { PerDrawUniformStrideInBytes } * UniformSlotMeshHandles.size() };
+
+    if (!Vulkan::Allocators::LinearBufferAllocator::Allocate(FrameState.LinearAllocatorHandles [FrameState.CurrentFrameStateIndex], kAllocationSizeInBytes, OutputUniformBufferAllocation))
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Too many meshes to fit in the uniform buffer, static meshes will not be drawn."));
+        return false;
+    }
 
-        VkPipelineInputAssemblyStateCreateInfo const InputAssemblerState = Vulkan::InputAssemblyState();
+    void * MappedAddress = {};
+    Vulkan::Allocators::LinearBufferAllocator::GetMappedAddress(OutputUniformBufferAllocation, MappedAddress);
 
-        VkPipelineRasterizationStateCreateInfo const RasterizationState = Vulkan::RasterizationState(VK_CULL_MODE_BACK_BIT);
+    std::byte * const OutputSlots = static_cast<std::byte *>(MappedAddress);
 
-        VkPipelineColorBlendAttachmentState const ColourAttachmentState = Vulkan::ColourAttachmentBlendState();
-        VkPipelineColorBlendStateCreateInfo const ColourBlendState = Vulkan::ColourBlendState(1u, &ColourAttachmentState);
+    Assets::StaticMesh::Types::StaticMesh MeshData = {};
 
-        VkPipelineDepthStencilStateCreateInfo const DepthStencilState = Vulkan::DepthStencilState(VK_TRUE, VK_TRUE, VK_COMPARE_OP_GREATER);
-        VkPipelineMultisampleStateCreateInfo const MultiSampleState = Vulkan::MultiSampleState();
+    UniformSlotMeshBuffers.resize(UniformSlotMeshHandles.size());
 
-        VkPipelineViewportStateCreateInfo const PipelineViewportState = Vulkan::ViewportState(1u, nullptr, 1u, nullptr);
+    for (uint32 SlotIndex = {};
+         SlotIndex < UniformSlotMeshHandles.size();
+         SlotIndex++)
+    {
+        /* Batches with a missing mesh aren't drawn */
+        bool const kbHasMesh = Assets::StaticMesh::GetAssetData(UniformSlotMeshHandles [SlotIndex], MeshData);
 
-        std::array<VkDynamicState, 2u> const DynamicStates =
+        PerDrawUniformBufferData const kPerDrawData =
         {
-            VK_DYNAMIC_STATE_VIEWPORT,
-            VK_DYNAMIC_STATE_SCISSOR,
+            kbHasMesh ? Assets::StaticMesh::GetMeshToModelTransform(MeshData) : Math::Affine3x4::Identity(),
         };
 
-        VkPipelineDynamicStateCreateInfo const DynamicState = Vulkan::DynamicState(static_cast<uint32>(DynamicStates.size()), DynamicStates.data());
+        ::memcpy_s(OutputSlots + PerDrawUniformStrideInBytes * SlotIndex, PerDrawUniformStrideInBytes, &kPerDrawData, sizeof(kPerDrawData));
 
-        VkGraphicsPipelineCreateInfo const CreateInfo = Vulkan::GraphicsPipelineState(PipelineLayouts [0u], MainRenderPass, 0u,
-                                                                                      static_cast<uint32>(ShaderStages.size()), ShaderStages.data(),
-                                                                                      &VertexInputState, &InputAssemblerState, &PipelineViewportState,
-                                                                                      &RasterizationState, &ColourBlendState, &DepthStencilState, &DynamicState, &MultiSampleState);
+        MeshDrawBuffers & SlotMeshBuffers = UniformSlotMeshBuffers [SlotIndex];
+        SlotMeshBuffers = MeshDrawBuffers {};
 
-        VERIFY_VKRESULT(vkCreateGraphicsPipelines(DeviceState.Device, VK_NULL_HANDLE, 1u, &CreateInfo, nullptr, &Pipelines [0u]));
+        if (kbHasMesh)
+        {
+            Vulkan::Resource::Buffer VertexBuffer = {};
+            Vulkan::Resource::Buffer IndexBuffer = {};
+
+            if (Vulkan::Resource::GetBuffer(MeshData.MeshBufferHandle, VertexBuffer) && Vulkan::Resource::GetBuffer(MeshData.IndexBufferHandle, IndexBuffer))
+            {
+                SlotMeshBuffers.VertexBuffer = VertexBuffer.Resource;
+                SlotMeshBuffers.IndexBuffer = IndexBuffer.Resource;
+                SlotMeshBuffers.StreamOffsetsInBytes = { 0u, MeshData.NormalDataOffsetInBytes, MeshData.TangentDataOffsetInBytes, MeshData.UVDataOffsetInBytes };
+                SlotMeshBuffers.IndexCount = MeshData.IndexCount;
+            }
+        }
     }
 
     return true;
 }
 
-static bool const CreateOutputPipeline()
+/*
+    Writes the transform slot of every instance, draws index it with gl_InstanceIndex as each batch starts at its first instance.
+    When culling on the GPU the buffer is only allocated here, the cull pass writes the visible instances.
+*/
+static bool const CreateAndFillInstanceBuffer(RenderSnapshot::Types::FrameSnapshot const & kSnapshot, uint32 & OutputInstanceBufferAllocation)
 {
+    uint64 const kInstanceDataSizeInBytes = { sizeof(uint32) * kSnapshot.InstanceTransformSlots.size() };
+
+    bool const kFitsInBuffer = kInstanceDataSizeInBytes <= kInstanceBufferSizeInBytes;
+
+    if (!kFitsInBuffer)
     {
-        VkDescriptorSetLayout DescriptorSetLayout = {};
-        Vulkan::Descriptors::GetDescriptorSetLayout(DescriptorSetLayoutHandles [0u], DescriptorSetLayout);
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Too many instances are visible to fit in the instance buffer, static meshes will not be drawn."));
+    }
 
-        VkPipelineLayoutCreateInfo const PipelineLayout = Vulkan::PipelineLayout(1u, &DescriptorSetLayout);
-        VERIFY_VKRESULT(vkCreatePipelineLayout(DeviceState.Device, &PipelineLayout, nullptr, &PipelineLayouts [1u]));
+    /* The per frame descriptor set always needs a buffer, even when nothing is drawn */
+    uint64 const kAllocationSizeInBytes = ::AlignToStorageBuffer(kFitsInBuffer ? std::max(kInstanceDataSizeInBytes, uint64 { sizeof(uint32) }) : sizeof(uint32));
+
+    Vulkan::Allocators::LinearBufferAllocator::Allocate(FrameState.InstanceAllocatorHandles [FrameState.CurrentFrameStateIndex], kAllocationSizeInBytes, OutputInstanceBufferAllocation);
+
+    if (kFitsInBuffer && kInstanceDataSizeInBytes > 0u && !bCullOnGPU)
+    {
+        void * MappedAddress = {};
+        Vulkan::Allocators::LinearBufferAllocator::GetMappedAddress(OutputInstanceBufferAllocation, MappedAddress);
+
+        ::memcpy_s(MappedAddress, kAllocationSizeInBytes, kSnapshot.InstanceTransformSlots.data(), kInstanceDataSizeInBytes);
     }
 
-    bool const bLoaded = ShaderLibrary::CreateShaderModule(DeviceState, VertexShaderHandles [1u], FullScreenTriangleVSShaderModule)
-        && ShaderLibrary::CreateShaderModule(DeviceState, FragmentShaderHandles [1u], PostProcessFSShaderModule);
+    return kFitsInBuffer;
+}
+
+/*
+    Candidate instances for the cull pass, plus a cull batch and draw command per draw batch.
+    Draw commands start with no instances, the cull pass counts the visible ones. Fails if the instance buffer is full, there must be at least one batch.
+*/
+static bool const CreateAndFillCullBuffers(RenderSnapshot::Types::FrameSnapshot const & kSnapshot, CullBufferAllocations & OutputAllocations)
+{
+    using namespace Vulkan::Allocators;
+
+    uint16 const kAllocatorHandle = FrameState.InstanceAllocatorHandles [FrameState.CurrentFrameStateIndex];
+
+    uint64 const kCandidateSizeInBytes = { sizeof(uint32) * kSnapshot.InstanceTransformSlots.size() };
+    uint64 const kBatchSizeInBytes = { sizeof(CullBatchData) * kSnapshot.DrawBatches.size() };
+    uint64 const kDrawCommandSizeInBytes = { sizeof(VkDrawIndexedIndirectCommand) * kSnapshot.DrawBatches.size() };
+
+    bool const kbAllocated = LinearBufferAllocator::Allocate(kAllocatorHandle, ::AlignToStorageBuffer(kCandidateSizeInBytes), OutputAllocations.CandidateAllocation)
+                             && LinearBufferAllocator::Allocate(kAllocatorHandle, ::AlignToStorageBuffer(kBatchSizeInBytes), OutputAllocations.BatchAllocation)
+                             && LinearBufferAllocator::Allocate(kAllocatorHandle, ::AlignToStorageBuffer(kDrawCommandSizeInBytes), OutputAllocations.DrawCommandAllocation);
 
-    if (!bLoaded)
+    if (!kbAllocated)
     {
-        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to create shader module for Output pipeline"));
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Too many instances to cull on the GPU, static meshes will not be drawn."));
+        OutputAllocations = {};
         return false;
     }
 
-    std::array<VkPipelineShaderStageCreateInfo, 2u> const ShaderStages =
-    {
-        Vulkan::PipelineShaderStage(VK_SHADER_STAGE_VERTEX_BIT, FullScreenTriangleVSShaderModule, kDefaultShaderEntryPointName.c_str()),
-        Vulkan::PipelineShaderStage(VK_SHADER_STAGE_FRAGMENT_BIT, PostProcessFSShaderModule, kDefaultShaderEntryPointName.c_str()),
-    };
+    void * CandidateAddress = {};
+    LinearBufferAllocator::GetMappedAddress(OutputAllocations.CandidateAllocation, CandidateAddress);
 
-    VkPipelineVertexInputStateCreateInfo const VertexInputState = Vulkan::VertexInputState(0u, nullptr, 0u, nullptr);
-    VkPipelineInputAssemblyStateCreateInfo const InputAssemblerState = Vulkan::InputAssemblyState();
+    ::memcpy_s(CandidateAddress, kCandidateSizeInBytes, kSnapshot.InstanceTransformSlots.data(), kCandidateSizeInBytes);
 
-    VkPipelineRasterizationStateCreateInfo const RasterizationState = Vulkan::RasterizationState(VK_CULL_MODE_NONE);
+    void * BatchAddress = {};
+    LinearBufferAllocator::GetMappedAddress(OutputAllocations.BatchAllocation, BatchAddress);
 
-    VkPipelineColorBlendAttachmentState const ColourAttachmentState = Vulkan::ColourAttachmentBlendState();
-    VkPipelineColorBlendStateCreateInfo const ColourBlendState = Vulkan::ColourBlendState(1u, &ColourAttachmentState);
+    void * DrawCommandAddress = {};
+    LinearBufferAllocator::GetMappedAddress(OutputAllocations.DrawCommandAllocation, DrawCommandAddress);
 
-    VkPipelineDepthStencilStateCreateInfo const DepthStencilState = Vulkan::DepthStencilState(VK_FALSE, VK_FALSE, VK_COMPARE_OP_NEVER);
-    VkPipelineMultisampleStateCreateInfo const MultiSampleState = Vulkan::MultiSampleState();
+    CullBatchData * const OutputBatches = static_cast<CullBatchData *>(BatchAddress);
+    VkDrawIndexedIndirectCommand * const OutputDrawCommands = static_cast<VkDrawIndexedIndirectCommand *>(DrawCommandAddress);
 
-    VkPipelineViewportStateCreateInfo const Viewport = Vulkan::ViewportState(1u, nullptr, 1u, nullptr);
+    Assets::StaticMesh::Types::StaticMesh MeshData = {};
 
-    std::array<VkDynamicState, 2u> DynamicStateFlags =
+    for (uint32 BatchIndex = {};
+         BatchIndex < kSnapshot.DrawBatches.size();
+         BatchIndex++)
     {
-        VK_DYNAMIC_STATE_VIEWPORT,
-        VK_DYNAMIC_STATE_SCISSOR,
-    };
+        RenderSnapshot::Types::DrawBatch const & kDrawBatch = kSnapshot.DrawBatches [BatchIndex];
 
-    VkPipelineDynamicStateCreateInfo const DynamicState = Vulkan::DynamicState(static_cast<uint32>(DynamicStateFlags.size()), DynamicStateFlags.data());
+        /* Batches with a missing mesh aren't drawn, zero indices keeps the command harmless anyway */
+        bool const kbHasMesh = Assets::StaticMesh::GetAssetData(kDrawBatch.MeshHandle, MeshData);
 
-    VkGraphicsPipelineCreateInfo const PipelineCreateInfo = Vulkan::GraphicsPipelineState(PipelineLayouts [1u], MainRenderPass, 1u,
-                                                                                          static_cast<uint32>(ShaderStages.size()), ShaderStages.data(),
-                                                                                          &VertexInputState, &InputAssemblerState, &Viewport,
-                                                                                          &RasterizationState, &ColourBlendState, &DepthStencilState,
-                                                                                          &DynamicState, &MultiSampleState);
+        OutputBatches [BatchIndex] = CullBatchData
+        {
+            kbHasMesh ? Assets::StaticMesh::GetMeshToModelTransform(MeshData) : Math::Affine3x4::Identity(),
+            kDrawBatch.FirstInstanceIndex,
+            kDrawBatch.InstanceCount,
+        };
 
-    VERIFY_VKRESULT(vkCreateGraphicsPipelines(DeviceState.Device, VK_NULL_HANDLE, 1u, &PipelineCreateInfo, nullptr, &Pipelines [1u]));
+        OutputDrawCommands [BatchIndex] = VkDrawIndexedIndirectCommand
+        {
+            kbHasMesh ? MeshData.IndexCount : 0u,
+            0u,
+            0u,
+            0,
+            kDrawBatch.FirstInstanceIndex,
+        };
+    }
 
     return true;
 }
 
-static bool const CreateAndFillUniformBuffers(Scene::SceneData const & Scene, std::vector<uint32> & OutputUniformBufferAllocations)
+static void GrowTransformBuffer(VkCommandBuffer const kCommandBuffer, uint32 const kRequiredSlotCount)
 {
-    bool bResult = false;
-
+    uint32 NewCapacity = std::max(kMinimumTransformSlotCount, TransformBufferCapacity << 1u);
+    while (NewCapacity < kRequiredSlotCount)
     {
-        uint32 AllocationHandle = {};
-        bResult = Vulkan::Allocators::LinearBufferAllocator::Allocate(FrameState.LinearAllocatorHandles [FrameState.CurrentFrameStateIndex], sizeof(PerFrameUniformBufferData), AllocationHandle);
+        NewCapacity <<= 1u;
+    }
 
-        if (bResult)
-        {
-            PerFrameUniformBufferData PerFrameData =
-            {
-                Math::Matrix4x4::Identity(),
-                Scene.MainCamera.ProjectionMatrix,
-            };
+    uint32 NewBufferHandle = {};
+    Vulkan::Device::CreateBuffer(DeviceState,
+                                 sizeof(Math::Affine3x4) * NewCapacity,
+                                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                 NewBufferHandle);
 
-            Camera::GetViewMatrix(Scene.MainCamera, PerFrameData.WorldToViewMatrix);
-            PerFrameData.WorldToViewMatrix = Math::Matrix4x4::Inverse(PerFrameData.WorldToViewMatrix);
+    if (TransformBufferHandle != 0u)
+    {
+        Vulkan::Resource::Buffer OldBuffer = {};
+        Vulkan::Resource::GetBuffer(TransformBufferHandle, OldBuffer);
+
+        Vulkan::Resource::Buffer NewBuffer = {};
+        Vulkan::Resource::GetBuffer(NewBufferHandle, NewBuffer);
+
+        /* Wait for earlier uploads before copying the existing transforms across */
+        VkBufferMemoryBarrier const kReadBarrier = Vulkan::BufferMemoryBarrier(OldBuffer.Resource, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+        vkCmdPipelineBarrier(kCommandBuffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0u,
+                             0u, nullptr,
+                             1u, &kReadBarrier,
+                             0u, nullptr);
+
+        VkBufferCopy const kCopyRegion = { 0u, 0u, sizeof(Math::Affine3x4) * TransformBufferCapacity };
+        vkCmdCopyBuffer(kCommandBuffer, OldBuffer.Resource, NewBuffer.Resource, 1u, &kCopyRegion);
+
+        /* This frame's upload can overwrite the copied transforms */
+        VkBufferMemoryBarrier const kWriteBarrier = Vulkan::BufferMemoryBarrier(NewBuffer.Resource, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+        vkCmdPipelineBarrier(kCommandBuffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0u,
+                             0u, nullptr,
+                             1u, &kWriteBarrier,
+                             0u, nullptr);
+
+        Vulkan::Device::DestroyBuffer(DeviceState, TransformBufferHandle, FrameState.Fences [FrameState.CurrentFrameStateIndex]);
+    }
 
-            void * MappedAddress = {};
-            Vulkan::Allocators::LinearBufferAllocator::GetMappedAddress(AllocationHandle, MappedAddress);
+    TransformBufferHandle = NewBufferHandle;
+    TransformBufferCapacity = NewCapacity;
+}
 
-            ::memcpy_s(MappedAddress, sizeof(PerFrameUniformBufferData), &PerFrameData, sizeof(PerFrameData));
+/* Copies the world transforms that changed since the previous snapshot into the transform buffer, runs of slots are copied with a single region */
+static void UploadDirtyTransforms(VkCommandBuffer const kCommandBuffer, RenderSnapshot::Types::FrameSnapshot const & kSnapshot)
+{
+    using namespace Vulkan::Allocators;
 
-            OutputUniformBufferAllocations.push_back(AllocationHandle);
-        }
+    /* The per frame set always binds the transform buffer, so it is created even if there aren't any transforms yet */
+    if (TransformBufferHandle == 0u || kSnapshot.TransformSlotCount > TransformBufferCapacity)
+    {
+        ::GrowTransformBuffer(kCommandBuffer, kSnapshot.TransformSlotCount);
     }
 
-    PerDrawUniformBufferData IntermediateUniformBufferData = {};
+    if (kSnapshot.Transforms.empty())
+    {
+        return;
+    }
 
-    uint32 const kActorCount = { static_cast<uint32>(Scene.ComponentMasks.size()) };
+    uint64 const kTransformSizeInBytes = { sizeof(Math::Affine3x4) * kSnapshot.Transforms.size() };
 
     uint32 AllocationHandle = {};
-    bResult &= Vulkan::Allocators::LinearBufferAllocator::Allocate(FrameState.LinearAllocatorHandles [FrameState.CurrentFrameStateIndex], sizeof(PerFrameUniformBufferData) * kActorCount, AllocationHandle);
+    if (!LinearBufferAllocator::Allocate(FrameState.StagingAllocatorHandles [FrameState.CurrentFrameStateIndex], kTransformSizeInBytes, AllocationHandle))
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to allocate staging memory for transform upload."));
+        return;
+    }
 
-    void * MappedAddress = {};
-    Vulkan::Allocators::LinearBufferAllocator::GetMappedAddress(AllocationHandle, MappedAddress);
+    Types::AllocationInfo Allocation = {};
+    LinearBufferAllocator::GetAllocationInfo(AllocationHandle, Allocation);
 
-    uint32 CurrentOutputIndex = {};
-    for (Components::StaticMesh::Types::Iterator CurrentMesh = Components::StaticMesh::Types::Iterator::Begin();
-         CurrentMesh != Components::StaticMesh::Types::Iterator::End();
-         ++CurrentMesh)
-    {
-        Components::StaticMesh::Types::ComponentData const kComponentData = *CurrentMesh;
+    Vulkan::Resource::Buffer StagingBuffer = {};
+    Vulkan::Resource::GetBuffer(Allocation.BufferHandle, StagingBuffer);
 
-        Components::Transform::GetTransformationMatrix(kComponentData.ParentActorHandle, IntermediateUniformBufferData.ModelToWorldMatrix);
+    Vulkan::Resource::Buffer TransformBuffer = {};
+    Vulkan::Resource::GetBuffer(TransformBufferHandle, TransformBuffer);
 
-        // need to handle the case there isn't a valid transform
-        //if (!bHasTransform)
-        //{
-        //    // just use some default transform, but should also log this
-        //}
+    /* The snapshot packs the transforms in range order, so they go into staging memory in one copy */
+    ::memcpy_s(Allocation.MappedAddress, kTransformSizeInBytes, kSnapshot.Transforms.data(), kTransformSizeInBytes);
 
-        PerDrawUniformBufferData * OutputAddress = static_cast<PerDrawUniformBufferData *>(MappedAddress) + CurrentOutputIndex;
+    uint64 StagingOffsetInBytes = { Allocation.OffsetInBytes };
 
-        std::memcpy(OutputAddress, &IntermediateUniformBufferData, sizeof(IntermediateUniformBufferData));
+    std::vector<VkBufferCopy> CopyRegions = {};
+    CopyRegions.reserve(kSnapshot.TransformRanges.size());
 
-        CurrentOutputIndex++;
-    }
+    for (Components::Transform::Types::SlotRange const & kSlotRange : kSnapshot.TransformRanges)
+    {
+        uint64 const kRangeSizeInBytes = { sizeof(Math::Affine3x4) * kSlotRange.SlotCount };
+        CopyRegions.push_back(VkBufferCopy { StagingOffsetInBytes, sizeof(Math::Affine3x4) * kSlotRange.FirstSlotIndex, kRangeSizeInBytes });
 
-    OutputUniformBufferAllocations.push_back(AllocationHandle);
+        StagingOffsetInBytes += kRangeSizeInBytes;
+    }
 
-    return bResult;
+    /* Both the cull pass and the vertex shader read the transforms */
+    VkPipelineStageFlags const kTransformReadStages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+
+    /* Frames still in flight may be reading the transforms */
+    VkBufferMemoryBarrier const kPreCopyBarrier = Vulkan::BufferMemoryBarrier(TransformBuffer.Resource, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+    vkCmdPipelineBarrier(kCommandBuffer,
+                         kTransformReadStages, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0u,
+                         0u, nullptr,
+                         1u, &kPreCopyBarrier,
+                         0u, nullptr);
+
+    vkCmdCopyBuffer(kCommandBuffer, StagingBuffer.Resource, TransformBuffer.Resource, static_cast<uint32>(CopyRegions.size()), CopyRegions.data());
+
+    VkBufferMemoryBarrier const kPostCopyBarrier = Vulkan::BufferMemoryBarrier(TransformBuffer.Resource, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
+    vkCmdPipelineBarrier(kCommandBuffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, kTransformReadStages,
+                         0u,
+                         0u, nullptr,
+                         1u, &kPostCopyBarrier,
+                         0u, nullptr);
 }
 
-static void UpdatePerFrameDescriptorSet(uint16 const kPerFrameDescriptorSetHandle, uint32 const kPerFrameUniformBufferAllocation)
+static void UpdatePerFrameDescriptorSet(uint16 const kPerFrameDescriptorSetHandle, uint32 const kPerFrameUniformBufferAllocation, uint32 const kInstanceBufferAllocation)
 {
     using namespace Vulkan::Allocators;
     using namespace Vulkan::Allocators::Types;
@@ -503,10 +1000,21 @@ static void UpdatePerFrameDescriptorSet(uint16 const kPerFrameDescriptorSetHandl
     Vulkan::Resource::Buffer PerFrameUniformBuffer = {};
     Vulkan::Resource::GetBuffer(Allocation.BufferHandle, PerFrameUniformBuffer);
 
+    AllocationInfo InstanceAllocation = {};
+    LinearBufferAllocator::GetAllocationInfo(kInstanceBufferAllocation, InstanceAllocation);
+
+    Vulkan::Resource::Buffer InstanceBuffer = {};
+    Vulkan::Resource::GetBuffer(InstanceAllocation.BufferHandle, InstanceBuffer);
+
+    Vulkan::Resource::Buffer TransformBuffer = {};
+    Vulkan::Resource::GetBuffer(TransformBufferHandle, TransformBuffer);
+
     VkImageView SceneColourImageView = {};
     Vulkan::Resource::GetImageView(FrameState.SceneColourImageViews [FrameState.CurrentFrameStateIndex], SceneColourImageView);
 
     VkDescriptorBufferInfo const kPerFrameUniformBufferDesc = Vulkan::DescriptorBufferInfo(PerFrameUniformBuffer.Resource, Allocation.OffsetInBytes, Allocation.SizeInBytes);
+    VkDescriptorBufferInfo const kInstanceBufferDesc = Vulkan::DescriptorBufferInfo(InstanceBuffer.Resource, InstanceAllocation.OffsetInBytes, InstanceAllocation.SizeInBytes);
+    VkDescriptorBufferInfo const kTransformBufferDesc = Vulkan::DescriptorBufferInfo(TransformBuffer.Resource, 0u, VK_WHOLE_SIZE);
     VkDescriptorImageInfo const kSceneColourImageDesc =
     {
         VK_NULL_HANDLE,
@@ -518,61 +1026,322 @@ static void UpdatePerFrameDescriptorSet(uint16 const kPerFrameDescriptorSetHandl
 
     Vulkan::Descriptors::BindBufferDescriptors(kAllocatorHandle, kPerFrameDescriptorSetHandle, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0u, 1u, &kPerFrameUniformBufferDesc);
     Vulkan::Descriptors::BindImageDescriptors(kAllocatorHandle, kPerFrameDescriptorSetHandle, VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1u, 1u, &kSceneColourImageDesc);
+    Vulkan::Descriptors::BindBufferDescriptors(kAllocatorHandle, kPerFrameDescriptorSetHandle, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2u, 1u, &kInstanceBufferDesc);
+    Vulkan::Descriptors::BindBufferDescriptors(kAllocatorHandle, kPerFrameDescriptorSetHandle, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3u, 1u, &kTransformBufferDesc);
 }
 
-static void UpdatePerDrawDescriptorSet(uint16 const kPerDrawDescriptorSetHandle, uint32 const kPerDrawUniformBufferAllocation, Assets::Material::MaterialData const & Material)
+/* The range covers a single slot, each draw picks its slot with a dynamic offset so the set is only written once a frame */
+static void UpdatePerDrawDescriptorSet(uint16 const kPerDrawDescriptorSetHandle, uint32 const kPerDrawUniformBufferAllocation)
 {
-    using namespace Vulkan::Allocators;
-    using namespace Vulkan::Allocators::Types;
-
-    AllocationInfo Allocation = {};
-    LinearBufferAllocator::GetAllocationInfo(kPerDrawUniformBufferAllocation, Allocation);
+    Vulkan::Allocators::Types::AllocationInfo Allocation = {};
+    Vulkan::Allocators::LinearBufferAllocator::GetAllocationInfo(kPerDrawUniformBufferAllocation, Allocation);
 
     Vulkan::Resource::Buffer PerDrawUniformBuffer = {};
     Vulkan::Resource::GetBuffer(Allocation.BufferHandle, PerDrawUniformBuffer);
 
-    VkDescriptorBufferInfo const kPerDrawUniformBufferDesc = Vulkan::DescriptorBufferInfo(PerDrawUniformBuffer.Resource, Allocation.OffsetInBytes, Allocation.SizeInBytes);
-
-    std::array<VkDescriptorImageInfo, 7u> ImageViewsAndSamplers = {};
+    VkDescriptorBufferInfo const kPerDrawUniformBufferDesc = Vulkan::DescriptorBufferInfo(PerDrawUniformBuffer.Resource, Allocation.OffsetInBytes, sizeof(PerDrawUniformBufferData));
 
-    Assets::Texture::TextureData TextureData = {};
+    uint16 const kAllocatorHandle = FrameState.DescriptorAllocators [FrameState.CurrentFrameStateIndex];
 
-    Assets::Texture::GetTextureData(Material.AlbedoTexture, TextureData);
-    Vulkan::Resource::GetImageView(TextureData.ViewHandle, ImageViewsAndSamplers [0u].imageView);
-    ImageViewsAndSamplers [0u].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    Vulkan::Descriptors::BindBufferDescriptors(kAllocatorHandle, kPerDrawDescriptorSetHandle, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 0u, 1u, &kPerDrawUniformBufferDesc);
+}
 
-    Assets::Texture::GetTextureData(Material.SpecularTexture, TextureData);
-    Vulkan::Resource::GetImageView(TextureData.ViewHandle, ImageViewsAndSamplers [1u].imageView);
-    ImageViewsAndSamplers [1u].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+/* Writes the material's textures into a new set. Fails until every texture has been uploaded, so it is tried again on a later frame */
+static bool const CreateMaterialDescriptorSet(uint32 const kMaterialHandle, uint16 & OutputDescriptorSetHandle)
+{
+    Assets::Material::MaterialData MaterialData = {};
 
-    Assets::Texture::GetTextureData(Material.NormalTexture, TextureData);
-    Vulkan::Resource::GetImageView(TextureData.ViewHandle, ImageViewsAndSamplers [2u].imageView);
-    ImageViewsAndSamplers [2u].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    
-    Assets::Texture::GetTextureData(Material.RoughnessTexture, TextureData);
-    Vulkan::Resource::GetImageView(TextureData.ViewHandle, ImageViewsAndSamplers [3u].imageView);
-    ImageViewsAndSamplers [3u].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    if (!Assets::Material::GetAssetData(kMaterialHandle, MaterialData))
+    {
+        return false;
+    }
 
-    Assets::Texture::GetTextureData(Material.AmbientOcclusionTexture, TextureData);
-    Vulkan::Resource::GetImageView(TextureData.ViewHandle, ImageViewsAndSamplers [4u].imageView);
-    ImageViewsAndSamplers [4u].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    std::array const kTextureHandles = std::array<uint32, 5u>
+    {
+        MaterialData.AlbedoTexture,
+        MaterialData.SpecularTexture,
+        MaterialData.NormalTexture,
+        MaterialData.RoughnessTexture,
+        MaterialData.AmbientOcclusionTexture,
+    };
 
-    ImageViewsAndSamplers [ImageViewsAndSamplers.size() - 2u].sampler = ImageSamplers [1u];
-    ImageViewsAndSamplers [ImageViewsAndSamplers.size() - 1u].sampler = ImageSamplers [0u];
+    std::array<VkDescriptorImageInfo, kTextureHandles.size() + 2u> ImageViewsAndSamplers = {};
 
-    uint16 const kAllocatorHandle = FrameState.DescriptorAllocators [FrameState.CurrentFrameStateIndex];
+    for (uint32 TextureIndex = {};
+         TextureIndex < kTextureHandles.size();
+         TextureIndex++)
+    {
+        Assets::Texture::TextureData TextureData = {};
 
-    Vulkan::Descriptors::BindBufferDescriptors(kAllocatorHandle, kPerDrawDescriptorSetHandle, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0u, 1u, &kPerDrawUniformBufferDesc);
-    Vulkan::Descriptors::BindImageDescriptors(kAllocatorHandle, kPerDrawDescriptorSetHandle, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1u, static_cast<uint8>(ImageViewsAndSamplers.size() - 2u), ImageViewsAndSamplers.data());
-    Vulkan::Descriptors::BindImageDescriptors(kAllocatorHandle, kPerDrawDescriptorSetHandle, VK_DESCRIPTOR_TYPE_SAMPLER, 6u, 2u, &ImageViewsAndSamplers [ImageViewsAndSamplers.size() - 2u]);
+        if (!Assets::Texture::GetTextureData(kTextureHandles [TextureIndex], TextureData) || TextureData.ViewHandle == 0u)
+        {
+            return false;
+        }
+
+        Vulkan::Resource::GetImageView(TextureData.ViewHandle, ImageViewsAndSamplers [TextureIndex].imageView);
+        ImageViewsAndSamplers [TextureIndex].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    }
+
+    ImageViewsAndSamplers [ImageViewsAndSamplers.size() - 2u].sampler = ImageSamplers [1u];
+    ImageViewsAndSamplers [ImageViewsAndSamplers.size() - 1u].sampler = ImageSamplers [0u];
+
+    uint16 DescriptorSetHandle = {};
+
+    if (!Vulkan::Descriptors::AllocateDescriptorSet(DeviceState, MaterialDescriptorAllocatorHandle, DescriptorSetLayoutHandles [1u], DescriptorSetHandle))
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to allocate material descriptor set."));
+        return false;
+    }
+
+    Vulkan::Descriptors::BindImageDescriptors(MaterialDescriptorAllocatorHandle, DescriptorSetHandle, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 0u, static_cast<uint8>(kTextureHandles.size()), ImageViewsAndSamplers.data());
+    Vulkan::Descriptors::BindImageDescriptors(MaterialDescriptorAllocatorHandle, DescriptorSetHandle, VK_DESCRIPTOR_TYPE_SAMPLER, 5u, 2u, &ImageViewsAndSamplers [kTextureHandles.size()]);
+
+    OutputDescriptorSetHandle = DescriptorSetHandle;
+
+    return true;
+}
+
+/*
+    Writes the array slot of each of the material's textures the first time the texture is used, then the material's entry in the material buffer.
+    Fails until every texture has been uploaded, so it is tried again on a later frame. Materials that can never fit in the bindless arrays are rejected instead.
+*/
+static bool const WriteBindlessMaterial(uint32 const kMaterialHandle)
+{
+    uint32 const kMaterialIndex = { kMaterialHandle - 1u };
+
+    if (kMaterialIndex >= kMaximumBindlessMaterialCount)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Too many materials for the material buffer, material will not be drawn."));
+        RejectedBindlessMaterials [kMaterialIndex] = true;
+        return false;
+    }
+
+    Assets::Material::MaterialData MaterialData = {};
+
+    if (!Assets::Material::GetAssetData(kMaterialHandle, MaterialData))
+    {
+        return false;
+    }
+
+    std::array const kTextureHandles = std::array<uint32, 5u>
+    {
+        MaterialData.AlbedoTexture,
+        MaterialData.SpecularTexture,
+        MaterialData.NormalTexture,
+        MaterialData.RoughnessTexture,
+        MaterialData.AmbientOcclusionTexture,
+    };
+
+    for (uint32 const kTextureHandle : kTextureHandles)
+    {
+        if (kTextureHandle > kMaximumBindlessTextureCount)
+        {
+            Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Too many textures for the bindless texture array, material will not be drawn."));
+            RejectedBindlessMaterials [kMaterialIndex] = true;
+            return false;
+        }
+    }
+
+    std::array<VkDescriptorImageInfo, kTextureHandles.size()> ImageViews = {};
+
+    for (uint32 TextureIndex = {};
+         TextureIndex < kTextureHandles.size();
+         TextureIndex++)
+    {
+        Assets::Texture::TextureData TextureData = {};
+
+        if (!Assets::Texture::GetTextureData(kTextureHandles [TextureIndex], TextureData) || TextureData.ViewHandle == 0u)
+        {
+            return false;
+        }
+
+        Vulkan::Resource::GetImageView(TextureData.ViewHandle, ImageViews [TextureIndex].imageView);
+        ImageViews [TextureIndex].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    }
+
+    for (uint32 TextureIndex = {};
+         TextureIndex < kTextureHandles.size();
+         TextureIndex++)
+    {
+        uint32 const kTextureSlot = { kTextureHandles [TextureIndex] - 1u };
+
+        if (kTextureSlot >= WrittenTextureSlots.size())
+        {
+            WrittenTextureSlots.resize(kTextureSlot + 1u);
+        }
+
+        if (!WrittenTextureSlots [kTextureSlot])
+        {
+            Vulkan::Descriptors::BindImageDescriptors(BindlessDescriptorAllocatorHandle, BindlessDescriptorSetHandle, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 0u, kTextureSlot, 1u, &ImageViews [TextureIndex]);
+            WrittenTextureSlots [kTextureSlot] = true;
+        }
+    }
+
+    BindlessMaterialData const kBindlessMaterialData =
+    {
+        kTextureHandles [0u] - 1u,
+        kTextureHandles [1u] - 1u,
+        kTextureHandles [2u] - 1u,
+        kTextureHandles [3u] - 1u,
+        kTextureHandles [4u] - 1u,
+    };
+
+    void * MappedAddress = {};
+    Vulkan::Allocators::LinearBufferAllocator::GetMappedAddress(MaterialBufferAllocation, MappedAddress);
+
+    ::memcpy_s(static_cast<BindlessMaterialData *>(MappedAddress) + kMaterialIndex, sizeof(BindlessMaterialData), &kBindlessMaterialData, sizeof(kBindlessMaterialData));
+
+    return true;
+}
+
+/*
+    Creates sets, or with bindless materials writes their textures and indices, for the materials drawn for the first time.
+    The writes are left for the caller to flush, so once every material is ready a frame doesn't write any material descriptors.
+    Runs on the render thread before recording, so the recording jobs only ever read MaterialDescriptorSetHandles.
+*/
+static void CreateMaterialDescriptorSets(std::vector<RenderSnapshot::Types::DrawBatch> const & kDrawBatches)
+{
+    uint32 PreviousMaterialHandle = {};
+    uint32 WrittenMaterialCount = {};
+
+    for (RenderSnapshot::Types::DrawBatch const & kDrawBatch : kDrawBatches)
+    {
+        /* Batches are grouped by material */
+        if (kDrawBatch.MaterialHandle == PreviousMaterialHandle || kDrawBatch.MaterialHandle == 0u)
+        {
+            continue;
+        }
+
+        PreviousMaterialHandle = kDrawBatch.MaterialHandle;
+
+        uint32 const kMaterialIndex = { kDrawBatch.MaterialHandle - 1u };
+
+        if (kMaterialIndex >= MaterialDescriptorSetHandles.size())
+        {
+            MaterialDescriptorSetHandles.resize(kMaterialIndex + 1u);
+            RejectedBindlessMaterials.resize(kMaterialIndex + 1u);
+        }
+
+        if (MaterialDescriptorSetHandles [kMaterialIndex] != 0u || WrittenMaterialCount >= kMaximumMaterialWritesPerFrame)
+        {
+            continue;
+        }
+
+        if (bBindlessMaterials)
+        {
+            if (RejectedBindlessMaterials [kMaterialIndex])
+            {
+                continue;
+            }
+
+            if (::WriteBindlessMaterial(kDrawBatch.MaterialHandle))
+            {
+                MaterialDescriptorSetHandles [kMaterialIndex] = BindlessDescriptorSetHandle;
+                WrittenMaterialCount++;
+            }
+        }
+        else if (::CreateMaterialDescriptorSet(kDrawBatch.MaterialHandle, MaterialDescriptorSetHandles [kMaterialIndex]))
+        {
+            WrittenMaterialCount++;
+        }
+    }
+}
+
+/* Tests every candidate instance against the frustum and packs the visible ones into the instance buffer, counting them into the draw commands */
+static void RecordCullPass(VkCommandBuffer const kCommandBuffer, RenderSnapshot::Types::FrameSnapshot const & kSnapshot, CullBufferAllocations const & kCullAllocations, uint32 const kInstanceBufferAllocation)
+{
+    using namespace Vulkan::Allocators;
+    using namespace Vulkan::Allocators::Types;
+
+    uint16 const kAllocatorHandle = FrameState.DescriptorAllocators [FrameState.CurrentFrameStateIndex];
+
+    uint16 DescriptorSetHandle = {};
+    Vulkan::Descriptors::AllocateDescriptorSet(DeviceState, kAllocatorHandle, DescriptorSetLayoutHandles [2u], DescriptorSetHandle);
+
+    std::array<uint32, 4u> const kAllocations =
+    {
+        kCullAllocations.CandidateAllocation,
+        kCullAllocations.BatchAllocation,
+        kCullAllocations.DrawCommandAllocation,
+        kInstanceBufferAllocation,
+    };
+
+    /* Every allocation comes from the instance allocator, so they share a buffer */
+    std::array<VkDescriptorBufferInfo, 5u> BufferDescs = {};
+    VkBuffer InstanceBuffer = {};
+
+    {
+        Vulkan::Resource::Buffer TransformBuffer = {};
+        Vulkan::Resource::GetBuffer(TransformBufferHandle, TransformBuffer);
+
+        BufferDescs [0u] = Vulkan::DescriptorBufferInfo(TransformBuffer.Resource, 0u, VK_WHOLE_SIZE);
+    }
+
+    for (uint32 AllocationIndex = {};
+         AllocationIndex < kAllocations.size();
+         AllocationIndex++)
+    {
+        AllocationInfo Allocation = {};
+        LinearBufferAllocator::GetAllocationInfo(kAllocations [AllocationIndex], Allocation);
+
+        Vulkan::Resource::Buffer Buffer = {};
+        Vulkan::Resource::GetBuffer(Allocation.BufferHandle, Buffer);
+
+        BufferDescs [AllocationIndex + 1u] = Vulkan::DescriptorBufferInfo(Buffer.Resource, Allocation.OffsetInBytes, Allocation.SizeInBytes);
+        InstanceBuffer = Buffer.Resource;
+    }
+
+    Vulkan::Descriptors::BindBufferDescriptors(kAllocatorHandle, DescriptorSetHandle, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 0u, static_cast<uint8>(BufferDescs.size()), BufferDescs.data());
+    Vulkan::Descriptors::FlushDescriptorWrites(DeviceState);
+
+    VkDescriptorSet DescriptorSet = {};
+    Vulkan::Descriptors::GetDescriptorSet(kAllocatorHandle, DescriptorSetHandle, DescriptorSet);
+
+    CullConstants const kCullConstants =
+    {
+        kSnapshot.FrustumPlanes,
+        static_cast<uint32>(kSnapshot.InstanceTransformSlots.size()),
+        static_cast<uint32>(kSnapshot.DrawBatches.size()),
+    };
+
+    vkCmdBindPipeline(kCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, CullPipeline);
+    vkCmdBindDescriptorSets(kCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, PipelineLayouts [2u], 0u, 1u, &DescriptorSet, 0u, nullptr);
+    vkCmdPushConstants(kCommandBuffer, PipelineLayouts [2u], VK_SHADER_STAGE_COMPUTE_BIT, 0u, sizeof(kCullConstants), &kCullConstants);
+
+    vkCmdDispatch(kCommandBuffer, (kCullConstants.InstanceCount + kCullGroupSize - 1u) / kCullGroupSize, 1u, 1u);
+
+    /* The draw commands are read as indirect arguments and the visible instances by the vertex shader */
+    VkBufferMemoryBarrier const kCullBarrier = Vulkan::BufferMemoryBarrier(InstanceBuffer, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT);
+    vkCmdPipelineBarrier(kCommandBuffer,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                         0u,
+                         0u, nullptr,
+                         1u, &kCullBarrier,
+                         0u, nullptr);
+}
+
+static uint32 const GetRecordingIndex(uint32 const kJobIndex)
+{
+    return FrameState.CurrentFrameStateIndex * RecordingJobCount + kJobIndex;
 }
 
 static void ResetCurrentFrameState()
 {
     Vulkan::Allocators::LinearBufferAllocator::Reset(FrameState.LinearAllocatorHandles [FrameState.CurrentFrameStateIndex]);
+    Vulkan::Allocators::LinearBufferAllocator::Reset(FrameState.StagingAllocatorHandles [FrameState.CurrentFrameStateIndex]);
+    Vulkan::Allocators::LinearBufferAllocator::Reset(FrameState.InstanceAllocatorHandles [FrameState.CurrentFrameStateIndex]);
 
     Vulkan::Descriptors::ResetDescriptorAllocator(DeviceState, FrameState.DescriptorAllocators [FrameState.CurrentFrameStateIndex]);
 
+    for (uint32 JobIndex = {};
+         JobIndex < RecordingJobCount;
+         JobIndex++)
+    {
+        uint32 const kRecordingIndex = ::GetRecordingIndex(JobIndex);
+
+        VERIFY_VKRESULT(vkResetCommandPool(DeviceState.Device, FrameState.RecordingCommandPools [kRecordingIndex], 0u));
+    }
+
     vkResetFences(DeviceState.Device, 1u, &FrameState.Fences [FrameState.CurrentFrameStateIndex]);
 
     VERIFY_VKRESULT(vkResetCommandBuffer(FrameState.CommandBuffers [FrameState.CurrentFrameStateIndex], 0u));
@@ -581,11 +1350,13 @@ static void ResetCurrentFrameState()
     VERIFY_VKRESULT(vkBeginCommandBuffer(FrameState.CommandBuffers [FrameState.CurrentFrameStateIndex], &BeginInfo));
 }
 
-static void ResizeViewport()
+static void ResizeViewport(RenderSnapshot::Types::FrameSnapshot const & kSnapshot)
 {
     VERIFY_VKRESULT(vkDeviceWaitIdle(DeviceState.Device));
 
-    if (Vulkan::Viewport::ResizeViewport(InstanceState, DeviceState, ViewportState))
+    VkExtent2D const kWindowExtents = { kSnapshot.WindowWidth, kSnapshot.WindowHeight };
+
+    if (Vulkan::Viewport::ResizeViewport(InstanceState, DeviceState, kWindowExtents, ViewportState))
     {
         for (std::uint32_t CurrentImageIndex = {};
              CurrentImageIndex < kFrameStateCount;
@@ -601,13 +1372,13 @@ static void ResizeViewport()
     FrameState.CurrentFrameStateIndex = 0u;
 }
 
-static bool const PreRender()
+static bool const PreRender(RenderSnapshot::Types::FrameSnapshot const & kSnapshot)
 {
     VkResult const ImageAcquireResult = vkAcquireNextImageKHR(DeviceState.Device, ViewportState.SwapChain, std::numeric_limits<uint64>::max(), FrameState.Semaphores [FrameState.CurrentFrameStateIndex], VK_NULL_HANDLE, &FrameState.CurrentImageIndex);
 
     if (ImageAcquireResult == VK_ERROR_OUT_OF_DATE_KHR)
     {
-        ::ResizeViewport();
+        ::ResizeViewport(kSnapshot);
         return false;
     }
 
@@ -660,71 +1431,247 @@ static void PostRender()
     Vulkan::Device::DestroyUnusedResources(DeviceState);
 }
 
-static void RenderStaticMeshes(VkCommandBuffer const kCommandBuffer, uint16 const kDescriptorSetHandle, VkDescriptorSet const kMeshDescriptorSet, uint32 const kAllocation)
+/*
+    One instanced draw per batch in [kFirstBatchIndex, kEndBatchIndex). Batches are sorted by material then mesh, so state is only bound when it differs from the previous batch.
+    With a draw command buffer the instance counts come from the cull pass, one command per batch.
+    Batches whose material doesn't have a set yet, or whose mesh is missing, are skipped.
+    The depth pre-pass skips the same batches, otherwise they would hide what is behind them without being shaded. It only binds the position stream.
+    Run as a recording job, so mesh buffers are read from UniformSlotMeshBuffers rather than the static mesh assets.
+*/
+static void RenderStaticMeshes(VkCommandBuffer const kCommandBuffer, bool const kbDepthOnly, VkDescriptorSet const kPerDrawDescriptorSet,
+                               std::vector<RenderSnapshot::Types::DrawBatch> const & kDrawBatches, uint32 const kFirstBatchIndex, uint32 const kEndBatchIndex, uint32 const kDrawCommandAllocation)
 {
-    for (Components::StaticMesh::Types::Iterator CurrentMesh = Components::StaticMesh::Types::Iterator::Begin();
-         CurrentMesh != Components::StaticMesh::Types::Iterator::End();
-         ++CurrentMesh)
+    uint32 BoundMaterialHandle = {};
+    uint32 BoundMeshHandle = {};
+    uint32 BoundIndexCount = {};
+
+    Vulkan::Allocators::Types::AllocationInfo DrawCommands = {};
+    Vulkan::Resource::Buffer DrawCommandBuffer = {};
+
+    if (kDrawCommandAllocation != 0u)
     {
-        Components::StaticMesh::Types::ComponentData const kComponentData = *CurrentMesh;
+        Vulkan::Allocators::LinearBufferAllocator::GetAllocationInfo(kDrawCommandAllocation, DrawCommands);
+        Vulkan::Resource::GetBuffer(DrawCommands.BufferHandle, DrawCommandBuffer);
+    }
+
+    for (uint32 BatchIndex = { kFirstBatchIndex };
+         BatchIndex < kEndBatchIndex;
+         BatchIndex++)
+    {
+        RenderSnapshot::Types::DrawBatch const & kDrawBatch = kDrawBatches [BatchIndex];
+
+        if (kDrawBatch.MaterialHandle != BoundMaterialHandle)
+        {
+            uint32 const kMaterialIndex = { kDrawBatch.MaterialHandle - 1u };
+
+            if (kDrawBatch.MaterialHandle == 0u
+                || kMaterialIndex >= MaterialDescriptorSetHandles.size()
+                || MaterialDescriptorSetHandles [kMaterialIndex] == 0u)
+            {
+                continue;
+            }
+
+            if (!kbDepthOnly)
+            {
+                if (bBindlessMaterials)
+                {
+                    /* The bindless set stays bound, only the index into the material buffer changes */
+                    vkCmdPushConstants(kCommandBuffer, PipelineLayouts [0u], VK_SHADER_STAGE_FRAGMENT_BIT, 0u, sizeof(kMaterialIndex), &kMaterialIndex);
+                }
+                else
+                {
+                    VkDescriptorSet MaterialDescriptorSet = {};
+                    Vulkan::Descriptors::GetDescriptorSet(MaterialDescriptorAllocatorHandle, MaterialDescriptorSetHandles [kMaterialIndex], MaterialDescriptorSet);
 
-        Assets::StaticMesh::Types::StaticMesh MeshData = {};
-        Assets::Material::MaterialData MaterialData = {};
+                    vkCmdBindDescriptorSets(kCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, PipelineLayouts [0u], 1u, 1u, &MaterialDescriptorSet, 0u, nullptr);
+                }
+            }
 
-        bool bHasData = Assets::StaticMesh::GetAssetData(kComponentData.MeshHandle, MeshData);
-        bHasData &= Assets::Material::GetAssetData(kComponentData.MaterialHandle, MaterialData);
+            BoundMaterialHandle = kDrawBatch.MaterialHandle;
+        }
 
-        if (bHasData)
+        if (kDrawBatch.MeshHandle != BoundMeshHandle)
         {
-            ::UpdatePerDrawDescriptorSet(kDescriptorSetHandle, kAllocation, MaterialData);
+            uint32 const kSlotIndex = { MeshUniformSlotIndices [kDrawBatch.MeshHandle] };
+            MeshDrawBuffers const & kMeshBuffers = UniformSlotMeshBuffers [kSlotIndex];
 
-            std::array MeshBuffers = std::array<Vulkan::Resource::Buffer, 2u>();
+            if (kMeshBuffers.VertexBuffer == VK_NULL_HANDLE)
+            {
+                continue;
+            }
 
-            Vulkan::Resource::GetBuffer(MeshData.MeshBufferHandle, MeshBuffers [0u]);
-            Vulkan::Resource::GetBuffer(MeshData.IndexBufferHandle, MeshBuffers [1u]);
+            /* The slot only holds mesh data, so batches drawing the same mesh as the previous one can keep its offset */
+            uint32 const kPerDrawOffsetInBytes = { PerDrawUniformStrideInBytes * kSlotIndex };
 
-            vkCmdBindIndexBuffer(kCommandBuffer, MeshBuffers [1u].Resource, 0u, VK_INDEX_TYPE_UINT32);
+            vkCmdBindDescriptorSets(kCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, PipelineLayouts [0u], 2u, 1u, &kPerDrawDescriptorSet, 1u, &kPerDrawOffsetInBytes);
+
+            vkCmdBindIndexBuffer(kCommandBuffer, kMeshBuffers.IndexBuffer, 0u, VK_INDEX_TYPE_UINT32);
 
             {
                 std::array const kBuffers = std::array<VkBuffer, 4u>
                 {
-                    MeshBuffers [0u].Resource,
-                    MeshBuffers [0u].Resource,
-                    MeshBuffers [0u].Resource,
-                    MeshBuffers [0u].Resource,
+                    kMeshBuffers.VertexBuffer,
+                    kMeshBuffers.VertexBuffer,
+                    kMeshBuffers.VertexBuffer,
+                    kMeshBuffers.VertexBuffer,
                 };
 
-                std::array const kBufferOffsets = std::array<VkDeviceSize, kBuffers.size()>
-                {
-                    0u,
-                    MeshData.NormalDataOffsetInBytes,
-                    MeshData.TangentDataOffsetInBytes,
-                    MeshData.UVDataOffsetInBytes,
-                };
+                uint32 const kBufferCount = { kbDepthOnly ? 1u : static_cast<uint32>(kBuffers.size()) };
 
-                vkCmdBindVertexBuffers(kCommandBuffer, 0u, static_cast<uint32>(kBuffers.size()), kBuffers.data(), kBufferOffsets.data());
+                vkCmdBindVertexBuffers(kCommandBuffer, 0u, kBufferCount, kBuffers.data(), kMeshBuffers.StreamOffsetsInBytes.data());
             }
 
-            vkCmdBindDescriptorSets(kCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, PipelineLayouts [0u], 1u, 1u, &kMeshDescriptorSet, 0u, nullptr);
-
-            /* Put this here at the moment, ideally we should be flushing after changing the material */
-            /* Doesn't do anything if there aren't any descriptors to flush */
-            Vulkan::Descriptors::FlushDescriptorWrites(DeviceState);
+            BoundMeshHandle = kDrawBatch.MeshHandle;
+            BoundIndexCount = kMeshBuffers.IndexCount;
+        }
 
-            vkCmdDrawIndexed(kCommandBuffer, MeshData.IndexCount, 1u, 0u, 0u, 0u);
+        if (kDrawCommandAllocation != 0u)
+        {
+            /* Each batch binds its own mesh buffers, so the commands can't be merged into one multi draw */
+            vkCmdDrawIndexedIndirect(kCommandBuffer, DrawCommandBuffer.Resource, DrawCommands.OffsetInBytes + sizeof(VkDrawIndexedIndirectCommand) * BatchIndex, 1u, sizeof(VkDrawIndexedIndirectCommand));
         }
+        else
+        {
+            vkCmdDrawIndexed(kCommandBuffer, BoundIndexCount, kDrawBatch.InstanceCount, 0u, 0u, kDrawBatch.FirstInstanceIndex);
+        }
+    }
+}
+
+/* Records a range of batches into a secondary command buffer for the scene subpass. Secondaries don't inherit any state, so everything is bound again */
+static void RecordStaticMeshPass(VkCommandBuffer const kCommandBuffer, VkPipeline const kPipeline, bool const kbDepthOnly, VkFramebuffer const kFrameBuffer, VkDescriptorSet const kPerFrameDescriptorSet, VkDescriptorSet const kPerDrawDescriptorSet,
+                                 std::vector<RenderSnapshot::Types::DrawBatch> const & kDrawBatches, uint32 const kFirstBatchIndex, uint32 const kEndBatchIndex, uint32 const kDrawCommandAllocation)
+{
+    VkCommandBufferInheritanceInfo const kInheritanceInfo = Vulkan::CommandBufferInheritance(MainRenderPass, 0u, kFrameBuffer);
+    VkCommandBufferBeginInfo const kBeginInfo = Vulkan::CommandBufferBegin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, &kInheritanceInfo);
+
+    VERIFY_VKRESULT(vkBeginCommandBuffer(kCommandBuffer, &kBeginInfo));
+
+    vkCmdSetViewport(kCommandBuffer, 0u, 1u, &ViewportState.DynamicViewport);
+    vkCmdSetScissor(kCommandBuffer, 0u, 1u, &ViewportState.DynamicScissorRect);
+
+    vkCmdBindPipeline(kCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, kPipeline);
+    vkCmdBindDescriptorSets(kCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, PipelineLayouts [0u], 0u, 1u, &kPerFrameDescriptorSet, 0u, nullptr);
+
+    if (bBindlessMaterials && !kbDepthOnly)
+    {
+        vkCmdBindDescriptorSets(kCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, PipelineLayouts [0u], 1u, 1u, &BindlessDescriptorSet, 0u, nullptr);
+    }
+
+    ::RenderStaticMeshes(kCommandBuffer, kbDepthOnly, kPerDrawDescriptorSet, kDrawBatches, kFirstBatchIndex, kEndBatchIndex, kDrawCommandAllocation);
+
+    VERIFY_VKRESULT(vkEndCommandBuffer(kCommandBuffer));
+}
+
+/* Records the job's range of batches for the scene pass, and the depth pre-pass when it has a pipeline */
+static void RecordStaticMeshBatches(uint32 const kJobIndex, VkPipeline const kDepthPrePassPipeline, VkPipeline const kScenePipeline, VkFramebuffer const kFrameBuffer, VkDescriptorSet const kPerFrameDescriptorSet, VkDescriptorSet const kPerDrawDescriptorSet,
+                                    std::vector<RenderSnapshot::Types::DrawBatch> const & kDrawBatches, uint32 const kFirstBatchIndex, uint32 const kEndBatchIndex, uint32 const kDrawCommandAllocation)
+{
+    uint32 const kRecordingIndex = ::GetRecordingIndex(kJobIndex);
+
+    if (kDepthPrePassPipeline != VK_NULL_HANDLE)
+    {
+        ::RecordStaticMeshPass(FrameState.DepthPrePassCommandBuffers [kRecordingIndex], kDepthPrePassPipeline, true, kFrameBuffer, kPerFrameDescriptorSet, kPerDrawDescriptorSet,
+                               kDrawBatches, kFirstBatchIndex, kEndBatchIndex, kDrawCommandAllocation);
     }
+
+    ::RecordStaticMeshPass(FrameState.RecordingCommandBuffers [kRecordingIndex], kScenePipeline, false, kFrameBuffer, kPerFrameDescriptorSet, kPerDrawDescriptorSet,
+                           kDrawBatches, kFirstBatchIndex, kEndBatchIndex, kDrawCommandAllocation);
+}
+
+/*
+    Splits the batches into contiguous ranges that are recorded in parallel, one secondary command buffer per range.
+    The secondaries are executed in range order, so the draws stay in render queue order.
+    With a depth pre-pass pipeline every range's pre-pass is executed before any of the scene pass, so the depth buffer is complete before anything is shaded.
+*/
+static void RecordStaticMeshes(VkCommandBuffer const kCommandBuffer, VkPipeline const kDepthPrePassPipeline, VkPipeline const kScenePipeline, VkFramebuffer const kFrameBuffer, VkDescriptorSet const kPerFrameDescriptorSet, VkDescriptorSet const kPerDrawDescriptorSet,
+                               std::vector<RenderSnapshot::Types::DrawBatch> const & kDrawBatches, uint32 const kDrawCommandAllocation)
+{
+    uint32 const kBatchCount = static_cast<uint32>(kDrawBatches.size());
+
+    if (kBatchCount == 0u)
+    {
+        return;
+    }
+
+    /* At most RecordingJobCount jobs, so each job has its own pool */
+    uint32 const kBatchesPerJob = std::max(kMinimumBatchesPerRecordingJob, (kBatchCount + RecordingJobCount - 1u) / RecordingJobCount);
+    uint32 const kJobCount = (kBatchCount + kBatchesPerJob - 1u) / kBatchesPerJob;
+
+    Jobs::ParallelFor(kJobCount, 1u,
+                      [kDepthPrePassPipeline, kScenePipeline, kFrameBuffer, kPerFrameDescriptorSet, kPerDrawDescriptorSet, &kDrawBatches, kBatchCount, kBatchesPerJob, kDrawCommandAllocation](uint32 const FirstIndex, uint32 const EndIndex)
+                      {
+                          for (uint32 JobIndex = { FirstIndex };
+                               JobIndex < EndIndex;
+                               JobIndex++)
+                          {
+                              uint32 const kFirstBatchIndex = { JobIndex * kBatchesPerJob };
+                              uint32 const kEndBatchIndex = std::min(kFirstBatchIndex + kBatchesPerJob, kBatchCount);
+
+                              ::RecordStaticMeshBatches(JobIndex, kDepthPrePassPipeline, kScenePipeline, kFrameBuffer, kPerFrameDescriptorSet, kPerDrawDescriptorSet, kDrawBatches, kFirstBatchIndex, kEndBatchIndex, kDrawCommandAllocation);
+                          }
+                      });
+
+    if (kDepthPrePassPipeline != VK_NULL_HANDLE)
+    {
+        vkCmdExecuteCommands(kCommandBuffer, kJobCount, &FrameState.DepthPrePassCommandBuffers [::GetRecordingIndex(0u)]);
+    }
+
+    vkCmdExecuteCommands(kCommandBuffer, kJobCount, &FrameState.RecordingCommandBuffers [::GetRecordingIndex(0u)]);
+}
+
+/* Allocates the bindless set and the material buffer, then writes the bindings that don't change. Texture slots are written as materials are first drawn */
+static void CreateBindlessMaterialState()
+{
+    Vulkan::Descriptors::CreateDescriptorAllocator(DeviceState,
+                                                   Vulkan::Descriptors::DescriptorTypes::SampledImage | Vulkan::Descriptors::DescriptorTypes::Sampler | Vulkan::Descriptors::DescriptorTypes::StorageBuffer,
+                                                   kMaximumBindlessTextureCount, VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+                                                   BindlessDescriptorAllocatorHandle);
+
+    Vulkan::Descriptors::AllocateDescriptorSet(DeviceState, BindlessDescriptorAllocatorHandle, DescriptorSetLayoutHandles [4u], BindlessDescriptorSetHandle);
+    Vulkan::Descriptors::GetDescriptorSet(BindlessDescriptorAllocatorHandle, BindlessDescriptorSetHandle, BindlessDescriptorSet);
+
+    uint64 const kMaterialBufferSizeInBytes = { sizeof(BindlessMaterialData) * kMaximumBindlessMaterialCount };
+
+    /* Never reset, the one allocation lives until shutdown */
+    Vulkan::Allocators::LinearBufferAllocator::CreateAllocator(DeviceState,
+                                                               kMaterialBufferSizeInBytes,
+                                                               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                                               MaterialBufferAllocatorHandle);
+    Vulkan::Allocators::LinearBufferAllocator::Allocate(MaterialBufferAllocatorHandle, kMaterialBufferSizeInBytes, MaterialBufferAllocation);
+
+    Vulkan::Allocators::Types::AllocationInfo Allocation = {};
+    Vulkan::Allocators::LinearBufferAllocator::GetAllocationInfo(MaterialBufferAllocation, Allocation);
+
+    Vulkan::Resource::Buffer MaterialBuffer = {};
+    Vulkan::Resource::GetBuffer(Allocation.BufferHandle, MaterialBuffer);
+
+    VkDescriptorBufferInfo const kMaterialBufferDesc = Vulkan::DescriptorBufferInfo(MaterialBuffer.Resource, Allocation.OffsetInBytes, kMaterialBufferSizeInBytes);
+
+    std::array<VkDescriptorImageInfo, 2u> Samplers = {};
+    Samplers [0u].sampler = ImageSamplers [1u];
+    Samplers [1u].sampler = ImageSamplers [0u];
+
+    Vulkan::Descriptors::BindImageDescriptors(BindlessDescriptorAllocatorHandle, BindlessDescriptorSetHandle, VK_DESCRIPTOR_TYPE_SAMPLER, 1u, 2u, Samplers.data());
+    Vulkan::Descriptors::BindBufferDescriptors(BindlessDescriptorAllocatorHandle, BindlessDescriptorSetHandle, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3u, 1u, &kMaterialBufferDesc);
+
+    /* Writes are cached per thread and this may not be the render thread */
+    Vulkan::Descriptors::FlushDescriptorWrites(DeviceState);
 }
 
 bool const ForwardRenderer::Initialise(VkApplicationInfo const & ApplicationInfo)
 {
     /* These are loaded and compiled async, doing them here should mean they will be ready by the time we create the pipeline state */
     ShaderLibrary::LoadShader("ProjectOnScreen.vert", VertexShaderHandles [0u]);
+    ShaderLibrary::LoadShader("ProjectOnScreen.vert", { "DEPTH_ONLY" }, VertexShaderHandles [2u]);
     ShaderLibrary::LoadShader("TorranceSparrow.frag", FragmentShaderHandles [0u]);
+    ShaderLibrary::LoadShader("TorranceSparrow.frag", { "BINDLESS_MATERIALS" }, FragmentShaderHandles [2u]);
 
     ShaderLibrary::LoadShader("FullScreenTriangle.vert", VertexShaderHandles [1u]);
     ShaderLibrary::LoadShader("PostProcess.frag", FragmentShaderHandles [1u]);
 
+    ShaderLibrary::LoadShader("CullInstances.comp", CullInstancesShaderHandle);
+
     bool bResult = false;
 
     if (Vulkan::Instance::CreateInstance(ApplicationInfo, InstanceState))
@@ -734,15 +1681,35 @@ bool const ForwardRenderer::Initialise(VkApplicationInfo const & ApplicationInfo
 
         if (bResult)
         {
+            bBindlessMaterials = DeviceState.DescriptorIndexingFeatures.runtimeDescriptorArray == VK_TRUE;
+
+            Vulkan::PipelineCache::CreatePipelineCache(DeviceState, kPipelineCacheFilePath, PipelineCache);
+
+            Vulkan::Pipelines::Initialise(DeviceState, PipelineCache);
+
             bResult &= ::CreateMainRenderPass();
             bResult &= ::CreateDescriptorSetLayout();
             bResult &= ::CreateTorranceSparrowPipeline();
             bResult &= ::CreateOutputPipeline();
 
+            bCullOnGPU = DeviceState.PhysicalDeviceFeatures.drawIndirectFirstInstance == VK_TRUE;
+
+            PerDrawUniformStrideInBytes = static_cast<uint32>(::AlignToUniformBuffer(sizeof(PerDrawUniformBufferData)));
+
+            if (bCullOnGPU && !::CreateCullPipeline())
+            {
+                Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to create cull pipeline, culling on the CPU instead."));
+                bCullOnGPU = false;
+            }
+
             if (bResult)
             {
                 ::CreateFrameState();
 
+                Vulkan::Descriptors::CreateDescriptorAllocator(DeviceState,
+                                                               Vulkan::Descriptors::DescriptorTypes::SampledImage | Vulkan::Descriptors::DescriptorTypes::Sampler,
+                                                               MaterialDescriptorAllocatorHandle);
+
                 VkSamplerCreateInfo SamplerCreateInfo =
                 {
                     VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
@@ -764,6 +1731,11 @@ bool const ForwardRenderer::Initialise(VkApplicationInfo const & ApplicationInfo
                 SamplerCreateInfo.anisotropyEnable = VK_TRUE;
 
                 VERIFY_VKRESULT(vkCreateSampler(DeviceState.Device, &SamplerCreateInfo, nullptr, &ImageSamplers [1u]));
+
+                if (bBindlessMaterials)
+                {
+                    ::CreateBindlessMaterialState();
+                }
             }
             else
             {
@@ -781,16 +1753,29 @@ bool const ForwardRenderer::Shutdown()
 
     ::DestroyFrameState();
 
-    for (uint8 PipelineIndex = {};
-         PipelineIndex < Pipelines.size();
-         PipelineIndex++)
+    if (MaterialBufferAllocatorHandle != 0u)
     {
-        if (Pipelines [PipelineIndex] != VK_NULL_HANDLE)
-        {
-            vkDestroyPipeline(DeviceState.Device, Pipelines [PipelineIndex], nullptr);
-        }
+        Vulkan::Allocators::LinearBufferAllocator::DestroyAllocator(MaterialBufferAllocatorHandle, DeviceState);
+        MaterialBufferAllocatorHandle = 0u;
+    }
+
+    if (TransformBufferHandle != 0u)
+    {
+        Vulkan::Device::DestroyBuffer(DeviceState, TransformBufferHandle, VK_NULL_HANDLE);
+        TransformBufferHandle = 0u;
     }
 
+    if (CullPipeline != VK_NULL_HANDLE)
+    {
+        vkDestroyPipeline(DeviceState.Device, CullPipeline, nullptr);
+        CullPipeline = VK_NULL_HANDLE;
+    }
+
+    /* Before the cache is saved, so pipelines that were still compiling end up in it */
+    Vulkan::Pipelines::Destroy(DeviceState);
+
+    Vulkan::PipelineCache::DestroyPipelineCache(DeviceState, kPipelineCacheFilePath, PipelineCache);
+
     ShaderLibrary::DestroyShaderModules(DeviceState);
 
     if (MainRenderPass)
@@ -808,32 +1793,105 @@ bool const ForwardRenderer::Shutdown()
     return true;
 }
 
-void ForwardRenderer::Render(Scene::SceneData const & Scene)
+bool const ForwardRenderer::Render(RenderSnapshot::Types::FrameSnapshot const & Snapshot)
 {
-    if (!::PreRender())
+    /* The snapshot's transforms haven't been uploaded, so it has to be rendered again rather than dropped */
+    if (!::PreRender(Snapshot))
     {
-        return;
+        return false;
     }
 
+    Vulkan::Pipelines::Update(DeviceState);
+
     // before rendering the meshes, we will want to find all lights in the scene and organise them into a buffer.
     // due to the nature of the code, we can simply iterate over all the light components
 
     // setup uniform buffers for all things that need rendering (atm this is just static meshes)
 
     std::vector<uint32> UniformBufferAllocations = {};
-    ::CreateAndFillUniformBuffers(Scene, UniformBufferAllocations);
+    ::CreateAndFillUniformBuffers(Snapshot, UniformBufferAllocations);
 
-    /* Only require 2 per frame atm, so allocate here */
-    uint16 const kDescriptorAllocatorHandle = { FrameState.DescriptorAllocators [FrameState.CurrentFrameStateIndex] };
+    uint32 InstanceBufferAllocation = {};
+    bool bDrawStaticMeshes = ::CreateAndFillInstanceBuffer(Snapshot, InstanceBufferAllocation);
 
-    std::array<uint16, 2u> DescriptorSetHandles = {};
-    Vulkan::Descriptors::AllocateDescriptorSet(DeviceState, kDescriptorAllocatorHandle, DescriptorSetLayoutHandles [0u], DescriptorSetHandles [0u]);
-    Vulkan::Descriptors::AllocateDescriptorSet(DeviceState, kDescriptorAllocatorHandle, DescriptorSetLayoutHandles [1u], DescriptorSetHandles [1u]);
+    /* Static meshes aren't drawn until the scene pipeline has finished compiling, the transforms are still uploaded */
+    VkPipeline ScenePipeline = {};
+    VkPipeline DepthPrePassPipeline = {};
 
-    ::UpdatePerFrameDescriptorSet(DescriptorSetHandles [0u], UniformBufferAllocations [0u]);
+    /* Drawn without the pre-pass until both of its pipelines have finished compiling */
+    bool const kbDepthPrePass = Snapshot.bDepthPrePass
+                                && Vulkan::Pipelines::GetPipeline(GraphicsPipelineHandles [2u], DepthPrePassPipeline)
+                                && Vulkan::Pipelines::GetPipeline(GraphicsPipelineHandles [3u], ScenePipeline);
+
+    if (!kbDepthPrePass)
+    {
+        DepthPrePassPipeline = VK_NULL_HANDLE;
+
+        if (bDrawStaticMeshes && !Vulkan::Pipelines::GetPipeline(GraphicsPipelineHandles [0u], ScenePipeline))
+        {
+            bDrawStaticMeshes = false;
+        }
+    }
+
+    uint32 PerDrawUniformBufferAllocation = {};
+
+    if (bDrawStaticMeshes && !Snapshot.DrawBatches.empty())
+    {
+        bDrawStaticMeshes = ::CreateAndFillPerDrawUniformBuffer(Snapshot, PerDrawUniformBufferAllocation);
+    }
+
+    CullBufferAllocations CullAllocations = {};
+
+    bool const kbRecordCullPass = bCullOnGPU && bDrawStaticMeshes && !Snapshot.DrawBatches.empty();
+
+    if (kbRecordCullPass)
+    {
+        bDrawStaticMeshes = ::CreateAndFillCullBuffers(Snapshot, CullAllocations);
+    }
 
     VkCommandBuffer CommandBuffer = FrameState.CommandBuffers [FrameState.CurrentFrameStateIndex];
 
+    /* Copies and dispatches have to be recorded outside of the render pass */
+    ::UploadDirtyTransforms(CommandBuffer, Snapshot);
+
+    if (kbRecordCullPass && bDrawStaticMeshes)
+    {
+        ::RecordCullPass(CommandBuffer, Snapshot, CullAllocations, InstanceBufferAllocation);
+    }
+
+    uint16 const kDescriptorAllocatorHandle = { FrameState.DescriptorAllocators [FrameState.CurrentFrameStateIndex] };
+
+    uint16 PerFrameDescriptorSetHandle = {};
+    Vulkan::Descriptors::AllocateDescriptorSet(DeviceState, kDescriptorAllocatorHandle, DescriptorSetLayoutHandles [0u], PerFrameDescriptorSetHandle);
+
+    ::UpdatePerFrameDescriptorSet(PerFrameDescriptorSetHandle, UniformBufferAllocations [0u], InstanceBufferAllocation);
+
+    uint16 PerDrawDescriptorSetHandle = {};
+
+    if (bDrawStaticMeshes && PerDrawUniformBufferAllocation != 0u)
+    {
+        Vulkan::Descriptors::AllocateDescriptorSet(DeviceState, kDescriptorAllocatorHandle, DescriptorSetLayoutHandles [3u], PerDrawDescriptorSetHandle);
+
+        ::UpdatePerDrawDescriptorSet(PerDrawDescriptorSetHandle, PerDrawUniformBufferAllocation);
+        ::CreateMaterialDescriptorSets(Snapshot.DrawBatches);
+    }
+
+    /* Writes are flushed per thread, so this thread's have to be flushed before the recording jobs use the sets */
+    Vulkan::Descriptors::FlushDescriptorWrites(DeviceState);
+
+    VkDescriptorSet PerFrameDescriptorSet = {};
+    Vulkan::Descriptors::GetDescriptorSet(kDescriptorAllocatorHandle, PerFrameDescriptorSetHandle, PerFrameDescriptorSet);
+
+    VkDescriptorSet PerDrawDescriptorSet = {};
+
+    if (PerDrawDescriptorSetHandle != 0u)
+    {
+        Vulkan::Descriptors::GetDescriptorSet(kDescriptorAllocatorHandle, PerDrawDescriptorSetHandle, PerDrawDescriptorSet);
+    }
+
+    VkFramebuffer CurrentFrameBuffer = {};
+    Vulkan::Resource::GetFrameBuffer(FrameState.FrameBuffers [FrameState.CurrentFrameStateIndex], CurrentFrameBuffer);
+
     {
         std::array<VkClearValue, 3u> const kAttachmentClearValues =
         {
@@ -842,41 +1900,32 @@ void ForwardRenderer::Render(Scene::SceneData const & Scene)
             VkClearValue { 0.0f, 0.0f, 0.0f, 1.0f },
         };
 
-        VkFramebuffer CurrentFrameBuffer = {};
-        Vulkan::Resource::GetFrameBuffer(FrameState.FrameBuffers [FrameState.CurrentFrameStateIndex], CurrentFrameBuffer);
-
         VkRenderPassBeginInfo const BeginInfo = Vulkan::RenderPassBegin(MainRenderPass, CurrentFrameBuffer, VkRect2D { VkOffset2D { 0u, 0u }, ViewportState.ImageExtents }, static_cast<uint32>(kAttachmentClearValues.size()), kAttachmentClearValues.data());
 
-        vkCmdBeginRenderPass(CommandBuffer, &BeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+        /* The scene subpass is recorded into secondary command buffers */
+        vkCmdBeginRenderPass(CommandBuffer, &BeginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
     }
 
-    vkCmdSetViewport(CommandBuffer, 0u, 1u, &ViewportState.DynamicViewport);
-    vkCmdSetScissor(CommandBuffer, 0u, 1u, &ViewportState.DynamicScissorRect);
-
-    vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipelines [0u]);
-
-    std::array<VkDescriptorSet, 2u> DescriptorSets = {};
-    Vulkan::Descriptors::GetDescriptorSet(kDescriptorAllocatorHandle, DescriptorSetHandles [0u], DescriptorSets[0u]);
-    Vulkan::Descriptors::GetDescriptorSet(kDescriptorAllocatorHandle, DescriptorSetHandles [1u], DescriptorSets [1u]);
+    if (bDrawStaticMeshes)
+    {
+        ::RecordStaticMeshes(CommandBuffer, DepthPrePassPipeline, ScenePipeline, CurrentFrameBuffer, PerFrameDescriptorSet, PerDrawDescriptorSet, Snapshot.DrawBatches, CullAllocations.DrawCommandAllocation);
+    }
 
-    /*
-        Frequency Based Descriptor Sets
-        - Allocate descriptor set per material (Need a way to determine active materials)
-        - Check if per mesh data is necessary
-        - Need a descriptor set for per-frame data
-    */
+    vkCmdNextSubpass(CommandBuffer, VK_SUBPASS_CONTENTS_INLINE);
 
-    /* bind the per-frame descriptor set */
-    vkCmdBindDescriptorSets(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, PipelineLayouts [0u], 0u, 1u, DescriptorSets.data(), 0u, nullptr);
+    /* Executing secondaries leaves the primary's state undefined */
+    vkCmdSetViewport(CommandBuffer, 0u, 1u, &ViewportState.DynamicViewport);
+    vkCmdSetScissor(CommandBuffer, 0u, 1u, &ViewportState.DynamicScissorRect);
 
-    ::RenderStaticMeshes(CommandBuffer, DescriptorSetHandles [1u], DescriptorSets [1u], UniformBufferAllocations [1u]);
-    
-    vkCmdNextSubpass(CommandBuffer, VK_SUBPASS_CONTENTS_INLINE);
+    VkPipeline OutputPipeline = {};
 
-    vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Pipelines [1u]);
-    vkCmdBindDescriptorSets(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, PipelineLayouts [1u], 0u, 1u, DescriptorSets.data(), 0u, nullptr);
+    if (Vulkan::Pipelines::GetPipeline(GraphicsPipelineHandles [1u], OutputPipeline))
+    {
+        vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, OutputPipeline);
+        vkCmdBindDescriptorSets(CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, PipelineLayouts [1u], 0u, 1u, &PerFrameDescriptorSet, 0u, nullptr);
 
-    vkCmdDraw(CommandBuffer, 3u, 1u, 0u, 0u);
+        vkCmdDraw(CommandBuffer, 3u, 1u, 0u, 0u);
+    }
 
     vkCmdEndRenderPass(CommandBuffer);
 
@@ -902,10 +1951,23 @@ void ForwardRenderer::Render(Scene::SceneData const & Scene)
 
         if (kPresentResult == VK_SUBOPTIMAL_KHR || kPresentResult == VK_ERROR_OUT_OF_DATE_KHR)
         {
-            ::ResizeViewport();
-            return;
+            /* The frame was still submitted, so the snapshot is done with */
+            ::ResizeViewport(Snapshot);
+            return true;
         }
     }
 
     ::PostRender();
+
+    return true;
+}
+
+uint32 const ForwardRenderer::GetMaximumTransformUploadCount()
+{
+    return static_cast<uint32>(kTransformStagingSizeInBytes / sizeof(Math::Affine3x4));
+}
+
+bool const ForwardRenderer::IsGPUCullingEnabled()
+{
+    return bCullOnGPU;
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Graphics/Device.hpp"
 
 #include <array>
+#include <limits>
 #include <memory>
 #include <queue>
 
@@ -23,7 +24,13 @@ struct DescriptorLayouts
 
 struct DescriptorPoolCollection
 {
+    /* Every pool in the collection is created with the same sizes and flags */
+    std::vector<VkDescriptorPoolSize> PoolSizes = {};
+    VkDescriptorPoolCreateFlags PoolCreateFlags = {};
+
     std::vector<VkDescriptorPool> Pools = {};
+
+    /* kMaximumDescriptorSetCount per pool, a set's handle is its index plus one */
     std::vector<VkDescriptorSet> DescriptorSets = {};
     std::vector<uint64> AvailableDescriptorSetMasks = {};
 };
@@ -35,28 +42,76 @@ struct DescriptorCache
     std::vector<VkDescriptorType> DescriptorTypes = {};
     std::vector<uint8> DescriptorCounts = {};
     std::vector<uint8> FirstBindingIndices = {};
+    std::vector<uint32> FirstArrayElements = {};
     std::vector<uint8> FirstDescriptorOffset = {};
 
     std::vector<VkDescriptorBufferInfo> BufferDescriptors = {};
     std::vector<VkDescriptorImageInfo> ImageDescriptors = {};
 };
 
-static uint16 const kMaximumDescriptorAllocatorCount = { 6u };
+static uint16 const kMaximumDescriptorAllocatorCount = { 16u };
 static uint8 const kMaximumDescriptorSetCount = { 64u };
-static uint8 const kDefaultPoolDescriptorCount = { 16u };
+
+/* Per descriptor type, enough for four of each type per set before the pool runs out */
+static uint32 const kDefaultPoolDescriptorCount = { 256u };
+
+/* Set handles are 16 bit */
+static uint32 const kMaximumPoolCount = { std::numeric_limits<uint16>::max() / kMaximumDescriptorSetCount };
 
 static uint16 NextAvailableAllocatorIndex = {};
 static std::array<DescriptorPoolCollection, kMaximumDescriptorAllocatorCount> DescriptorAllocators = {};
 static std::array<uint32, kMaximumDescriptorAllocatorCount> DescriptorTypeMasks = {};
 
 static DescriptorLayouts DescriptorSetLayouts = {};
-static DescriptorCache Cache = {};
+
+/* Each thread batches its own writes, so threads writing to different descriptor sets don't need to lock */
+static thread_local DescriptorCache Cache = {};
+
+static bool const AddDescriptorPool(Vulkan::Device::DeviceState const & kDeviceState, DescriptorPoolCollection & Allocator)
+{
+    if (Allocator.Pools.size() >= kMaximumPoolCount)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot add descriptor pool, the allocator has run out of descriptor set handles."));
+        return false;
+    }
+
+    VkDescriptorPoolCreateInfo const kPoolCreateInfo = 
+        VkDescriptorPoolCreateInfo 
+    { 
+        VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO, 
+        nullptr, 
+        Allocator.PoolCreateFlags, 
+        kMaximumDescriptorSetCount, 
+        static_cast<uint32>(Allocator.PoolSizes.size()), 
+        Allocator.PoolSizes.data() 
+    };
+
+    Allocator.Pools.emplace_back();
+    Allocator.AvailableDescriptorSetMasks.push_back(std::numeric_limits<uint64>::max());
+    Allocator.DescriptorSets.resize(Allocator.DescriptorSets.size() + kMaximumDescriptorSetCount);
+
+    VERIFY_VKRESULT(vkCreateDescriptorPool(kDeviceState.Device, &kPoolCreateInfo, nullptr, &Allocator.Pools.back()));
+
+    return true;
+}
 
 bool const Vulkan::Descriptors::CreateDescriptorAllocator(Vulkan::Device::DeviceState const & kDeviceState, uint32 const kDescriptorTypeFlags, uint16 & OutputAllocatorHandle)
 {
+    return Vulkan::Descriptors::CreateDescriptorAllocator(kDeviceState, kDescriptorTypeFlags, kDefaultPoolDescriptorCount, 0u, OutputAllocatorHandle);
+}
+
+bool const Vulkan::Descriptors::CreateDescriptorAllocator(Vulkan::Device::DeviceState const & kDeviceState, uint32 const kDescriptorTypeFlags, uint32 const kPoolDescriptorCount, VkDescriptorPoolCreateFlags const kPoolCreateFlags, uint16 & OutputAllocatorHandle)
+{
+    if (NextAvailableAllocatorIndex >= kMaximumDescriptorAllocatorCount)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot create descriptor allocator, the maximum number of allocators has been reached."));
+        return false;
+    }
+
     uint16 const kAllocatorHandle = ++NextAvailableAllocatorIndex;
+    uint16 const kAllocatorIndex = { kAllocatorHandle - 1u };
 
-    std::vector<VkDescriptorPoolSize> PoolSizes = {};
+    DescriptorPoolCollection & Allocator = DescriptorAllocators [kAllocatorIndex];
 
     uint32 DescriptorType = {};
     uint32 DescriptorTypeMask = { kDescriptorTypeFlags };
@@ -64,10 +119,11 @@ bool const Vulkan::Descriptors::CreateDescriptorAllocator(Vulkan::Device::Device
     {
         DescriptorTypeMask ^= 1u << DescriptorType;
 
-        VkDescriptorPoolSize & PoolSize = PoolSizes.emplace_back();
-        PoolSize.descriptorCount = kDefaultPoolDescriptorCount;
+        VkDescriptorPoolSize & PoolSize = Allocator.PoolSizes.emplace_back();
+        PoolSize.descriptorCount = kPoolDescriptorCount;
 
-        switch (DescriptorType)
+        /* DescriptorType is a bit index, the enum stores flags */
+        switch (1u << DescriptorType)
         {
             case Vulkan::Descriptors::DescriptorTypes::Uniform:
                 PoolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
@@ -78,30 +134,20 @@ bool const Vulkan::Descriptors::CreateDescriptorAllocator(Vulkan::Device::Device
             case Vulkan::Descriptors::DescriptorTypes::SampledImage:
                 PoolSize.type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
                 break;
+            case Vulkan::Descriptors::DescriptorTypes::StorageBuffer:
+                PoolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                break;
+            case Vulkan::Descriptors::DescriptorTypes::UniformDynamic:
+                PoolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+                break;
         }
     }
 
-    VkDescriptorPoolCreateInfo const kPoolCreateInfo = 
-        VkDescriptorPoolCreateInfo 
-    { 
-        VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO, 
-        nullptr, 
-        0u, 
-        kMaximumDescriptorSetCount, 
-        static_cast<uint32>(PoolSizes.size()), 
-        PoolSizes.data() 
-    };
-
-    uint16 const kAllocatorIndex = { kAllocatorHandle - 1u };
-
-    DescriptorPoolCollection & Allocator = DescriptorAllocators [kAllocatorIndex];
-    Allocator.Pools.emplace_back();
-    Allocator.AvailableDescriptorSetMasks.push_back(std::numeric_limits<uint64>::max());
-    Allocator.DescriptorSets.resize(Allocator.DescriptorSets.size() + kMaximumDescriptorSetCount);
+    Allocator.PoolCreateFlags = kPoolCreateFlags;
 
     DescriptorTypeMasks [kAllocatorIndex] = kDescriptorTypeFlags;
 
-    VERIFY_VKRESULT(vkCreateDescriptorPool(kDeviceState.Device, &kPoolCreateInfo, nullptr, &Allocator.Pools.back()));
+    ::AddDescriptorPool(kDeviceState, Allocator);
 
     OutputAllocatorHandle = { kAllocatorHandle };
 
@@ -116,12 +162,16 @@ bool const Vulkan::Descriptors::ResetDescriptorAllocator(Vulkan::Device::DeviceS
         return false;
     }
 
-    /* TODO: This will need to iterate the descriptor pools when we allocate additional */
-
     DescriptorPoolCollection & Allocator = DescriptorAllocators [kAllocatorHandle - 1u];
-    VERIFY_VKRESULT(vkResetDescriptorPool(kDeviceState.Device, Allocator.Pools.back(), 0u));
 
-    Allocator.AvailableDescriptorSetMasks [0u] = std::numeric_limits<uint64>::max();
+    for (uint32 PoolIndex = {};
+         PoolIndex < Allocator.Pools.size();
+         PoolIndex++)
+    {
+        VERIFY_VKRESULT(vkResetDescriptorPool(kDeviceState.Device, Allocator.Pools [PoolIndex], 0u));
+
+        Allocator.AvailableDescriptorSetMasks [PoolIndex] = std::numeric_limits<uint64>::max();
+    }
 
     return true;
 }
@@ -139,29 +189,66 @@ bool const Vulkan::Descriptors::AllocateDescriptorSet(Vulkan::Device::DeviceStat
     DescriptorPoolCollection & Allocator = DescriptorAllocators [kAllocatorIndex];
     VkDescriptorSetLayout const kLayout = DescriptorSetLayouts.Layouts [kLayoutIndex];
 
-    VkDescriptorSetAllocateInfo const kAllocationInfo =
+    /* TODO: Bundle descriptor set allocator handle and descriptor set handle into a single uint32 */
+
+    /* First fit, a pool is added once every existing one is full */
+    for (uint32 PoolIndex = {};
+         PoolIndex <= Allocator.Pools.size();
+         PoolIndex++)
     {
-        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
-        nullptr,
-        Allocator.Pools.back(),
-        1u,
-        &kLayout
-    };
+        bool const kbIsNewPool = PoolIndex == Allocator.Pools.size();
 
-    /* TODO: Prior to this we need to find an available pool */
-    /* TODO: Bundle descriptor set allocator handle and descriptor set handle into a single uint32 */
+        if (kbIsNewPool && !::AddDescriptorPool(kDeviceState, Allocator))
+        {
+            return false;
+        }
+
+        uint64 const kDescriptorSetMask = { Allocator.AvailableDescriptorSetMasks [PoolIndex] };
 
-    uint64 const kDescriptorSetMask = { Allocator.AvailableDescriptorSetMasks [0u] };
-    uint32 FirstFreeIndex = {};
-    _BitScanForward64(reinterpret_cast<unsigned long*>(&FirstFreeIndex), kDescriptorSetMask);
+        if (kDescriptorSetMask == 0u)
+        {
+            continue;
+        }
 
-    VERIFY_VKRESULT(vkAllocateDescriptorSets(kDeviceState.Device, &kAllocationInfo, &Allocator.DescriptorSets [FirstFreeIndex]));
+        uint32 FirstFreeIndex = {};
+        _BitScanForward64(reinterpret_cast<unsigned long*>(&FirstFreeIndex), kDescriptorSetMask);
 
-    Allocator.AvailableDescriptorSetMasks [0u] ^= 1ull << FirstFreeIndex;
+        uint32 const kDescriptorSetIndex = { PoolIndex * kMaximumDescriptorSetCount + FirstFreeIndex };
 
-    OutputDescriptorSetHandle = { static_cast<uint16>(FirstFreeIndex + 1u) };
+        VkDescriptorSetAllocateInfo const kAllocationInfo =
+        {
+            VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            nullptr,
+            Allocator.Pools [PoolIndex],
+            1u,
+            &kLayout
+        };
 
-    return true;
+        VkResult const kResult = vkAllocateDescriptorSets(kDeviceState.Device, &kAllocationInfo, &Allocator.DescriptorSets [kDescriptorSetIndex]);
+
+        if (kResult == VK_ERROR_OUT_OF_POOL_MEMORY || kResult == VK_ERROR_FRAGMENTED_POOL)
+        {
+            if (kbIsNewPool)
+            {
+                Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot allocate descriptor set, the layout needs more descriptors than a pool holds."));
+                return false;
+            }
+
+            /* The pool has sets left but not descriptors, nothing else will fit until it is reset */
+            Allocator.AvailableDescriptorSetMasks [PoolIndex] = 0u;
+            continue;
+        }
+
+        VERIFY_VKRESULT(kResult);
+
+        Allocator.AvailableDescriptorSetMasks [PoolIndex] ^= 1ull << FirstFreeIndex;
+
+        OutputDescriptorSetHandle = { static_cast<uint16>(kDescriptorSetIndex + 1u) };
+
+        return true;
+    }
+
+    return false;
 }
 
 bool const Vulkan::Descriptors::BindBufferDescriptors(uint16 const kAllocatorHandle, uint16 const kDescriptorSetHandle, VkDescriptorType const kDescriptorType, uint8 const kFirstBindingIndex, uint8 const kDescriptorCount, VkDescriptorBufferInfo const * const kBufferDescriptors)
@@ -201,12 +288,18 @@ bool const Vulkan::Descriptors::BindBufferDescriptors(uint16 const kAllocatorHan
     Cache.DescriptorTypes.push_back(kDescriptorType);
     Cache.DescriptorCounts.push_back(kDescriptorCount);
     Cache.FirstBindingIndices.push_back(kFirstBindingIndex);
+    Cache.FirstArrayElements.push_back(0u);
     Cache.FirstDescriptorOffset.push_back(kFirstDescriptorIndex);
     
     return true;
 }
 
 bool const Vulkan::Descriptors::BindImageDescriptors(uint16 const kAllocatorHandle, uint16 const kDescriptorSetHandle, VkDescriptorType const kDescriptorType, uint8 const kFirstBindingIndex, uint8 const kDescriptorCount, VkDescriptorImageInfo const * const kImageDescriptors)
+{
+    return Vulkan::Descriptors::BindImageDescriptors(kAllocatorHandle, kDescriptorSetHandle, kDescriptorType, kFirstBindingIndex, 0u, kDescriptorCount, kImageDescriptors);
+}
+
+bool const Vulkan::Descriptors::BindImageDescriptors(uint16 const kAllocatorHandle, uint16 const kDescriptorSetHandle, VkDescriptorType const kDescriptorType, uint8 const kBindingIndex, uint32 const kFirstArrayElement, uint8 const kDescriptorCount, VkDescriptorImageInfo const * const kImageDescriptors)
 {
     if (kAllocatorHandle == 0u)
     {
@@ -241,7 +334,8 @@ bool const Vulkan::Descriptors::BindImageDescriptors(uint16 const kAllocatorHand
     Cache.DescriptorSetHandles.push_back(kDescriptorSetHandle);
     Cache.DescriptorTypes.push_back(kDescriptorType);
     Cache.DescriptorCounts.push_back(kDescriptorCount);
-    Cache.FirstBindingIndices.push_back(kFirstBindingIndex);
+    Cache.FirstBindingIndices.push_back(kBindingIndex);
+    Cache.FirstArrayElements.push_back(kFirstArrayElement);
     Cache.FirstDescriptorOffset.push_back(kFirstDescriptorIndex);
 
     return true;
@@ -269,11 +363,14 @@ bool const Vulkan::Descriptors::FlushDescriptorWrites(Vulkan::Device::DeviceStat
                                                          Cache.DescriptorTypes [DescriptorIndex],
                                                          Cache.FirstBindingIndices [DescriptorIndex],
                                                          Cache.DescriptorCounts [DescriptorIndex],
-                                                         nullptr, nullptr);
+                                                         nullptr, nullptr,
+                                                         Cache.FirstArrayElements [DescriptorIndex]);
 
         switch (Cache.DescriptorTypes [DescriptorIndex])
         {
             case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
             {
                 DescriptorWriteInfo.pBufferInfo = (&Cache.BufferDescriptors [Cache.FirstDescriptorOffset [DescriptorIndex]]);
             }
@@ -300,6 +397,7 @@ bool const Vulkan::Descriptors::FlushDescriptorWrites(Vulkan::Device::DeviceStat
     Cache.DescriptorTypes.clear();
     Cache.DescriptorCounts.clear();
     Cache.FirstBindingIndices.clear();
+    Cache.FirstArrayElements.clear();
     Cache.FirstDescriptorOffset.clear();
 
     Cache.BufferDescriptors.clear();
@@ -309,6 +407,11 @@ bool const Vulkan::Descriptors::FlushDescriptorWrites(Vulkan::Device::DeviceStat
 }
 
 bool const Vulkan::Descriptors::CreateDescriptorSetLayout(Vulkan::Device::DeviceState const & kDeviceState, uint32 const kBindingCount, VkDescriptorSetLayoutBinding const * const kResourceBindings, uint16 & OutputLayoutHandle)
+{
+    return Vulkan::Descriptors::CreateDescriptorSetLayout(kDeviceState, kBindingCount, kResourceBindings, nullptr, OutputLayoutHandle);
+}
+
+bool const Vulkan::Descriptors::CreateDescriptorSetLayout(Vulkan::Device::DeviceState const & kDeviceState, uint32 const kBindingCount, VkDescriptorSetLayoutBinding const * const kResourceBindings, VkDescriptorBindingFlags const * const kBindingFlags, uint16 & OutputLayoutHandle)
 {
     if (kBindingCount == 0u)
     {
@@ -334,7 +437,29 @@ bool const Vulkan::Descriptors::CreateDescriptorSetLayout(Vulkan::Device::Device
 
     uint16 const kLayoutIndex = { LayoutHandle - 1u };
 
-    VkDescriptorSetLayoutCreateInfo const CreateInfo = Vulkan::DescriptorSetLayout(kBindingCount, kResourceBindings);
+    VkDescriptorSetLayoutCreateInfo CreateInfo = Vulkan::DescriptorSetLayout(kBindingCount, kResourceBindings);
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo BindingFlagsCreateInfo = {};
+
+    if (kBindingFlags)
+    {
+        BindingFlagsCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        BindingFlagsCreateInfo.bindingCount = kBindingCount;
+        BindingFlagsCreateInfo.pBindingFlags = kBindingFlags;
+
+        CreateInfo.pNext = &BindingFlagsCreateInfo;
+
+        for (uint32 BindingIndex = {};
+             BindingIndex < kBindingCount;
+             BindingIndex++)
+        {
+            if ((kBindingFlags [BindingIndex] & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT) != 0u)
+            {
+                CreateInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+            }
+        }
+    }
+
     VERIFY_VKRESULT(vkCreateDescriptorSetLayout(kDeviceState.Device, &CreateInfo, nullptr, &DescriptorSetLayouts.Layouts [kLayoutIndex]));
 
     DescriptorSetLayouts.Bindings [kLayoutIndex] = std::move(std::make_unique<LayoutBinding[]>(kBindingCount));
@@ -17,7 +17,7 @@ namespace Vulkan::Device::Private
     {
         std::unordered_map<VkFence, std::vector<uint32>> FenceToPendingDeletionQueueMap = {};
 
-        // the index returned from Add can be used as the handle
+        /* Handles from Add are used as the resource handles, stale handles are rejected instead of aliasing a newer resource */
         SparseVector<TResourceType> Resources = {};
 
         bool DestroyResource(Vulkan::Device::DeviceState const & kDeviceState, uint32 const kResourceHandle);
@@ -26,6 +26,12 @@ namespace Vulkan::Device::Private
         {
             for (auto & [Fence, Handles] : FenceToPendingDeletionQueueMap)
             {
+                /* The entries are kept for reuse, most frames have nothing queued for most fences so skip the status query */
+                if (Handles.size() == 0u)
+                {
+                    continue;
+                }
+
                 VkResult const kFenceStatus = vkGetFenceStatus(kDeviceState.Device, Fence);
 
                 if (kFenceStatus == VK_SUCCESS)
@@ -52,9 +58,13 @@ namespace Vulkan::Device::Private
     {
         Logging::Log(Logging::LogTypes::Info, String::Format(PBR_TEXT("DestroyBuffer: Destroying buffer [ID: %u]"), kResourceHandle));
 
-        uint32 const kBufferIndex = { kResourceHandle - 1u };
+        if (!Resources.Contains(kResourceHandle))
+        {
+            Logging::Log(Logging::LogTypes::Error, PBR_TEXT("DestroyBuffer: Invalid buffer handle. Cannot destroy a buffer that has already been destroyed."));
+            return false;
+        }
 
-        Vulkan::Resource::Buffer const & kBuffer = Resources [kBufferIndex];
+        Vulkan::Resource::Buffer const & kBuffer = Resources [kResourceHandle];
 
         if (kBuffer.Resource != VK_NULL_HANDLE)
         {
@@ -63,7 +73,7 @@ namespace Vulkan::Device::Private
 
         Vulkan::Memory::Free(kBuffer.MemoryAllocationHandle);
 
-        Resources.Remove(kBufferIndex);
+        Resources.Remove(kResourceHandle);
 
         return true;
     }
@@ -72,9 +82,13 @@ namespace Vulkan::Device::Private
     {
         Logging::Log(Logging::LogTypes::Info, String::Format(PBR_TEXT("DestroyImage: Destroying image [ID: %u]"), kResourceHandle));
 
-        uint32 const kImageIndex = { kResourceHandle - 1u };
+        if (!Resources.Contains(kResourceHandle))
+        {
+            Logging::Log(Logging::LogTypes::Error, PBR_TEXT("DestroyImage: Invalid image handle. Cannot destroy a image that has already been destroyed."));
+            return false;
+        }
 
-        Vulkan::Resource::Image const & kImage = Resources [kImageIndex];
+        Vulkan::Resource::Image const & kImage = Resources [kResourceHandle];
 
         if (kImage.Resource != VK_NULL_HANDLE)
         {
@@ -83,7 +97,7 @@ namespace Vulkan::Device::Private
 
         Vulkan::Memory::Free(kImage.MemoryAllocationHandle);
 
-        Resources.Remove(kImageIndex);
+        Resources.Remove(kResourceHandle);
 
         return true;
     }
@@ -92,16 +106,20 @@ namespace Vulkan::Device::Private
     {
         Logging::Log(Logging::LogTypes::Info, String::Format(PBR_TEXT("DestroyImageView: Destroying image view [ID: %u]"), kResourceHandle));
 
-        uint32 const kImageViewIndex = { kResourceHandle - 1u };
+        if (!Resources.Contains(kResourceHandle))
+        {
+            Logging::Log(Logging::LogTypes::Error, PBR_TEXT("DestroyImageView: Invalid image view handle. Cannot destroy a image view that has already been destroyed."));
+            return false;
+        }
 
-        VkImageView const kImageView = Resources [kImageViewIndex];
+        VkImageView const kImageView = Resources [kResourceHandle];
 
         if (kImageView != VK_NULL_HANDLE)
         {
             vkDestroyImageView(kDeviceState.Device, kImageView, nullptr);
         }
 
-        Resources.Remove(kImageViewIndex);
+        Resources.Remove(kResourceHandle);
 
         return true;
     }
@@ -110,16 +128,20 @@ namespace Vulkan::Device::Private
     {
         //Logging::Log(Logging::LogTypes::Info, String::Format(PBR_TEXT("DestroyFrameBuffer: Destroying frame buffer [ID: %u]"), kResourceHandle));
 
-        uint32 const kFrameBufferIndex = { kResourceHandle - 1u };
+        if (!Resources.Contains(kResourceHandle))
+        {
+            Logging::Log(Logging::LogTypes::Error, PBR_TEXT("DestroyFrameBuffer: Invalid frame buffer handle. Cannot destroy a frame buffer that has already been destroyed."));
+            return false;
+        }
 
-        VkFramebuffer const kFrameBuffer = Resources [kFrameBufferIndex];
+        VkFramebuffer const kFrameBuffer = Resources [kResourceHandle];
 
         if (kFrameBuffer != VK_NULL_HANDLE)
         {
             vkDestroyFramebuffer(kDeviceState.Device, kFrameBuffer, nullptr);
         }
 
-        Resources.Remove(kFrameBufferIndex);
+        Resources.Remove(kResourceHandle);
 
         return true;
     }
@@ -309,8 +331,54 @@ bool const Vulkan::Device::CreateDevice(Vulkan::Instance::InstanceState const &
                                        },
                                        IntermediateState.PhysicalDevice);
 
+    /* Falls back to integrated and CPU implementations, so the renderer can also be checked on a software device */
+    bResult = bResult || ::GetPhysicalDevice(InstanceState.Instance,
+                                             [](VkPhysicalDeviceFeatures const & Features, VkPhysicalDeviceProperties const &)
+                                             {
+                                                 return Features.samplerAnisotropy == VK_TRUE;
+                                             },
+                                             IntermediateState.PhysicalDevice);
+
     if (bResult)
     {
+        vkGetPhysicalDeviceProperties(IntermediateState.PhysicalDevice, &IntermediateState.PhysicalDeviceProperties);
+
+        {
+            VkPhysicalDeviceFeatures SupportedFeatures = {};
+            vkGetPhysicalDeviceFeatures(IntermediateState.PhysicalDevice, &SupportedFeatures);
+
+            /* Optional, the renderer only culls on the GPU when indirect draws can start at a non-zero instance */
+            IntermediateState.PhysicalDeviceFeatures.drawIndirectFirstInstance = SupportedFeatures.drawIndirectFirstInstance;
+        }
+
+        IntermediateState.DescriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+
+        /* Optional, descriptor indexing is core from 1.2 and the renderer falls back to a descriptor set per material without it */
+        if (IntermediateState.PhysicalDeviceProperties.apiVersion >= VK_API_VERSION_1_2)
+        {
+            VkPhysicalDeviceDescriptorIndexingFeatures SupportedIndexingFeatures = {};
+            SupportedIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+
+            VkPhysicalDeviceFeatures2 SupportedFeatures = {};
+            SupportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            SupportedFeatures.pNext = &SupportedIndexingFeatures;
+
+            vkGetPhysicalDeviceFeatures2(IntermediateState.PhysicalDevice, &SupportedFeatures);
+
+            bool const kbSupportsBindlessTextures = SupportedIndexingFeatures.runtimeDescriptorArray == VK_TRUE
+                                                    && SupportedIndexingFeatures.descriptorBindingPartiallyBound == VK_TRUE
+                                                    && SupportedIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE
+                                                    && SupportedIndexingFeatures.shaderSampledImageArrayNonUniformIndexing == VK_TRUE;
+
+            if (kbSupportsBindlessTextures)
+            {
+                IntermediateState.DescriptorIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
+                IntermediateState.DescriptorIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+                IntermediateState.DescriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+                IntermediateState.DescriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+            }
+        }
+
         if (::HasRequiredExtensions(IntermediateState.PhysicalDevice) &&
             ::GetQueueFamilyIndex(IntermediateState.PhysicalDevice, VK_QUEUE_GRAPHICS_BIT, true, InstanceState.Surface, IntermediateState.GraphicsQueueFamilyIndex))
         {
@@ -321,11 +389,17 @@ bool const Vulkan::Device::CreateDevice(Vulkan::Instance::InstanceState const &
                                                                                  &QueuePriority);
 
             {
-                VkDeviceCreateInfo const kCreateInfo = Vulkan::DeviceInfo(1u, &kQueueCreateInfo,
-                                                                          &IntermediateState.PhysicalDeviceFeatures,
-                                                                          static_cast<uint32>(kRequiredExtensionNames.size()), kRequiredExtensionNames.data());
+                VkDeviceCreateInfo CreateInfo = Vulkan::DeviceInfo(1u, &kQueueCreateInfo,
+                                                                   &IntermediateState.PhysicalDeviceFeatures,
+                                                                   static_cast<uint32>(kRequiredExtensionNames.size()), kRequiredExtensionNames.data());
 
-                VERIFY_VKRESULT(vkCreateDevice(IntermediateState.PhysicalDevice, &kCreateInfo, nullptr, &IntermediateState.Device));
+                /* The structure is unknown before 1.2, so it is only chained when something is enabled */
+                if (IntermediateState.DescriptorIndexingFeatures.runtimeDescriptorArray == VK_TRUE)
+                {
+                    CreateInfo.pNext = &IntermediateState.DescriptorIndexingFeatures;
+                }
+
+                VERIFY_VKRESULT(vkCreateDevice(IntermediateState.PhysicalDevice, &CreateInfo, nullptr, &IntermediateState.Device));
             }
 
             if (::LoadDeviceFunctions(IntermediateState.Device) &&
@@ -365,11 +439,32 @@ void Vulkan::Device::DestroyDevice(Vulkan::Device::DeviceState & DeviceState)
     }
 }
 
+void Vulkan::Device::CreateCommandPool(Vulkan::Device::DeviceState const & kDeviceState, VkCommandPoolCreateFlags const kFlags, VkCommandPool & OutputCommandPool)
+{
+    VkCommandPoolCreateInfo const kCreateInfo = Vulkan::CommandPoolInfo(kDeviceState.GraphicsQueueFamilyIndex, kFlags);
+
+    VERIFY_VKRESULT(vkCreateCommandPool(kDeviceState.Device, &kCreateInfo, nullptr, &OutputCommandPool));
+}
+
+void Vulkan::Device::DestroyCommandPool(Vulkan::Device::DeviceState const & kDeviceState, VkCommandPool & CommandPool)
+{
+    if (CommandPool)
+    {
+        vkDestroyCommandPool(kDeviceState.Device, CommandPool, nullptr);
+        CommandPool = VK_NULL_HANDLE;
+    }
+}
+
 void Vulkan::Device::CreateCommandBuffers(Vulkan::Device::DeviceState const & kDeviceState, VkCommandBufferLevel const kCommandBufferLevel, uint32 const kCommandBufferCount, std::vector<VkCommandBuffer> & OutputCommandBuffers)
+{
+    Vulkan::Device::CreateCommandBuffers(kDeviceState, kDeviceState.CommandPool, kCommandBufferLevel, kCommandBufferCount, OutputCommandBuffers);
+}
+
+void Vulkan::Device::CreateCommandBuffers(Vulkan::Device::DeviceState const & kDeviceState, VkCommandPool const kCommandPool, VkCommandBufferLevel const kCommandBufferLevel, uint32 const kCommandBufferCount, std::vector<VkCommandBuffer> & OutputCommandBuffers)
 {
     std::vector CommandBuffers = std::vector<VkCommandBuffer>(kCommandBufferCount);
 
-    VkCommandBufferAllocateInfo const kAllocateInfo = Vulkan::CommandBufferAllocateInfo(kDeviceState.CommandPool, kCommandBufferCount, kCommandBufferLevel);
+    VkCommandBufferAllocateInfo const kAllocateInfo = Vulkan::CommandBufferAllocateInfo(kCommandPool, kCommandBufferCount, kCommandBufferLevel);
 
     VERIFY_VKRESULT(vkAllocateCommandBuffers(kDeviceState.Device, &kAllocateInfo, CommandBuffers.data()));
 
@@ -444,7 +539,7 @@ void Vulkan::Device::CreateFrameBuffer(Vulkan::Device::DeviceState const & kDevi
     VkFramebuffer NewFrameBuffer = {};
     VERIFY_VKRESULT(vkCreateFramebuffer(kDeviceState.Device, &kCreateInfo, nullptr, &NewFrameBuffer));
 
-    uint32 const kNewFrameBufferHandle = { FrameBufferManager.Resources.Add(NewFrameBuffer) + 1u };
+    uint32 const kNewFrameBufferHandle = { FrameBufferManager.Resources.Add(NewFrameBuffer) };
 
     OutputFrameBufferHandle = kNewFrameBufferHandle;
 }
@@ -489,7 +584,7 @@ void Vulkan::Device::CreateBuffer(Vulkan::Device::DeviceState const & kDeviceSta
 
     VERIFY_VKRESULT(vkBindBufferMemory(kDeviceState.Device, NewBuffer.Resource, AllocationInfo.DeviceMemory, AllocationInfo.OffsetInBytes));
 
-    uint32 const kNewBufferHandle = { BufferManager.Resources.Add(NewBuffer) + 1u };
+    uint32 const kNewBufferHandle = { BufferManager.Resources.Add(NewBuffer) };
 
     OutputBufferHandle = kNewBufferHandle;
 }
@@ -512,7 +607,7 @@ void Vulkan::Device::CreateBuffer(Vulkan::Device::DeviceState const & kDeviceSta
 
     VERIFY_VKRESULT(vkBindBufferMemory(kDeviceState.Device, NewBuffer.Resource, AllocationInfo.DeviceMemory, AllocationInfo.OffsetInBytes));
 
-    uint32 const kNewBufferHandle = { BufferManager.Resources.Add(NewBuffer) + 1u };
+    uint32 const kNewBufferHandle = { BufferManager.Resources.Add(NewBuffer) };
 
     OutputBufferHandle = kNewBufferHandle;
 }
@@ -562,7 +657,7 @@ void Vulkan::Device::CreateImage(Vulkan::Device::DeviceState const & kDeviceStat
 
     VERIFY_VKRESULT(vkBindImageMemory(kDeviceState.Device, NewImage.Resource, AllocationInfo.DeviceMemory, AllocationInfo.OffsetInBytes));
 
-    uint32 const kNewImageHandle = { ImageManager.Resources.Add(NewImage) + 1u };
+    uint32 const kNewImageHandle = { ImageManager.Resources.Add(NewImage) };
 
     OutputImageHandle = kNewImageHandle;
 }
@@ -604,7 +699,7 @@ void Vulkan::Device::CreateImageView(Vulkan::Device::DeviceState const & kDevice
     VkImageView NewImageView = {};  
     VERIFY_VKRESULT(vkCreateImageView(kDeviceState.Device, &CreateInfo, nullptr, &NewImageView));
 
-    uint32 const kNewImageViewHandle = { ImageViewManager.Resources.Add(NewImageView) + 1u };
+    uint32 const kNewImageViewHandle = { ImageViewManager.Resources.Add(NewImageView) };
 
     OutputImageViewHandle = kNewImageViewHandle;
 }
@@ -639,67 +734,52 @@ void Vulkan::Device::DestroyUnusedResources(Vulkan::Device::DeviceState const &
 
 bool const Vulkan::Resource::GetBuffer(uint32 const kBufferHandle, Vulkan::Resource::Buffer & OutputBuffer)
 {
-    if (kBufferHandle == 0u)
+    if (!BufferManager.Resources.Contains(kBufferHandle))
     {
-        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("GetBuffer: Invalid buffer handle. Cannot get buffer for NULL handle."));
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("GetBuffer: Invalid buffer handle. Cannot get buffer for NULL or stale handle."));
         return false;
     }
 
-    //PBR_ASSERT(kBufferHandle <= BufferManager.Resources.size());
-
-    uint32 const kBufferIndex = { kBufferHandle - 1u };
-    OutputBuffer = BufferManager.Resources [kBufferIndex];
+    OutputBuffer = BufferManager.Resources [kBufferHandle];
 
     return true;
 }
 
 bool const Vulkan::Resource::GetImage(uint32 const kImageHandle, Vulkan::Resource::Image & OutputImage)
 {
-    if (kImageHandle == 0u)
+    if (!ImageManager.Resources.Contains(kImageHandle))
     {
-        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("GetImage: Invalid image handle. Cannot get image for NULL handle."));
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("GetImage: Invalid image handle. Cannot get image for NULL or stale handle."));
         return false;
     }
 
-    //PBR_ASSERT(kImageHandle <= ImageManager.Resources.size());
-
-    uint32 const kImageIndex = { kImageHandle - 1u };
-
-    OutputImage = ImageManager.Resources [kImageIndex];
+    OutputImage = ImageManager.Resources [kImageHandle];
 
     return true;
 }
 
 bool const Vulkan::Resource::GetImageView(uint32 const kImageViewHandle, VkImageView & OutputImageView)
 {
-    if (kImageViewHandle == 0u)
+    if (!ImageViewManager.Resources.Contains(kImageViewHandle))
     {
-        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("GetImageView: Invalid image view handle. Cannot get image view for NULL handle."));
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("GetImageView: Invalid image view handle. Cannot get image view for NULL or stale handle."));
         return false;
     }
 
-    //PBR_ASSERT(kImageViewHandle <= ImageViewManager.Resources.size());
-
-    uint32 const kImageViewIndex = { kImageViewHandle - 1u };
-
-    OutputImageView = ImageViewManager.Resources [kImageViewIndex];
+    OutputImageView = ImageViewManager.Resources [kImageViewHandle];
 
     return true;
 }
 
 bool const Vulkan::Resource::GetFrameBuffer(uint32 const kFrameBufferHandle, VkFramebuffer & OutputFrameBuffer)
 {
-    if (kFrameBufferHandle == 0u)
+    if (!FrameBufferManager.Resources.Contains(kFrameBufferHandle))
     {
-        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("GetFrameBuffer: Invalid frame buffer handle. Cannot get frame buffer for NULL handle."));
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("GetFrameBuffer: Invalid frame buffer handle. Cannot get frame buffer for NULL or stale handle."));
         return false;
     }
 
-    //PBR_ASSERT(kFrameBufferHandle <= FrameBufferManager.Resources.size());
-
-    uint32 const kFrameBufferIndex = { kFrameBufferHandle - 1u };
-
-    OutputFrameBuffer = FrameBufferManager.Resources [kFrameBufferIndex];
+    OutputFrameBuffer = FrameBufferManager.Resources [kFrameBufferHandle];
 
     return true;
 }
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "Graphics/PipelineCache.hpp"
+
+#include "Graphics/Device.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+static bool const ReadCacheFile(std::filesystem::path const & kFilePath, std::vector<std::byte> & OutputCacheData)
+{
+    std::ifstream FileStream = std::ifstream(kFilePath, std::ios::binary | std::ios::ate);
+
+    if (!FileStream)
+    {
+        return false;
+    }
+
+    OutputCacheData.resize(static_cast<std::size_t>(FileStream.tellg()));
+
+    FileStream.seekg(0);
+    FileStream.read(reinterpret_cast<char *>(OutputCacheData.data()), static_cast<std::streamsize>(OutputCacheData.size()));
+
+    return static_cast<bool>(FileStream);
+}
+
+/* Written to a temporary file first, so a failed write can't leave a truncated cache behind */
+static bool const WriteCacheFile(std::filesystem::path const & kFilePath, std::vector<std::byte> const & kCacheData)
+{
+    std::filesystem::path TemporaryFilePath = kFilePath;
+    TemporaryFilePath += ".tmp";
+
+    {
+        std::ofstream FileStream = std::ofstream(TemporaryFilePath, std::ios::binary | std::ios::trunc);
+        FileStream.write(reinterpret_cast<char const *>(kCacheData.data()), static_cast<std::streamsize>(kCacheData.size()));
+
+        if (!FileStream)
+        {
+            return false;
+        }
+    }
+
+    std::error_code ErrorCode = {};
+    std::filesystem::rename(TemporaryFilePath, kFilePath, ErrorCode);
+
+    return !ErrorCode;
+}
+
+bool const Vulkan::PipelineCache::IsCacheDataValid(VkPhysicalDeviceProperties const & kDeviceProperties, std::vector<std::byte> const & kCacheData)
+{
+    VkPipelineCacheHeaderVersionOne Header = {};
+
+    if (kCacheData.size() < sizeof(Header))
+    {
+        return false;
+    }
+
+    ::memcpy_s(&Header, sizeof(Header), kCacheData.data(), sizeof(Header));
+
+    return Header.headerSize >= sizeof(Header)
+           && Header.headerSize <= kCacheData.size()
+           && Header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+           && Header.vendorID == kDeviceProperties.vendorID
+           && Header.deviceID == kDeviceProperties.deviceID
+           && ::memcmp(Header.pipelineCacheUUID, kDeviceProperties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+bool const Vulkan::PipelineCache::CreatePipelineCache(Vulkan::Device::DeviceState const & kDeviceState, std::filesystem::path const & kFilePath, VkPipelineCache & OutputPipelineCache)
+{
+    std::vector<std::byte> CacheData = {};
+
+    if (::ReadCacheFile(kFilePath, CacheData) && !Vulkan::PipelineCache::IsCacheDataValid(kDeviceState.PhysicalDeviceProperties, CacheData))
+    {
+        Logging::Log(Logging::LogTypes::Info, PBR_TEXT("Pipeline cache was written by a different device or driver, starting with an empty cache."));
+        CacheData.clear();
+    }
+
+    VkPipelineCacheCreateInfo const kCreateInfo =
+    {
+        VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        nullptr,
+        0u,
+        CacheData.size(),
+        CacheData.data(),
+    };
+
+    VkResult const kResult = vkCreatePipelineCache(kDeviceState.Device, &kCreateInfo, nullptr, &OutputPipelineCache);
+
+    if (kResult != VK_SUCCESS)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to create pipeline cache."));
+        OutputPipelineCache = VK_NULL_HANDLE;
+        return false;
+    }
+
+    return true;
+}
+
+bool const Vulkan::PipelineCache::DestroyPipelineCache(Vulkan::Device::DeviceState const & kDeviceState, std::filesystem::path const & kFilePath, VkPipelineCache & PipelineCache)
+{
+    if (PipelineCache == VK_NULL_HANDLE)
+    {
+        return false;
+    }
+
+    bool bResult = false;
+
+    std::size_t CacheSizeInBytes = {};
+
+    if (vkGetPipelineCacheData(kDeviceState.Device, PipelineCache, &CacheSizeInBytes, nullptr) == VK_SUCCESS && CacheSizeInBytes > 0u)
+    {
+        std::vector<std::byte> CacheData = std::vector<std::byte>(CacheSizeInBytes);
+
+        /* VK_INCOMPLETE would mean only part of the cache was written, which isn't worth saving */
+        if (vkGetPipelineCacheData(kDeviceState.Device, PipelineCache, &CacheSizeInBytes, CacheData.data()) == VK_SUCCESS)
+        {
+            CacheData.resize(CacheSizeInBytes);
+            bResult = ::WriteCacheFile(kFilePath, CacheData);
+        }
+    }
+
+    if (!bResult)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to save pipeline cache."));
+    }
+
+    vkDestroyPipelineCache(kDeviceState.Device, PipelineCache, nullptr);
+    PipelineCache = VK_NULL_HANDLE;
+
+    return bResult;
+}
\ No newline at end of file
@@ -0,0 +1,329 @@
+#include "Graphics/Pipelines.hpp"
+
+#include "Graphics/Device.hpp"
+#include "Graphics/ShaderLibrary.hpp"
+#include "Jobs.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Vulkan::Pipelines::Private
+{
+    enum class PipelineStatus : uint8
+    {
+        WaitingForShaders,
+        Compiling,
+        Ready,
+        Failed,
+    };
+
+    /* Entries never move, so compile jobs can write to them while more pipelines are requested */
+    struct PipelineEntry
+    {
+        Types::GraphicsPipelineDescription Description = {};
+        std::vector<std::byte> Key = {};
+
+        VkShaderModule VertexShaderModule = {};
+        VkShaderModule FragmentShaderModule = {};
+
+        /* Only written by the compile job before the status is set to Ready */
+        VkPipeline Pipeline = {};
+
+        std::atomic<PipelineStatus> Status = {};
+    };
+
+    static uint16 const kMaximumPipelineCount = { 64u };
+    static uint32 const kMaximumColourAttachmentCount = { 8u };
+
+    static uint64 const kFNVOffsetBasis = { 14695981039346656037u };
+    static uint64 const kFNVPrime = { 1099511628211u };
+
+    static char const * const kShaderEntryPointName = "main";
+
+    static VkDevice Device = {};
+    static VkPipelineCache PipelineCache = {};
+
+    static std::array<PipelineEntry, kMaximumPipelineCount> Pipelines = {};
+    static uint16 PipelineCount = {};
+
+    /* Keyed by the hash of the description, entries with the same hash are told apart by their keys */
+    static std::unordered_multimap<uint64, uint16> HashToPipelineIndex = {};
+
+    static std::vector<uint16> WaitingPipelineIndices = {};
+
+    static Jobs::Types::Counter PendingCompilationCounter = {};
+}
+
+template<typename ValueType>
+static void WriteValue(std::vector<std::byte> & OutputKey, ValueType const & kValue)
+{
+    std::byte const * const kBytes = reinterpret_cast<std::byte const *>(&kValue);
+    OutputKey.insert(OutputKey.end(), kBytes, kBytes + sizeof(kValue));
+}
+
+/* Written member by member, so padding and unused array entries don't end up in the key */
+static void BuildKey(Vulkan::Pipelines::Types::GraphicsPipelineDescription const & kDescription, std::vector<std::byte> & OutputKey)
+{
+    ::WriteValue(OutputKey, kDescription.PipelineLayout);
+    ::WriteValue(OutputKey, kDescription.RenderPass);
+    ::WriteValue(OutputKey, kDescription.SubpassIndex);
+    ::WriteValue(OutputKey, kDescription.VertexShaderHandle);
+    ::WriteValue(OutputKey, kDescription.FragmentShaderHandle);
+
+    ::WriteValue(OutputKey, kDescription.VertexBindingCount);
+
+    for (uint32 BindingIndex = {};
+         BindingIndex < kDescription.VertexBindingCount;
+         BindingIndex++)
+    {
+        ::WriteValue(OutputKey, kDescription.VertexBindings [BindingIndex]);
+    }
+
+    ::WriteValue(OutputKey, kDescription.VertexAttributeCount);
+
+    for (uint32 AttributeIndex = {};
+         AttributeIndex < kDescription.VertexAttributeCount;
+         AttributeIndex++)
+    {
+        ::WriteValue(OutputKey, kDescription.VertexAttributes [AttributeIndex]);
+    }
+
+    ::WriteValue(OutputKey, kDescription.CullMode);
+    ::WriteValue(OutputKey, kDescription.ColourAttachmentCount);
+    ::WriteValue(OutputKey, kDescription.ColourBlendState);
+    ::WriteValue(OutputKey, kDescription.bDepthTestEnable);
+    ::WriteValue(OutputKey, kDescription.bDepthWriteEnable);
+    ::WriteValue(OutputKey, kDescription.DepthCompareOp);
+}
+
+/* FNV-1a */
+static uint64 const HashKey(std::vector<std::byte> const & kKey)
+{
+    using namespace Vulkan::Pipelines;
+
+    uint64 Hash = { Private::kFNVOffsetBasis };
+
+    for (std::byte const kByte : kKey)
+    {
+        Hash ^= static_cast<uint64>(kByte);
+        Hash *= Private::kFNVPrime;
+    }
+
+    return Hash;
+}
+
+static void CompilePipelineJob(void * Data)
+{
+    using namespace Vulkan::Pipelines;
+
+    Private::PipelineEntry & Entry = *static_cast<Private::PipelineEntry *>(Data);
+    Types::GraphicsPipelineDescription const & kDescription = Entry.Description;
+
+    std::array<VkPipelineShaderStageCreateInfo, 2u> const kShaderStages =
+    {
+        Vulkan::PipelineShaderStage(VK_SHADER_STAGE_VERTEX_BIT, Entry.VertexShaderModule, Private::kShaderEntryPointName),
+        Vulkan::PipelineShaderStage(VK_SHADER_STAGE_FRAGMENT_BIT, Entry.FragmentShaderModule, Private::kShaderEntryPointName),
+    };
+
+    uint32 const kShaderStageCount = { Entry.FragmentShaderModule != VK_NULL_HANDLE ? 2u : 1u };
+
+    VkPipelineVertexInputStateCreateInfo const kVertexInputState = Vulkan::VertexInputState(kDescription.VertexBindingCount, kDescription.VertexBindings.data(),
+                                                                                            kDescription.VertexAttributeCount, kDescription.VertexAttributes.data());
+
+    VkPipelineInputAssemblyStateCreateInfo const kInputAssemblerState = Vulkan::InputAssemblyState();
+
+    VkPipelineRasterizationStateCreateInfo const kRasterizationState = Vulkan::RasterizationState(kDescription.CullMode);
+
+    std::array<VkPipelineColorBlendAttachmentState, Private::kMaximumColourAttachmentCount> ColourAttachmentStates = {};
+    ColourAttachmentStates.fill(kDescription.ColourBlendState);
+
+    VkPipelineColorBlendStateCreateInfo const kColourBlendState = Vulkan::ColourBlendState(kDescription.ColourAttachmentCount, ColourAttachmentStates.data());
+
+    VkPipelineDepthStencilStateCreateInfo const kDepthStencilState = Vulkan::DepthStencilState(kDescription.bDepthTestEnable, kDescription.bDepthWriteEnable, kDescription.DepthCompareOp);
+    VkPipelineMultisampleStateCreateInfo const kMultiSampleState = Vulkan::MultiSampleState();
+
+    VkPipelineViewportStateCreateInfo const kViewportState = Vulkan::ViewportState(1u, nullptr, 1u, nullptr);
+
+    std::array<VkDynamicState, 2u> const kDynamicStates =
+    {
+        VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR,
+    };
+
+    VkPipelineDynamicStateCreateInfo const kDynamicState = Vulkan::DynamicState(static_cast<uint32>(kDynamicStates.size()), kDynamicStates.data());
+
+    VkGraphicsPipelineCreateInfo const kCreateInfo = Vulkan::GraphicsPipelineState(kDescription.PipelineLayout, kDescription.RenderPass, kDescription.SubpassIndex,
+                                                                                   kShaderStageCount, kShaderStages.data(),
+                                                                                   &kVertexInputState, &kInputAssemblerState, &kViewportState,
+                                                                                   &kRasterizationState, &kColourBlendState, &kDepthStencilState, &kDynamicState, &kMultiSampleState);
+
+    /* The pipeline cache is internally synchronised, so jobs can create pipelines at the same time */
+    if (vkCreateGraphicsPipelines(Private::Device, Private::PipelineCache, 1u, &kCreateInfo, nullptr, &Entry.Pipeline) == VK_SUCCESS)
+    {
+        Entry.Status.store(Private::PipelineStatus::Ready, std::memory_order_release);
+    }
+    else
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to create graphics pipeline."));
+        Entry.Status.store(Private::PipelineStatus::Failed, std::memory_order_release);
+    }
+}
+
+/* Creating the modules doesn't block once the shaders are ready */
+static bool const CreateShaderModules(Vulkan::Device::DeviceState const & kDeviceState, Vulkan::Pipelines::Private::PipelineEntry & Entry)
+{
+    bool bResult = ShaderLibrary::CreateShaderModule(kDeviceState, Entry.Description.VertexShaderHandle, Entry.VertexShaderModule)
+                   && Entry.VertexShaderModule != VK_NULL_HANDLE;
+
+    if (bResult && Entry.Description.FragmentShaderHandle != 0u)
+    {
+        bResult = ShaderLibrary::CreateShaderModule(kDeviceState, Entry.Description.FragmentShaderHandle, Entry.FragmentShaderModule)
+                  && Entry.FragmentShaderModule != VK_NULL_HANDLE;
+    }
+
+    return bResult;
+}
+
+void Vulkan::Pipelines::Initialise(Vulkan::Device::DeviceState const & kDeviceState, VkPipelineCache const kPipelineCache)
+{
+    Private::Device = kDeviceState.Device;
+    Private::PipelineCache = kPipelineCache;
+}
+
+void Vulkan::Pipelines::Destroy(Vulkan::Device::DeviceState const & kDeviceState)
+{
+    Jobs::WaitForCounter(Private::PendingCompilationCounter);
+
+    for (uint16 PipelineIndex = {};
+         PipelineIndex < Private::PipelineCount;
+         PipelineIndex++)
+    {
+        Private::PipelineEntry & Entry = Private::Pipelines [PipelineIndex];
+
+        if (Entry.Status.load(std::memory_order_acquire) == Private::PipelineStatus::Ready)
+        {
+            vkDestroyPipeline(kDeviceState.Device, Entry.Pipeline, nullptr);
+        }
+
+        Entry.Pipeline = VK_NULL_HANDLE;
+        Entry.Status.store(Private::PipelineStatus::Failed, std::memory_order_relaxed);
+    }
+
+    Private::HashToPipelineIndex.clear();
+    Private::WaitingPipelineIndices.clear();
+    Private::PipelineCount = 0u;
+}
+
+bool const Vulkan::Pipelines::RequestGraphicsPipeline(Types::GraphicsPipelineDescription const & kDescription, uint16 & OutputPipelineHandle)
+{
+    if (kDescription.VertexShaderHandle == 0u)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot request a graphics pipeline without a vertex shader."));
+        return false;
+    }
+
+    if (kDescription.VertexBindingCount > Types::kMaximumVertexBindingCount
+        || kDescription.VertexAttributeCount > Types::kMaximumVertexAttributeCount
+        || kDescription.ColourAttachmentCount > Private::kMaximumColourAttachmentCount)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Graphics pipeline description has too many vertex inputs or colour attachments."));
+        return false;
+    }
+
+    std::vector<std::byte> Key = {};
+    ::BuildKey(kDescription, Key);
+
+    uint64 const kHash = ::HashKey(Key);
+
+    auto const [kFirstMatch, kEndMatch] = Private::HashToPipelineIndex.equal_range(kHash);
+
+    for (auto Match = kFirstMatch;
+         Match != kEndMatch;
+         Match++)
+    {
+        if (Private::Pipelines [Match->second].Key == Key)
+        {
+            OutputPipelineHandle = Match->second + 1u;
+            return true;
+        }
+    }
+
+    if (Private::PipelineCount == Private::kMaximumPipelineCount)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Too many graphics pipelines requested."));
+        return false;
+    }
+
+    uint16 const kPipelineIndex = { Private::PipelineCount++ };
+
+    Private::PipelineEntry & Entry = Private::Pipelines [kPipelineIndex];
+    Entry.Description = kDescription;
+    Entry.Key = std::move(Key);
+    Entry.VertexShaderModule = VK_NULL_HANDLE;
+    Entry.FragmentShaderModule = VK_NULL_HANDLE;
+    Entry.Pipeline = VK_NULL_HANDLE;
+    Entry.Status.store(Private::PipelineStatus::WaitingForShaders, std::memory_order_relaxed);
+
+    Private::HashToPipelineIndex.emplace(kHash, kPipelineIndex);
+    Private::WaitingPipelineIndices.push_back(kPipelineIndex);
+
+    OutputPipelineHandle = kPipelineIndex + 1u;
+
+    return true;
+}
+
+void Vulkan::Pipelines::Update(Vulkan::Device::DeviceState const & kDeviceState)
+{
+    auto const kFirstStillWaiting = std::remove_if(Private::WaitingPipelineIndices.begin(), Private::WaitingPipelineIndices.end(),
+                                                   [&kDeviceState](uint16 const kPipelineIndex)
+                                                   {
+                                                       Private::PipelineEntry & Entry = Private::Pipelines [kPipelineIndex];
+
+                                                       bool const kbShadersReady = ShaderLibrary::IsShaderReady(Entry.Description.VertexShaderHandle)
+                                                                                   && (Entry.Description.FragmentShaderHandle == 0u || ShaderLibrary::IsShaderReady(Entry.Description.FragmentShaderHandle));
+
+                                                       if (!kbShadersReady)
+                                                       {
+                                                           return false;
+                                                       }
+
+                                                       if (!::CreateShaderModules(kDeviceState, Entry))
+                                                       {
+                                                           Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to create shader modules for graphics pipeline."));
+                                                           Entry.Status.store(Private::PipelineStatus::Failed, std::memory_order_relaxed);
+                                                           return true;
+                                                       }
+
+                                                       Entry.Status.store(Private::PipelineStatus::Compiling, std::memory_order_relaxed);
+
+                                                       Jobs::SubmitBackground(Jobs::Types::Job { &::CompilePipelineJob, &Entry, &Private::PendingCompilationCounter });
+
+                                                       return true;
+                                                   });
+
+    Private::WaitingPipelineIndices.erase(kFirstStillWaiting, Private::WaitingPipelineIndices.end());
+}
+
+bool const Vulkan::Pipelines::GetPipeline(uint16 const kPipelineHandle, VkPipeline & OutputPipeline)
+{
+    if (kPipelineHandle == 0u || kPipelineHandle > Private::PipelineCount)
+    {
+        return false;
+    }
+
+    Private::PipelineEntry const & kEntry = Private::Pipelines [kPipelineHandle - 1u];
+
+    /* Pairs with the release in the compile job, so the pipeline handle is visible */
+    if (kEntry.Status.load(std::memory_order_acquire) != Private::PipelineStatus::Ready)
+    {
+        return false;
+    }
+
+    OutputPipeline = kEntry.Pipeline;
+
+    return true;
+}
\ No newline at end of file
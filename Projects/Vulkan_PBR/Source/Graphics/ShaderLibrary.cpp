@@ -3,12 +3,14 @@
 #include "ShaderCompiler/ShaderCompiler.hpp"
 
 #include "Graphics/Device.hpp"
+#include "Jobs.hpp"
+#include "Names.hpp"
 
+#include <chrono>
+#include <future>
+#include <memory>
 #include <vector>
 #include <sstream>
-#include <queue>
-#include <mutex>
-#include <condition_variable>
 
 using namespace Platform::Windows;
 using namespace Platform::Windows::Types;
@@ -27,7 +29,8 @@ struct ShaderData
 
 struct ShaderCollection
 {
-    std::unordered_map<std::string, uint16> ShaderPathToIndex = {};
+    /* Keyed by the name ID of the file name, followed by any defines */
+    std::unordered_map<uint32, uint16> ShaderPathToIndex = {};
 
     std::unordered_map<uint16, std::future<ShaderData>> PendingShaders = {};
 
@@ -44,78 +47,7 @@ static std::filesystem::path const kShaderDirectoryPath = std::filesystem::curre
 
 static ShaderCollection Shaders;
 
-namespace ShaderCompilationThread
-{
-    struct CompileTaskParameters
-    {
-        std::filesystem::path ShaderFilePath;
-    };
-
-    using CompileTask = std::packaged_task<ShaderData(CompileTaskParameters const &)>;
-
-    static std::wstring const kThreadName = L"Shader Compilation Thread";
-
-    static std::thread Thread;
-
-    static std::atomic_bool bStopThread;
-
-    static std::mutex WorkQueueMutex;
-    static std::condition_variable WorkCondition;
-
-    static std::queue<CompileTaskParameters> TaskParameterQueue;
-    static std::queue<CompileTask> TaskQueue;
-
-    static void Main()
-    {
-        while (!bStopThread)
-        {
-            CompileTaskParameters CurrentTaskParameters;
-            CompileTask CurrentTask;
-
-            {
-                std::unique_lock QueueLock = std::unique_lock(WorkQueueMutex);
-
-                WorkCondition.wait(QueueLock,
-                                   []()
-                                   {
-                                       return TaskQueue.size() > 0u || bStopThread;
-                                   });
-
-                if (TaskQueue.size() > 0u)
-                {
-                    CurrentTaskParameters = std::move(TaskParameterQueue.front());
-                    CurrentTask = std::move(TaskQueue.front());
-
-                    TaskParameterQueue.pop();
-                    TaskQueue.pop();
-                }
-            }
-
-            if (CurrentTask.valid())
-            {
-                CurrentTask(CurrentTaskParameters);
-            }
-        }
-    }
-
-    static void Start()
-    {
-        bStopThread = false;
-        Thread = std::thread(Main);
-
-        SetThreadDescription(Thread.native_handle(), kThreadName.c_str());
-    }
-
-    static void Stop()
-    {
-        bStopThread = true;
-        WorkCondition.notify_one();
-
-        Thread.join();
-    }
-}
-
-static ShaderData CompileShader(std::filesystem::path const FilePath)
+static ShaderData CompileShader(std::filesystem::path const FilePath, std::vector<std::string> const & Defines)
 {
     ShaderData CompiledOutput = {};
 
@@ -124,7 +56,7 @@ static ShaderData CompileShader(std::filesystem::path const FilePath)
     while (!bShaderCompiledSuccessfully)
     {
         std::basic_string<Char> ErrorMessage = {};
-        bShaderCompiledSuccessfully = ShaderCompiler::CompileShader(FilePath, CompiledOutput.ByteCode, CompiledOutput.ByteCodeSizeInBytes, ErrorMessage);
+        bShaderCompiledSuccessfully = ShaderCompiler::CompileShader(FilePath, Defines, CompiledOutput.ByteCode, CompiledOutput.ByteCodeSizeInBytes, ErrorMessage);
 
         if (!bShaderCompiledSuccessfully)
         {
@@ -148,6 +80,24 @@ static ShaderData CompileShader(std::filesystem::path const FilePath)
     return CompiledOutput;
 }
 
+/* Compilation runs as a background job, the result is handed back through the promise */
+struct CompileJobData
+{
+    std::filesystem::path ShaderFilePath;
+    std::vector<std::string> Defines;
+    std::promise<ShaderData> Result;
+};
+
+/* Shaders still compiling when the library is destroyed have to finish before the compiler is shut down */
+static Jobs::Types::Counter PendingCompilationCounter = {};
+
+static void CompileShaderJob(void * Data)
+{
+    std::unique_ptr<CompileJobData> const kJobData = std::unique_ptr<CompileJobData>(static_cast<CompileJobData *>(Data));
+
+    kJobData->Result.set_value(::CompileShader(kJobData->ShaderFilePath, kJobData->Defines));
+}
+
 static bool const WaitForShaderToLoad(uint16 const ShaderIndex)
 {
     ShaderData CompilerOutput = Shaders.PendingShaders [ShaderIndex].get();
@@ -164,27 +114,38 @@ bool const ShaderLibrary::Initialise()
 {
     bool bResult = ShaderCompiler::Initialise();
 
-    ShaderCompilationThread::Start();
-
     return bResult;
 }
 
 void ShaderLibrary::Destroy()
 {
-    ShaderCompilationThread::Stop();
+    Jobs::WaitForCounter(PendingCompilationCounter);
 
     ShaderCompiler::Destroy();
 }
 
 bool const ShaderLibrary::LoadShader(std::filesystem::path const FilePath, uint16 & OutputShaderHandle)
+{
+    return ShaderLibrary::LoadShader(FilePath, std::vector<std::string> {}, OutputShaderHandle);
+}
+
+bool const ShaderLibrary::LoadShader(std::filesystem::path const FilePath, std::vector<std::string> const & Defines, uint16 & OutputShaderHandle)
 {
     bool bResult = false;
     uint16 NewShaderHandle = {};
 
     std::filesystem::path const ShaderFilePath = kShaderDirectoryPath / FilePath;
-    std::string const ShaderFileName = FilePath.filename().string();
 
-    auto FoundShaderIndex = Shaders.ShaderPathToIndex.find(ShaderFileName);
+    std::string ShaderName = FilePath.filename().generic_string();
+
+    for (std::string const & Define : Defines)
+    {
+        ShaderName += "|" + Define;
+    }
+
+    uint32 const kShaderFileNameID = Names::Intern(ShaderName);
+
+    auto FoundShaderIndex = Shaders.ShaderPathToIndex.find(kShaderFileNameID);
 
     if (FoundShaderIndex != Shaders.ShaderPathToIndex.end())
     {
@@ -202,26 +163,16 @@ bool const ShaderLibrary::LoadShader(std::filesystem::path const FilePath, uint1
             NewShaderHandle = static_cast<uint16>(Shaders.ShaderModules.size());
 
             uint16 const NewShaderIndex = { NewShaderHandle - 1u };
-            Shaders.ShaderPathToIndex [ShaderFileName] = NewShaderIndex;
+            Shaders.ShaderPathToIndex [kShaderFileNameID] = NewShaderIndex;
 
-            ShaderCompilationThread::CompileTask NewTask = ShaderCompilationThread::CompileTask(
-                [](ShaderCompilationThread::CompileTaskParameters const & Parameters)
-                {
-                    return ::CompileShader(Parameters.ShaderFilePath);
-                });
+            CompileJobData * const kJobData = new CompileJobData { ShaderFilePath, Defines, std::promise<ShaderData>() };
 
-            Shaders.PendingShaders [NewShaderIndex] = NewTask.get_future();
+            Shaders.PendingShaders [NewShaderIndex] = kJobData->Result.get_future();
             Shaders.ShaderStatusFlags [NewShaderIndex].bPendingCompilation = true;
 
-            {
-                std::scoped_lock QueueLock = std::scoped_lock(ShaderCompilationThread::WorkQueueMutex);
+            /* Can block on a message box if compilation fails, so it must not hold up per-frame jobs */
+            Jobs::SubmitBackground(Jobs::Types::Job { &::CompileShaderJob, kJobData, &PendingCompilationCounter });
 
-                ShaderCompilationThread::TaskParameterQueue.emplace(std::move(ShaderCompilationThread::CompileTaskParameters { std::move(ShaderFilePath) }));
-                ShaderCompilationThread::TaskQueue.emplace(std::move(NewTask));
-            }
-
-            ShaderCompilationThread::WorkCondition.notify_one();
-            
             bResult = true;
         }
     }
@@ -231,6 +182,25 @@ bool const ShaderLibrary::LoadShader(std::filesystem::path const FilePath, uint1
     return bResult;
 }
 
+bool const ShaderLibrary::IsShaderReady(uint16 const ShaderHandle)
+{
+    if (ShaderHandle == 0u)
+    {
+        return false;
+    }
+
+    uint16 const ShaderIndex = ShaderHandle - 1u;
+
+    if (!Shaders.ShaderStatusFlags [ShaderIndex].bPendingCompilation)
+    {
+        return true;
+    }
+
+    auto const FoundShader = Shaders.PendingShaders.find(ShaderIndex);
+
+    return FoundShader != Shaders.PendingShaders.end() && FoundShader->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
 bool const ShaderLibrary::CreateShaderModule(Vulkan::Device::DeviceState const & DeviceState, uint16 const ShaderHandle, VkShaderModule & OutputShaderModule)
 {
     if (ShaderHandle == 0u)
@@ -168,7 +168,7 @@ bool const Vulkan::Viewport::CreateViewport(Vulkan::Instance::InstanceState cons
     return bResult;
 }
 
-bool const Vulkan::Viewport::ResizeViewport(Vulkan::Instance::InstanceState const & InstanceState, Vulkan::Device::DeviceState const & DeviceState, Vulkan::Viewport::ViewportState & State)
+bool const Vulkan::Viewport::ResizeViewport(Vulkan::Instance::InstanceState const & InstanceState, Vulkan::Device::DeviceState const & DeviceState, VkExtent2D const & WindowExtents, Vulkan::Viewport::ViewportState & State)
 {
     bool bResult = false;
 
@@ -190,11 +190,7 @@ bool const Vulkan::Viewport::ResizeViewport(Vulkan::Instance::InstanceState cons
 
         Vulkan::Viewport::ViewportState IntermediateState = {};
 
-        VkExtent2D NewImageExtents = {};
-        NewImageExtents.width = Application::State.CurrentWindowWidth;
-        NewImageExtents.height = Application::State.CurrentWindowHeight;
-
-        IntermediateState.ImageExtents = ::GetSwapChainImageExtents(NewImageExtents, SurfaceCapabilities);
+        IntermediateState.ImageExtents = ::GetSwapChainImageExtents(WindowExtents, SurfaceCapabilities);
         IntermediateState.SurfaceFormat = State.SurfaceFormat;
 
         /* Need to find out whether we should keep track of the old swapchains and destroy them ourselves */
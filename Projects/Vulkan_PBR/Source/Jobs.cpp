@@ -0,0 +1,423 @@
+#include "Jobs.hpp"
+
+#include "Platform/Windows.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace Platform;
+
+namespace Jobs::Private
+{
+    /* The owning thread pushes and pops at the back, other threads steal from the front */
+    struct WorkQueue
+    {
+        std::mutex Mutex = {};
+        std::deque<Types::Job> Jobs = {};
+    };
+
+    struct ParallelForData
+    {
+        Types::ParallelForFunction Function = {};
+        void * Data = {};
+
+        uint32 Count = {};
+        uint32 BatchSize = {};
+
+        std::atomic<uint32> NextIndex = {};
+    };
+
+    static std::wstring const kThreadName = L"Job Worker Thread";
+
+    /* Queue 0 belongs to the thread that called Initialise, the rest belong to the workers */
+    static std::unique_ptr<WorkQueue []> WorkQueues = {};
+    static uint32 WorkQueueCount = {};
+
+    static std::vector<std::thread> Workers = {};
+
+    static std::mutex BackgroundQueueMutex = {};
+    static std::deque<Types::Job> BackgroundJobs = {};
+
+    /* Counts background jobs too, idle workers sleep until this is non-zero */
+    static std::atomic<uint32> QueuedJobCount = {};
+
+    static std::mutex SleepMutex = {};
+    static std::condition_variable WorkCondition = {};
+
+    static std::atomic_bool bStopWorkers = { false };
+
+    static thread_local uint32 CurrentQueueIndex = {};
+}
+
+static void WakeWorkers(uint32 const kJobCount)
+{
+    /* Taking the lock stops a worker missing the notify between checking for work and going to sleep */
+    {
+        std::scoped_lock Lock = std::scoped_lock(Jobs::Private::SleepMutex);
+    }
+
+    if (kJobCount == 1u)
+    {
+        Jobs::Private::WorkCondition.notify_one();
+    }
+    else
+    {
+        Jobs::Private::WorkCondition.notify_all();
+    }
+}
+
+static void PushJobs(Jobs::Types::Job const * const kJobs, uint32 const kJobCount)
+{
+    using namespace Jobs;
+
+    Private::WorkQueue & Queue = Private::WorkQueues [Private::CurrentQueueIndex];
+
+    {
+        std::scoped_lock Lock = std::scoped_lock(Queue.Mutex);
+        Queue.Jobs.insert(Queue.Jobs.end(), kJobs, kJobs + kJobCount);
+    }
+
+    Private::QueuedJobCount.fetch_add(kJobCount, std::memory_order_release);
+
+    ::WakeWorkers(kJobCount);
+}
+
+static void ReleaseDependentJobs(std::vector<Jobs::Types::Job> const & kDependentJobs)
+{
+    if (kDependentJobs.size() > 0u)
+    {
+        ::PushJobs(kDependentJobs.data(), static_cast<uint32>(kDependentJobs.size()));
+    }
+}
+
+static void ExecuteJob(Jobs::Types::Job const & kJob)
+{
+    kJob.Function(kJob.Data);
+
+    if (kJob.SignalCounter)
+    {
+        std::vector<Jobs::Types::Job> DependentJobs = {};
+
+        /* The waiter locks this before returning, so the counter stays alive until the dependent jobs have been taken */
+        {
+            std::scoped_lock Lock = std::scoped_lock(kJob.SignalCounter->DependentJobsMutex);
+
+            if (kJob.SignalCounter->Value.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+            {
+                DependentJobs.swap(kJob.SignalCounter->DependentJobs);
+            }
+        }
+
+        ::ReleaseDependentJobs(DependentJobs);
+    }
+}
+
+static bool const PopJob(Jobs::Private::WorkQueue & Queue, bool const bSteal, Jobs::Types::Job & OutputJob)
+{
+    std::scoped_lock Lock = std::scoped_lock(Queue.Mutex);
+
+    if (Queue.Jobs.size() == 0u)
+    {
+        return false;
+    }
+
+    if (bSteal)
+    {
+        OutputJob = Queue.Jobs.front();
+        Queue.Jobs.pop_front();
+    }
+    else
+    {
+        OutputJob = Queue.Jobs.back();
+        Queue.Jobs.pop_back();
+    }
+
+    return true;
+}
+
+static bool const PopBackgroundJob(Jobs::Types::Job & OutputJob)
+{
+    using namespace Jobs;
+
+    std::scoped_lock Lock = std::scoped_lock(Private::BackgroundQueueMutex);
+
+    if (Private::BackgroundJobs.size() == 0u)
+    {
+        return false;
+    }
+
+    OutputJob = Private::BackgroundJobs.front();
+    Private::BackgroundJobs.pop_front();
+
+    return true;
+}
+
+/* Own queue first (most recently pushed, likely still in cache), then the oldest job from each other queue, then background work */
+static bool const TryRunJob(uint32 const kQueueIndex, bool const bAllowBackgroundJobs)
+{
+    using namespace Jobs;
+
+    if (Private::QueuedJobCount.load(std::memory_order_acquire) == 0u)
+    {
+        return false;
+    }
+
+    Types::Job Job = {};
+
+    bool bFoundJob = ::PopJob(Private::WorkQueues [kQueueIndex], false, Job);
+
+    for (uint32 VictimOffset = { 1u };
+         !bFoundJob && VictimOffset < Private::WorkQueueCount;
+         VictimOffset++)
+    {
+        uint32 const kVictimIndex = (kQueueIndex + VictimOffset) % Private::WorkQueueCount;
+        bFoundJob = ::PopJob(Private::WorkQueues [kVictimIndex], true, Job);
+    }
+
+    if (!bFoundJob && bAllowBackgroundJobs)
+    {
+        bFoundJob = ::PopBackgroundJob(Job);
+    }
+
+    if (bFoundJob)
+    {
+        Private::QueuedJobCount.fetch_sub(1u, std::memory_order_acq_rel);
+        ::ExecuteJob(Job);
+    }
+
+    return bFoundJob;
+}
+
+static void WorkerMain(uint32 const kQueueIndex)
+{
+    using namespace Jobs;
+
+    Private::CurrentQueueIndex = kQueueIndex;
+
+    while (true)
+    {
+        if (::TryRunJob(kQueueIndex, true))
+        {
+            continue;
+        }
+
+        std::unique_lock Lock = std::unique_lock(Private::SleepMutex);
+
+        Private::WorkCondition.wait(Lock,
+                                    []()
+                                    {
+                                        return Private::QueuedJobCount.load(std::memory_order_acquire) > 0u || Private::bStopWorkers;
+                                    });
+
+        /* Workers only exit once everything queued has run */
+        if (Private::bStopWorkers && Private::QueuedJobCount.load(std::memory_order_acquire) == 0u)
+        {
+            break;
+        }
+    }
+}
+
+static void RunParallelForBatches(void * Data)
+{
+    Jobs::Private::ParallelForData & ParallelFor = *static_cast<Jobs::Private::ParallelForData *>(Data);
+
+    for (uint32 FirstIndex = ParallelFor.NextIndex.fetch_add(ParallelFor.BatchSize, std::memory_order_relaxed);
+         FirstIndex < ParallelFor.Count;
+         FirstIndex = ParallelFor.NextIndex.fetch_add(ParallelFor.BatchSize, std::memory_order_relaxed))
+    {
+        ParallelFor.Function(ParallelFor.Data, FirstIndex, std::min(FirstIndex + ParallelFor.BatchSize, ParallelFor.Count));
+    }
+}
+
+bool const Jobs::Initialise(uint32 const WorkerCount)
+{
+    uint32 NewWorkerCount = { WorkerCount };
+
+    if (NewWorkerCount == 0u)
+    {
+        /* hardware_concurrency can return zero, always have at least one worker so background jobs never run on the calling thread */
+        NewWorkerCount = std::max(2u, std::thread::hardware_concurrency()) - 1u;
+    }
+
+    Private::bStopWorkers = false;
+
+    Private::WorkQueueCount = NewWorkerCount + 1u;
+    Private::WorkQueues = std::make_unique<Private::WorkQueue []>(Private::WorkQueueCount);
+
+    Private::CurrentQueueIndex = 0u;
+
+    Private::Workers.reserve(NewWorkerCount);
+
+    for (uint32 WorkerIndex = {};
+         WorkerIndex < NewWorkerCount;
+         WorkerIndex++)
+    {
+        std::thread & Worker = Private::Workers.emplace_back(::WorkerMain, WorkerIndex + 1u);
+
+        std::wstring const kWorkerName = Private::kThreadName + L" " + std::to_wstring(WorkerIndex);
+        Windows::SetThreadDescription(Worker.native_handle(), kWorkerName.c_str());
+    }
+
+    return true;
+}
+
+void Jobs::Destroy()
+{
+    {
+        std::scoped_lock Lock = std::scoped_lock(Private::SleepMutex);
+        Private::bStopWorkers = true;
+    }
+
+    Private::WorkCondition.notify_all();
+
+    for (std::thread & Worker : Private::Workers)
+    {
+        Worker.join();
+    }
+
+    Private::Workers.clear();
+
+    Private::WorkQueues.reset();
+    Private::WorkQueueCount = 0u;
+}
+
+uint32 const Jobs::GetWorkerCount()
+{
+    return static_cast<uint32>(Private::Workers.size());
+}
+
+void Jobs::Submit(Types::Job const & Job)
+{
+    Jobs::Submit(&Job, 1u);
+}
+
+void Jobs::Submit(Types::Job const * const NewJobs, uint32 const JobCount)
+{
+    for (uint32 JobIndex = {};
+         JobIndex < JobCount;
+         JobIndex++)
+    {
+        if (NewJobs [JobIndex].SignalCounter)
+        {
+            NewJobs [JobIndex].SignalCounter->Value.fetch_add(1u, std::memory_order_relaxed);
+        }
+    }
+
+    if (Private::WorkQueueCount == 0u)
+    {
+        for (uint32 JobIndex = {};
+             JobIndex < JobCount;
+             JobIndex++)
+        {
+            ::ExecuteJob(NewJobs [JobIndex]);
+        }
+
+        return;
+    }
+
+    ::PushJobs(NewJobs, JobCount);
+}
+
+void Jobs::SubmitAfter(Types::Counter & DependencyCounter, Types::Job const & Job)
+{
+    if (Job.SignalCounter)
+    {
+        Job.SignalCounter->Value.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    {
+        std::scoped_lock Lock = std::scoped_lock(DependencyCounter.DependentJobsMutex);
+
+        if (DependencyCounter.Value.load(std::memory_order_acquire) > 0u)
+        {
+            DependencyCounter.DependentJobs.push_back(Job);
+            return;
+        }
+    }
+
+    if (Private::WorkQueueCount == 0u)
+    {
+        ::ExecuteJob(Job);
+    }
+    else
+    {
+        ::PushJobs(&Job, 1u);
+    }
+}
+
+void Jobs::SubmitBackground(Types::Job const & Job)
+{
+    if (Job.SignalCounter)
+    {
+        Job.SignalCounter->Value.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    if (Private::WorkQueueCount == 0u)
+    {
+        ::ExecuteJob(Job);
+        return;
+    }
+
+    {
+        std::scoped_lock Lock = std::scoped_lock(Private::BackgroundQueueMutex);
+        Private::BackgroundJobs.push_back(Job);
+    }
+
+    Private::QueuedJobCount.fetch_add(1u, std::memory_order_release);
+
+    ::WakeWorkers(1u);
+}
+
+void Jobs::WaitForCounter(Types::Counter & Counter)
+{
+    while (Counter.Value.load(std::memory_order_acquire) > 0u)
+    {
+        if (Private::WorkQueueCount == 0u || !::TryRunJob(Private::CurrentQueueIndex, false))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    /* The last job to finish may still be releasing dependent jobs */
+    std::scoped_lock Lock = std::scoped_lock(Counter.DependentJobsMutex);
+}
+
+void Jobs::ParallelFor(uint32 const Count, uint32 const BatchSize, Types::ParallelForFunction const Function, void * const Data)
+{
+    if (Count == 0u)
+    {
+        return;
+    }
+
+    uint32 const kBatchSize = std::max(BatchSize, 1u);
+    uint32 const kBatchCount = (Count + kBatchSize - 1u) / kBatchSize;
+
+    /* Not worth waking anyone for a single batch */
+    if (kBatchCount == 1u || Private::WorkQueueCount == 0u)
+    {
+        Function(Data, 0u, Count);
+        return;
+    }
+
+    Private::ParallelForData ParallelForData = {};
+    ParallelForData.Function = Function;
+    ParallelForData.Data = Data;
+    ParallelForData.Count = Count;
+    ParallelForData.BatchSize = kBatchSize;
+
+    Types::Counter Counter = {};
+
+    /* Each helper job keeps pulling batches until there are none left, the calling thread does the same */
+    uint32 const kHelperJobCount = std::min(kBatchCount - 1u, static_cast<uint32>(Private::Workers.size()));
+
+    std::vector<Types::Job> HelperJobs = std::vector<Types::Job>(kHelperJobCount, Types::Job { &::RunParallelForBatches, &ParallelForData, &Counter });
+    Jobs::Submit(HelperJobs.data(), kHelperJobCount);
+
+    ::RunParallelForBatches(&ParallelForData);
+
+    Jobs::WaitForCounter(Counter);
+}
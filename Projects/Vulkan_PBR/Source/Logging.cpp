@@ -1,11 +1,11 @@
 #include "Logging.hpp"
 
 #include "Common.hpp"
+#include "Jobs.hpp"
 
-#include <thread>
 #include <atomic>
 #include <string>
-#include <future>
+#include <mutex>
 #include <array>
 #include <queue>
 #include <fstream>
@@ -14,7 +14,7 @@
 using namespace Platform;
 using namespace Platform::Windows::Types;
 
-namespace LoggingThread
+namespace LoggingOutput
 {
     struct LogMessageData
     {
@@ -22,8 +22,6 @@ namespace LoggingThread
         Logging::LogTypes Type;
     };
 
-    static std::wstring const kThreadName = L"Logging Thread";
-
     static std::array<String, static_cast<uint32>(Logging::LogTypes::TypeCount)> const LogHeaderTable =
     {
         PBR_TEXT("Info"),
@@ -33,12 +31,12 @@ namespace LoggingThread
     static std::queue<LogMessageData> MessageQueue = {};
 
     static std::mutex MessageQueueMutex = {};
-    static std::condition_variable WorkCondition = {};
 
-    static std::atomic_bool bStopThread = { false };
-    static std::atomic_bool bEmptyMessageQueue = { true };
+    /* Only one thread writes at a time so messages come out in the order they were logged */
+    static std::mutex OutputMutex = {};
 
-    static std::thread Thread = {};
+    /* Set while a drain job is waiting to run, so a burst of messages only queues one job */
+    static std::atomic_bool bDrainJobQueued = { false };
 
     static void Log(LogMessageData const & Parameters)
     {
@@ -51,30 +49,24 @@ namespace LoggingThread
         Windows::OutputDebugString(OutputString.Data());
     }
 
-    static void Main()
+    static void Drain()
     {
-        /* TODO: Open a file stream */
+        std::scoped_lock OutputLock = std::scoped_lock(OutputMutex);
 
-        while (!bStopThread)
+        while (true)
         {
             LogMessageData Parameters = {};
 
             {
-                std::unique_lock Lock = std::unique_lock(MessageQueueMutex);
-
-                WorkCondition.wait(Lock,
-                                   []()
-                                   {
-                                       return MessageQueue.size() > 0u || bStopThread;
-                                   });
+                std::scoped_lock Lock = std::scoped_lock(MessageQueueMutex);
 
-                if (MessageQueue.size() > 0u)
+                if (MessageQueue.size() == 0u)
                 {
-                    Parameters = std::move(MessageQueue.front());
-                    MessageQueue.pop();
+                    break;
                 }
 
-                bEmptyMessageQueue.store(MessageQueue.size() == 0u, std::memory_order::memory_order_release);
+                Parameters = std::move(MessageQueue.front());
+                MessageQueue.pop();
             }
 
             if (Parameters.Content.Length() > 0u)
@@ -82,23 +74,15 @@ namespace LoggingThread
                 Log(Parameters);
             }
         }
-
-        /* TODO: Close filestream */
     }
 
-    static void Start()
+    /* Runs on the job system's background queue rather than a dedicated thread */
+    static void DrainJob(void *)
     {
-        Thread = std::thread(Main);
+        /* Cleared first, anything logged after this point queues another job */
+        bDrainJobQueued = false;
 
-        Windows::SetThreadDescription(Thread.native_handle(), kThreadName.c_str());
-    }
-
-    static void Stop()
-    {
-        bStopThread = true;
-        WorkCondition.notify_one();
-
-        Thread.join();
+        Drain();
     }
 }
 
@@ -106,35 +90,34 @@ bool const Logging::Initialise()
 {
     bool bResult = true;
 
-    LoggingThread::Start();
-
     return bResult;
 }
 
 void Logging::Destroy()
 {
-    LoggingThread::Stop();
+    Logging::Flush();
 }
 
 void Logging::Log(Logging::LogTypes LogType, String Message)
 {
-    LoggingThread::LogMessageData Parameters = LoggingThread::LogMessageData { std::move(Message), LogType };
+    LoggingOutput::LogMessageData Parameters = LoggingOutput::LogMessageData { std::move(Message), LogType };
 
     {
-        std::scoped_lock Lock = std::scoped_lock(LoggingThread::MessageQueueMutex);
-
-        LoggingThread::MessageQueue.emplace(std::move(Parameters));
+        std::scoped_lock Lock = std::scoped_lock(LoggingOutput::MessageQueueMutex);
 
-        LoggingThread::bEmptyMessageQueue.store(false, std::memory_order::memory_order_release);
+        LoggingOutput::MessageQueue.emplace(std::move(Parameters));
     }
 
-    LoggingThread::WorkCondition.notify_one();
+    if (!LoggingOutput::bDrainJobQueued.exchange(true))
+    {
+        Jobs::SubmitBackground(Jobs::Types::Job { &LoggingOutput::DrainJob });
+    }
 }
 
 void Logging::Flush()
 {
-    /* This will work, but would be better to do other work in the meantime */
-    while (!LoggingThread::bEmptyMessageQueue);
+    /* Writes anything still queued on the calling thread instead of waiting for the drain job */
+    LoggingOutput::Drain();
 }
 
 void Logging::DebugLog(Char const * Message)
@@ -0,0 +1,49 @@
+#include "Names.hpp"
+
+#include "Utilities/StringTable.hpp"
+
+#include <mutex>
+#include <shared_mutex>
+
+namespace Names::Private
+{
+    static StringTable Table = {};
+
+    /* Lookups far outnumber new names, so they only take a shared lock */
+    static std::shared_mutex TableMutex = {};
+}
+
+uint32 const Names::Intern(std::string_view const Name)
+{
+    if (Name.empty())
+    {
+        return 0u;
+    }
+
+    {
+        std::shared_lock Lock = std::shared_lock(Private::TableMutex);
+
+        if (uint32 const kNameID = Private::Table.Find(Name))
+        {
+            return kNameID;
+        }
+    }
+
+    std::scoped_lock Lock = std::scoped_lock(Private::TableMutex);
+
+    return Private::Table.Intern(Name);
+}
+
+uint32 const Names::Find(std::string_view const Name)
+{
+    std::shared_lock Lock = std::shared_lock(Private::TableMutex);
+
+    return Private::Table.Find(Name);
+}
+
+std::string_view const Names::GetString(uint32 const NameID)
+{
+    std::shared_lock Lock = std::shared_lock(Private::TableMutex);
+
+    return Private::Table.Get(NameID);
+}
@@ -0,0 +1,369 @@
+#include "RenderQueue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <intrin.h>
+
+namespace RenderQueue::Private
+{
+    static uint32 const kPassBitCount = { 4u };
+    static uint32 const kPipelineBitCount = { 8u };
+    static uint32 const kMaterialBitCount = { 20u };
+    static uint32 const kMeshBitCount = { 20u };
+    static uint32 const kDepthBucketBitCount = { 12u };
+
+    /* 2048 buckets of histogram still fit in L1, and cover a 44 bit range in 4 passes rather than 6 */
+    static uint32 const kDigitBitCount = { 11u };
+    static uint32 const kMaximumDigitCount = { (64u + kDigitBitCount - 1u) / kDigitBitCount };
+    static uint32 const kBucketCount = { 1u << kDigitBitCount };
+
+    /* Runs of differing bits packed together, the closest runs are merged until there are at most this many */
+    static uint32 const kMaximumBitRunCount = { 4u };
+
+    struct BitRun
+    {
+        uint32 FirstBit = {};
+        uint32 BitCount = {};
+    };
+
+    using Histograms = std::array<std::array<uint32, kBucketCount>, kMaximumDigitCount>;
+
+    static_assert(kPassBitCount + kPipelineBitCount + kMaterialBitCount + kMeshBitCount + kDepthBucketBitCount == 64u, "Sort key fields must fill 64 bits");
+
+    static constexpr uint64 const FieldMask(uint32 const BitCount)
+    {
+        return (uint64 { 1u } << BitCount) - 1u;
+    }
+
+    static constexpr uint32 const GetDigitCount(uint32 const BitCount)
+    {
+        return (BitCount + kDigitBitCount - 1u) / kDigitBitCount;
+    }
+}
+
+using namespace RenderQueue;
+
+uint64 const RenderQueue::MakeSortKey(Types::Passes const Pass, uint32 const Pipeline, uint32 const MaterialHandle, uint32 const MeshHandle, uint32 const DepthBucket)
+{
+    uint64 SortKey = { static_cast<uint64>(Pass) & Private::FieldMask(Private::kPassBitCount) };
+
+    SortKey = (SortKey << Private::kPipelineBitCount) | (Pipeline & Private::FieldMask(Private::kPipelineBitCount));
+    SortKey = (SortKey << Private::kMaterialBitCount) | (MaterialHandle & Private::FieldMask(Private::kMaterialBitCount));
+    SortKey = (SortKey << Private::kMeshBitCount) | (MeshHandle & Private::FieldMask(Private::kMeshBitCount));
+    SortKey = (SortKey << Private::kDepthBucketBitCount) | (DepthBucket & Private::FieldMask(Private::kDepthBucketBitCount));
+
+    return SortKey;
+}
+
+uint32 const RenderQueue::GetDepthBucket(float const Depth, float const MinimumDepth, float const MaximumDepth)
+{
+    uint32 const kMaximumBucket = static_cast<uint32>(Private::FieldMask(Private::kDepthBucketBitCount));
+
+    float const kDepthRange = MaximumDepth - MinimumDepth;
+
+    if (!(kDepthRange > 0.0f))
+    {
+        return 0u;
+    }
+
+    float const kNormalisedDepth = std::clamp((Depth - MinimumDepth) / kDepthRange, 0.0f, 1.0f);
+
+    return static_cast<uint32>(kNormalisedDepth * static_cast<float>(kMaximumBucket));
+}
+
+void RenderQueue::Clear(Types::QueueData & Queue)
+{
+    Queue.SortKeys.clear();
+    Queue.Values.clear();
+}
+
+void RenderQueue::Push(Types::QueueData & Queue, uint64 const SortKey, uint32 const Value)
+{
+    Queue.SortKeys.push_back(SortKey);
+    Queue.Values.push_back(Value);
+}
+
+static void AddToHistograms(uint64 const kWord, uint32 const kFirstBit, uint32 const kDigitCount, Private::Histograms & Histograms)
+{
+    for (uint32 DigitIndex = {};
+         DigitIndex < kDigitCount;
+         DigitIndex++)
+    {
+        Histograms [DigitIndex] [(kWord >> (kFirstBit + DigitIndex * Private::kDigitBitCount)) & (Private::kBucketCount - 1u)]++;
+    }
+}
+
+/* Sorts the words by bits [FirstBit, FirstBit + BitCount), bits outside the range must be the same in every word. The histograms must already hold every word, and the values are moved with the words when given */
+static void RadixSort(uint32 const kFirstBit, uint32 const kBitCount, Private::Histograms & Histograms,
+                      std::vector<uint64> & Words, std::vector<uint64> & ScratchWords,
+                      std::vector<uint32> * const Values, std::vector<uint32> * const ScratchValues)
+{
+    uint32 const kEntryCount = static_cast<uint32>(Words.size());
+    uint32 const kDigitCount = Private::GetDigitCount(kBitCount);
+
+    ScratchWords.resize(kEntryCount);
+
+    if (Values)
+    {
+        ScratchValues->resize(kEntryCount);
+    }
+
+    for (uint32 DigitIndex = {};
+         DigitIndex < kDigitCount;
+         DigitIndex++)
+    {
+        uint32 const kShift = { kFirstBit + DigitIndex * Private::kDigitBitCount };
+
+        std::array<uint32, Private::kBucketCount> & Offsets = Histograms [DigitIndex];
+
+        /* Scattering would leave the order unchanged */
+        if (Offsets [(Words [0u] >> kShift) & (Private::kBucketCount - 1u)] == kEntryCount)
+        {
+            continue;
+        }
+
+        uint32 FirstIndex = {};
+
+        for (uint32 & Offset : Offsets)
+        {
+            uint32 const kBucketSize = { Offset };
+            Offset = FirstIndex;
+            FirstIndex += kBucketSize;
+        }
+
+        uint64 const * const kWords = Words.data();
+        uint64 * const OutputWords = ScratchWords.data();
+
+        if (Values)
+        {
+            uint32 const * const kValues = Values->data();
+            uint32 * const OutputValues = ScratchValues->data();
+
+            for (uint32 EntryIndex = {};
+                 EntryIndex < kEntryCount;
+                 EntryIndex++)
+            {
+                uint32 const kOutputIndex = Offsets [(kWords [EntryIndex] >> kShift) & (Private::kBucketCount - 1u)]++;
+
+                OutputWords [kOutputIndex] = kWords [EntryIndex];
+                OutputValues [kOutputIndex] = kValues [EntryIndex];
+            }
+
+            Values->swap(*ScratchValues);
+        }
+        else
+        {
+            for (uint32 EntryIndex = {};
+                 EntryIndex < kEntryCount;
+                 EntryIndex++)
+            {
+                OutputWords [Offsets [(kWords [EntryIndex] >> kShift) & (Private::kBucketCount - 1u)]++] = kWords [EntryIndex];
+            }
+        }
+
+        Words.swap(ScratchWords);
+    }
+}
+
+void RenderQueue::Sort(Types::QueueData & Queue)
+{
+    uint32 const kEntryCount = static_cast<uint32>(Queue.SortKeys.size());
+
+    if (kEntryCount < 2u)
+    {
+        return;
+    }
+
+    /* Only bits that differ between keys affect the order, in a typical frame the pass, pipeline and high handle bits never do */
+    uint64 AllBitsSet = { ~uint64 {} };
+    uint64 AnyBitsSet = {};
+
+    for (uint64 const kSortKey : Queue.SortKeys)
+    {
+        AllBitsSet &= kSortKey;
+        AnyBitsSet |= kSortKey;
+    }
+
+    uint64 const kDifferingBits = AllBitsSet ^ AnyBitsSet;
+
+    if (kDifferingBits == 0u)
+    {
+        return;
+    }
+
+    /* Each field only uses its low bits in a typical frame, so the differing bits come in a few runs with constant bits between them */
+    std::array<Private::BitRun, 64u> BitRuns = {};
+    uint32 BitRunCount = {};
+
+    for (uint64 RemainingBits = { kDifferingBits };
+         RemainingBits != 0u;)
+    {
+        unsigned long FirstBit = {};
+        ::_BitScanForward64(&FirstBit, RemainingBits);
+
+        unsigned long EndBit = { 64u };
+        ::_BitScanForward64(&EndBit, ~RemainingBits & (~uint64 {} << FirstBit));
+
+        BitRuns [BitRunCount++] = Private::BitRun { static_cast<uint32>(FirstBit), static_cast<uint32>(EndBit - FirstBit) };
+
+        RemainingBits &= EndBit < 64u ? ~uint64 {} << EndBit : uint64 {};
+    }
+
+    while (BitRunCount > Private::kMaximumBitRunCount)
+    {
+        uint32 ClosestRunIndex = {};
+        uint32 ClosestGap = { ~0u };
+
+        for (uint32 RunIndex = {};
+             RunIndex + 1u < BitRunCount;
+             RunIndex++)
+        {
+            uint32 const kGap = BitRuns [RunIndex + 1u].FirstBit - (BitRuns [RunIndex].FirstBit + BitRuns [RunIndex].BitCount);
+
+            if (kGap < ClosestGap)
+            {
+                ClosestGap = kGap;
+                ClosestRunIndex = RunIndex;
+            }
+        }
+
+        BitRuns [ClosestRunIndex].BitCount = BitRuns [ClosestRunIndex + 1u].FirstBit + BitRuns [ClosestRunIndex + 1u].BitCount - BitRuns [ClosestRunIndex].FirstBit;
+
+        std::copy(BitRuns.begin() + ClosestRunIndex + 2u, BitRuns.begin() + BitRunCount, BitRuns.begin() + ClosestRunIndex + 1u);
+        BitRunCount--;
+    }
+
+    uint32 LiveBitCount = {};
+
+    for (uint32 RunIndex = {};
+         RunIndex < BitRunCount;
+         RunIndex++)
+    {
+        LiveBitCount += BitRuns [RunIndex].BitCount;
+    }
+
+    /* Every histogram is built in one pass over the keys */
+    Private::Histograms Histograms = {};
+
+    unsigned long LastIndexBit = {};
+    ::_BitScanReverse64(&LastIndexBit, kEntryCount - 1u);
+
+    uint32 const kIndexBitCount = static_cast<uint32>(LastIndexBit + 1u);
+
+    /* Too many live bits to pack with the index, sort the keys with the values alongside */
+    if (LiveBitCount + kIndexBitCount > 64u)
+    {
+        Private::BitRun const & kLastRun = BitRuns [BitRunCount - 1u];
+
+        uint32 const kFirstBit = { BitRuns [0u].FirstBit };
+        uint32 const kBitCount = { kLastRun.FirstBit + kLastRun.BitCount - kFirstBit };
+
+        for (uint64 const kSortKey : Queue.SortKeys)
+        {
+            ::AddToHistograms(kSortKey, kFirstBit, Private::GetDigitCount(kBitCount), Histograms);
+        }
+
+        ::RadixSort(kFirstBit, kBitCount, Histograms, Queue.SortKeys, Queue.ScratchSortKeys, &Queue.Values, &Queue.ScratchValues);
+        return;
+    }
+
+    uint64 const kIndexMask = (uint64 { 1u } << kIndexBitCount) - 1u;
+
+    /* Where each run goes in the packed word, higher runs go higher so the order is kept. Runs past the count are left empty so every loop below has a fixed length */
+    std::array<uint32, Private::kMaximumBitRunCount> PackedShifts = {};
+    std::array<uint64, Private::kMaximumBitRunCount> RunMasks = {};
+
+    uint32 PackedBitCount = { kIndexBitCount };
+
+    for (uint32 RunIndex = {};
+         RunIndex < BitRunCount;
+         RunIndex++)
+    {
+        PackedShifts [RunIndex] = PackedBitCount;
+        RunMasks [RunIndex] = ((uint64 { 1u } << BitRuns [RunIndex].BitCount) - 1u) << BitRuns [RunIndex].FirstBit;
+
+        PackedBitCount += BitRuns [RunIndex].BitCount;
+    }
+
+    uint32 const kDigitCount = Private::GetDigitCount(LiveBitCount);
+
+    /* The live bits above the entry index, so the values never move during the sort. The histograms are built while packing */
+    Queue.PackedWords.resize(kEntryCount);
+
+    for (uint32 EntryIndex = {};
+         EntryIndex < kEntryCount;
+         EntryIndex++)
+    {
+        uint64 const kSortKey = Queue.SortKeys [EntryIndex];
+
+        uint64 PackedWord = { EntryIndex };
+
+        for (uint32 RunIndex = {};
+             RunIndex < Private::kMaximumBitRunCount;
+             RunIndex++)
+        {
+            PackedWord |= ((kSortKey & RunMasks [RunIndex]) >> BitRuns [RunIndex].FirstBit) << PackedShifts [RunIndex];
+        }
+
+        Queue.PackedWords [EntryIndex] = PackedWord;
+
+        ::AddToHistograms(PackedWord, kIndexBitCount, kDigitCount, Histograms);
+    }
+
+    /* The last digit holds the highest differing bit so it is never skipped, and is scattered separately below */
+    ::RadixSort(kIndexBitCount, (kDigitCount - 1u) * Private::kDigitBitCount, Histograms, Queue.PackedWords, Queue.ScratchPackedWords, nullptr, nullptr);
+
+    uint32 const kLastShift = { kIndexBitCount + (kDigitCount - 1u) * Private::kDigitBitCount };
+
+    std::array<uint32, Private::kBucketCount> & Offsets = Histograms [kDigitCount - 1u];
+
+    uint32 FirstIndex = {};
+
+    for (uint32 & Offset : Offsets)
+    {
+        uint32 const kBucketSize = { Offset };
+        Offset = FirstIndex;
+        FirstIndex += kBucketSize;
+    }
+
+    /* Bits outside the runs are the same in every key, so the last scatter rebuilds the keys from the packed words and gathers the values in the same pass */
+    uint64 RunBits = {};
+
+    for (uint64 const kRunMask : RunMasks)
+    {
+        RunBits |= kRunMask;
+    }
+
+    uint64 const kConstantBits = AllBitsSet & ~RunBits;
+
+    uint64 const * const kPackedWords = Queue.PackedWords.data();
+    uint32 const * const kValues = Queue.Values.data();
+
+    Queue.ScratchValues.resize(kEntryCount);
+
+    uint64 * const OutputSortKeys = Queue.SortKeys.data();
+    uint32 * const OutputValues = Queue.ScratchValues.data();
+
+    for (uint32 EntryIndex = {};
+         EntryIndex < kEntryCount;
+         EntryIndex++)
+    {
+        uint64 const kPackedWord = kPackedWords [EntryIndex];
+
+        uint64 SortKey = { kConstantBits };
+
+        for (uint32 RunIndex = {};
+             RunIndex < Private::kMaximumBitRunCount;
+             RunIndex++)
+        {
+            SortKey |= ((kPackedWord >> PackedShifts [RunIndex]) << BitRuns [RunIndex].FirstBit) & RunMasks [RunIndex];
+        }
+
+        uint32 const kOutputIndex = Offsets [kPackedWord >> kLastShift]++;
+
+        OutputSortKeys [kOutputIndex] = SortKey;
+        OutputValues [kOutputIndex] = kValues [static_cast<uint32>(kPackedWord & kIndexMask)];
+    }
+
+    Queue.Values.swap(Queue.ScratchValues);
+}
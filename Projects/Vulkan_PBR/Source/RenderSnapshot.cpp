@@ -0,0 +1,308 @@
+#include "RenderSnapshot.hpp"
+
+#include "Camera.hpp"
+#include "Components/Archetypes.hpp"
+#include "RenderQueue.hpp"
+#include "Scene.hpp"
+#include "SpatialIndex.hpp"
+
+#include <Math/Transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace RenderSnapshot::Private
+{
+    static uint32 const kSnapshotCount = { static_cast<uint32>(std::tuple_size<decltype(Types::SnapshotQueue::Snapshots)>::value) };
+
+    /* Reused between builds */
+    static std::vector<uint32> CandidateActorHandles = {};
+    static std::vector<Components::Archetypes::Types::ChunkView> RenderableChunks = {};
+    static std::vector<Types::DrawPacket> DrawPackets = {};
+    static std::vector<float> DrawPacketDepths = {};
+    static RenderQueue::Types::QueueData DrawQueue = {};
+}
+
+/* Every actor with a static mesh, read straight from the archetype chunks */
+static void GatherRenderableActors(std::vector<uint32> & OutputActorHandles)
+{
+    using namespace RenderSnapshot;
+
+    uint32 const kRenderableComponentMask = static_cast<uint32>(Scene::ComponentMasks::Transform) | static_cast<uint32>(Scene::ComponentMasks::StaticMesh);
+
+    Private::RenderableChunks.clear();
+    Components::Archetypes::QueryChunks(kRenderableComponentMask, Private::RenderableChunks);
+
+    for (Components::Archetypes::Types::ChunkView const & kChunk : Private::RenderableChunks)
+    {
+        uint32 const * const kActorHandles = kChunk.GetColumn<Components::Archetypes::Types::Columns::ActorHandle>();
+        OutputActorHandles.insert(OutputActorHandles.end(), kActorHandles, kActorHandles + kChunk.EntityCount);
+    }
+}
+
+/* Outputs a packet for each candidate actor, along with the view space depth of the actor's origin */
+static void BuildDrawPackets(RenderSnapshot::Types::FrameSnapshot const & kSnapshot, bool const kbCullOnGPU, std::vector<RenderSnapshot::Types::DrawPacket> & OutputDrawPackets, std::vector<float> & OutputDepths)
+{
+    using namespace RenderSnapshot;
+
+    Private::CandidateActorHandles.clear();
+
+    if (kbCullOnGPU)
+    {
+        ::GatherRenderableActors(Private::CandidateActorHandles);
+    }
+    else
+    {
+        SpatialIndex::QueryFrustum(kSnapshot.FrustumPlanes, Private::CandidateActorHandles);
+    }
+
+    OutputDrawPackets.clear();
+    OutputDrawPackets.reserve(Private::CandidateActorHandles.size());
+
+    OutputDepths.clear();
+    OutputDepths.reserve(Private::CandidateActorHandles.size());
+
+    Math::Affine3x4 const kWorldToView = Math::Affine3x4::FromMatrix4x4(kSnapshot.WorldToViewMatrix);
+
+    for (uint32 const kActorHandle : Private::CandidateActorHandles)
+    {
+        Components::Archetypes::Types::ChunkView Chunk = {};
+        uint32 RowIndex = {};
+
+        if (!Components::Archetypes::GetEntity(kActorHandle, Chunk, RowIndex))
+        {
+            continue;
+        }
+
+        Types::DrawPacket CurrentDrawPacket =
+        {
+            Chunk.GetColumn<Components::Archetypes::Types::Columns::MeshHandle>() [RowIndex],
+            Chunk.GetColumn<Components::Archetypes::Types::Columns::MaterialHandle>() [RowIndex],
+        };
+
+        if (Components::Transform::GetTransformSlot(kActorHandle, CurrentDrawPacket.TransformSlotIndex))
+        {
+            Math::Affine3x4 ModelToWorld = {};
+            Components::Transform::GetWorldTransforms(Components::Transform::Types::SlotRange { CurrentDrawPacket.TransformSlotIndex, 1u }, &ModelToWorld);
+
+            Math::Vector3 const kPositionWS = Math::Vector3 { ModelToWorld.Data [3u], ModelToWorld.Data [7u], ModelToWorld.Data [11u] };
+
+            OutputDrawPackets.push_back(CurrentDrawPacket);
+            OutputDepths.push_back(Math::TransformPoint(kWorldToView, kPositionWS).Z);
+        }
+    }
+}
+
+/*
+    Sorts the packets by render queue key, then merges runs that share a mesh and material into batches.
+    Batches end up grouped by material, and the instances within a batch are drawn front to back unless the GPU culls them, as its compaction doesn't keep the order.
+*/
+static void BuildDrawBatches(std::vector<RenderSnapshot::Types::DrawPacket> const & kDrawPackets, std::vector<float> const & kDepths, RenderSnapshot::Types::FrameSnapshot & OutputSnapshot)
+{
+    using namespace RenderSnapshot;
+
+    float MinimumDepth = std::numeric_limits<float>::max();
+    float MaximumDepth = std::numeric_limits<float>::lowest();
+
+    for (float const kDepth : kDepths)
+    {
+        MinimumDepth = std::min(MinimumDepth, kDepth);
+        MaximumDepth = std::max(MaximumDepth, kDepth);
+    }
+
+    RenderQueue::Clear(Private::DrawQueue);
+
+    for (uint32 PacketIndex = {};
+         PacketIndex < kDrawPackets.size();
+         PacketIndex++)
+    {
+        Types::DrawPacket const & kDrawPacket = kDrawPackets [PacketIndex];
+
+        /* Only the one pipeline for now */
+        uint64 const kSortKey = RenderQueue::MakeSortKey(RenderQueue::Types::Passes::Opaque, 0u,
+                                                         kDrawPacket.MaterialHandle, kDrawPacket.MeshHandle,
+                                                         RenderQueue::GetDepthBucket(kDepths [PacketIndex], MinimumDepth, MaximumDepth));
+
+        RenderQueue::Push(Private::DrawQueue, kSortKey, PacketIndex);
+    }
+
+    RenderQueue::Sort(Private::DrawQueue);
+
+    OutputSnapshot.DrawBatches.clear();
+    OutputSnapshot.InstanceTransformSlots.resize(kDrawPackets.size());
+
+    for (uint32 InstanceIndex = {};
+         InstanceIndex < Private::DrawQueue.Values.size();
+         InstanceIndex++)
+    {
+        Types::DrawPacket const & kDrawPacket = kDrawPackets [Private::DrawQueue.Values [InstanceIndex]];
+
+        /* Handles are compared rather than keys, as the key fields can be truncated */
+        bool const kStartsBatch = OutputSnapshot.DrawBatches.empty()
+                                  || OutputSnapshot.DrawBatches.back().MeshHandle != kDrawPacket.MeshHandle
+                                  || OutputSnapshot.DrawBatches.back().MaterialHandle != kDrawPacket.MaterialHandle;
+
+        if (kStartsBatch)
+        {
+            OutputSnapshot.DrawBatches.push_back(Types::DrawBatch { kDrawPacket.MeshHandle, kDrawPacket.MaterialHandle, InstanceIndex });
+        }
+
+        OutputSnapshot.DrawBatches.back().InstanceCount++;
+        OutputSnapshot.InstanceTransformSlots [InstanceIndex] = kDrawPacket.TransformSlotIndex;
+    }
+}
+
+static void CopyDirtyTransforms(uint32 const kMaximumTransformCount, RenderSnapshot::Types::FrameSnapshot & OutputSnapshot)
+{
+    OutputSnapshot.TransformSlotCount = Components::Transform::GetTransformSlotCount();
+
+    OutputSnapshot.TransformRanges.clear();
+    uint32 const kFlushedSlotCount = Components::Transform::FlushDirtySlots(kMaximumTransformCount, OutputSnapshot.TransformRanges);
+
+    OutputSnapshot.Transforms.resize(kFlushedSlotCount);
+
+    Math::Affine3x4 * OutputTransforms = OutputSnapshot.Transforms.data();
+
+    for (Components::Transform::Types::SlotRange const & kSlotRange : OutputSnapshot.TransformRanges)
+    {
+        Components::Transform::GetWorldTransforms(kSlotRange, OutputTransforms);
+        OutputTransforms += kSlotRange.SlotCount;
+    }
+}
+
+void RenderSnapshot::Build(Scene::SceneData const & Scene, uint32 const MaximumTransformCount, bool const bCullOnGPU, Types::FrameSnapshot & OutputSnapshot)
+{
+    Camera::GetViewMatrix(Scene.MainCamera, OutputSnapshot.WorldToViewMatrix);
+
+    /* The camera basis is orthonormal so the inverse is just a transpose */
+    Math::Affine3x4 const kViewToWorld = Math::Affine3x4::FromMatrix4x4(OutputSnapshot.WorldToViewMatrix);
+    OutputSnapshot.WorldToViewMatrix = Math::Affine3x4::ToMatrix4x4(Math::Affine3x4::InverseRigid(kViewToWorld));
+
+    OutputSnapshot.ViewToClipMatrix = Scene.MainCamera.ProjectionMatrix;
+
+    Math::ExtractFrustumPlanes(OutputSnapshot.ViewToClipMatrix * OutputSnapshot.WorldToViewMatrix, OutputSnapshot.FrustumPlanes);
+
+    ::BuildDrawPackets(OutputSnapshot, bCullOnGPU, Private::DrawPackets, Private::DrawPacketDepths);
+    ::BuildDrawBatches(Private::DrawPackets, Private::DrawPacketDepths, OutputSnapshot);
+    ::CopyDirtyTransforms(MaximumTransformCount, OutputSnapshot);
+}
+
+bool const RenderSnapshot::BeginWrite(Types::SnapshotQueue & Queue, Types::FrameSnapshot *& OutputSnapshot)
+{
+    /* Only this thread changes the published count */
+    uint64 const kPublishedCount = Queue.PublishedCount.load(std::memory_order_relaxed);
+
+    /* Pairs with the release in EndRead, so the render thread is finished with the snapshot before it is overwritten */
+    if (kPublishedCount - Queue.ReleasedCount.load(std::memory_order_acquire) >= Private::kSnapshotCount)
+    {
+        return false;
+    }
+
+    OutputSnapshot = &Queue.Snapshots [kPublishedCount % Private::kSnapshotCount];
+
+    return true;
+}
+
+static void WakeQueue(RenderSnapshot::Types::SnapshotQueue & Queue)
+{
+    /* Taking the lock stops the other thread missing the notify between checking the counts and going to sleep */
+    {
+        std::scoped_lock Lock = std::scoped_lock(Queue.SleepMutex);
+    }
+
+    Queue.SleepCondition.notify_all();
+}
+
+void RenderSnapshot::EndWrite(Types::SnapshotQueue & Queue)
+{
+    Queue.PublishedCount.store(Queue.PublishedCount.load(std::memory_order_relaxed) + 1u, std::memory_order_release);
+
+    ::WakeQueue(Queue);
+}
+
+bool const RenderSnapshot::BeginRead(Types::SnapshotQueue & Queue, Types::FrameSnapshot const *& OutputSnapshot)
+{
+    uint64 const kReleasedCount = Queue.ReleasedCount.load(std::memory_order_relaxed);
+
+    /* Pairs with the release in EndWrite, so the whole snapshot is visible */
+    if (Queue.PublishedCount.load(std::memory_order_acquire) == kReleasedCount)
+    {
+        return false;
+    }
+
+    OutputSnapshot = &Queue.Snapshots [kReleasedCount % Private::kSnapshotCount];
+
+    return true;
+}
+
+void RenderSnapshot::EndRead(Types::SnapshotQueue & Queue)
+{
+    Queue.ReleasedCount.store(Queue.ReleasedCount.load(std::memory_order_relaxed) + 1u, std::memory_order_release);
+
+    ::WakeQueue(Queue);
+}
+
+bool const RenderSnapshot::WaitToWrite(Types::SnapshotQueue & Queue, uint32 const TimeoutInMilliseconds, Types::FrameSnapshot *& OutputSnapshot)
+{
+    std::unique_lock Lock = std::unique_lock(Queue.SleepMutex);
+
+    bool const kbCanWrite = Queue.SleepCondition.wait_for(Lock, std::chrono::milliseconds(TimeoutInMilliseconds),
+                                                          [&Queue, &OutputSnapshot]()
+                                                          {
+                                                              return Queue.bClosed || RenderSnapshot::BeginWrite(Queue, OutputSnapshot);
+                                                          });
+
+    return kbCanWrite && !Queue.bClosed;
+}
+
+bool const RenderSnapshot::WaitToRead(Types::SnapshotQueue & Queue, Types::FrameSnapshot const *& OutputSnapshot)
+{
+    std::unique_lock Lock = std::unique_lock(Queue.SleepMutex);
+
+    Queue.SleepCondition.wait(Lock,
+                              [&Queue, &OutputSnapshot]()
+                              {
+                                  return Queue.bClosed || (!Queue.bMinimised && RenderSnapshot::BeginRead(Queue, OutputSnapshot));
+                              });
+
+    return !Queue.bClosed;
+}
+
+void RenderSnapshot::WaitForMinimised(Types::SnapshotQueue & Queue, uint32 const TimeoutInMilliseconds)
+{
+    std::unique_lock Lock = std::unique_lock(Queue.SleepMutex);
+
+    Queue.SleepCondition.wait_for(Lock, std::chrono::milliseconds(TimeoutInMilliseconds),
+                                  [&Queue]()
+                                  {
+                                      return Queue.bClosed || Queue.bMinimised;
+                                  });
+}
+
+void RenderSnapshot::SetMinimised(Types::SnapshotQueue & Queue, bool const bMinimised)
+{
+    bool bChanged = false;
+
+    {
+        std::scoped_lock Lock = std::scoped_lock(Queue.SleepMutex);
+
+        bChanged = Queue.bMinimised != bMinimised;
+        Queue.bMinimised = bMinimised;
+    }
+
+    if (bChanged)
+    {
+        Queue.SleepCondition.notify_all();
+    }
+}
+
+void RenderSnapshot::Close(Types::SnapshotQueue & Queue)
+{
+    {
+        std::scoped_lock Lock = std::scoped_lock(Queue.SleepMutex);
+        Queue.bClosed = true;
+    }
+
+    Queue.SleepCondition.notify_all();
+}
@@ -1,36 +1,205 @@
 #include "Scene.hpp"
 
 #include "Common.hpp"
+#include "Components/Archetypes.hpp"
+#include "Components/TransformComponent.hpp"
 #include "Logging.hpp"
+#include "Names.hpp"
+#include "SpatialIndex.hpp"
+
+static void SetActorName(Scene::SceneData & Scene, uint32 const kActorHandle, std::string_view const kActorName)
+{
+    uint32 const kNameID = Names::Intern(kActorName);
+
+    Scene.ActorNameIDs [Scene::GetActorIndex(kActorHandle)] = kNameID;
+
+    if (kNameID == 0u)
+    {
+        return;
+    }
+
+    if (kNameID > Scene.NameActorHandles.size())
+    {
+        Scene.NameActorHandles.resize(kNameID);
+    }
+
+    Scene.NameActorHandles [kNameID - 1u] = kActorHandle;
+}
 
 bool const Scene::CreateActor(Scene::SceneData & Scene, Scene::ActorData const & ActorData, uint32 & OutputActorHandle)
 {
-    uint32 NewActorHandle = {};
+    uint32 NewActorIndex = {};
 
-    if (Scene.FreeActorHandles.size() == 0u)
+    if (Scene.FreeActorIndices.size() == 0u)
     {
+        if (Scene.ActorCount >= kMaximumActorCount)
+        {
+            Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to create actor. The maximum number of actors has been reached."));
+            return false;
+        }
+
+        NewActorIndex = Scene.ActorCount;
         Scene.ActorCount++;
-        NewActorHandle = Scene.ActorCount;
 
         Scene.ComponentMasks.emplace_back();
+        Scene.ActorGenerations.emplace_back();
+        Scene.ActorNameIDs.emplace_back();
     }
     else
     {
-        NewActorHandle = Scene.FreeActorHandles.front();
-        Scene.FreeActorHandles.pop();
+        NewActorIndex = Scene.FreeActorIndices.front();
+        Scene.FreeActorIndices.pop();
+    }
+
+    uint32 const kNewActorHandle = Scene::MakeActorHandle(NewActorIndex, Scene.ActorGenerations [NewActorIndex]);
+
+    ::SetActorName(Scene, kNewActorHandle, ActorData.DebugName);
+
+    Components::Archetypes::CreateEntity(kNewActorHandle);
+
+    OutputActorHandle = kNewActorHandle;
+
+    Logging::Log(Logging::LogTypes::Info, String::Format(PBR_TEXT("Creating New Actor [ID = %d]"), kNewActorHandle));
+
+    return true;
+}
+
+bool const Scene::CreateActors(Scene::SceneData & Scene, uint32 const ComponentMask, uint32 const ActorCount, Components::Archetypes::Types::ColumnData const & ColumnData,
+                               std::string_view const * const ActorNames, uint32 * const OutputActorHandles)
+{
+    uint32 const kFreeActorCount = static_cast<uint32>(Scene.FreeActorIndices.size());
+
+    if (ActorCount > kFreeActorCount + (kMaximumActorCount - Scene.ActorCount))
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to create actors. The maximum number of actors would be exceeded."));
+        return false;
+    }
+
+    /* Everything is sized once up front */
+    uint32 const kNewActorIndexCount = ActorCount > kFreeActorCount ? ActorCount - kFreeActorCount : 0u;
+
+    Scene.ComponentMasks.resize(Scene.ActorCount + kNewActorIndexCount);
+    Scene.ActorGenerations.resize(Scene.ActorCount + kNewActorIndexCount);
+    Scene.ActorNameIDs.resize(Scene.ActorCount + kNewActorIndexCount);
+
+    for (uint32 CurrentActorIndex = {};
+         CurrentActorIndex < ActorCount;
+         CurrentActorIndex++)
+    {
+        uint32 NewActorIndex = {};
+
+        if (Scene.FreeActorIndices.size() == 0u)
+        {
+            NewActorIndex = Scene.ActorCount++;
+        }
+        else
+        {
+            NewActorIndex = Scene.FreeActorIndices.front();
+            Scene.FreeActorIndices.pop();
+        }
+
+        uint32 const kNewActorHandle = Scene::MakeActorHandle(NewActorIndex, Scene.ActorGenerations [NewActorIndex]);
+
+        Scene.ComponentMasks [NewActorIndex] = ComponentMask;
+
+        ::SetActorName(Scene, kNewActorHandle, ActorNames ? ActorNames [CurrentActorIndex] : std::string_view {});
+
+        OutputActorHandles [CurrentActorIndex] = kNewActorHandle;
+    }
+
+    bool bResult = Components::Archetypes::CreateEntities(ComponentMask, OutputActorHandles, ActorCount, ColumnData);
+
+    if (bResult && (ComponentMask & static_cast<uint32>(Scene::ComponentMasks::Transform)))
+    {
+        bResult = Components::Transform::CreateComponents(OutputActorHandles, ActorCount);
+    }
+
+    Logging::Log(Logging::LogTypes::Info, String::Format(PBR_TEXT("Created %u Actors [Component Mask = 0x%x]"), ActorCount, ComponentMask));
+
+    return bResult;
+}
+
+bool const Scene::DestroyActor(Scene::SceneData & Scene, uint32 const ActorHandle)
+{
+    if (!Scene::IsActorValid(Scene, ActorHandle))
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to destroy actor. The actor handle is NULL or stale."));
+        return false;
+    }
+
+    uint32 const kActorIndex = Scene::GetActorIndex(ActorHandle);
+
+    /* Children of the actor are attached to its parent */
+    if (Scene::DoesActorHaveComponents(Scene, ActorHandle, static_cast<uint32>(Scene::ComponentMasks::Transform)))
+    {
+        Components::Transform::DestroyComponent(ActorHandle, Scene);
     }
 
-    Scene.ActorNameToHandleMap [ActorData.DebugName] = NewActorHandle;
+    Components::Archetypes::DestroyEntity(ActorHandle);
+    SpatialIndex::RemoveActor(ActorHandle);
 
-    OutputActorHandle = NewActorHandle;
+    /* The name stays interned, only the lookup is cleared */
+    uint32 const kNameID = Scene.ActorNameIDs [kActorIndex];
+    if (kNameID != 0u && Scene.NameActorHandles [kNameID - 1u] == ActorHandle)
+    {
+        Scene.NameActorHandles [kNameID - 1u] = {};
+    }
+
+    Scene.ActorNameIDs [kActorIndex] = {};
+    Scene.ComponentMasks [kActorIndex] = {};
 
-    Logging::Log(Logging::LogTypes::Info, String::Format(PBR_TEXT("Creating New Actor [ID = %d]"), NewActorHandle));
+    /* Wraps around, any handle still held from kActorGenerationMask + 1 destructions ago will alias */
+    Scene.ActorGenerations [kActorIndex] = static_cast<uint16>((Scene.ActorGenerations [kActorIndex] + 1u) & kActorGenerationMask);
+
+    Scene.FreeActorIndices.push(kActorIndex);
 
     return true;
 }
 
+bool const Scene::IsActorValid(Scene::SceneData const & Scene, uint32 const ActorHandle)
+{
+    if (ActorHandle == 0u)
+    {
+        return false;
+    }
+
+    uint32 const kActorIndex = Scene::GetActorIndex(ActorHandle);
+
+    return kActorIndex < Scene.ActorCount && Scene.ActorGenerations [kActorIndex] == Scene::GetActorGeneration(ActorHandle);
+}
+
 bool const Scene::DoesActorHaveComponents(Scene::SceneData const & Scene, uint32 const ActorHandle, uint32 const ComponentMask)
 {
-    uint32 const ActorIndex = ActorHandle - 1u;
-    return (Scene.ComponentMasks [ActorIndex] & ComponentMask) == ComponentMask;
-}
\ No newline at end of file
+    if (!Scene::IsActorValid(Scene, ActorHandle))
+    {
+        return false;
+    }
+
+    uint32 const kActorIndex = Scene::GetActorIndex(ActorHandle);
+    return (Scene.ComponentMasks [kActorIndex] & ComponentMask) == ComponentMask;
+}
+
+bool const Scene::FindActor(Scene::SceneData const & Scene, std::string_view const ActorName, uint32 & OutputActorHandle)
+{
+    uint32 const kNameID = Names::Find(ActorName);
+
+    /* The name can have been interned by something other than this scene */
+    if (kNameID == 0u || kNameID > Scene.NameActorHandles.size() || Scene.NameActorHandles [kNameID - 1u] == 0u)
+    {
+        return false;
+    }
+
+    OutputActorHandle = Scene.NameActorHandles [kNameID - 1u];
+
+    return true;
+}
+
+std::string_view const Scene::GetActorName(Scene::SceneData const & Scene, uint32 const ActorHandle)
+{
+    if (!Scene::IsActorValid(Scene, ActorHandle))
+    {
+        return std::string_view {};
+    }
+
+    return Names::GetString(Scene.ActorNameIDs [Scene::GetActorIndex(ActorHandle)]);
+}
@@ -0,0 +1,864 @@
+#include "SceneFile.hpp"
+
+#include "Assets/Material.hpp"
+#include "Assets/StaticMesh.hpp"
+#include "Assets/Texture.hpp"
+#include "Components/Archetypes.hpp"
+#include "Components/TransformComponent.hpp"
+#include "Logging.hpp"
+#include "Scene.hpp"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/*
+    File layout, everything is little endian and each section starts on a 4 byte boundary.
+
+    FileHeader
+    String table            StringTableSizeInBytes of null terminated strings, padded to 4 bytes
+    AssetReference          [StaticMeshCount]
+    AssetReference          [TextureCount]
+    MaterialReference       [MaterialCount]
+    Actor name offsets      uint32 [ActorCount], kNullOffset for unnamed actors
+    Actor parents           uint32 [ActorCount], file actor index + 1 or 0 for no parent
+    Blocks                  [BlockCount], a BlockHeader followed by one array per column (except actor handles) in column order
+
+    Actors are numbered in the order their blocks appear. Mesh and material columns hold asset index + 1, or 0 for NULL.
+*/
+namespace SceneFile::Private
+{
+    static constexpr uint32 kMagic = { 0x53524250u };
+    static constexpr uint32 kVersion = { 1u };
+
+    static constexpr uint32 kNullOffset = { ~0u };
+
+    static constexpr uint32 kKnownComponentMask = { static_cast<uint32>(Scene::ComponentMasks::Transform) | static_cast<uint32>(Scene::ComponentMasks::StaticMesh) };
+
+    struct FileHeader
+    {
+        uint32 Magic = {};
+        uint32 Version = {};
+
+        uint32 ActorCount = {};
+        uint32 BlockCount = {};
+
+        uint32 StaticMeshCount = {};
+        uint32 TextureCount = {};
+        uint32 MaterialCount = {};
+
+        uint32 StringTableSizeInBytes = {};
+    };
+
+    struct AssetReference
+    {
+        uint32 NameOffset = {};
+        uint32 FilePathOffset = {};
+    };
+
+    struct MaterialReference
+    {
+        uint32 NameOffset = {};
+
+        /* Albedo, normal, specular, roughness then ambient occlusion. Texture index + 1, or 0 for NULL */
+        std::array<uint32, 5u> TextureIndices = {};
+    };
+
+    struct BlockHeader
+    {
+        uint32 ComponentMask = {};
+        uint32 ActorCount = {};
+    };
+
+    /* Rows of a chunk that are written to the file */
+    struct RowRange
+    {
+        uint32 ChunkIndex = {};
+        uint32 FirstRowIndex = {};
+        uint32 RowCount = {};
+    };
+
+    /* Bounds checked view of the file contents */
+    struct FileReader
+    {
+        std::vector<std::byte> Data = {};
+        uint64 OffsetInBytes = {};
+    };
+}
+
+using namespace SceneFile;
+
+static std::byte const * const ReadBytes(Private::FileReader & Reader, uint64 const kSizeInBytes)
+{
+    if (kSizeInBytes > Reader.Data.size() - Reader.OffsetInBytes)
+    {
+        return nullptr;
+    }
+
+    std::byte const * const kData = Reader.Data.data() + Reader.OffsetInBytes;
+
+    /* Sections are padded so the next one stays aligned */
+    Reader.OffsetInBytes = std::min<uint64>((Reader.OffsetInBytes + kSizeInBytes + 3u) & ~uint64 { 3u }, Reader.Data.size());
+
+    return kData;
+}
+
+template<class ValueType>
+static bool const ReadValues(Private::FileReader & Reader, uint32 const kValueCount, std::vector<ValueType> & OutputValues)
+{
+    std::byte const * const kData = ::ReadBytes(Reader, static_cast<uint64>(kValueCount) * sizeof(ValueType));
+
+    if (!kData)
+    {
+        return false;
+    }
+
+    OutputValues.resize(kValueCount);
+
+    /* Empty vectors can have a NULL data pointer, which memcpy doesn't allow even for zero bytes */
+    if (kValueCount > 0u)
+    {
+        std::memcpy(OutputValues.data(), kData, static_cast<uint64>(kValueCount) * sizeof(ValueType));
+    }
+
+    return true;
+}
+
+static bool const GetString(std::vector<char> const & kStringTable, uint32 const kOffset, std::string & OutputString)
+{
+    if (kOffset >= kStringTable.size())
+    {
+        return false;
+    }
+
+    OutputString.assign(kStringTable.data() + kOffset);
+
+    return true;
+}
+
+static uint32 const AddString(std::vector<char> & StringTable, std::string_view const kString)
+{
+    uint32 const kOffset = static_cast<uint32>(StringTable.size());
+
+    StringTable.insert(StringTable.end(), kString.cbegin(), kString.cend());
+    StringTable.push_back('\0');
+
+    return kOffset;
+}
+
+static void WriteBytes(std::vector<std::byte> & FileData, void const * const kData, uint64 const kSizeInBytes)
+{
+    std::byte const * const kBytes = static_cast<std::byte const *>(kData);
+
+    FileData.insert(FileData.end(), kBytes, kBytes + kSizeInBytes);
+    FileData.resize((FileData.size() + 3u) & ~std::size_t { 3u });
+}
+
+/* Imports every texture, mesh and material that isn't already loaded, outputs their handles by file index */
+static bool const LoadAssets(Private::FileReader & Reader, Private::FileHeader const & kHeader, std::vector<char> const & kStringTable, std::filesystem::path const & kSceneDirectoryPath,
+                             std::vector<uint32> & OutputStaticMeshHandles, std::vector<uint32> & OutputMaterialHandles)
+{
+    std::vector<Private::AssetReference> StaticMeshReferences = {};
+    std::vector<Private::AssetReference> TextureReferences = {};
+    std::vector<Private::MaterialReference> MaterialReferences = {};
+
+    if (!::ReadValues(Reader, kHeader.StaticMeshCount, StaticMeshReferences)
+        || !::ReadValues(Reader, kHeader.TextureCount, TextureReferences)
+        || !::ReadValues(Reader, kHeader.MaterialCount, MaterialReferences))
+    {
+        return false;
+    }
+
+    std::vector<uint32> TextureHandles = std::vector<uint32>(kHeader.TextureCount);
+
+    for (uint32 CurrentTextureIndex = {};
+         CurrentTextureIndex < kHeader.TextureCount;
+         CurrentTextureIndex++)
+    {
+        std::string AssetName = {};
+        std::string FilePath = {};
+
+        if (!::GetString(kStringTable, TextureReferences [CurrentTextureIndex].NameOffset, AssetName)
+            || !::GetString(kStringTable, TextureReferences [CurrentTextureIndex].FilePathOffset, FilePath))
+        {
+            return false;
+        }
+
+        if (!Assets::Texture::FindTexture(AssetName, TextureHandles [CurrentTextureIndex])
+            && !Assets::Texture::ImportTexture(kSceneDirectoryPath / FilePath, AssetName, TextureHandles [CurrentTextureIndex]))
+        {
+            Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to load scene. A texture it references could not be imported."));
+            return false;
+        }
+    }
+
+    OutputStaticMeshHandles.resize(kHeader.StaticMeshCount);
+
+    for (uint32 CurrentMeshIndex = {};
+         CurrentMeshIndex < kHeader.StaticMeshCount;
+         CurrentMeshIndex++)
+    {
+        std::string AssetName = {};
+        std::string FilePath = {};
+
+        if (!::GetString(kStringTable, StaticMeshReferences [CurrentMeshIndex].NameOffset, AssetName)
+            || !::GetString(kStringTable, StaticMeshReferences [CurrentMeshIndex].FilePathOffset, FilePath))
+        {
+            return false;
+        }
+
+        if (!Assets::StaticMesh::FindStaticMesh(AssetName, OutputStaticMeshHandles [CurrentMeshIndex])
+            && !Assets::StaticMesh::ImportStaticMesh(kSceneDirectoryPath / FilePath, AssetName, OutputStaticMeshHandles [CurrentMeshIndex]))
+        {
+            Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to load scene. A static mesh it references could not be imported."));
+            return false;
+        }
+    }
+
+    OutputMaterialHandles.resize(kHeader.MaterialCount);
+
+    for (uint32 CurrentMaterialIndex = {};
+         CurrentMaterialIndex < kHeader.MaterialCount;
+         CurrentMaterialIndex++)
+    {
+        Private::MaterialReference const & kReference = MaterialReferences [CurrentMaterialIndex];
+
+        std::string AssetName = {};
+
+        if (!::GetString(kStringTable, kReference.NameOffset, AssetName))
+        {
+            return false;
+        }
+
+        if (Assets::Material::FindMaterial(AssetName, OutputMaterialHandles [CurrentMaterialIndex]))
+        {
+            continue;
+        }
+
+        std::array<uint32, 5u> MaterialTextureHandles = {};
+
+        for (uint8 CurrentTextureIndex = {};
+             CurrentTextureIndex < MaterialTextureHandles.size();
+             CurrentTextureIndex++)
+        {
+            uint32 const kTextureIndex = kReference.TextureIndices [CurrentTextureIndex];
+
+            if (kTextureIndex > kHeader.TextureCount)
+            {
+                return false;
+            }
+
+            MaterialTextureHandles [CurrentTextureIndex] = kTextureIndex == 0u ? 0u : TextureHandles [kTextureIndex - 1u];
+        }
+
+        Assets::Material::MaterialData const kMaterialDesc =
+        {
+            MaterialTextureHandles [0u], MaterialTextureHandles [1u],
+            MaterialTextureHandles [2u], MaterialTextureHandles [3u],
+            MaterialTextureHandles [4u],
+        };
+
+        Assets::Material::CreateMaterial(kMaterialDesc, std::move(AssetName), OutputMaterialHandles [CurrentMaterialIndex]);
+    }
+
+    return true;
+}
+
+/* File asset indices (+ 1) are swapped for handles in place */
+static bool const RemapAssetIndices(std::vector<uint32> const & kAssetHandles, uint32 * const AssetIndices, uint32 const kCount)
+{
+    for (uint32 CurrentIndex = {};
+         CurrentIndex < kCount;
+         CurrentIndex++)
+    {
+        uint32 const kAssetIndex = AssetIndices [CurrentIndex];
+
+        if (kAssetIndex > kAssetHandles.size())
+        {
+            return false;
+        }
+
+        AssetIndices [CurrentIndex] = kAssetIndex == 0u ? 0u : kAssetHandles [kAssetIndex - 1u];
+    }
+
+    return true;
+}
+
+bool const SceneFile::Load(std::filesystem::path const & FilePath, Scene::SceneData & Scene, std::vector<uint32> & OutputActorHandles)
+{
+    /* Read the whole file at once, everything after this is parsed in memory */
+    std::vector<std::byte> FileData = {};
+
+    if (!SceneFile::ReadFile(FilePath, FileData))
+    {
+        return false;
+    }
+
+    return SceneFile::LoadFromMemory(std::move(FileData), FilePath.parent_path(), Scene, OutputActorHandles);
+}
+
+bool const SceneFile::ReadFile(std::filesystem::path const & FilePath, std::vector<std::byte> & OutputFileData)
+{
+    std::ifstream FileStream = std::ifstream(FilePath, std::ios::binary | std::ios::ate);
+
+    if (!FileStream)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to open scene file."));
+        return false;
+    }
+
+    OutputFileData.resize(static_cast<std::size_t>(FileStream.tellg()));
+
+    FileStream.seekg(0);
+    FileStream.read(reinterpret_cast<char *>(OutputFileData.data()), static_cast<std::streamsize>(OutputFileData.size()));
+
+    if (!FileStream)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to read scene file."));
+        return false;
+    }
+
+    return true;
+}
+
+bool const SceneFile::LoadFromMemory(std::vector<std::byte> FileData, std::filesystem::path const & SceneDirectoryPath, Scene::SceneData & Scene, std::vector<uint32> & OutputActorHandles)
+{
+    Private::FileReader Reader = {};
+    Reader.Data = std::move(FileData);
+
+    Private::FileHeader Header = {};
+
+    if (std::byte const * const kHeaderData = ::ReadBytes(Reader, sizeof(Header)))
+    {
+        std::memcpy(&Header, kHeaderData, sizeof(Header));
+    }
+
+    if (Header.Magic != Private::kMagic || Header.Version != Private::kVersion)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to load scene. The file is not a scene file or was written by a different version."));
+        return false;
+    }
+
+    std::vector<char> StringTable = {};
+    std::vector<uint32> StaticMeshHandles = {};
+    std::vector<uint32> MaterialHandles = {};
+    std::vector<uint32> ActorNameOffsets = {};
+    std::vector<uint32> ActorParentIndices = {};
+
+    bool bResult = ::ReadValues(Reader, Header.StringTableSizeInBytes, StringTable);
+    bResult = bResult && (StringTable.size() == 0u || StringTable.back() == '\0');
+    bResult = bResult && ::LoadAssets(Reader, Header, StringTable, SceneDirectoryPath, StaticMeshHandles, MaterialHandles);
+    bResult = bResult && ::ReadValues(Reader, Header.ActorCount, ActorNameOffsets);
+    bResult = bResult && ::ReadValues(Reader, Header.ActorCount, ActorParentIndices);
+
+    if (!bResult)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to load scene. The file is truncated or corrupt."));
+        return false;
+    }
+
+    uint64 const kFirstActorHandleIndex = OutputActorHandles.size();
+    OutputActorHandles.resize(kFirstActorHandleIndex + Header.ActorCount);
+
+    uint32 LoadedActorCount = {};
+
+    std::vector<std::string_view> ActorNames = {};
+    std::vector<uint32> AssetHandleColumns [2u] = {};
+
+    for (uint32 CurrentBlockIndex = {};
+         CurrentBlockIndex < Header.BlockCount && bResult;
+         CurrentBlockIndex++)
+    {
+        Private::BlockHeader Block = {};
+
+        if (std::byte const * const kBlockData = ::ReadBytes(Reader, sizeof(Block)))
+        {
+            std::memcpy(&Block, kBlockData, sizeof(Block));
+        }
+        else
+        {
+            bResult = false;
+            break;
+        }
+
+        if ((Block.ComponentMask & ~Private::kKnownComponentMask) != 0u || Block.ActorCount > Header.ActorCount - LoadedActorCount)
+        {
+            bResult = false;
+            break;
+        }
+
+        /* Columns point straight into the file data, apart from asset handles which have to be remapped first */
+        Components::Archetypes::Types::ColumnData ColumnData = {};
+
+        for (uint8 CurrentColumnIndex = { 1u };
+             CurrentColumnIndex < Components::Archetypes::Types::kColumnCount && bResult;
+             CurrentColumnIndex++)
+        {
+            Components::Archetypes::Types::Columns const kColumn = static_cast<Components::Archetypes::Types::Columns>(CurrentColumnIndex);
+
+            if (!Components::Archetypes::HasColumn(Block.ComponentMask, kColumn))
+            {
+                continue;
+            }
+
+            std::byte const * const kColumnData = ::ReadBytes(Reader, static_cast<uint64>(Block.ActorCount) * Components::Archetypes::GetColumnSizeInBytes(kColumn));
+
+            if (!kColumnData)
+            {
+                bResult = false;
+                break;
+            }
+
+            ColumnData [CurrentColumnIndex] = kColumnData;
+
+            if (kColumn == Components::Archetypes::Types::Columns::MeshHandle || kColumn == Components::Archetypes::Types::Columns::MaterialHandle)
+            {
+                bool const bMeshColumn = kColumn == Components::Archetypes::Types::Columns::MeshHandle;
+
+                std::vector<uint32> & AssetHandles = AssetHandleColumns [bMeshColumn ? 0u : 1u];
+                AssetHandles.resize(Block.ActorCount);
+                std::memcpy(AssetHandles.data(), kColumnData, AssetHandles.size() * sizeof(uint32));
+
+                bResult = ::RemapAssetIndices(bMeshColumn ? StaticMeshHandles : MaterialHandles, AssetHandles.data(), Block.ActorCount);
+
+                ColumnData [CurrentColumnIndex] = reinterpret_cast<std::byte const *>(AssetHandles.data());
+            }
+        }
+
+        if (!bResult)
+        {
+            break;
+        }
+
+        /* Names are only copied out for blocks that have some */
+        bool bHasNames = false;
+
+        for (uint32 CurrentActorIndex = {};
+             CurrentActorIndex < Block.ActorCount && !bHasNames;
+             CurrentActorIndex++)
+        {
+            bHasNames = ActorNameOffsets [LoadedActorCount + CurrentActorIndex] != Private::kNullOffset;
+        }
+
+        if (bHasNames)
+        {
+            ActorNames.assign(Block.ActorCount, std::string_view {});
+
+            for (uint32 CurrentActorIndex = {};
+                 CurrentActorIndex < Block.ActorCount;
+                 CurrentActorIndex++)
+            {
+                uint32 const kNameOffset = ActorNameOffsets [LoadedActorCount + CurrentActorIndex];
+
+                /* Views into the string table, the scene interns its own copy */
+                if (kNameOffset != Private::kNullOffset)
+                {
+                    bResult &= kNameOffset < StringTable.size();
+                    ActorNames [CurrentActorIndex] = bResult ? std::string_view { StringTable.data() + kNameOffset } : std::string_view {};
+                }
+            }
+        }
+
+        bResult = bResult && Scene::CreateActors(Scene, Block.ComponentMask, Block.ActorCount, ColumnData, bHasNames ? ActorNames.data() : nullptr,
+                                                 OutputActorHandles.data() + kFirstActorHandleIndex + LoadedActorCount);
+
+        LoadedActorCount += Block.ActorCount;
+    }
+
+    if (!bResult || LoadedActorCount != Header.ActorCount)
+    {
+        OutputActorHandles.resize(kFirstActorHandleIndex + LoadedActorCount);
+
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to load scene. The file is truncated or corrupt."));
+        return false;
+    }
+
+    /* Parents can be in any block, so they are set once every actor exists */
+    {
+        std::vector<uint32> ChildActorHandles = {};
+        std::vector<uint32> ParentActorHandles = {};
+
+        for (uint32 CurrentActorIndex = {};
+             CurrentActorIndex < Header.ActorCount;
+             CurrentActorIndex++)
+        {
+            uint32 const kParentIndex = ActorParentIndices [CurrentActorIndex];
+
+            if (kParentIndex == 0u)
+            {
+                continue;
+            }
+
+            if (kParentIndex > Header.ActorCount)
+            {
+                Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to load scene. An actor's parent is out of range."));
+                return false;
+            }
+
+            ChildActorHandles.push_back(OutputActorHandles [kFirstActorHandleIndex + CurrentActorIndex]);
+            ParentActorHandles.push_back(OutputActorHandles [kFirstActorHandleIndex + kParentIndex - 1u]);
+        }
+
+        if (ChildActorHandles.size() > 0u
+            && !Components::Transform::SetParents(ChildActorHandles.data(), ParentActorHandles.data(), static_cast<uint32>(ChildActorHandles.size()), Scene))
+        {
+            return false;
+        }
+    }
+
+    Logging::Log(Logging::LogTypes::Info, String::Format(PBR_TEXT("Loaded Scene [Actors = %u, Blocks = %u, Static Meshes = %u, Materials = %u]"),
+                                                         Header.ActorCount, Header.BlockCount, Header.StaticMeshCount, Header.MaterialCount));
+
+    return true;
+}
+
+bool const SceneFile::Save(std::filesystem::path const & FilePath, Scene::SceneData const & Scene, uint32 const * const ActorHandles, uint32 const ActorCount)
+{
+    using namespace Components;
+
+    /* Chunks come out grouped by archetype, and each archetype becomes a block */
+    std::vector<Archetypes::Types::ChunkView> Chunks = {};
+    Archetypes::QueryChunks(0u, Chunks);
+
+    std::vector<uint32> ChunkComponentMasks = std::vector<uint32>(Chunks.size());
+
+    /* Indexed by actor index, only filled in when saving some of the actors */
+    std::vector<uint8> SavedActors = {};
+
+    if (ActorHandles)
+    {
+        SavedActors.resize(Scene.ActorCount);
+
+        for (uint32 CurrentActorIndex = {};
+             CurrentActorIndex < ActorCount;
+             CurrentActorIndex++)
+        {
+            if (Scene::IsActorValid(Scene, ActorHandles [CurrentActorIndex]))
+            {
+                SavedActors [Scene::GetActorIndex(ActorHandles [CurrentActorIndex])] = 1u;
+            }
+        }
+    }
+
+    /* File actor index + 1 by actor index */
+    std::vector<uint32> ActorFileIndices = std::vector<uint32>(Scene.ActorCount);
+
+    /* Consecutive rows that are saved are copied together, so saving every actor copies whole chunk columns */
+    std::vector<Private::RowRange> RowRanges = {};
+
+    uint32 SavedActorCount = {};
+
+    for (uint32 CurrentChunkIndex = {};
+         CurrentChunkIndex < Chunks.size();
+         CurrentChunkIndex++)
+    {
+        Archetypes::Types::ChunkView const & kChunk = Chunks [CurrentChunkIndex];
+        uint32 const * const kActorHandles = kChunk.GetColumn<Archetypes::Types::Columns::ActorHandle>();
+
+        ChunkComponentMasks [CurrentChunkIndex] = Scene.ComponentMasks [Scene::GetActorIndex(kActorHandles [0u])];
+
+        for (uint32 CurrentRowIndex = {};
+             CurrentRowIndex < kChunk.EntityCount;
+             CurrentRowIndex++)
+        {
+            uint32 const kActorIndex = Scene::GetActorIndex(kActorHandles [CurrentRowIndex]);
+
+            if (SavedActors.size() > 0u && SavedActors [kActorIndex] == 0u)
+            {
+                continue;
+            }
+
+            ActorFileIndices [kActorIndex] = ++SavedActorCount;
+
+            if (RowRanges.size() > 0u
+                && RowRanges.back().ChunkIndex == CurrentChunkIndex
+                && RowRanges.back().FirstRowIndex + RowRanges.back().RowCount == CurrentRowIndex)
+            {
+                RowRanges.back().RowCount++;
+            }
+            else
+            {
+                RowRanges.push_back(Private::RowRange { CurrentChunkIndex, CurrentRowIndex, 1u });
+            }
+        }
+    }
+
+    Private::FileHeader Header = {};
+    Header.Magic = Private::kMagic;
+    Header.Version = Private::kVersion;
+    Header.ActorCount = SavedActorCount;
+
+    std::vector<char> StringTable = {};
+
+    std::vector<Private::AssetReference> StaticMeshReferences = {};
+    std::vector<Private::AssetReference> TextureReferences = {};
+    std::vector<Private::MaterialReference> MaterialReferences = {};
+
+    /* File asset index + 1 by handle */
+    std::unordered_map<uint32, uint32> StaticMeshFileIndices = {};
+    std::unordered_map<uint32, uint32> TextureFileIndices = {};
+    std::unordered_map<uint32, uint32> MaterialFileIndices = {};
+
+    std::filesystem::path const kSceneDirectoryPath = std::filesystem::absolute(FilePath).parent_path();
+
+    /* Paths are stored relative to the scene file where possible so the assets can move with it */
+    auto const AddAssetReference = [&StringTable, &kSceneDirectoryPath](std::string const & kAssetName, std::filesystem::path const & kAssetFilePath)
+    {
+        std::filesystem::path RelativeFilePath = std::filesystem::absolute(kAssetFilePath).lexically_relative(kSceneDirectoryPath);
+
+        if (RelativeFilePath.empty())
+        {
+            RelativeFilePath = std::filesystem::absolute(kAssetFilePath);
+        }
+
+        return Private::AssetReference { ::AddString(StringTable, kAssetName), ::AddString(StringTable, RelativeFilePath.generic_string()) };
+    };
+
+    auto const FindTextureIndex = [&](uint32 const kTextureHandle, uint32 & OutputTextureIndex)
+    {
+        if (kTextureHandle == 0u)
+        {
+            OutputTextureIndex = 0u;
+            return true;
+        }
+
+        if (auto const kIterator = TextureFileIndices.find(kTextureHandle);
+            kIterator != TextureFileIndices.cend())
+        {
+            OutputTextureIndex = kIterator->second;
+            return true;
+        }
+
+        std::string AssetName = {};
+        std::filesystem::path AssetFilePath = {};
+
+        if (!Assets::Texture::GetAssetSource(kTextureHandle, AssetName, AssetFilePath))
+        {
+            return false;
+        }
+
+        TextureReferences.push_back(AddAssetReference(AssetName, AssetFilePath));
+        OutputTextureIndex = TextureFileIndices [kTextureHandle] = static_cast<uint32>(TextureReferences.size());
+
+        return true;
+    };
+
+    auto const FindStaticMeshIndex = [&](uint32 const kStaticMeshHandle, uint32 & OutputStaticMeshIndex)
+    {
+        if (kStaticMeshHandle == 0u)
+        {
+            OutputStaticMeshIndex = 0u;
+            return true;
+        }
+
+        if (auto const kIterator = StaticMeshFileIndices.find(kStaticMeshHandle);
+            kIterator != StaticMeshFileIndices.cend())
+        {
+            OutputStaticMeshIndex = kIterator->second;
+            return true;
+        }
+
+        std::string AssetName = {};
+        std::filesystem::path AssetFilePath = {};
+
+        if (!Assets::StaticMesh::GetAssetSource(kStaticMeshHandle, AssetName, AssetFilePath))
+        {
+            return false;
+        }
+
+        StaticMeshReferences.push_back(AddAssetReference(AssetName, AssetFilePath));
+        OutputStaticMeshIndex = StaticMeshFileIndices [kStaticMeshHandle] = static_cast<uint32>(StaticMeshReferences.size());
+
+        return true;
+    };
+
+    auto const FindMaterialIndex = [&](uint32 const kMaterialHandle, uint32 & OutputMaterialIndex)
+    {
+        if (kMaterialHandle == 0u)
+        {
+            OutputMaterialIndex = 0u;
+            return true;
+        }
+
+        if (auto const kIterator = MaterialFileIndices.find(kMaterialHandle);
+            kIterator != MaterialFileIndices.cend())
+        {
+            OutputMaterialIndex = kIterator->second;
+            return true;
+        }
+
+        std::string AssetName = {};
+        Assets::Material::MaterialData MaterialData = {};
+
+        if (!Assets::Material::GetAssetName(kMaterialHandle, AssetName) || !Assets::Material::GetAssetData(kMaterialHandle, MaterialData))
+        {
+            return false;
+        }
+
+        Private::MaterialReference Reference = {};
+        Reference.NameOffset = ::AddString(StringTable, AssetName);
+
+        std::array<uint32, 5u> const kTextureHandles =
+        {
+            MaterialData.AlbedoTexture, MaterialData.NormalTexture,
+            MaterialData.SpecularTexture, MaterialData.RoughnessTexture,
+            MaterialData.AmbientOcclusionTexture,
+        };
+
+        for (uint8 CurrentTextureIndex = {};
+             CurrentTextureIndex < kTextureHandles.size();
+             CurrentTextureIndex++)
+        {
+            if (!FindTextureIndex(kTextureHandles [CurrentTextureIndex], Reference.TextureIndices [CurrentTextureIndex]))
+            {
+                return false;
+            }
+        }
+
+        MaterialReferences.push_back(Reference);
+        OutputMaterialIndex = MaterialFileIndices [kMaterialHandle] = static_cast<uint32>(MaterialReferences.size());
+
+        return true;
+    };
+
+    std::vector<uint32> ActorNameOffsets = std::vector<uint32>(SavedActorCount, Private::kNullOffset);
+    std::vector<uint32> ActorParentIndices = std::vector<uint32>(SavedActorCount);
+
+    std::vector<std::byte> BlockData = {};
+
+    bool bResult = true;
+
+    for (uint32 FirstRangeIndex = {}, EndRangeIndex = {};
+         FirstRangeIndex < RowRanges.size() && bResult;
+         FirstRangeIndex = EndRangeIndex)
+    {
+        uint32 const kComponentMask = ChunkComponentMasks [RowRanges [FirstRangeIndex].ChunkIndex];
+
+        Private::BlockHeader Block = { kComponentMask, 0u };
+
+        for (EndRangeIndex = FirstRangeIndex;
+             EndRangeIndex < RowRanges.size() && ChunkComponentMasks [RowRanges [EndRangeIndex].ChunkIndex] == kComponentMask;
+             EndRangeIndex++)
+        {
+            Block.ActorCount += RowRanges [EndRangeIndex].RowCount;
+        }
+
+        ::WriteBytes(BlockData, &Block, sizeof(Block));
+
+        for (uint8 CurrentColumnIndex = { 1u };
+             CurrentColumnIndex < Archetypes::Types::kColumnCount && bResult;
+             CurrentColumnIndex++)
+        {
+            Archetypes::Types::Columns const kColumn = static_cast<Archetypes::Types::Columns>(CurrentColumnIndex);
+
+            if (!Archetypes::HasColumn(kComponentMask, kColumn))
+            {
+                continue;
+            }
+
+            uint32 const kElementSizeInBytes = Archetypes::GetColumnSizeInBytes(kColumn);
+
+            for (uint32 CurrentRangeIndex = { FirstRangeIndex };
+                 CurrentRangeIndex < EndRangeIndex && bResult;
+                 CurrentRangeIndex++)
+            {
+                Private::RowRange const & kRange = RowRanges [CurrentRangeIndex];
+                Archetypes::Types::ChunkView const & kChunk = Chunks [kRange.ChunkIndex];
+
+                std::byte const * const kColumnData = kChunk.Data + kChunk.ColumnOffsets [CurrentColumnIndex] + static_cast<uint64>(kRange.FirstRowIndex) * kElementSizeInBytes;
+
+                if (kColumn == Archetypes::Types::Columns::MeshHandle || kColumn == Archetypes::Types::Columns::MaterialHandle)
+                {
+                    for (uint32 CurrentRowIndex = {};
+                         CurrentRowIndex < kRange.RowCount && bResult;
+                         CurrentRowIndex++)
+                    {
+                        uint32 AssetHandle = {};
+                        std::memcpy(&AssetHandle, kColumnData + CurrentRowIndex * sizeof(uint32), sizeof(uint32));
+
+                        uint32 AssetIndex = {};
+                        bResult = kColumn == Archetypes::Types::Columns::MeshHandle ? FindStaticMeshIndex(AssetHandle, AssetIndex) : FindMaterialIndex(AssetHandle, AssetIndex);
+
+                        BlockData.insert(BlockData.end(), reinterpret_cast<std::byte const *>(&AssetIndex), reinterpret_cast<std::byte const *>(&AssetIndex) + sizeof(AssetIndex));
+                    }
+                }
+                else
+                {
+                    BlockData.insert(BlockData.end(), kColumnData, kColumnData + static_cast<uint64>(kRange.RowCount) * kElementSizeInBytes);
+                }
+            }
+
+            BlockData.resize((BlockData.size() + 3u) & ~std::size_t { 3u });
+        }
+
+        for (uint32 CurrentRangeIndex = { FirstRangeIndex };
+             CurrentRangeIndex < EndRangeIndex && bResult;
+             CurrentRangeIndex++)
+        {
+            Private::RowRange const & kRange = RowRanges [CurrentRangeIndex];
+            uint32 const * const kActorHandles = Chunks [kRange.ChunkIndex].GetColumn<Archetypes::Types::Columns::ActorHandle>();
+
+            for (uint32 CurrentRowIndex = { kRange.FirstRowIndex };
+                 CurrentRowIndex < kRange.FirstRowIndex + kRange.RowCount;
+                 CurrentRowIndex++)
+            {
+                uint32 const kActorHandle = kActorHandles [CurrentRowIndex];
+                uint32 const kActorIndex = Scene::GetActorIndex(kActorHandle);
+                uint32 const kFileIndex = ActorFileIndices [kActorIndex] - 1u;
+
+                std::string_view const kActorName = Scene::GetActorName(Scene, kActorHandle);
+
+                if (kActorName.size() > 0u)
+                {
+                    ActorNameOffsets [kFileIndex] = ::AddString(StringTable, kActorName);
+                }
+
+                uint32 ParentActorHandle = {};
+
+                if ((kComponentMask & static_cast<uint32>(Scene::ComponentMasks::Transform)) && Transform::GetParent(kActorHandle, ParentActorHandle) && ParentActorHandle != 0u)
+                {
+                    ActorParentIndices [kFileIndex] = ActorFileIndices [Scene::GetActorIndex(ParentActorHandle)];
+                }
+            }
+        }
+
+        Header.BlockCount++;
+    }
+
+    if (!bResult)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to save scene. An actor references an asset that doesn't exist."));
+        return false;
+    }
+
+    Header.StaticMeshCount = static_cast<uint32>(StaticMeshReferences.size());
+    Header.TextureCount = static_cast<uint32>(TextureReferences.size());
+    Header.MaterialCount = static_cast<uint32>(MaterialReferences.size());
+    Header.StringTableSizeInBytes = static_cast<uint32>(StringTable.size());
+
+    std::vector<std::byte> FileData = {};
+    FileData.reserve(sizeof(Header) + StringTable.size() + BlockData.size() + static_cast<uint64>(SavedActorCount) * 2u * sizeof(uint32) + 4096u);
+
+    ::WriteBytes(FileData, &Header, sizeof(Header));
+    ::WriteBytes(FileData, StringTable.data(), StringTable.size());
+    ::WriteBytes(FileData, StaticMeshReferences.data(), StaticMeshReferences.size() * sizeof(Private::AssetReference));
+    ::WriteBytes(FileData, TextureReferences.data(), TextureReferences.size() * sizeof(Private::AssetReference));
+    ::WriteBytes(FileData, MaterialReferences.data(), MaterialReferences.size() * sizeof(Private::MaterialReference));
+    ::WriteBytes(FileData, ActorNameOffsets.data(), ActorNameOffsets.size() * sizeof(uint32));
+    ::WriteBytes(FileData, ActorParentIndices.data(), ActorParentIndices.size() * sizeof(uint32));
+    ::WriteBytes(FileData, BlockData.data(), BlockData.size());
+
+    std::ofstream FileStream = std::ofstream(FilePath, std::ios::binary | std::ios::trunc);
+    FileStream.write(reinterpret_cast<char const *>(FileData.data()), static_cast<std::streamsize>(FileData.size()));
+
+    if (!FileStream)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to write scene file."));
+        return false;
+    }
+
+    return true;
+}
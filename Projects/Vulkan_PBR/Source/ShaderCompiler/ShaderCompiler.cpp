@@ -278,7 +278,34 @@ GLSLangStage GetShaderStage(std::filesystem::path const & ShaderFilePath)
     return ShaderStage;
 }
 
-bool const ShaderCompiler::CompileShader(std::filesystem::path const & ShaderFilePath, unsigned int *& OutputByteCode, uint64 & OutputByteCodeSizeInBytes, std::basic_string<Char> & OutputErrorMessage)
+/* #version has to come first, so the defines go on the line after it. #line keeps the line numbers in error messages matching the file */
+static void InsertDefines(std::vector<std::string> const & Defines, std::string & ShaderSource)
+{
+    if (Defines.empty())
+    {
+        return;
+    }
+
+    std::size_t const kVersionLineEnd = ShaderSource.find('\n', ShaderSource.find("#version"));
+
+    if (kVersionLineEnd == std::string::npos)
+    {
+        return;
+    }
+
+    std::string DefineLines = {};
+
+    for (std::string const & Define : Defines)
+    {
+        DefineLines += "#define " + Define + "\n";
+    }
+
+    DefineLines += "#line 2\n";
+
+    ShaderSource.insert(kVersionLineEnd + 1u, DefineLines);
+}
+
+bool const ShaderCompiler::CompileShader(std::filesystem::path const & ShaderFilePath, std::vector<std::string> const & Defines, unsigned int *& OutputByteCode, uint64 & OutputByteCodeSizeInBytes, std::basic_string<Char> & OutputErrorMessage)
 {
     bool bResult = false;
 
@@ -291,6 +318,8 @@ bool const ShaderCompiler::CompileShader(std::filesystem::path const & ShaderFil
         std::string FileContent = std::string(kFileSizeInBytes, '\0');
         if (ShaderFileStream.read(FileContent.data(), kFileSizeInBytes))
         {
+            ::InsertDefines(Defines, FileContent);
+
             GLSLangShader * Shader = {};
             GLSLangProgram * Program = {};
 
@@ -0,0 +1,870 @@
+#include "SpatialIndex.hpp"
+
+#include "Assets/StaticMesh.hpp"
+#include "Components/Archetypes.hpp"
+#include "Components/TransformComponent.hpp"
+#include "Jobs.hpp"
+#include "Scene.hpp"
+
+#include <Math/Affine.hpp>
+
+#include <algorithm>
+#include <array>
+
+namespace SpatialIndex::Private
+{
+    static constexpr uint32 kInvalidNodeIndex = { ~0u };
+
+    /* Stored in the top bit of traversal stack entries, node indices never get this large */
+    static constexpr uint32 kInsideFrustumFlag = { 1u << 31u };
+
+    struct Node
+    {
+        /* Enlarged for leaves */
+        Math::AABB Bounds = {};
+
+        uint32 ParentIndex = { kInvalidNodeIndex };
+
+        /* Both are invalid for leaves */
+        std::array<uint32, 2u> ChildIndices = { kInvalidNodeIndex, kInvalidNodeIndex };
+
+        /* NULL for internal and free nodes */
+        uint32 ActorHandle = {};
+    };
+
+    struct BuildLeaf
+    {
+        Math::AABB Bounds = {};
+        Math::AABB ActorBounds = {};
+        Math::Vector3 Centre = {};
+        uint32 ActorHandle = {};
+    };
+
+    struct BuildTask
+    {
+        uint32 FirstLeafIndex = {};
+        uint32 LeafCount = {};
+        uint32 ParentIndex = {};
+        uint8 ChildSlot = {};
+    };
+
+    static std::vector<Node> Nodes = {};
+    static std::vector<uint32> FreeNodeIndices = {};
+
+    /* Indexed by node and only valid for leaves, queries test these rather than the enlarged leaf bounds */
+    static std::vector<Math::AABB> ActorBounds = {};
+
+    /* Indexed by actor index */
+    static std::vector<uint32> ActorLeafIndices = {};
+
+    static std::vector<uint32> DirtyActorHandles = {};
+
+    static uint32 RootIndex = { kInvalidNodeIndex };
+    static uint32 LeafCount = {};
+
+    /* Leaves inserted or reinserted since the last rebuild */
+    static uint32 ChangedLeafCount = {};
+
+    /* Leaf bounds are enlarged by this fraction of the actor's largest extent on every side */
+    static float const kLeafBoundsMargin = { 0.1f };
+
+    static uint32 const kBinCount = { 16u };
+
+    /* Trees smaller than this are queried on the calling thread */
+    static uint32 const kParallelQueryLeafCount = { 16384u };
+    static uint32 const kParallelQuerySubtreeCount = { 64u };
+
+    static uint32 const kBoundsBatchSize = { 1024u };
+}
+
+using namespace SpatialIndex;
+
+static bool const IsLeaf(Private::Node const & kNode)
+{
+    return kNode.ChildIndices [0u] == Private::kInvalidNodeIndex;
+}
+
+static float const GetAxis(Math::Vector3 const & kVector, uint8 const kAxis)
+{
+    return kAxis == 0u ? kVector.X : (kAxis == 1u ? kVector.Y : kVector.Z);
+}
+
+static Math::AABB const EnlargeBounds(Math::AABB const & kBounds)
+{
+    float const kMargin = Private::kLeafBoundsMargin * std::max({ kBounds.Maximum.X - kBounds.Minimum.X, kBounds.Maximum.Y - kBounds.Minimum.Y, kBounds.Maximum.Z - kBounds.Minimum.Z });
+
+    return Math::AABB
+    {
+        Math::Vector3 { kBounds.Minimum.X - kMargin, kBounds.Minimum.Y - kMargin, kBounds.Minimum.Z - kMargin },
+        Math::Vector3 { kBounds.Maximum.X + kMargin, kBounds.Maximum.Y + kMargin, kBounds.Maximum.Z + kMargin },
+    };
+}
+
+static uint32 const AllocateNode()
+{
+    uint32 NodeIndex = {};
+
+    if (Private::FreeNodeIndices.size() > 0u)
+    {
+        NodeIndex = Private::FreeNodeIndices.back();
+        Private::FreeNodeIndices.pop_back();
+    }
+    else
+    {
+        NodeIndex = static_cast<uint32>(Private::Nodes.size());
+        Private::Nodes.emplace_back();
+        Private::ActorBounds.emplace_back();
+    }
+
+    return NodeIndex;
+}
+
+static void FreeNode(uint32 const kNodeIndex)
+{
+    Private::Nodes [kNodeIndex] = Private::Node {};
+    Private::FreeNodeIndices.push_back(kNodeIndex);
+}
+
+/* Walks up from the node recomputing bounds, stops early once a node's bounds don't change */
+static void RefitAncestors(uint32 const kFirstNodeIndex)
+{
+    for (uint32 CurrentNodeIndex = { kFirstNodeIndex };
+         CurrentNodeIndex != Private::kInvalidNodeIndex;
+         CurrentNodeIndex = Private::Nodes [CurrentNodeIndex].ParentIndex)
+    {
+        Private::Node & Node = Private::Nodes [CurrentNodeIndex];
+
+        Math::AABB const kBounds = Math::AABB::Union(Private::Nodes [Node.ChildIndices [0u]].Bounds, Private::Nodes [Node.ChildIndices [1u]].Bounds);
+
+        if (Math::AABB::Contains(Node.Bounds, kBounds) && Math::AABB::Contains(kBounds, Node.Bounds))
+        {
+            break;
+        }
+
+        Node.Bounds = kBounds;
+    }
+}
+
+/* Pairs the leaf with the sibling that adds the least surface area to the tree, following Box2D's dynamic tree */
+static void InsertLeaf(uint32 const kLeafIndex)
+{
+    if (Private::RootIndex == Private::kInvalidNodeIndex)
+    {
+        Private::RootIndex = kLeafIndex;
+        Private::Nodes [kLeafIndex].ParentIndex = Private::kInvalidNodeIndex;
+        return;
+    }
+
+    Math::AABB const kLeafBounds = Private::Nodes [kLeafIndex].Bounds;
+
+    uint32 SiblingIndex = { Private::RootIndex };
+
+    while (!::IsLeaf(Private::Nodes [SiblingIndex]))
+    {
+        Private::Node const & kNode = Private::Nodes [SiblingIndex];
+
+        float const kCombinedArea = Math::AABB::HalfSurfaceArea(Math::AABB::Union(kNode.Bounds, kLeafBounds));
+
+        /* Cost of a new parent for this node and the leaf */
+        float const kCost = 2.0f * kCombinedArea;
+
+        /* Every ancestor of the new parent grows by at least this much */
+        float const kInheritedCost = 2.0f * (kCombinedArea - Math::AABB::HalfSurfaceArea(kNode.Bounds));
+
+        std::array<float, 2u> ChildCosts = {};
+
+        for (uint8 ChildSlot = {};
+             ChildSlot < ChildCosts.size();
+             ChildSlot++)
+        {
+            Private::Node const & kChild = Private::Nodes [kNode.ChildIndices [ChildSlot]];
+
+            float const kChildCombinedArea = Math::AABB::HalfSurfaceArea(Math::AABB::Union(kChild.Bounds, kLeafBounds));
+
+            ChildCosts [ChildSlot] = ::IsLeaf(kChild)
+                ? kChildCombinedArea + kInheritedCost
+                : kChildCombinedArea - Math::AABB::HalfSurfaceArea(kChild.Bounds) + kInheritedCost;
+        }
+
+        if (kCost < ChildCosts [0u] && kCost < ChildCosts [1u])
+        {
+            break;
+        }
+
+        SiblingIndex = ChildCosts [0u] <= ChildCosts [1u] ? kNode.ChildIndices [0u] : kNode.ChildIndices [1u];
+    }
+
+    uint32 const kOldParentIndex = Private::Nodes [SiblingIndex].ParentIndex;
+
+    /* Allocating can reallocate the node array, so no references are held across this */
+    uint32 const kNewParentIndex = ::AllocateNode();
+
+    Private::Node & NewParent = Private::Nodes [kNewParentIndex];
+    NewParent.Bounds = Math::AABB::Union(Private::Nodes [SiblingIndex].Bounds, kLeafBounds);
+    NewParent.ParentIndex = kOldParentIndex;
+    NewParent.ChildIndices = { SiblingIndex, kLeafIndex };
+
+    Private::Nodes [SiblingIndex].ParentIndex = kNewParentIndex;
+    Private::Nodes [kLeafIndex].ParentIndex = kNewParentIndex;
+
+    if (kOldParentIndex == Private::kInvalidNodeIndex)
+    {
+        Private::RootIndex = kNewParentIndex;
+    }
+    else
+    {
+        Private::Node & OldParent = Private::Nodes [kOldParentIndex];
+        OldParent.ChildIndices [OldParent.ChildIndices [0u] == SiblingIndex ? 0u : 1u] = kNewParentIndex;
+
+        ::RefitAncestors(kOldParentIndex);
+    }
+}
+
+/* The leaf's parent is freed and its sibling takes the parent's place */
+static void RemoveLeaf(uint32 const kLeafIndex)
+{
+    if (kLeafIndex == Private::RootIndex)
+    {
+        Private::RootIndex = Private::kInvalidNodeIndex;
+        return;
+    }
+
+    uint32 const kParentIndex = Private::Nodes [kLeafIndex].ParentIndex;
+
+    Private::Node const & kParent = Private::Nodes [kParentIndex];
+
+    uint32 const kSiblingIndex = kParent.ChildIndices [0u] == kLeafIndex ? kParent.ChildIndices [1u] : kParent.ChildIndices [0u];
+    uint32 const kGrandparentIndex = kParent.ParentIndex;
+
+    Private::Nodes [kSiblingIndex].ParentIndex = kGrandparentIndex;
+
+    if (kGrandparentIndex == Private::kInvalidNodeIndex)
+    {
+        Private::RootIndex = kSiblingIndex;
+    }
+    else
+    {
+        Private::Node & Grandparent = Private::Nodes [kGrandparentIndex];
+        Grandparent.ChildIndices [Grandparent.ChildIndices [0u] == kParentIndex ? 0u : 1u] = kSiblingIndex;
+
+        ::RefitAncestors(kGrandparentIndex);
+    }
+
+    ::FreeNode(kParentIndex);
+
+    Private::Nodes [kLeafIndex].ParentIndex = Private::kInvalidNodeIndex;
+}
+
+/* Outputs the actor's leaf, the leaf stores the full handle so stale handles fail */
+static bool const FindLeafIndex(uint32 const kActorHandle, uint32 & OutputLeafIndex)
+{
+    if (kActorHandle == 0u)
+    {
+        return false;
+    }
+
+    uint32 const kActorIndex = Scene::GetActorIndex(kActorHandle);
+
+    if (kActorIndex >= Private::ActorLeafIndices.size())
+    {
+        return false;
+    }
+
+    uint32 const kLeafIndex = Private::ActorLeafIndices [kActorIndex];
+
+    if (kLeafIndex == Private::kInvalidNodeIndex || Private::Nodes [kLeafIndex].ActorHandle != kActorHandle)
+    {
+        return false;
+    }
+
+    OutputLeafIndex = kLeafIndex;
+
+    return true;
+}
+
+/* When bInsert is false the leaf is left out of the tree, it is picked up by the next rebuild */
+static void SetActorBounds(uint32 const kActorHandle, Math::AABB const & kBounds, bool const bInsert)
+{
+    uint32 const kActorIndex = Scene::GetActorIndex(kActorHandle);
+
+    if (kActorIndex >= Private::ActorLeafIndices.size())
+    {
+        Private::ActorLeafIndices.resize(kActorIndex + 1u, Private::kInvalidNodeIndex);
+    }
+
+    uint32 LeafIndex = { Private::ActorLeafIndices [kActorIndex] };
+
+    /* The previous actor at this index was destroyed without being removed */
+    if (LeafIndex != Private::kInvalidNodeIndex && Private::Nodes [LeafIndex].ActorHandle != kActorHandle)
+    {
+        SpatialIndex::RemoveActor(Private::Nodes [LeafIndex].ActorHandle);
+        LeafIndex = Private::kInvalidNodeIndex;
+    }
+
+    if (LeafIndex != Private::kInvalidNodeIndex)
+    {
+        Private::ActorBounds [LeafIndex] = kBounds;
+
+        /* Small movements stay inside the enlarged bounds and don't touch the tree */
+        if (Math::AABB::Contains(Private::Nodes [LeafIndex].Bounds, kBounds))
+        {
+            return;
+        }
+
+        ::RemoveLeaf(LeafIndex);
+    }
+    else
+    {
+        LeafIndex = ::AllocateNode();
+
+        Private::Nodes [LeafIndex].ActorHandle = kActorHandle;
+        Private::ActorBounds [LeafIndex] = kBounds;
+        Private::ActorLeafIndices [kActorIndex] = LeafIndex;
+
+        Private::LeafCount++;
+    }
+
+    Private::Nodes [LeafIndex].Bounds = ::EnlargeBounds(kBounds);
+    Private::ChangedLeafCount++;
+
+    if (bInsert)
+    {
+        ::InsertLeaf(LeafIndex);
+    }
+}
+
+/* World space bounds of the mesh's quantisation cube */
+static bool const ComputeActorBounds(Scene::SceneData const & kScene, uint32 const kActorHandle, Math::AABB & OutputBounds)
+{
+    uint32 const kRenderableComponentMask = static_cast<uint32>(Scene::ComponentMasks::Transform) | static_cast<uint32>(Scene::ComponentMasks::StaticMesh);
+
+    if (!Scene::DoesActorHaveComponents(kScene, kActorHandle, kRenderableComponentMask))
+    {
+        return false;
+    }
+
+    Components::Archetypes::Types::ChunkView Chunk = {};
+    uint32 RowIndex = {};
+
+    Assets::StaticMesh::Types::StaticMesh MeshData = {};
+    Math::Affine3x4 ModelToWorldMatrix = {};
+
+    bool bResult = Components::Archetypes::GetEntity(kActorHandle, Chunk, RowIndex);
+    bResult = bResult && Assets::StaticMesh::GetAssetData(Chunk.GetColumn<Components::Archetypes::Types::Columns::MeshHandle>() [RowIndex], MeshData);
+    bResult = bResult && Components::Transform::GetTransformationMatrix(kActorHandle, ModelToWorldMatrix);
+
+    if (bResult)
+    {
+        Math::AABB const kUnitCube = { Math::Vector3::Zero(), Math::Vector3::One() };
+        OutputBounds = Math::TransformAABB(ModelToWorldMatrix * Assets::StaticMesh::GetMeshToModelTransform(MeshData), kUnitCube);
+    }
+
+    return bResult;
+}
+
+static void QuerySubtreeFrustum(Math::FrustumPlanes const & kPlanes, uint32 const kStackEntry, std::vector<uint32> & OutputActorHandles)
+{
+    std::vector<uint32> Stack = {};
+    Stack.reserve(64u);
+    Stack.push_back(kStackEntry);
+
+    while (Stack.size() > 0u)
+    {
+        uint32 const kEntry = Stack.back();
+        Stack.pop_back();
+
+        uint32 const kNodeIndex = kEntry & ~Private::kInsideFrustumFlag;
+        uint32 InsideFlag = kEntry & Private::kInsideFrustumFlag;
+
+        Private::Node const & kNode = Private::Nodes [kNodeIndex];
+        bool const bLeaf = ::IsLeaf(kNode);
+
+        /* Everything below a node that is fully inside is visible, so no more tests are needed */
+        if (!InsideFlag)
+        {
+            Math::FrustumTestResults const kResult = Math::TestFrustumAABB(kPlanes, bLeaf ? Private::ActorBounds [kNodeIndex] : kNode.Bounds);
+
+            if (kResult == Math::FrustumTestResults::Outside)
+            {
+                continue;
+            }
+
+            InsideFlag = kResult == Math::FrustumTestResults::Inside ? Private::kInsideFrustumFlag : 0u;
+        }
+
+        if (bLeaf)
+        {
+            OutputActorHandles.push_back(kNode.ActorHandle);
+        }
+        else
+        {
+            Stack.push_back(kNode.ChildIndices [1u] | InsideFlag);
+            Stack.push_back(kNode.ChildIndices [0u] | InsideFlag);
+        }
+    }
+}
+
+void SpatialIndex::UpdateActor(uint32 const ActorHandle, Math::AABB const & Bounds)
+{
+    if (ActorHandle == 0u)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Cannot add NULL actor to the spatial index."));
+        return;
+    }
+
+    ::SetActorBounds(ActorHandle, Bounds, true);
+}
+
+void SpatialIndex::RemoveActor(uint32 const ActorHandle)
+{
+    uint32 LeafIndex = {};
+
+    if (!::FindLeafIndex(ActorHandle, LeafIndex))
+    {
+        return;
+    }
+
+    /* Leaves waiting for a rebuild aren't in the tree yet */
+    if (LeafIndex == Private::RootIndex || Private::Nodes [LeafIndex].ParentIndex != Private::kInvalidNodeIndex)
+    {
+        ::RemoveLeaf(LeafIndex);
+    }
+
+    ::FreeNode(LeafIndex);
+
+    Private::ActorLeafIndices [Scene::GetActorIndex(ActorHandle)] = Private::kInvalidNodeIndex;
+    Private::LeafCount--;
+}
+
+void SpatialIndex::MarkActorDirty(uint32 const ActorHandle)
+{
+    Private::DirtyActorHandles.push_back(ActorHandle);
+}
+
+void SpatialIndex::Synchronise(Scene::SceneData const & Scene)
+{
+    Components::Transform::FlushMovedActors(Private::DirtyActorHandles);
+
+    if (Private::DirtyActorHandles.size() == 0u)
+    {
+        return;
+    }
+
+    uint32 const kDirtyActorCount = static_cast<uint32>(Private::DirtyActorHandles.size());
+
+    std::vector<Math::AABB> Bounds = std::vector<Math::AABB>(kDirtyActorCount);
+    std::vector<uint8> HasBounds = std::vector<uint8>(kDirtyActorCount);
+
+    /* Only reads scene and component data, so this can be spread across the workers */
+    Jobs::ParallelFor(kDirtyActorCount, Private::kBoundsBatchSize,
+                      [&Scene, &Bounds, &HasBounds](uint32 const FirstIndex, uint32 const EndIndex)
+                      {
+                          for (uint32 CurrentIndex = { FirstIndex };
+                               CurrentIndex < EndIndex;
+                               CurrentIndex++)
+                          {
+                              HasBounds [CurrentIndex] = static_cast<uint8>(::ComputeActorBounds(Scene, Private::DirtyActorHandles [CurrentIndex], Bounds [CurrentIndex]));
+                          }
+                      });
+
+    /* When most of the tree is changing (e.g. loading a level) a single rebuild is cheaper than inserting one at a time */
+    bool const bBulkUpdate = kDirtyActorCount > Private::LeafCount / 2u;
+
+    if (bBulkUpdate)
+    {
+        for (uint32 CurrentIndex = {};
+             CurrentIndex < kDirtyActorCount;
+             CurrentIndex++)
+        {
+            SpatialIndex::RemoveActor(Private::DirtyActorHandles [CurrentIndex]);
+        }
+    }
+
+    for (uint32 CurrentIndex = {};
+         CurrentIndex < kDirtyActorCount;
+         CurrentIndex++)
+    {
+        uint32 const kActorHandle = Private::DirtyActorHandles [CurrentIndex];
+
+        if (HasBounds [CurrentIndex])
+        {
+            ::SetActorBounds(kActorHandle, Bounds [CurrentIndex], !bBulkUpdate);
+        }
+        else
+        {
+            SpatialIndex::RemoveActor(kActorHandle);
+        }
+    }
+
+    Private::DirtyActorHandles.clear();
+
+    /* Incremental inserts are greedy, so rebuild once the number of changes is comparable to the size of the tree */
+    if (bBulkUpdate || Private::ChangedLeafCount > Private::LeafCount)
+    {
+        SpatialIndex::Rebuild();
+    }
+}
+
+void SpatialIndex::Rebuild()
+{
+    std::vector<Private::BuildLeaf> Leaves = {};
+    Leaves.reserve(Private::LeafCount);
+
+    for (uint32 CurrentNodeIndex = {};
+         CurrentNodeIndex < Private::Nodes.size();
+         CurrentNodeIndex++)
+    {
+        Private::Node const & kNode = Private::Nodes [CurrentNodeIndex];
+
+        if (kNode.ActorHandle != 0u)
+        {
+            Leaves.push_back(Private::BuildLeaf { kNode.Bounds, Private::ActorBounds [CurrentNodeIndex], Math::AABB::Centre(kNode.Bounds), kNode.ActorHandle });
+        }
+    }
+
+    Private::Nodes.clear();
+    Private::ActorBounds.clear();
+    Private::FreeNodeIndices.clear();
+
+    Private::RootIndex = Private::kInvalidNodeIndex;
+    Private::ChangedLeafCount = 0u;
+
+    if (Leaves.size() == 0u)
+    {
+        return;
+    }
+
+    Private::Nodes.reserve(Leaves.size() * 2u - 1u);
+    Private::ActorBounds.reserve(Leaves.size() * 2u - 1u);
+
+    /* Iterative so that unbalanced splits can't overflow the call stack, left children are built first so subtrees are contiguous */
+    std::vector<Private::BuildTask> Tasks = {};
+    Tasks.push_back(Private::BuildTask { 0u, static_cast<uint32>(Leaves.size()), Private::kInvalidNodeIndex, 0u });
+
+    while (Tasks.size() > 0u)
+    {
+        Private::BuildTask const kTask = Tasks.back();
+        Tasks.pop_back();
+
+        uint32 const kNodeIndex = ::AllocateNode();
+
+        Private::Nodes [kNodeIndex].ParentIndex = kTask.ParentIndex;
+
+        if (kTask.ParentIndex == Private::kInvalidNodeIndex)
+        {
+            Private::RootIndex = kNodeIndex;
+        }
+        else
+        {
+            Private::Nodes [kTask.ParentIndex].ChildIndices [kTask.ChildSlot] = kNodeIndex;
+        }
+
+        std::vector<Private::BuildLeaf>::iterator const kFirstLeaf = Leaves.begin() + kTask.FirstLeafIndex;
+        std::vector<Private::BuildLeaf>::iterator const kEndLeaf = kFirstLeaf + kTask.LeafCount;
+
+        if (kTask.LeafCount == 1u)
+        {
+            Private::Nodes [kNodeIndex].Bounds = kFirstLeaf->Bounds;
+            Private::Nodes [kNodeIndex].ActorHandle = kFirstLeaf->ActorHandle;
+            Private::ActorBounds [kNodeIndex] = kFirstLeaf->ActorBounds;
+            Private::ActorLeafIndices [Scene::GetActorIndex(kFirstLeaf->ActorHandle)] = kNodeIndex;
+            continue;
+        }
+
+        Math::AABB NodeBounds = Math::AABB::Empty();
+        Math::AABB CentreBounds = Math::AABB::Empty();
+
+        for (std::vector<Private::BuildLeaf>::iterator CurrentLeaf = kFirstLeaf;
+             CurrentLeaf != kEndLeaf;
+             CurrentLeaf++)
+        {
+            NodeBounds = Math::AABB::Union(NodeBounds, CurrentLeaf->Bounds);
+            CentreBounds = Math::AABB::Union(CentreBounds, Math::AABB { CurrentLeaf->Centre, CurrentLeaf->Centre });
+        }
+
+        Private::Nodes [kNodeIndex].Bounds = NodeBounds;
+
+        /* Split along the axis the centres are most spread out on */
+        Math::Vector3 const kCentreExtent = CentreBounds.Maximum - CentreBounds.Minimum;
+        uint8 const kAxis = static_cast<uint8>(kCentreExtent.X >= kCentreExtent.Y && kCentreExtent.X >= kCentreExtent.Z ? 0u : (kCentreExtent.Y >= kCentreExtent.Z ? 1u : 2u));
+
+        float const kAxisMinimum = ::GetAxis(CentreBounds.Minimum, kAxis);
+        float const kAxisExtent = ::GetAxis(kCentreExtent, kAxis);
+
+        uint32 LeftLeafCount = {};
+
+        if (kAxisExtent > 0.0f)
+        {
+            float const kBinScale = static_cast<float>(Private::kBinCount) / kAxisExtent;
+
+            auto const GetBinIndex = [kAxis, kAxisMinimum, kBinScale](Private::BuildLeaf const & kLeaf)
+            {
+                return std::min(static_cast<uint32>((::GetAxis(kLeaf.Centre, kAxis) - kAxisMinimum) * kBinScale), Private::kBinCount - 1u);
+            };
+
+            std::array<Math::AABB, Private::kBinCount> BinBounds = {};
+            std::array<uint32, Private::kBinCount> BinLeafCounts = {};
+            BinBounds.fill(Math::AABB::Empty());
+
+            for (std::vector<Private::BuildLeaf>::iterator CurrentLeaf = kFirstLeaf;
+                 CurrentLeaf != kEndLeaf;
+                 CurrentLeaf++)
+            {
+                uint32 const kBinIndex = GetBinIndex(*CurrentLeaf);
+
+                BinBounds [kBinIndex] = Math::AABB::Union(BinBounds [kBinIndex], CurrentLeaf->Bounds);
+                BinLeafCounts [kBinIndex]++;
+            }
+
+            /* Surface area and count of everything right of each split plane */
+            std::array<float, Private::kBinCount> RightAreas = {};
+            std::array<uint32, Private::kBinCount> RightLeafCounts = {};
+
+            {
+                Math::AABB RightBounds = Math::AABB::Empty();
+                uint32 RightLeafCount = {};
+
+                for (uint32 BinIndex = { Private::kBinCount - 1u };
+                     BinIndex > 0u;
+                     BinIndex--)
+                {
+                    RightBounds = Math::AABB::Union(RightBounds, BinBounds [BinIndex]);
+                    RightLeafCount += BinLeafCounts [BinIndex];
+
+                    RightAreas [BinIndex] = RightLeafCount > 0u ? Math::AABB::HalfSurfaceArea(RightBounds) : 0.0f;
+                    RightLeafCounts [BinIndex] = RightLeafCount;
+                }
+            }
+
+            float BestCost = { 3.402823466e+38f };
+            uint32 BestSplitIndex = {};
+
+            Math::AABB LeftBounds = Math::AABB::Empty();
+            uint32 RunningLeftLeafCount = {};
+
+            for (uint32 SplitIndex = { 1u };
+                 SplitIndex < Private::kBinCount;
+                 SplitIndex++)
+            {
+                LeftBounds = Math::AABB::Union(LeftBounds, BinBounds [SplitIndex - 1u]);
+                RunningLeftLeafCount += BinLeafCounts [SplitIndex - 1u];
+
+                if (RunningLeftLeafCount == 0u || RightLeafCounts [SplitIndex] == 0u)
+                {
+                    continue;
+                }
+
+                float const kCost = static_cast<float>(RunningLeftLeafCount) * Math::AABB::HalfSurfaceArea(LeftBounds)
+                                  + static_cast<float>(RightLeafCounts [SplitIndex]) * RightAreas [SplitIndex];
+
+                if (kCost < BestCost)
+                {
+                    BestCost = kCost;
+                    BestSplitIndex = SplitIndex;
+                }
+            }
+
+            if (BestSplitIndex > 0u)
+            {
+                std::vector<Private::BuildLeaf>::iterator const kMiddleLeaf = std::partition(kFirstLeaf, kEndLeaf,
+                                                                                             [&GetBinIndex, BestSplitIndex](Private::BuildLeaf const & kLeaf)
+                                                                                             {
+                                                                                                 return GetBinIndex(kLeaf) < BestSplitIndex;
+                                                                                             });
+
+                LeftLeafCount = static_cast<uint32>(kMiddleLeaf - kFirstLeaf);
+            }
+        }
+
+        /* Every centre is in the same place (or bin), fall back to splitting the leaves in half */
+        if (LeftLeafCount == 0u || LeftLeafCount == kTask.LeafCount)
+        {
+            LeftLeafCount = kTask.LeafCount / 2u;
+
+            std::nth_element(kFirstLeaf, kFirstLeaf + LeftLeafCount, kEndLeaf,
+                             [kAxis](Private::BuildLeaf const & kLeft, Private::BuildLeaf const & kRight)
+                             {
+                                 return ::GetAxis(kLeft.Centre, kAxis) < ::GetAxis(kRight.Centre, kAxis);
+                             });
+        }
+
+        Tasks.push_back(Private::BuildTask { kTask.FirstLeafIndex + LeftLeafCount, kTask.LeafCount - LeftLeafCount, kNodeIndex, 1u });
+        Tasks.push_back(Private::BuildTask { kTask.FirstLeafIndex, LeftLeafCount, kNodeIndex, 0u });
+    }
+}
+
+void SpatialIndex::QueryFrustum(Math::FrustumPlanes const & Planes, std::vector<uint32> & OutputActorHandles)
+{
+    if (Private::RootIndex == Private::kInvalidNodeIndex)
+    {
+        return;
+    }
+
+    if (Private::LeafCount < Private::kParallelQueryLeafCount)
+    {
+        ::QuerySubtreeFrustum(Planes, Private::RootIndex, OutputActorHandles);
+        return;
+    }
+
+    /* Expand the top of the tree breadth first until there are enough subtrees to spread across the workers */
+    std::vector<uint32> Subtrees = { Private::RootIndex };
+
+    for (bool bExpanded = true;
+         bExpanded && Subtrees.size() < Private::kParallelQuerySubtreeCount;)
+    {
+        bExpanded = false;
+
+        std::vector<uint32> NextSubtrees = {};
+        NextSubtrees.reserve(Subtrees.size() * 2u);
+
+        for (uint32 const kEntry : Subtrees)
+        {
+            Private::Node const & kNode = Private::Nodes [kEntry & ~Private::kInsideFrustumFlag];
+
+            if ((kEntry & Private::kInsideFrustumFlag) || ::IsLeaf(kNode))
+            {
+                NextSubtrees.push_back(kEntry);
+                continue;
+            }
+
+            Math::FrustumTestResults const kResult = Math::TestFrustumAABB(Planes, kNode.Bounds);
+
+            if (kResult == Math::FrustumTestResults::Inside)
+            {
+                NextSubtrees.push_back(kEntry | Private::kInsideFrustumFlag);
+            }
+            else if (kResult == Math::FrustumTestResults::Intersecting)
+            {
+                NextSubtrees.push_back(kNode.ChildIndices [0u]);
+                NextSubtrees.push_back(kNode.ChildIndices [1u]);
+            }
+
+            bExpanded = true;
+        }
+
+        Subtrees = std::move(NextSubtrees);
+    }
+
+    std::vector<std::vector<uint32>> SubtreeActorHandles = std::vector<std::vector<uint32>>(Subtrees.size());
+
+    Jobs::ParallelFor(static_cast<uint32>(Subtrees.size()), 1u,
+                      [&Planes, &Subtrees, &SubtreeActorHandles](uint32 const FirstIndex, uint32 const EndIndex)
+                      {
+                          for (uint32 CurrentIndex = { FirstIndex };
+                               CurrentIndex < EndIndex;
+                               CurrentIndex++)
+                          {
+                              ::QuerySubtreeFrustum(Planes, Subtrees [CurrentIndex], SubtreeActorHandles [CurrentIndex]);
+                          }
+                      });
+
+    for (std::vector<uint32> const & kActorHandles : SubtreeActorHandles)
+    {
+        OutputActorHandles.insert(OutputActorHandles.end(), kActorHandles.cbegin(), kActorHandles.cend());
+    }
+}
+
+void SpatialIndex::QueryOverlap(Math::AABB const & Bounds, std::vector<uint32> & OutputActorHandles)
+{
+    if (Private::RootIndex == Private::kInvalidNodeIndex)
+    {
+        return;
+    }
+
+    std::vector<uint32> Stack = { Private::RootIndex };
+
+    while (Stack.size() > 0u)
+    {
+        uint32 const kNodeIndex = Stack.back();
+        Stack.pop_back();
+
+        Private::Node const & kNode = Private::Nodes [kNodeIndex];
+
+        if (::IsLeaf(kNode))
+        {
+            if (Math::AABB::Overlaps(Private::ActorBounds [kNodeIndex], Bounds))
+            {
+                OutputActorHandles.push_back(kNode.ActorHandle);
+            }
+        }
+        else if (Math::AABB::Overlaps(kNode.Bounds, Bounds))
+        {
+            Stack.push_back(kNode.ChildIndices [1u]);
+            Stack.push_back(kNode.ChildIndices [0u]);
+        }
+    }
+}
+
+bool const SpatialIndex::RayCast(Math::Vector3 const & Origin, Math::Vector3 const & Direction, float const MaximumDistance, Types::RayHit & OutputHit)
+{
+    if (Private::RootIndex == Private::kInvalidNodeIndex)
+    {
+        return false;
+    }
+
+    Math::Vector3 const kInverseDirection = { 1.0f / Direction.X, 1.0f / Direction.Y, 1.0f / Direction.Z };
+
+    bool bHit = false;
+    float ClosestDistance = { MaximumDistance };
+
+    std::vector<uint32> Stack = { Private::RootIndex };
+
+    while (Stack.size() > 0u)
+    {
+        uint32 const kNodeIndex = Stack.back();
+        Stack.pop_back();
+
+        Private::Node const & kNode = Private::Nodes [kNodeIndex];
+        bool const bLeaf = ::IsLeaf(kNode);
+
+        /* Anything further than the closest hit so far is skipped */
+        float EntryDistance = {};
+        if (!Math::IntersectRayAABB(Origin, kInverseDirection, ClosestDistance, bLeaf ? Private::ActorBounds [kNodeIndex] : kNode.Bounds, EntryDistance))
+        {
+            continue;
+        }
+
+        if (bLeaf)
+        {
+            bHit = true;
+            ClosestDistance = EntryDistance;
+            OutputHit = Types::RayHit { kNode.ActorHandle, EntryDistance };
+        }
+        else
+        {
+            Stack.push_back(kNode.ChildIndices [1u]);
+            Stack.push_back(kNode.ChildIndices [0u]);
+        }
+    }
+
+    return bHit;
+}
+
+uint32 const SpatialIndex::GetActorCount()
+{
+    return Private::LeafCount;
+}
+
+float const SpatialIndex::GetTreeCost()
+{
+    if (Private::RootIndex == Private::kInvalidNodeIndex)
+    {
+        return 0.0f;
+    }
+
+    float InternalArea = {};
+
+    for (uint32 CurrentNodeIndex = {};
+         CurrentNodeIndex < Private::Nodes.size();
+         CurrentNodeIndex++)
+    {
+        Private::Node const & kNode = Private::Nodes [CurrentNodeIndex];
+
+        if (!::IsLeaf(kNode))
+        {
+            InternalArea += Math::AABB::HalfSurfaceArea(kNode.Bounds);
+        }
+    }
+
+    return InternalArea / Math::AABB::HalfSurfaceArea(Private::Nodes [Private::RootIndex].Bounds);
+}
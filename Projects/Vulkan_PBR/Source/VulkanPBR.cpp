@@ -9,7 +9,13 @@
 #include "Graphics/VulkanModule.hpp"
 #include "Graphics/ShaderLibrary.hpp"
 #include "Input/InputManager.hpp"
+#include "Jobs.hpp"
+#include "RenderSnapshot.hpp"
 #include "Scene.hpp"
+#include "SceneFile.hpp"
+#include "SpatialIndex.hpp"
+#include "World/Partition.hpp"
+#include "World/Streaming.hpp"
 
 #include <Math/Transform.hpp>
 #include <Math/Utilities.hpp>
@@ -30,6 +36,17 @@ extern Application::ApplicationState Application::State = {};
 
 static Scene::SceneData PBRScene = {};
 
+/* Only used when the scene is a partitioned world */
+static World::Partition::Types::WorldData StreamedWorld = {};
+static World::Streaming::Types::StreamingState WorldStreamingState = {};
+static bool bStreamWorld = false;
+
+/* Toggled with P, so the cost of the pre-pass can be compared per scene */
+static bool bDepthPrePass = false;
+
+/* The simulation thread builds a snapshot of each frame while the render thread records the one before it */
+static RenderSnapshot::Types::SnapshotQueue RenderSnapshots = {};
+
 static UINT DPI = {};
 
 static LRESULT CALLBACK WindowProcedure(HWND Window, UINT Message, WPARAM WParam, LPARAM LParam)
@@ -94,42 +111,76 @@ static LRESULT CALLBACK WindowProcedure(HWND Window, UINT Message, WPARAM WParam
 static bool const SetupScene()
 {
     static std::filesystem::path const kAssetDirectoryPath = std::filesystem::current_path() / "Assets";
+    static std::filesystem::path const kSceneFilePath = kAssetDirectoryPath / "Boat.scene";
+    static std::filesystem::path const kWorldFilePath = kAssetDirectoryPath / "Boat.world";
 
-    uint32 BoatHandle = {};
-    bool bFoundBoat = Assets::StaticMesh::ImportStaticMesh(kAssetDirectoryPath / "Fishing Boat/Boat.obj", "Boat", BoatHandle);
+    bool bResult = false;
 
-    if (bFoundBoat)
+    if (std::filesystem::exists(kWorldFilePath))
     {
-        std::array<uint32, 5u> TextureHandles = {};
+        /* Cells are streamed in around the camera from the first update */
+        World::Streaming::Types::Settings const kStreamingSettings =
+        {
+            1500.0f, 1750.0f,
+            uint64 { 1024u } * 1024u * 1024u,
+            2000000u,
+            4u,
+        };
 
-        Assets::Texture::ImportTexture(kAssetDirectoryPath / "Fishing Boat/textures/boat_diffuse.bmp", "Boat Diffuse", TextureHandles[0u]);
-        Assets::Texture::ImportTexture(kAssetDirectoryPath / "Fishing Boat/textures/boat_ao.bmp", "Boat AO", TextureHandles [1u]);
-        Assets::Texture::ImportTexture(kAssetDirectoryPath / "Fishing Boat/textures/boat_normal.bmp", "Boat Normal", TextureHandles [2u]);
-        Assets::Texture::ImportTexture(kAssetDirectoryPath / "Fishing Boat/textures/boat_gloss.bmp", "Boat Gloss", TextureHandles [3u]);
-        Assets::Texture::ImportTexture(kAssetDirectoryPath / "Fishing Boat/textures/boat_specular.bmp", "Boat Specular", TextureHandles [4u]);
+        bResult = World::Partition::LoadWorld(kWorldFilePath, StreamedWorld);
+        bResult = bResult && World::Streaming::Initialise(WorldStreamingState, StreamedWorld.Layout, kStreamingSettings, World::Partition::CreateLoader(StreamedWorld, PBRScene));
 
-        Assets::Material::MaterialData const MaterialDesc =
+        bStreamWorld = bResult;
+    }
+    else if (std::filesystem::exists(kSceneFilePath))
+    {
+        std::vector<uint32> ActorHandles = {};
+        bResult = SceneFile::Load(kSceneFilePath, PBRScene, ActorHandles);
+    }
+    else
+    {
+        uint32 BoatHandle = {};
+        bResult = Assets::StaticMesh::ImportStaticMesh(kAssetDirectoryPath / "Fishing Boat/Boat.obj", "Boat", BoatHandle);
+
+        if (bResult)
         {
-            TextureHandles [0u], TextureHandles [2u],
-            TextureHandles [4u], TextureHandles [3u],
-            TextureHandles [1u],
-        };
+            std::array<uint32, 5u> TextureHandles = {};
+
+            Assets::Texture::ImportTexture(kAssetDirectoryPath / "Fishing Boat/textures/boat_diffuse.bmp", "Boat Diffuse", TextureHandles[0u]);
+            Assets::Texture::ImportTexture(kAssetDirectoryPath / "Fishing Boat/textures/boat_ao.bmp", "Boat AO", TextureHandles [1u]);
+            Assets::Texture::ImportTexture(kAssetDirectoryPath / "Fishing Boat/textures/boat_normal.bmp", "Boat Normal", TextureHandles [2u]);
+            Assets::Texture::ImportTexture(kAssetDirectoryPath / "Fishing Boat/textures/boat_gloss.bmp", "Boat Gloss", TextureHandles [3u]);
+            Assets::Texture::ImportTexture(kAssetDirectoryPath / "Fishing Boat/textures/boat_specular.bmp", "Boat Specular", TextureHandles [4u]);
+
+            Assets::Material::MaterialData const MaterialDesc =
+            {
+                TextureHandles [0u], TextureHandles [2u],
+                TextureHandles [4u], TextureHandles [3u],
+                TextureHandles [1u],
+            };
+
+            uint32 BoatMaterial = {};
+            Assets::Material::CreateMaterial(MaterialDesc, "Boat Material", BoatMaterial);
 
-        uint32 BoatMaterial = {};
-        Assets::Material::CreateMaterial(MaterialDesc, "Boat Material", BoatMaterial);
+            Scene::ActorData const BoatActorData = { "Boat" };
 
-        Scene::ActorData const BoatActorData = { "Boat" };
+            uint32 BoatActorHandle = {};
+            Scene::CreateActor(PBRScene, BoatActorData, BoatActorHandle);
 
-        uint32 BoatActorHandle = {};
-        Scene::CreateActor(PBRScene, BoatActorData, BoatActorHandle);
+            Components::StaticMesh::CreateComponent(PBRScene, BoatActorHandle, BoatHandle, BoatMaterial);
+            Components::Transform::CreateComponent(BoatActorHandle, PBRScene);
 
-        Components::StaticMesh::CreateComponent(PBRScene, BoatActorHandle, BoatHandle, BoatMaterial);
-        Components::Transform::CreateComponent(BoatActorHandle, PBRScene);
+            Math::Vector3 const kPosition = Math::Vector3 { 0.0f, 100.0f, -50.0f };
+            float const kScale = { 1.0f };
+            Components::Transform::SetTransform(BoatActorHandle, &kPosition, nullptr, &kScale);
 
-        Math::Vector3 const kPosition = Math::Vector3 { 0.0f, 100.0f, -50.0f };
-        float const kScale = { 1.0f };
-        Components::Transform::SetTransform(BoatActorHandle, &kPosition, nullptr, &kScale);
+            /* Loaded from the file next time */
+            SceneFile::Save(kSceneFilePath, PBRScene);
+        }
+    }
 
+    if (bResult)
+    {
         float const kAspectRatio = static_cast<float>(Application::State.CurrentWindowWidth) / static_cast<float>(Application::State.CurrentWindowHeight);
         float const kNearPlaneDistance = { 10.0f };
         float const kFarPlaneDistance = { 2000.0f };
@@ -137,13 +188,19 @@ static bool const SetupScene()
         PBRScene.MainCamera.ProjectionMatrix = Math::PerspectiveMatrix(Math::ConvertDegreesToRadians(90.0f), kAspectRatio, kNearPlaneDistance, kFarPlaneDistance);
     }
 
-    return bFoundBoat;
+    return bResult;
 }
 
 static bool const Initialise()
 {
     bool bResult = false;
 
+    /* Started first so logging and shader compilation can use the workers */
+    if (!Jobs::Initialise())
+    {
+        return false;
+    }
+
     if (!Logging::Initialise())
     {
         return false;
@@ -231,6 +288,12 @@ static bool const Initialise()
 
 static bool const Destroy()
 {
+    /* Waits for cell reads, which need the job system */
+    if (bStreamWorld)
+    {
+        World::Streaming::UnloadAll(WorldStreamingState);
+    }
+
     ShaderLibrary::Destroy();
 
     bool bResult = ForwardRenderer::Shutdown();
@@ -239,6 +302,8 @@ static bool const Destroy()
 
     Logging::Destroy();
 
+    Jobs::Destroy();
+
     return bResult;
 }
 
@@ -265,10 +330,33 @@ static bool const ProcessWindowMessages()
     return bResult;
 }
 
+static void RenderThreadMain()
+{
+    RenderSnapshot::Types::FrameSnapshot const * Snapshot = {};
+
+    while (RenderSnapshot::WaitToRead(RenderSnapshots, Snapshot))
+    {
+        /* A skipped frame is tried again with the same snapshot */
+        if (ForwardRenderer::Render(*Snapshot))
+        {
+            RenderSnapshot::EndRead(RenderSnapshots);
+        }
+        else
+        {
+            /* The swap chain was out of date, if the window was minimised the next read sleeps until it is restored */
+            constexpr uint32 kSkippedFrameTimeoutInMilliseconds = 100u;
+            RenderSnapshot::WaitForMinimised(RenderSnapshots, kSkippedFrameTimeoutInMilliseconds);
+        }
+    }
+}
+
 static bool const Run()
 {
     bool bResult = true;
 
+    std::thread RenderThread = std::thread(::RenderThreadMain);
+    ::SetThreadDescription(RenderThread.native_handle(), L"Render Thread");
+
     std::chrono::high_resolution_clock::time_point PreviousFrameBeginTime = { std::chrono::high_resolution_clock::now() };
 
     uint64 AccumulatedFrameTimeInNanoSeconds = {};
@@ -276,17 +364,38 @@ static bool const Run()
 
     for (;;)
     {
-        std::chrono::high_resolution_clock::time_point CurrentFrameBeginTime = { std::chrono::high_resolution_clock::now() };
-        uint64 const FrameDurationInNanoSeconds = std::chrono::duration_cast<std::chrono::duration<uint64, std::nano>>(CurrentFrameBeginTime - PreviousFrameBeginTime).count();
-        AccumulatedFrameTimeInNanoSeconds += FrameDurationInNanoSeconds;
+        /*
+            Sleeps while the render thread is still using both snapshots, simulating ahead of it would only add latency.
+            The wait is bounded so window messages are still handled when the renderer stalls.
+        */
+        constexpr uint32 kWriteTimeoutInMilliseconds = 16u;
 
-        PreviousFrameBeginTime = CurrentFrameBeginTime;
+        RenderSnapshot::Types::FrameSnapshot * Snapshot = {};
+        bool const kbCanWrite = RenderSnapshot::WaitToWrite(RenderSnapshots, kWriteTimeoutInMilliseconds, Snapshot);
 
-        Input::UpdateInputState(DPI);
+        if (kbCanWrite)
+        {
+            std::chrono::high_resolution_clock::time_point CurrentFrameBeginTime = { std::chrono::high_resolution_clock::now() };
+            uint64 const FrameDurationInNanoSeconds = std::chrono::duration_cast<std::chrono::duration<uint64, std::nano>>(CurrentFrameBeginTime - PreviousFrameBeginTime).count();
+            AccumulatedFrameTimeInNanoSeconds += FrameDurationInNanoSeconds;
+
+            PreviousFrameBeginTime = CurrentFrameBeginTime;
+
+            Input::UpdateInputState(DPI);
+        }
 
         if (::ProcessWindowMessages())
         {
-            if (!Application::State.bMinimised)
+            /* A zero sized client area can't be presented to either */
+            bool const kbMinimised = Application::State.bMinimised || Application::State.CurrentWindowWidth == 0u || Application::State.CurrentWindowHeight == 0u;
+            RenderSnapshot::SetMinimised(RenderSnapshots, kbMinimised);
+
+            if (kbMinimised)
+            {
+                /* Sleeps until the window is restored, or any other message arrives */
+                ::WaitMessage();
+            }
+            else if (kbCanWrite)
             {
                 /* Could do some actor culling and stuff here */
 
@@ -308,11 +417,25 @@ static bool const Run()
                     AccumulatedFrameTimeInNanoSeconds -= kFixedUpdateTimeInNanoSeconds;
                 }
 
-                ForwardRenderer::Render(PBRScene);
-            }
-            else
-            {
-                std::this_thread::sleep_for(std::chrono::duration<uint32, std::milli>(1u));
+                if (bStreamWorld)
+                {
+                    World::Streaming::Update(WorldStreamingState, PBRScene.MainCamera.Position);
+                }
+
+                Components::Transform::UpdateWorldTransforms();
+                SpatialIndex::Synchronise(PBRScene);
+
+                if (Input::IsKeyPushed(0x50))
+                {
+                    bDepthPrePass = !bDepthPrePass;
+                    Logging::Log(Logging::LogTypes::Info, bDepthPrePass ? PBR_TEXT("Depth pre-pass enabled.") : PBR_TEXT("Depth pre-pass disabled."));
+                }
+
+                RenderSnapshot::Build(PBRScene, ForwardRenderer::GetMaximumTransformUploadCount(), ForwardRenderer::IsGPUCullingEnabled(), *Snapshot);
+                Snapshot->bDepthPrePass = bDepthPrePass;
+                Snapshot->WindowWidth = Application::State.CurrentWindowWidth;
+                Snapshot->WindowHeight = Application::State.CurrentWindowHeight;
+                RenderSnapshot::EndWrite(RenderSnapshots);
             }
         }
         else
@@ -321,6 +444,10 @@ static bool const Run()
         }
     }
 
+    /* Anything still in the queue is dropped, the device is idled by the renderer on shutdown */
+    RenderSnapshot::Close(RenderSnapshots);
+    RenderThread.join();
+
     return bResult;
 }
 
@@ -0,0 +1,550 @@
+#include "World/Partition.hpp"
+
+#include "Assets/Material.hpp"
+#include "Assets/StaticMesh.hpp"
+#include "Assets/Texture.hpp"
+#include "Components/Archetypes.hpp"
+#include "Components/StaticMeshComponent.hpp"
+#include "Components/TransformComponent.hpp"
+#include "Jobs.hpp"
+#include "Logging.hpp"
+#include "Scene.hpp"
+#include "SceneFile.hpp"
+
+#include <Math/Affine.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+/*
+    World file layout, everything is little endian and each section starts on a 4 byte boundary.
+
+    FileHeader
+    String table            StringTableSizeInBytes of null terminated cell file paths, relative to the world file
+    CellRecord              [CellCount]
+    Asset sizes             uint64 [AssetCount]
+    Cell asset indices      uint32 [CellAssetIndexCount]
+*/
+namespace World::Partition::Private
+{
+    static constexpr uint32 kMagic = { 0x57524250u };
+    static constexpr uint32 kVersion = { 1u };
+
+    /* Keeps grid coordinates well inside int32 for positions that are far out */
+    static constexpr float kMaximumGridCoordinate = { 1.0e9f };
+
+    struct FileHeader
+    {
+        uint32 Magic = {};
+        uint32 Version = {};
+
+        uint32 CellCount = {};
+        uint32 AssetCount = {};
+        uint32 CellAssetIndexCount = {};
+
+        uint32 StringTableSizeInBytes = {};
+    };
+
+    struct CellRecord
+    {
+        uint64 ActorSizeInBytes = {};
+
+        Math::AABB Bounds = {};
+
+        uint32 FilePathOffset = {};
+        uint32 FirstAssetIndex = {};
+        uint32 AssetCount = {};
+        uint32 Padding = {};
+    };
+
+    /* World asset index by handle, assets are numbered across every cell */
+    struct AssetIndexMaps
+    {
+        std::unordered_map<uint32, uint32> StaticMeshes = {};
+        std::unordered_map<uint32, uint32> Materials = {};
+        std::unordered_map<uint32, uint32> Textures = {};
+
+        std::vector<uint64> SizesInBytes = {};
+    };
+}
+
+using namespace World::Partition;
+
+static void WriteBytes(std::vector<std::byte> & FileData, void const * const kData, uint64 const kSizeInBytes)
+{
+    std::byte const * const kBytes = static_cast<std::byte const *>(kData);
+
+    FileData.insert(FileData.end(), kBytes, kBytes + kSizeInBytes);
+    FileData.resize((FileData.size() + 3u) & ~std::size_t { 3u });
+}
+
+static std::byte const * const ReadBytes(std::vector<std::byte> const & kFileData, uint64 & OffsetInBytes, uint64 const kSizeInBytes)
+{
+    if (kSizeInBytes > kFileData.size() - OffsetInBytes)
+    {
+        return nullptr;
+    }
+
+    std::byte const * const kData = kFileData.data() + OffsetInBytes;
+
+    OffsetInBytes = std::min<uint64>((OffsetInBytes + kSizeInBytes + 3u) & ~uint64 { 3u }, kFileData.size());
+
+    return kData;
+}
+
+/* Columns plus the scene's own per actor arrays, and the world transform for actors that have one */
+static uint64 const GetActorSizeInBytes(uint32 const kComponentMask)
+{
+    using namespace Components;
+
+    uint64 SizeInBytes = sizeof(uint32) + sizeof(uint16) + sizeof(uint32);
+
+    for (uint8 CurrentColumnIndex = {};
+         CurrentColumnIndex < Archetypes::Types::kColumnCount;
+         CurrentColumnIndex++)
+    {
+        if (Archetypes::HasColumn(kComponentMask, static_cast<Archetypes::Types::Columns>(CurrentColumnIndex)))
+        {
+            SizeInBytes += Archetypes::GetColumnSizeInBytes(static_cast<Archetypes::Types::Columns>(CurrentColumnIndex));
+        }
+    }
+
+    if (kComponentMask & static_cast<uint32>(Scene::ComponentMasks::Transform))
+    {
+        SizeInBytes += sizeof(Math::Affine3x4);
+    }
+
+    return SizeInBytes;
+}
+
+/* Outputs the world asset index, adding the asset the first time it is seen */
+static uint32 const AddAsset(std::unordered_map<uint32, uint32> & AssetIndices, std::vector<uint64> & AssetSizesInBytes, uint32 const kAssetHandle, uint64 const kSizeInBytes)
+{
+    auto const [kIterator, bInserted] = AssetIndices.try_emplace(kAssetHandle, static_cast<uint32>(AssetSizesInBytes.size()));
+
+    if (bInserted)
+    {
+        AssetSizesInBytes.push_back(kSizeInBytes);
+    }
+
+    return kIterator->second;
+}
+
+/* Appends the world indices of every asset the actor's static mesh uses, sizes are what stays in memory once the asset is on the GPU */
+static void AddActorAssets(Scene::SceneData const & kScene, uint32 const kActorHandle, Private::AssetIndexMaps & AssetMaps, std::vector<uint32> & OutputAssetIndices)
+{
+    Components::StaticMesh::Types::ComponentData ComponentData = {};
+
+    if (!Scene::DoesActorHaveComponents(kScene, kActorHandle, static_cast<uint32>(Scene::ComponentMasks::StaticMesh))
+        || !Components::StaticMesh::GetComponentData(kScene, kActorHandle, ComponentData))
+    {
+        return;
+    }
+
+    Assets::StaticMesh::Types::StaticMesh StaticMesh = {};
+
+    if (ComponentData.MeshHandle != 0u && Assets::StaticMesh::GetAssetData(ComponentData.MeshHandle, StaticMesh))
+    {
+        uint64 const kSizeInBytes = StaticMesh.MeshDataSizeInBytes + static_cast<uint64>(StaticMesh.IndexCount) * sizeof(uint32);
+
+        OutputAssetIndices.push_back(::AddAsset(AssetMaps.StaticMeshes, AssetMaps.SizesInBytes, ComponentData.MeshHandle, kSizeInBytes));
+    }
+
+    Assets::Material::MaterialData Material = {};
+
+    if (ComponentData.MaterialHandle != 0u && Assets::Material::GetAssetData(ComponentData.MaterialHandle, Material))
+    {
+        OutputAssetIndices.push_back(::AddAsset(AssetMaps.Materials, AssetMaps.SizesInBytes, ComponentData.MaterialHandle, sizeof(Material)));
+
+        std::array<uint32, 5u> const kTextureHandles =
+        {
+            Material.AlbedoTexture, Material.NormalTexture,
+            Material.SpecularTexture, Material.RoughnessTexture,
+            Material.AmbientOcclusionTexture,
+        };
+
+        for (uint32 const kTextureHandle : kTextureHandles)
+        {
+            Assets::Texture::TextureData Texture = {};
+
+            if (kTextureHandle != 0u && Assets::Texture::GetTextureData(kTextureHandle, Texture))
+            {
+                /* RGBA8, the same as the image that is created for it */
+                uint64 const kSizeInBytes = uint64 { 4u } * Texture.WidthInPixels * Texture.HeightInPixels;
+
+                OutputAssetIndices.push_back(::AddAsset(AssetMaps.Textures, AssetMaps.SizesInBytes, kTextureHandle, kSizeInBytes));
+            }
+        }
+    }
+}
+
+bool const World::Partition::Build(Scene::SceneData const & Scene, float const CellSize, std::filesystem::path const & WorldFilePath)
+{
+    using namespace Components;
+
+    if (!(CellSize > 0.0f))
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to partition world. The cell size must be greater than zero."));
+        return false;
+    }
+
+    std::vector<Archetypes::Types::ChunkView> Chunks = {};
+    Archetypes::QueryChunks(0u, Chunks);
+
+    /* Ordered so cells are written in the same order every time */
+    std::map<std::array<int32, 3u>, std::vector<uint32>> GridCellActorHandles = {};
+    std::vector<uint32> PersistentActorHandles = {};
+
+    for (Archetypes::Types::ChunkView const & kChunk : Chunks)
+    {
+        uint32 const * const kActorHandles = kChunk.GetColumn<Archetypes::Types::Columns::ActorHandle>();
+
+        for (uint32 CurrentRowIndex = {};
+             CurrentRowIndex < kChunk.EntityCount;
+             CurrentRowIndex++)
+        {
+            uint32 const kActorHandle = kActorHandles [CurrentRowIndex];
+
+            uint32 const kTransformMask = static_cast<uint32>(Scene::ComponentMasks::Transform);
+
+            uint32 RootActorHandle = kActorHandle;
+            uint32 ParentActorHandle = {};
+
+            while (Scene::DoesActorHaveComponents(Scene, RootActorHandle, kTransformMask) && Transform::GetParent(RootActorHandle, ParentActorHandle) && ParentActorHandle != 0u)
+            {
+                RootActorHandle = ParentActorHandle;
+            }
+
+            Math::Affine3x4 RootTransform = {};
+
+            if (!Scene::DoesActorHaveComponents(Scene, RootActorHandle, kTransformMask) || !Transform::GetTransformationMatrix(RootActorHandle, RootTransform))
+            {
+                PersistentActorHandles.push_back(kActorHandle);
+                continue;
+            }
+
+            std::array<int32, 3u> GridCoordinates = {};
+
+            for (uint8 CurrentAxisIndex = {};
+                 CurrentAxisIndex < GridCoordinates.size();
+                 CurrentAxisIndex++)
+            {
+                /* Translation is the last column of each row */
+                float const kCoordinate = std::floor(RootTransform.Data [CurrentAxisIndex * 4u + 3u] / CellSize);
+
+                GridCoordinates [CurrentAxisIndex] = static_cast<int32>(std::clamp(kCoordinate, -Private::kMaximumGridCoordinate, Private::kMaximumGridCoordinate));
+            }
+
+            GridCellActorHandles [GridCoordinates].push_back(kActorHandle);
+        }
+    }
+
+    std::filesystem::path const kCellDirectoryPath = WorldFilePath.parent_path() / (WorldFilePath.stem().string() + "_Cells");
+
+    std::error_code ErrorCode = {};
+    std::filesystem::create_directories(kCellDirectoryPath, ErrorCode);
+
+    if (ErrorCode)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to partition world. The cell directory could not be created."));
+        return false;
+    }
+
+    std::vector<char> StringTable = {};
+    std::vector<Private::CellRecord> CellRecords = {};
+    std::vector<uint32> CellAssetIndices = {};
+
+    Private::AssetIndexMaps AssetMaps = {};
+
+    auto const WriteCell = [&](std::string const & kFileName, Math::AABB const & kBounds, std::vector<uint32> const & kActorHandles)
+    {
+        std::filesystem::path const kCellFilePath = kCellDirectoryPath / kFileName;
+
+        if (!SceneFile::Save(kCellFilePath, Scene, kActorHandles.data(), static_cast<uint32>(kActorHandles.size())))
+        {
+            return false;
+        }
+
+        Private::CellRecord Record = {};
+        Record.Bounds = kBounds;
+        Record.FirstAssetIndex = static_cast<uint32>(CellAssetIndices.size());
+
+        for (uint32 const kActorHandle : kActorHandles)
+        {
+            Record.ActorSizeInBytes += ::GetActorSizeInBytes(Scene.ComponentMasks [Scene::GetActorIndex(kActorHandle)]);
+
+            ::AddActorAssets(Scene, kActorHandle, AssetMaps, CellAssetIndices);
+        }
+
+        /* Each asset is listed once per cell, however many actors use it */
+        std::sort(CellAssetIndices.begin() + Record.FirstAssetIndex, CellAssetIndices.end());
+        CellAssetIndices.erase(std::unique(CellAssetIndices.begin() + Record.FirstAssetIndex, CellAssetIndices.end()), CellAssetIndices.end());
+
+        Record.AssetCount = static_cast<uint32>(CellAssetIndices.size()) - Record.FirstAssetIndex;
+
+        std::string const kRelativeFilePath = kCellFilePath.lexically_relative(WorldFilePath.parent_path()).generic_string();
+
+        Record.FilePathOffset = static_cast<uint32>(StringTable.size());
+        StringTable.insert(StringTable.end(), kRelativeFilePath.cbegin(), kRelativeFilePath.cend());
+        StringTable.push_back('\0');
+
+        CellRecords.push_back(Record);
+
+        return true;
+    };
+
+    bool bResult = true;
+
+    if (PersistentActorHandles.size() > 0u)
+    {
+        /* Every view position is inside these bounds, so the cell is always in range */
+        Math::AABB const kBounds =
+        {
+            Math::Vector3 { -3.402823466e+38f, -3.402823466e+38f, -3.402823466e+38f },
+            Math::Vector3 { 3.402823466e+38f, 3.402823466e+38f, 3.402823466e+38f },
+        };
+
+        bResult = WriteCell("Persistent.scene", kBounds, PersistentActorHandles);
+    }
+
+    for (auto const & [kGridCoordinates, kActorHandles] : GridCellActorHandles)
+    {
+        if (!bResult)
+        {
+            break;
+        }
+
+        Math::Vector3 const kMinimum =
+        {
+            static_cast<float>(kGridCoordinates [0u]) * CellSize,
+            static_cast<float>(kGridCoordinates [1u]) * CellSize,
+            static_cast<float>(kGridCoordinates [2u]) * CellSize,
+        };
+
+        std::string const kFileName = "Cell_" + std::to_string(kGridCoordinates [0u]) + "_" + std::to_string(kGridCoordinates [1u]) + "_" + std::to_string(kGridCoordinates [2u]) + ".scene";
+
+        bResult = WriteCell(kFileName, Math::AABB { kMinimum, kMinimum + Math::Vector3 { CellSize, CellSize, CellSize } }, kActorHandles);
+    }
+
+    if (!bResult)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to partition world. A cell file could not be written."));
+        return false;
+    }
+
+    Private::FileHeader Header = {};
+    Header.Magic = Private::kMagic;
+    Header.Version = Private::kVersion;
+    Header.CellCount = static_cast<uint32>(CellRecords.size());
+    Header.AssetCount = static_cast<uint32>(AssetMaps.SizesInBytes.size());
+    Header.CellAssetIndexCount = static_cast<uint32>(CellAssetIndices.size());
+    Header.StringTableSizeInBytes = static_cast<uint32>(StringTable.size());
+
+    std::vector<std::byte> FileData = {};
+
+    ::WriteBytes(FileData, &Header, sizeof(Header));
+    ::WriteBytes(FileData, StringTable.data(), StringTable.size());
+    ::WriteBytes(FileData, CellRecords.data(), CellRecords.size() * sizeof(Private::CellRecord));
+    ::WriteBytes(FileData, AssetMaps.SizesInBytes.data(), AssetMaps.SizesInBytes.size() * sizeof(uint64));
+    ::WriteBytes(FileData, CellAssetIndices.data(), CellAssetIndices.size() * sizeof(uint32));
+
+    std::ofstream FileStream = std::ofstream(WorldFilePath, std::ios::binary | std::ios::trunc);
+    FileStream.write(reinterpret_cast<char const *>(FileData.data()), static_cast<std::streamsize>(FileData.size()));
+
+    if (!FileStream)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to write world file."));
+        return false;
+    }
+
+    Logging::Log(Logging::LogTypes::Info, String::Format(PBR_TEXT("Partitioned World [Cells = %u, Assets = %u]"), Header.CellCount, Header.AssetCount));
+
+    return true;
+}
+
+bool const World::Partition::LoadWorld(std::filesystem::path const & WorldFilePath, Types::WorldData & OutputWorld)
+{
+    std::vector<std::byte> FileData = {};
+
+    {
+        std::ifstream FileStream = std::ifstream(WorldFilePath, std::ios::binary | std::ios::ate);
+
+        if (!FileStream)
+        {
+            Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to open world file."));
+            return false;
+        }
+
+        FileData.resize(static_cast<std::size_t>(FileStream.tellg()));
+
+        FileStream.seekg(0);
+        FileStream.read(reinterpret_cast<char *>(FileData.data()), static_cast<std::streamsize>(FileData.size()));
+
+        if (!FileStream)
+        {
+            Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to read world file."));
+            return false;
+        }
+    }
+
+    uint64 OffsetInBytes = {};
+
+    Private::FileHeader Header = {};
+
+    if (std::byte const * const kHeaderData = ::ReadBytes(FileData, OffsetInBytes, sizeof(Header)))
+    {
+        std::memcpy(&Header, kHeaderData, sizeof(Header));
+    }
+
+    if (Header.Magic != Private::kMagic || Header.Version != Private::kVersion)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to load world. The file is not a world file or was written by a different version."));
+        return false;
+    }
+
+    std::byte const * const kStringTableData = ::ReadBytes(FileData, OffsetInBytes, Header.StringTableSizeInBytes);
+    std::byte const * const kCellRecordData = ::ReadBytes(FileData, OffsetInBytes, static_cast<uint64>(Header.CellCount) * sizeof(Private::CellRecord));
+    std::byte const * const kAssetSizeData = ::ReadBytes(FileData, OffsetInBytes, static_cast<uint64>(Header.AssetCount) * sizeof(uint64));
+    std::byte const * const kCellAssetIndexData = ::ReadBytes(FileData, OffsetInBytes, static_cast<uint64>(Header.CellAssetIndexCount) * sizeof(uint32));
+
+    if (!kStringTableData || !kCellRecordData || !kAssetSizeData || !kCellAssetIndexData
+        || (Header.StringTableSizeInBytes > 0u && kStringTableData [Header.StringTableSizeInBytes - 1u] != std::byte { 0u }))
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to load world. The file is truncated or corrupt."));
+        return false;
+    }
+
+    char const * const kStringTable = reinterpret_cast<char const *>(kStringTableData);
+
+    Types::WorldData & World = OutputWorld;
+    World.Layout = {};
+    World.Layout.Cells.resize(Header.CellCount);
+    World.Layout.AssetSizesInBytes.resize(Header.AssetCount);
+    World.Layout.CellAssetIndices.resize(Header.CellAssetIndexCount);
+    World.Cells = std::vector<Types::CellData>(Header.CellCount);
+
+    /* Empty vectors can have a NULL data pointer, which memcpy doesn't allow even for zero bytes */
+    if (Header.AssetCount > 0u)
+    {
+        std::memcpy(World.Layout.AssetSizesInBytes.data(), kAssetSizeData, World.Layout.AssetSizesInBytes.size() * sizeof(uint64));
+    }
+
+    if (Header.CellAssetIndexCount > 0u)
+    {
+        std::memcpy(World.Layout.CellAssetIndices.data(), kCellAssetIndexData, World.Layout.CellAssetIndices.size() * sizeof(uint32));
+    }
+
+    for (uint32 CurrentCellIndex = {};
+         CurrentCellIndex < Header.CellCount;
+         CurrentCellIndex++)
+    {
+        Private::CellRecord Record = {};
+        std::memcpy(&Record, kCellRecordData + static_cast<uint64>(CurrentCellIndex) * sizeof(Record), sizeof(Record));
+
+        if (Record.FilePathOffset >= Header.StringTableSizeInBytes)
+        {
+            Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to load world. The file is truncated or corrupt."));
+            return false;
+        }
+
+        World.Layout.Cells [CurrentCellIndex] = Streaming::Types::CellDesc { Record.Bounds, Record.ActorSizeInBytes, Record.FirstAssetIndex, Record.AssetCount };
+        World.Cells [CurrentCellIndex].FilePath = WorldFilePath.parent_path() / std::string(kStringTable + Record.FilePathOffset);
+    }
+
+    Logging::Log(Logging::LogTypes::Info, String::Format(PBR_TEXT("Loaded World [Cells = %u, Assets = %u]"), Header.CellCount, Header.AssetCount));
+
+    return true;
+}
+
+static void ReadCellFile(void * Data)
+{
+    Types::CellData & Cell = *static_cast<Types::CellData *>(Data);
+
+    bool const kbResult = SceneFile::ReadFile(Cell.FilePath, Cell.FileData);
+
+    Cell.ReadState.store(kbResult ? Types::ReadStates::Succeeded : Types::ReadStates::Failed, std::memory_order_release);
+}
+
+static void BeginCellLoad(void * Data, uint32 const kCellIndex)
+{
+    Types::CellData & Cell = static_cast<Types::WorldData *>(Data)->Cells [kCellIndex];
+
+    Cell.ReadState.store(Types::ReadStates::Reading, std::memory_order_relaxed);
+
+    /* File reads block, so they go on the background queue instead of holding up frame jobs */
+    Jobs::SubmitBackground(Jobs::Types::Job { &::ReadCellFile, &Cell });
+}
+
+static bool const IsCellLoadComplete(void * Data, uint32 const kCellIndex)
+{
+    return static_cast<Types::WorldData *>(Data)->Cells [kCellIndex].ReadState.load(std::memory_order_acquire) != Types::ReadStates::Reading;
+}
+
+static bool const IntegrateCell(void * Data, uint32 const kCellIndex, uint64 & OutputTimeInNanoSeconds)
+{
+    std::chrono::high_resolution_clock::time_point const kStartTime = std::chrono::high_resolution_clock::now();
+
+    Types::WorldData & World = *static_cast<Types::WorldData *>(Data);
+    Types::CellData & Cell = World.Cells [kCellIndex];
+
+    bool const kbResult = Cell.ReadState.load(std::memory_order_acquire) == Types::ReadStates::Succeeded
+                          && SceneFile::LoadFromMemory(std::move(Cell.FileData), Cell.FilePath.parent_path(), *World.Scene, Cell.ActorHandles);
+
+    Cell.FileData = {};
+    Cell.ReadState.store(Types::ReadStates::Idle, std::memory_order_relaxed);
+
+    OutputTimeInNanoSeconds = std::chrono::duration_cast<std::chrono::duration<uint64, std::nano>>(std::chrono::high_resolution_clock::now() - kStartTime).count();
+
+    return kbResult;
+}
+
+static void UnloadCell(void * Data, uint32 const kCellIndex, uint64 & OutputTimeInNanoSeconds)
+{
+    std::chrono::high_resolution_clock::time_point const kStartTime = std::chrono::high_resolution_clock::now();
+
+    Types::WorldData & World = *static_cast<Types::WorldData *>(Data);
+    Types::CellData & Cell = World.Cells [kCellIndex];
+
+    /* Something else may have destroyed some of them already */
+    for (uint32 const kActorHandle : Cell.ActorHandles)
+    {
+        if (Scene::IsActorValid(*World.Scene, kActorHandle))
+        {
+            Scene::DestroyActor(*World.Scene, kActorHandle);
+        }
+    }
+
+    Cell.ActorHandles.clear();
+    Cell.FileData = {};
+    Cell.ReadState.store(Types::ReadStates::Idle, std::memory_order_relaxed);
+
+    OutputTimeInNanoSeconds = std::chrono::duration_cast<std::chrono::duration<uint64, std::nano>>(std::chrono::high_resolution_clock::now() - kStartTime).count();
+}
+
+/* Assets can't be unloaded yet, so they stay imported and the scheduler keeps counting them */
+static bool const ReleaseAsset(void *, uint32 const)
+{
+    return false;
+}
+
+World::Streaming::Types::Loader const World::Partition::CreateLoader(Types::WorldData & World, Scene::SceneData & Scene)
+{
+    World.Scene = &Scene;
+
+    return Streaming::Types::Loader
+    {
+        &World,
+        &::BeginCellLoad,
+        &::IsCellLoadComplete,
+        &::IntegrateCell,
+        &::UnloadCell,
+        &::ReleaseAsset,
+    };
+}
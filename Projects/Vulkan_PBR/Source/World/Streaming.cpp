@@ -0,0 +1,342 @@
+#include "World/Streaming.hpp"
+
+#include "Logging.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <thread>
+
+using namespace World::Streaming;
+
+/* The memory a cell would add if it started loading now, assets that are already resident are free */
+static uint64 const GetLoadSizeInBytes(Types::StreamingState const & kState, uint32 const kCellIndex)
+{
+    Types::CellDesc const & kCell = kState.Layout.Cells [kCellIndex];
+
+    uint64 SizeInBytes = kCell.ActorSizeInBytes;
+
+    for (uint32 CurrentIndex = { kCell.FirstAssetIndex };
+         CurrentIndex < kCell.FirstAssetIndex + kCell.AssetCount;
+         CurrentIndex++)
+    {
+        uint32 const kAssetIndex = kState.Layout.CellAssetIndices [CurrentIndex];
+
+        if (kState.ResidentAssets [kAssetIndex] == 0u)
+        {
+            SizeInBytes += kState.Layout.AssetSizesInBytes [kAssetIndex];
+        }
+    }
+
+    return SizeInBytes;
+}
+
+static void BeginLoad(Types::StreamingState & State, uint32 const kCellIndex)
+{
+    Types::CellDesc const & kCell = State.Layout.Cells [kCellIndex];
+
+    State.ResidentSizeInBytes += kCell.ActorSizeInBytes;
+
+    for (uint32 CurrentIndex = { kCell.FirstAssetIndex };
+         CurrentIndex < kCell.FirstAssetIndex + kCell.AssetCount;
+         CurrentIndex++)
+    {
+        uint32 const kAssetIndex = State.Layout.CellAssetIndices [CurrentIndex];
+
+        State.AssetReferenceCounts [kAssetIndex]++;
+
+        if (State.ResidentAssets [kAssetIndex] == 0u)
+        {
+            State.ResidentAssets [kAssetIndex] = 1u;
+            State.ResidentSizeInBytes += State.Layout.AssetSizesInBytes [kAssetIndex];
+        }
+    }
+
+    State.CurrentCellStates [kCellIndex] = Types::CellStates::Loading;
+    State.LoadingCellCount++;
+
+    State.CellLoader.BeginLoad(State.CellLoader.Data, kCellIndex);
+}
+
+/* Only for loaded and resident cells, loads can't be cancelled once they have started */
+static void UnloadCell(Types::StreamingState & State, uint32 const kCellIndex, Types::CellStates const kNewState, Types::UpdateStatistics & Statistics)
+{
+    Types::CellDesc const & kCell = State.Layout.Cells [kCellIndex];
+
+    uint64 TimeInNanoSeconds = {};
+    State.CellLoader.Unload(State.CellLoader.Data, kCellIndex, TimeInNanoSeconds);
+
+    State.ResidentSizeInBytes -= kCell.ActorSizeInBytes;
+
+    for (uint32 CurrentIndex = { kCell.FirstAssetIndex };
+         CurrentIndex < kCell.FirstAssetIndex + kCell.AssetCount;
+         CurrentIndex++)
+    {
+        uint32 const kAssetIndex = State.Layout.CellAssetIndices [CurrentIndex];
+
+        if (--State.AssetReferenceCounts [kAssetIndex] == 0u && State.CellLoader.ReleaseAsset(State.CellLoader.Data, kAssetIndex))
+        {
+            State.ResidentAssets [kAssetIndex] = 0u;
+            State.ResidentSizeInBytes -= State.Layout.AssetSizesInBytes [kAssetIndex];
+        }
+    }
+
+    State.CurrentCellStates [kCellIndex] = kNewState;
+
+    Statistics.UnloadedCellCount++;
+    Statistics.TimeInNanoSeconds += TimeInNanoSeconds;
+}
+
+static bool const IsCellInMemory(Types::CellStates const kState)
+{
+    return kState == Types::CellStates::Loaded || kState == Types::CellStates::Resident;
+}
+
+static void PollLoadingCells(Types::StreamingState & State)
+{
+    for (uint32 CurrentCellIndex = {};
+         CurrentCellIndex < State.CurrentCellStates.size() && State.LoadingCellCount > 0u;
+         CurrentCellIndex++)
+    {
+        if (State.CurrentCellStates [CurrentCellIndex] == Types::CellStates::Loading
+            && State.CellLoader.IsLoadComplete(State.CellLoader.Data, CurrentCellIndex))
+        {
+            State.CurrentCellStates [CurrentCellIndex] = Types::CellStates::Loaded;
+            State.LoadingCellCount--;
+        }
+    }
+}
+
+bool const World::Streaming::Initialise(Types::StreamingState & State, Types::WorldLayout Layout, Types::Settings const & Settings, Types::Loader const & Loader)
+{
+    if (!Loader.BeginLoad || !Loader.IsLoadComplete || !Loader.Integrate || !Loader.Unload || !Loader.ReleaseAsset)
+    {
+        Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to initialise world streaming. The cell loader is missing a function."));
+        return false;
+    }
+
+    for (Types::CellDesc const & kCell : Layout.Cells)
+    {
+        if (kCell.FirstAssetIndex > Layout.CellAssetIndices.size() || kCell.AssetCount > Layout.CellAssetIndices.size() - kCell.FirstAssetIndex)
+        {
+            Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to initialise world streaming. A cell's asset range is out of bounds."));
+            return false;
+        }
+    }
+
+    for (uint32 const kAssetIndex : Layout.CellAssetIndices)
+    {
+        if (kAssetIndex >= Layout.AssetSizesInBytes.size())
+        {
+            Logging::Log(Logging::LogTypes::Error, PBR_TEXT("Failed to initialise world streaming. A cell references an asset that doesn't exist."));
+            return false;
+        }
+    }
+
+    uint32 const kCellCount = static_cast<uint32>(Layout.Cells.size());
+    uint32 const kAssetCount = static_cast<uint32>(Layout.AssetSizesInBytes.size());
+
+    State = {};
+    State.Layout = std::move(Layout);
+    State.StreamingSettings = Settings;
+    State.StreamingSettings.UnloadDistance = std::max(Settings.UnloadDistance, Settings.LoadDistance);
+    State.StreamingSettings.MaximumLoadingCellCount = std::max(Settings.MaximumLoadingCellCount, 1u);
+    State.CellLoader = Loader;
+
+    State.CurrentCellStates.assign(kCellCount, Types::CellStates::Unloaded);
+    State.CellDistances.resize(kCellCount);
+    State.AssetReferenceCounts.resize(kAssetCount);
+    State.ResidentAssets.resize(kAssetCount);
+    State.SortedCellIndices.resize(kCellCount);
+
+    return true;
+}
+
+void World::Streaming::Update(Types::StreamingState & State, Math::Vector3 const & ViewPosition, Types::UpdateStatistics * const OutputStatistics)
+{
+    Types::Settings const & kSettings = State.StreamingSettings;
+    Types::UpdateStatistics Statistics = {};
+
+    uint32 const kCellCount = static_cast<uint32>(State.Layout.Cells.size());
+
+    for (uint32 CurrentCellIndex = {};
+         CurrentCellIndex < kCellCount;
+         CurrentCellIndex++)
+    {
+        State.CellDistances [CurrentCellIndex] = World::Streaming::GetCellDistance(State.Layout.Cells [CurrentCellIndex], ViewPosition);
+    }
+
+    ::PollLoadingCells(State);
+
+    /* Unloads free memory for the loads below, so every cell out of range is unloaded even if it takes the whole time slice */
+    for (uint32 CurrentCellIndex = {};
+         CurrentCellIndex < kCellCount;
+         CurrentCellIndex++)
+    {
+        if (::IsCellInMemory(State.CurrentCellStates [CurrentCellIndex]) && State.CellDistances [CurrentCellIndex] > kSettings.UnloadDistance)
+        {
+            ::UnloadCell(State, CurrentCellIndex, Types::CellStates::Unloaded, Statistics);
+        }
+    }
+
+    /* Ties are broken by index so replaying the same path always makes the same decisions */
+    std::iota(State.SortedCellIndices.begin(), State.SortedCellIndices.end(), 0u);
+    std::sort(State.SortedCellIndices.begin(), State.SortedCellIndices.end(),
+              [&State](uint32 const kLeftIndex, uint32 const kRightIndex)
+              {
+                  return State.CellDistances [kLeftIndex] < State.CellDistances [kRightIndex]
+                      || (State.CellDistances [kLeftIndex] == State.CellDistances [kRightIndex] && kLeftIndex < kRightIndex);
+              });
+
+    for (uint32 const kCellIndex : State.SortedCellIndices)
+    {
+        if (State.CurrentCellStates [kCellIndex] != Types::CellStates::Loaded)
+        {
+            continue;
+        }
+
+        if (Statistics.IntegratedCellCount > 0u && Statistics.TimeInNanoSeconds >= kSettings.TimeSliceInNanoSeconds)
+        {
+            break;
+        }
+
+        uint64 TimeInNanoSeconds = {};
+
+        if (State.CellLoader.Integrate(State.CellLoader.Data, kCellIndex, TimeInNanoSeconds))
+        {
+            State.CurrentCellStates [kCellIndex] = Types::CellStates::Resident;
+        }
+        else
+        {
+            Logging::Log(Logging::LogTypes::Error, String::Format(PBR_TEXT("Failed to stream in world cell %u. It won't be loaded again."), kCellIndex));
+
+            ::UnloadCell(State, kCellIndex, Types::CellStates::Failed, Statistics);
+        }
+
+        Statistics.IntegratedCellCount++;
+        Statistics.TimeInNanoSeconds += TimeInNanoSeconds;
+    }
+
+    bool bBudgetFull = false;
+
+    for (uint32 CurrentSortedIndex = {};
+         CurrentSortedIndex < kCellCount;
+         CurrentSortedIndex++)
+    {
+        uint32 const kCellIndex = State.SortedCellIndices [CurrentSortedIndex];
+
+        if (State.CellDistances [kCellIndex] > kSettings.LoadDistance)
+        {
+            break;
+        }
+
+        if (State.CurrentCellStates [kCellIndex] != Types::CellStates::Unloaded)
+        {
+            continue;
+        }
+
+        if (bBudgetFull)
+        {
+            Statistics.DeferredCellCount++;
+            continue;
+        }
+
+        if (State.LoadingCellCount >= kSettings.MaximumLoadingCellCount)
+        {
+            break;
+        }
+
+        uint64 LoadSizeInBytes = ::GetLoadSizeInBytes(State, kCellIndex);
+
+        if (State.ResidentSizeInBytes + LoadSizeInBytes > kSettings.MemoryBudgetInBytes)
+        {
+            /*
+                Evicting a cell frees at least its actors. An asset it frees that this cell also needs is added back to the load size, so freeing
+                assets never loses ground and this is a lower bound. Nothing is evicted for a load that still wouldn't fit.
+            */
+            uint64 EvictableSizeInBytes = {};
+
+            for (uint32 CurrentEvictIndex = { CurrentSortedIndex + 1u };
+                 CurrentEvictIndex < kCellCount;
+                 CurrentEvictIndex++)
+            {
+                uint32 const kEvictCellIndex = State.SortedCellIndices [CurrentEvictIndex];
+
+                if (::IsCellInMemory(State.CurrentCellStates [kEvictCellIndex]) && State.CellDistances [kEvictCellIndex] > State.CellDistances [kCellIndex])
+                {
+                    EvictableSizeInBytes += State.Layout.Cells [kEvictCellIndex].ActorSizeInBytes;
+                }
+            }
+
+            if (State.ResidentSizeInBytes + LoadSizeInBytes > kSettings.MemoryBudgetInBytes + EvictableSizeInBytes)
+            {
+                /* Cells further away don't jump the queue, they would only be evicted again once this one fits */
+                bBudgetFull = true;
+                Statistics.DeferredCellCount++;
+                continue;
+            }
+
+            for (uint32 CurrentEvictIndex = { kCellCount - 1u };
+                 CurrentEvictIndex > CurrentSortedIndex && State.ResidentSizeInBytes + LoadSizeInBytes > kSettings.MemoryBudgetInBytes;
+                 CurrentEvictIndex--)
+            {
+                uint32 const kEvictCellIndex = State.SortedCellIndices [CurrentEvictIndex];
+
+                if (::IsCellInMemory(State.CurrentCellStates [kEvictCellIndex]) && State.CellDistances [kEvictCellIndex] > State.CellDistances [kCellIndex])
+                {
+                    ::UnloadCell(State, kEvictCellIndex, Types::CellStates::Unloaded, Statistics);
+
+                    LoadSizeInBytes = ::GetLoadSizeInBytes(State, kCellIndex);
+                }
+            }
+        }
+
+        ::BeginLoad(State, kCellIndex);
+
+        Statistics.StartedLoadCount++;
+    }
+
+    if (OutputStatistics)
+    {
+        *OutputStatistics = Statistics;
+    }
+}
+
+void World::Streaming::UnloadAll(Types::StreamingState & State)
+{
+    while (State.LoadingCellCount > 0u)
+    {
+        ::PollLoadingCells(State);
+
+        if (State.LoadingCellCount > 0u)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    Types::UpdateStatistics Statistics = {};
+
+    for (uint32 CurrentCellIndex = {};
+         CurrentCellIndex < State.CurrentCellStates.size();
+         CurrentCellIndex++)
+    {
+        if (::IsCellInMemory(State.CurrentCellStates [CurrentCellIndex]))
+        {
+            ::UnloadCell(State, CurrentCellIndex, Types::CellStates::Unloaded, Statistics);
+        }
+    }
+}
+
+float const World::Streaming::GetCellDistance(Types::CellDesc const & Cell, Math::Vector3 const & Position)
+{
+    float const kDistanceX = std::max({ Cell.Bounds.Minimum.X - Position.X, 0.0f, Position.X - Cell.Bounds.Maximum.X });
+    float const kDistanceY = std::max({ Cell.Bounds.Minimum.Y - Position.Y, 0.0f, Position.Y - Cell.Bounds.Maximum.Y });
+    float const kDistanceZ = std::max({ Cell.Bounds.Minimum.Z - Position.Z, 0.0f, Position.Z - Cell.Bounds.Maximum.Z });
+
+    return std::sqrt(kDistanceX * kDistanceX + kDistanceY * kDistanceY + kDistanceZ * kDistanceZ);
+}
+
+uint64 const World::Streaming::GetResidentSizeInBytes(Types::StreamingState const & State)
+{
+    return State.ResidentSizeInBytes;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <vulkan/vulkan_core.h>
 
@@ -166,6 +167,11 @@ namespace Vulkan
         return VkCommandBufferBeginInfo { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, nullptr, UsageFlags, InheritanceInfo };
     }
 
+    constexpr VkCommandBufferInheritanceInfo CommandBufferInheritance(VkRenderPass const RenderPass, std::uint32_t const SubpassIndex, VkFramebuffer const FrameBuffer = VK_NULL_HANDLE)
+    {
+        return VkCommandBufferInheritanceInfo { VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO, nullptr, RenderPass, SubpassIndex, FrameBuffer, VK_FALSE, 0u, 0u };
+    }
+
     inline VkSubmitInfo const SubmitInfo(std::uint32_t const CommandBufferCount, VkCommandBuffer const * const CommandBuffers,
                                          std::uint32_t const SignalSemaphoreCount = 0u, VkSemaphore const * const SignalSemaphores = nullptr,
                                          std::uint32_t const WaitSemaphoreCount = 0u, VkSemaphore const * const WaitSemaphores = nullptr,
@@ -308,6 +314,11 @@ namespace Vulkan
         return VkGraphicsPipelineCreateInfo { VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO, nullptr, Flags, ShaderStageCount, ShaderStages, VertexInputState, InputAssemblyState, nullptr, ViewportState, RasterizationState, MultiSampleState, DepthStencilState, BlendState, DynamicState, PipelineLayout, RenderPass, SubPassIndex, VK_NULL_HANDLE, -1l };
     }
 
+    inline VkComputePipelineCreateInfo const ComputePipelineState(VkPipelineLayout const PipelineLayout, VkPipelineShaderStageCreateInfo const & ShaderStage, VkPipelineCreateFlags const Flags = 0u)
+    {
+        return VkComputePipelineCreateInfo { VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO, nullptr, Flags, ShaderStage, PipelineLayout, VK_NULL_HANDLE, -1l };
+    }
+
     inline VkSwapchainCreateInfoKHR const SwapChain(VkSwapchainKHR const OldSwapChain,
                                                     VkSurfaceKHR const Surface, VkExtent2D const & ImageExtents,
                                                     VkFormat const ImageFormat, VkColorSpaceKHR const ImageColourSpace,
@@ -375,10 +386,14 @@ VULKAN_WRAPPER_API void vkCmdBindVertexBuffers(VkCommandBuffer commandBuffer, st
 VULKAN_WRAPPER_API void vkCmdClearColorImage(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout imageLayout, VkClearColorValue const * pColor, std::uint32_t rangeCount, VkImageSubresourceRange const * pRanges);
 VULKAN_WRAPPER_API void vkCmdCopyBuffer(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer, std::uint32_t regionCount, VkBufferCopy const * pRegions);
 VULKAN_WRAPPER_API void vkCmdCopyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkImage dstImage, VkImageLayout dstImageLayout, std::uint32_t const regionCount, VkBufferImageCopy const * pRegions);
+VULKAN_WRAPPER_API void vkCmdDispatch(VkCommandBuffer commandBuffer, std::uint32_t groupCountX, std::uint32_t groupCountY, std::uint32_t groupCountZ);
 VULKAN_WRAPPER_API void vkCmdDraw(VkCommandBuffer commandBuffer, std::uint32_t vertexCount, std::uint32_t instanceCount, std::uint32_t firstVertex, std::uint32_t firstInstance);
 VULKAN_WRAPPER_API void vkCmdDrawIndexed(VkCommandBuffer commandBuffer, std::uint32_t indexCount, std::uint32_t instanceCount, std::uint32_t firstIndex, std::int32_t vertexOffset, std::uint32_t firstInstance);
+VULKAN_WRAPPER_API void vkCmdDrawIndexedIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, std::uint32_t drawCount, std::uint32_t stride);
 VULKAN_WRAPPER_API void vkCmdEndRenderPass(VkCommandBuffer commandBuffer);
+VULKAN_WRAPPER_API void vkCmdExecuteCommands(VkCommandBuffer commandBuffer, std::uint32_t commandBufferCount, VkCommandBuffer const * pCommandBuffers);
 VULKAN_WRAPPER_API void vkCmdNextSubpass(VkCommandBuffer commandBuffer, VkSubpassContents contents);
+VULKAN_WRAPPER_API void vkCmdPushConstants(VkCommandBuffer commandBuffer, VkPipelineLayout layout, VkShaderStageFlags stageFlags, std::uint32_t offset, std::uint32_t size, void const * pValues);
 VULKAN_WRAPPER_API void vkCmdPipelineBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask, VkDependencyFlags dependencyFlags, std::uint32_t memoryBarrierCount, VkMemoryBarrier const * pMemoryBarriers, std::uint32_t bufferMemoryBarrierCount, VkBufferMemoryBarrier const * pBufferMemoryBarriers, std::uint32_t imageMemoryBarrierCount, VkImageMemoryBarrier const * pImageMemoryBarriers);
 VULKAN_WRAPPER_API void vkCmdSetViewport(VkCommandBuffer commandBuffer, std::uint32_t firstViewport, std::uint32_t viewportCount, VkViewport * pViewports);
 VULKAN_WRAPPER_API void vkCmdSetScissor(VkCommandBuffer commandBuffer, std::uint32_t firstScissor, std::uint32_t scissorCount, VkRect2D * pScissors);
@@ -396,7 +411,9 @@ VULKAN_WRAPPER_API VkResult vkCreateShaderModule(VkDevice device, VkShaderModule
 VULKAN_WRAPPER_API VkResult vkCreateDescriptorPool(VkDevice device, VkDescriptorPoolCreateInfo const * pCreateInfo, VkAllocationCallbacks const * pAllocator, VkDescriptorPool * pDescriptorPool);
 VULKAN_WRAPPER_API VkResult vkCreateDescriptorSetLayout(VkDevice device, VkDescriptorSetLayoutCreateInfo const * pCreateInfo, VkAllocationCallbacks const * pAllocator, VkDescriptorSetLayout * pSetLayout);
 VULKAN_WRAPPER_API VkResult vkCreatePipelineLayout(VkDevice device, VkPipelineLayoutCreateInfo const * pCreateInfo, VkAllocationCallbacks const * pAllocator, VkPipelineLayout * pPipelineLayout);
+VULKAN_WRAPPER_API VkResult vkCreatePipelineCache(VkDevice device, VkPipelineCacheCreateInfo const * pCreateInfo, VkAllocationCallbacks const * pAllocator, VkPipelineCache * pPipelineCache);
 VULKAN_WRAPPER_API VkResult vkCreateGraphicsPipelines(VkDevice device, VkPipelineCache pipelineCache, std::uint32_t createInfoCount, VkGraphicsPipelineCreateInfo const * pCreateInfos, VkAllocationCallbacks const * pAllocator, VkPipeline * pPipelines);
+VULKAN_WRAPPER_API VkResult vkCreateComputePipelines(VkDevice device, VkPipelineCache pipelineCache, std::uint32_t createInfoCount, VkComputePipelineCreateInfo const * pCreateInfos, VkAllocationCallbacks const * pAllocator, VkPipeline * pPipelines);
 VULKAN_WRAPPER_API VkResult vkCreateBuffer(VkDevice device, VkBufferCreateInfo const * pCreateInfo, VkAllocationCallbacks const * pAllocator, VkBuffer * pBuffer);
 VULKAN_WRAPPER_API VkResult vkCreateImage(VkDevice device, VkImageCreateInfo const * pCreateInfo, VkAllocationCallbacks const * pAllocator, VkImage * pImage);
 VULKAN_WRAPPER_API VkResult vkCreateBufferView(VkDevice device, VkBufferViewCreateInfo const * pCreateInfo, VkAllocationCallbacks const * pAllocator, VkBufferView * pView);
@@ -417,6 +434,7 @@ VULKAN_WRAPPER_API void vkDestroyDescriptorPool(VkDevice device, VkDescriptorPoo
 VULKAN_WRAPPER_API void vkDestroyDescriptorSetLayout(VkDevice device, VkDescriptorSetLayout descriptorSetLayout, VkAllocationCallbacks const * pAllocator);
 VULKAN_WRAPPER_API void vkDestroyPipelineLayout(VkDevice device, VkPipelineLayout pipelineLayout, VkAllocationCallbacks const * pAllocator);
 VULKAN_WRAPPER_API void vkDestroyPipeline(VkDevice device, VkPipeline pipeline, VkAllocationCallbacks const * pAllocator);
+VULKAN_WRAPPER_API void vkDestroyPipelineCache(VkDevice device, VkPipelineCache pipelineCache, VkAllocationCallbacks const * pAllocator);
 VULKAN_WRAPPER_API void vkDestroyBuffer(VkDevice device, VkBuffer buffer, VkAllocationCallbacks const * pAllocator);
 VULKAN_WRAPPER_API void vkDestroyImage(VkDevice device, VkImage image, VkAllocationCallbacks const * pAllocator);
 VULKAN_WRAPPER_API void vkDestroyBufferView(VkDevice device, VkBufferView bufferView, VkAllocationCallbacks const * pAllocator);
@@ -438,6 +456,7 @@ VULKAN_WRAPPER_API void vkFreeMemory(VkDevice device, VkDeviceMemory memory, VkA
 
 VULKAN_WRAPPER_API void vkGetPhysicalDeviceProperties(VkPhysicalDevice physicalDevice, VkPhysicalDeviceProperties * pProperties);
 VULKAN_WRAPPER_API void vkGetPhysicalDeviceFeatures(VkPhysicalDevice physicalDevice, VkPhysicalDeviceFeatures * pFeatures);
+VULKAN_WRAPPER_API void vkGetPhysicalDeviceFeatures2(VkPhysicalDevice physicalDevice, VkPhysicalDeviceFeatures2 * pFeatures);
 VULKAN_WRAPPER_API void vkGetPhysicalDeviceMemoryProperties(VkPhysicalDevice physicalDevice, VkPhysicalDeviceMemoryProperties * pMemoryProperties);
 VULKAN_WRAPPER_API void vkGetPhysicalDeviceQueueFamilyProperties(VkPhysicalDevice physicalDevice, std::uint32_t * pQueueFamilyPropertyCount, VkQueueFamilyProperties * pQueueFamilyProperties);
 VULKAN_WRAPPER_API void vkGetPhysicalDeviceImageFormatProperties(VkPhysicalDevice physicalDevice, VkFormat format, VkImageType type, VkImageTiling tiling, VkImageUsageFlags usage, VkImageCreateFlags flags, VkImageFormatProperties * pImageFormatProperties);
@@ -449,6 +468,7 @@ VULKAN_WRAPPER_API void vkGetBufferMemoryRequirements(VkDevice device, VkBuffer
 VULKAN_WRAPPER_API void vkGetImageMemoryRequirements(VkDevice device, VkImage image, VkMemoryRequirements * pMemoryRequirements);
 VULKAN_WRAPPER_API VkResult vkGetFenceStatus(VkDevice device, VkFence fence);
 VULKAN_WRAPPER_API VkResult vkGetEventStatus(VkDevice device, VkEvent event);
+VULKAN_WRAPPER_API VkResult vkGetPipelineCacheData(VkDevice device, VkPipelineCache pipelineCache, std::size_t * pDataSize, void * pData);
 VULKAN_WRAPPER_API VkResult vkGetSwapchainImagesKHR(VkDevice device, VkSwapchainKHR swapchain, std::uint32_t * pSwapchainImageCount, VkImage * pSwapchainImages);
 
 VULKAN_WRAPPER_API VkResult vkMapMemory(VkDevice device, VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize size, VkMemoryMapFlags flags, void ** ppData);
@@ -177,6 +177,11 @@ void vkGetPhysicalDeviceFeatures(VkPhysicalDevice physicalDevice, VkPhysicalDevi
     Functions::vkGetPhysicalDeviceFeatures(physicalDevice, pFeatures);
 }
 
+void vkGetPhysicalDeviceFeatures2(VkPhysicalDevice physicalDevice, VkPhysicalDeviceFeatures2 * pFeatures)
+{
+    Functions::vkGetPhysicalDeviceFeatures2(physicalDevice, pFeatures);
+}
+
 void vkGetPhysicalDeviceMemoryProperties(VkPhysicalDevice physicalDevice, VkPhysicalDeviceMemoryProperties * pMemoryProperties)
 {
     Functions::vkGetPhysicalDeviceMemoryProperties(physicalDevice, pMemoryProperties);
@@ -222,6 +227,11 @@ void vkGetImageMemoryRequirements(VkDevice device, VkImage image, VkMemoryRequir
     Functions::vkGetImageMemoryRequirements(device, image, pMemoryRequirements);
 }
 
+VkResult vkGetPipelineCacheData(VkDevice device, VkPipelineCache pipelineCache, std::size_t * pDataSize, void * pData)
+{
+    return Functions::vkGetPipelineCacheData(device, pipelineCache, pDataSize, pData);
+}
+
 VkResult vkGetFenceStatus(VkDevice device, VkFence fence)
 {
     return Functions::vkGetFenceStatus(device, fence);
@@ -298,11 +308,21 @@ VkResult vkCreatePipelineLayout(VkDevice device, VkPipelineLayoutCreateInfo cons
     return Functions::vkCreatePipelineLayout(device, pCreateInfo, pAllocator, pPipelineLayout);
 }
 
+VkResult vkCreatePipelineCache(VkDevice device, VkPipelineCacheCreateInfo const * pCreateInfo, VkAllocationCallbacks const * pAllocator, VkPipelineCache * pPipelineCache)
+{
+    return Functions::vkCreatePipelineCache(device, pCreateInfo, pAllocator, pPipelineCache);
+}
+
 VkResult vkCreateGraphicsPipelines(VkDevice device, VkPipelineCache pipelineCache, std::uint32_t createInfoCount, VkGraphicsPipelineCreateInfo const * pCreateInfos, VkAllocationCallbacks const * pAllocator, VkPipeline * pPipelines)
 {
     return Functions::vkCreateGraphicsPipelines(device, pipelineCache, createInfoCount, pCreateInfos, pAllocator, pPipelines);
 }
 
+VkResult vkCreateComputePipelines(VkDevice device, VkPipelineCache pipelineCache, std::uint32_t createInfoCount, VkComputePipelineCreateInfo const * pCreateInfos, VkAllocationCallbacks const * pAllocator, VkPipeline * pPipelines)
+{
+    return Functions::vkCreateComputePipelines(device, pipelineCache, createInfoCount, pCreateInfos, pAllocator, pPipelines);
+}
+
 VkResult vkCreateBuffer(VkDevice device, VkBufferCreateInfo const * pCreateInfo, VkAllocationCallbacks const * pAllocator, VkBuffer * pBuffer)
 {
     return Functions::vkCreateBuffer(device, pCreateInfo, pAllocator, pBuffer);
@@ -404,6 +424,11 @@ void vkDestroyPipeline(VkDevice device, VkPipeline pipeline, VkAllocationCallbac
     Functions::vkDestroyPipeline(device, pipeline, pAllocator);
 }
 
+void vkDestroyPipelineCache(VkDevice device, VkPipelineCache pipelineCache, VkAllocationCallbacks const * pAllocator)
+{
+    Functions::vkDestroyPipelineCache(device, pipelineCache, pAllocator);
+}
+
 void vkDestroyBuffer(VkDevice device, VkBuffer buffer, VkAllocationCallbacks const * pAllocator)
 {
     Functions::vkDestroyBuffer(device, buffer, pAllocator);
@@ -560,6 +585,11 @@ void vkCmdClearColorImage(VkCommandBuffer commandBuffer, VkImage image, VkImageL
     Functions::vkCmdClearColorImage(commandBuffer, image, imageLayout, pColor, rangeCount, pRanges);
 }
 
+void vkCmdPushConstants(VkCommandBuffer commandBuffer, VkPipelineLayout layout, VkShaderStageFlags stageFlags, std::uint32_t offset, std::uint32_t size, void const * pValues)
+{
+    Functions::vkCmdPushConstants(commandBuffer, layout, stageFlags, offset, size, pValues);
+}
+
 void vkCmdPipelineBarrier(VkCommandBuffer commandBuffer,
                           VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask,
                           VkDependencyFlags dependencyFlags,
@@ -585,6 +615,11 @@ void vkCmdEndRenderPass(VkCommandBuffer commandBuffer)
     Functions::vkCmdEndRenderPass(commandBuffer);
 }
 
+void vkCmdExecuteCommands(VkCommandBuffer commandBuffer, std::uint32_t commandBufferCount, VkCommandBuffer const * pCommandBuffers)
+{
+    Functions::vkCmdExecuteCommands(commandBuffer, commandBufferCount, pCommandBuffers);
+}
+
 void vkCmdNextSubpass(VkCommandBuffer commandBuffer, VkSubpassContents contents)
 {
     Functions::vkCmdNextSubpass(commandBuffer, contents);
@@ -624,6 +659,16 @@ void vkCmdDrawIndexed(VkCommandBuffer commandBuffer, std::uint32_t indexCount, s
     Functions::vkCmdDrawIndexed(commandBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
 }
 
+void vkCmdDrawIndexedIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, std::uint32_t drawCount, std::uint32_t stride)
+{
+    Functions::vkCmdDrawIndexedIndirect(commandBuffer, buffer, offset, drawCount, stride);
+}
+
+void vkCmdDispatch(VkCommandBuffer commandBuffer, std::uint32_t groupCountX, std::uint32_t groupCountY, std::uint32_t groupCountZ)
+{
+    Functions::vkCmdDispatch(commandBuffer, groupCountX, groupCountY, groupCountZ);
+}
+
 void vkCmdSetViewport(VkCommandBuffer commandBuffer, std::uint32_t firstViewport, std::uint32_t viewportCount, VkViewport * pViewports)
 {
     Functions::vkCmdSetViewport(commandBuffer, firstViewport, viewportCount, pViewports);
@@ -29,6 +29,7 @@ VK_INSTANCE_FUNCTION(vkEnumerateDeviceLayerProperties);
 
 VK_INSTANCE_FUNCTION(vkGetPhysicalDeviceProperties);
 VK_INSTANCE_FUNCTION(vkGetPhysicalDeviceFeatures);
+VK_INSTANCE_FUNCTION(vkGetPhysicalDeviceFeatures2);
 VK_INSTANCE_FUNCTION(vkGetPhysicalDeviceMemoryProperties);
 VK_INSTANCE_FUNCTION(vkGetPhysicalDeviceQueueFamilyProperties);
 VK_INSTANCE_FUNCTION(vkGetPhysicalDeviceImageFormatProperties);
@@ -62,6 +63,7 @@ VK_DEVICE_FUNCTION(vkGetBufferMemoryRequirements);
 VK_DEVICE_FUNCTION(vkGetImageMemoryRequirements);
 VK_DEVICE_FUNCTION(vkGetFenceStatus);
 VK_DEVICE_FUNCTION(vkGetEventStatus);
+VK_DEVICE_FUNCTION(vkGetPipelineCacheData);
 
 VK_DEVICE_FUNCTION(vkDeviceWaitIdle);
 
@@ -81,7 +83,9 @@ VK_DEVICE_FUNCTION(vkCreateFramebuffer);
 VK_DEVICE_FUNCTION(vkCreateRenderPass);
 VK_DEVICE_FUNCTION(vkCreateShaderModule);
 VK_DEVICE_FUNCTION(vkCreatePipelineLayout);
+VK_DEVICE_FUNCTION(vkCreatePipelineCache);
 VK_DEVICE_FUNCTION(vkCreateGraphicsPipelines);
+VK_DEVICE_FUNCTION(vkCreateComputePipelines);
 VK_DEVICE_FUNCTION(vkCreateDescriptorPool);
 VK_DEVICE_FUNCTION(vkCreateDescriptorSetLayout);
 VK_DEVICE_FUNCTION(vkCreateBuffer);
@@ -100,6 +104,7 @@ VK_DEVICE_FUNCTION(vkDestroyFramebuffer);
 VK_DEVICE_FUNCTION(vkDestroyShaderModule);
 VK_DEVICE_FUNCTION(vkDestroyPipelineLayout);
 VK_DEVICE_FUNCTION(vkDestroyPipeline);
+VK_DEVICE_FUNCTION(vkDestroyPipelineCache);
 VK_DEVICE_FUNCTION(vkDestroyDescriptorPool);
 VK_DEVICE_FUNCTION(vkDestroyDescriptorSetLayout);
 VK_DEVICE_FUNCTION(vkDestroyBuffer);
@@ -136,13 +141,19 @@ VK_DEVICE_FUNCTION(vkCmdBindDescriptorSets);
 VK_DEVICE_FUNCTION(vkCmdBindVertexBuffers);
 VK_DEVICE_FUNCTION(vkCmdBindIndexBuffer);
 
+VK_DEVICE_FUNCTION(vkCmdPushConstants);
+
 VK_DEVICE_FUNCTION(vkCmdDraw);
 VK_DEVICE_FUNCTION(vkCmdDrawIndexed);
+VK_DEVICE_FUNCTION(vkCmdDrawIndexedIndirect);
+
+VK_DEVICE_FUNCTION(vkCmdDispatch);
 
 VK_DEVICE_FUNCTION(vkCmdBeginRenderPass);
 VK_DEVICE_FUNCTION(vkCmdEndRenderPass);
 
 VK_DEVICE_FUNCTION(vkCmdNextSubpass);
+VK_DEVICE_FUNCTION(vkCmdExecuteCommands);
 
 VK_DEVICE_FUNCTION(vkCmdSetViewport);
 VK_DEVICE_FUNCTION(vkCmdSetScissor);